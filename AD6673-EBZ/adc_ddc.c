@@ -0,0 +1,525 @@
+/**************************************************************************//**
+*   @file   adc_ddc.c
+*   @brief  Digital downconverter implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "adc_ddc.h"
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+#ifdef ADC_DDC_EN
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Fixed point one and 2*pi in Q30 */
+#define DDC_ONE_Q30				(1LL << 30)
+#define DDC_2PI_Q30				6746518852LL
+
+/* Points of the NCO table */
+#define DDC_NCO_SIZE			(1 << DDC_NCO_BITS)
+
+/* Compensating FIR filter in Q15, a least squares fit of the inverse of the
+   4 stage CIC droop up to 0.2 of the CIC output rate, stop band from 0.3.
+   The pass band ripple is within 0.1 dB and the images are 53 dB down. */
+static const int16_t ddcFir[DDC_FIR_TAPS] =
+{
+	-33, 42, 148, -76, -361, 113, 730, -135, -1342, 103, 2393, 106,
+	-4513, -1214, 11173, 18533, 11173, -1214, -4513, 106, 2393, 103,
+	-1342, -135, 730, 113, -361, -76, 148, 42, -33
+};
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+/* Sine in Q15 over one and a quarter periods, the cosine is read a quarter
+   period further */
+static int16_t ddcSin[DDC_NCO_SIZE + DDC_NCO_SIZE / 4];
+static uint32_t ddcSinValid = 0;
+
+/**************************************************************************//**
+* @brief Builds the NCO table. The first step is computed with the Taylor
+*        series and the table with rotations, in Q30, so no floating point
+*        library is needed.
+*
+* @return None.
+******************************************************************************/
+static void DDC_InitSin(void)
+{
+	int64_t x;
+	int64_t x2;
+	int64_t term;
+	int64_t cosStep;
+	int64_t sinStep;
+	int64_t c;
+	int64_t s;
+	int64_t t;
+	uint32_t i;
+
+	if(ddcSinValid)
+	{
+		return;
+	}
+	x  = DDC_2PI_Q30 / DDC_NCO_SIZE;
+	x2 = (x * x) >> 30;
+	cosStep = DDC_ONE_Q30;
+	sinStep = x;
+	term = DDC_ONE_Q30;
+	for(i = 1; i <= 4; i++)
+	{
+		term = -((term * x2) >> 30) / ((2 * i - 1) * (2 * i));
+		cosStep += term;
+	}
+	term = x;
+	for(i = 1; i <= 4; i++)
+	{
+		term = -((term * x2) >> 30) / ((2 * i) * (2 * i + 1));
+		sinStep += term;
+	}
+	c = DDC_ONE_Q30;
+	s = 0;
+	for(i = 0; i < DDC_NCO_SIZE + DDC_NCO_SIZE / 4; i++)
+	{
+		t = (s + (1LL << 14)) >> 15;
+		ddcSin[i] = (int16_t)((t > 32767) ? 32767 : ((t < -32767) ? -32767 : t));
+		t = ((c * cosStep) - (s * sinStep) + (1LL << 29)) >> 30;
+		s = ((s * cosStep) + (c * sinStep) + (1LL << 29)) >> 30;
+		c = t;
+	}
+	ddcSinValid = 1;
+}
+
+/**************************************************************************//**
+* @brief Clears the filter state of a downconverter. The NCO phase is kept.
+*
+* @param ddc - The downconverter.
+*
+* @return None.
+******************************************************************************/
+void DDC_Reset(stDdc* ddc)
+{
+	uint32_t c;
+	uint32_t i;
+
+	for(c = 0; c < 2; c++)
+	{
+		for(i = 0; i < DDC_CIC_STAGES; i++)
+		{
+			ddc->integ[c][i] = 0;
+			ddc->comb[c][i] = 0;
+		}
+		for(i = 0; i < 2 * DDC_FIR_TAPS; i++)
+		{
+			ddc->firLine[c][i] = 0;
+		}
+	}
+	ddc->cicCount = 0;
+	ddc->firPos = 0;
+	ddc->firPhase = 0;
+}
+
+/**************************************************************************//**
+* @brief Configures a downconverter. The CIC filter decimates by half the
+*        total decimation and the compensating FIR filter by 2. The gain is 1
+*        in the pass band, so a full scale tone at the NCO frequency comes out
+*        at half of the 16 bit full scale.
+*
+* @param ddc - The downconverter.
+* @param cfg - Sampling rate, channel frequency, decimation and resolution.
+*
+* @return 0 in case of success, -1 if the configuration is not supported.
+******************************************************************************/
+int32_t DDC_Init(stDdc* ddc, stDdcConfig* cfg)
+{
+	uint32_t gain;
+	uint32_t i;
+
+	if((cfg->decimation < DDC_MIN_DECIMATION) ||
+	   (cfg->decimation > DDC_MAX_DECIMATION) || (cfg->decimation & 1) ||
+	   !cfg->sampleRate || (cfg->ncoFreq >= cfg->sampleRate) ||
+	   (cfg->width < 2) || (cfg->width > 16))
+	{
+		return -1;
+	}
+	DDC_InitSin();
+
+	ddc->phase = 0;
+	ddc->phaseInc = (uint32_t)((((uint64_t)cfg->ncoFreq << 32) +
+								cfg->sampleRate / 2) / cfg->sampleRate);
+	ddc->mixShift = cfg->width - 1;
+
+	/* The CIC gain is ratio^stages, the growth is removed with a shift and
+	   the remainder with a Q15 multiplier */
+	ddc->cicRatio = cfg->decimation / 2;
+	gain = 1;
+	for(i = 0; i < DDC_CIC_STAGES; i++)
+	{
+		gain *= ddc->cicRatio;
+	}
+	ddc->cicShift = 0;
+	while((1UL << ddc->cicShift) < gain)
+	{
+		ddc->cicShift++;
+	}
+	ddc->cicGain = (int32_t)((1ULL << (ddc->cicShift + 15)) / gain);
+	DDC_Reset(ddc);
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Mixes a block of samples with the NCO. With NEON four samples are
+*        mixed at a time, the table is read one sample at a time.
+*
+* @param ddc - The downconverter.
+* @param in - Input samples.
+* @param count - Number of samples, up to DDC_BLOCK.
+* @param mixI - In phase products.
+* @param mixQ - Quadrature products.
+*
+* @return None.
+******************************************************************************/
+static void DDC_Mix(stDdc* ddc, const int16_t* in, uint32_t count,
+					int32_t* mixI, int32_t* mixQ)
+{
+	uint32_t phase = ddc->phase;
+	uint32_t idx;
+	uint32_t i = 0;
+#ifdef __ARM_NEON__
+	const int32x4_t shift = vdupq_n_s32(-(int32_t)ddc->mixShift);
+	int16_t cosT[4];
+	int16_t sinT[4];
+	int16x4_t x;
+	uint32_t k;
+
+	for(; (i + 4) <= count; i += 4)
+	{
+		for(k = 0; k < 4; k++)
+		{
+			idx = (phase + (i + k) * ddc->phaseInc) >> (32 - DDC_NCO_BITS);
+			cosT[k] = ddcSin[idx + DDC_NCO_SIZE / 4];
+			sinT[k] = ddcSin[idx];
+		}
+		x = vld1_s16(&in[i]);
+		vst1q_s32(&mixI[i], vshlq_s32(vmull_s16(x, vld1_s16(cosT)), shift));
+		vst1q_s32(&mixQ[i], vshlq_s32(vnegq_s32(vmull_s16(x, vld1_s16(sinT))),
+									  shift));
+	}
+#endif
+	for(; i < count; i++)
+	{
+		idx = (phase + i * ddc->phaseInc) >> (32 - DDC_NCO_BITS);
+		mixI[i] = (in[i] * ddcSin[idx + DDC_NCO_SIZE / 4]) >> ddc->mixShift;
+		mixQ[i] = (-in[i] * ddcSin[idx]) >> ddc->mixShift;
+	}
+	ddc->phase = phase + count * ddc->phaseInc;
+}
+
+/**************************************************************************//**
+* @brief Saturates a value to 16 bits.
+*
+* @param x - The value.
+*
+* @return The saturated value.
+******************************************************************************/
+static int16_t DDC_Sat16(int64_t x)
+{
+	if(x > 32767)
+	{
+		return 32767;
+	}
+	if(x < -32768)
+	{
+		return -32768;
+	}
+
+	return (int16_t)x;
+}
+
+/**************************************************************************//**
+* @brief Runs a block of mixer products through the CIC filter. With NEON
+*        the I and Q channels are filtered together in the two lanes of a
+*        vector.
+*
+* @param ddc - The downconverter.
+* @param mixI - In phase products.
+* @param mixQ - Quadrature products.
+* @param count - Number of products.
+* @param cicI - In phase outputs.
+* @param cicQ - Quadrature outputs.
+*
+* @return Number of outputs.
+******************************************************************************/
+static uint32_t DDC_Cic(stDdc* ddc, const int32_t* mixI, const int32_t* mixQ,
+						uint32_t count, int16_t* cicI, int16_t* cicQ)
+{
+#ifdef __ARM_NEON__
+	uint64x2_t integ[DDC_CIC_STAGES];
+	uint64x2_t comb[DDC_CIC_STAGES];
+	uint64x2_t x;
+	uint64x2_t t;
+	int64_t y;
+	uint32_t out = 0;
+	uint32_t s;
+	uint32_t i;
+
+	/* I in lane 0 and Q in lane 1 */
+	for(s = 0; s < DDC_CIC_STAGES; s++)
+	{
+		integ[s] = vcombine_u64(vld1_u64(&ddc->integ[0][s]),
+								vld1_u64(&ddc->integ[1][s]));
+		comb[s] = vcombine_u64(vld1_u64(&ddc->comb[0][s]),
+							   vld1_u64(&ddc->comb[1][s]));
+	}
+	for(i = 0; i < count; i++)
+	{
+		x = vreinterpretq_u64_s64(vmovl_s32(vset_lane_s32(mixQ[i],
+												vdup_n_s32(mixI[i]), 1)));
+		for(s = 0; s < DDC_CIC_STAGES; s++)
+		{
+			integ[s] = vaddq_u64(integ[s], x);
+			x = integ[s];
+		}
+		if(++ddc->cicCount < ddc->cicRatio)
+		{
+			continue;
+		}
+		ddc->cicCount = 0;
+		for(s = 0; s < DDC_CIC_STAGES; s++)
+		{
+			t = x;
+			x = vsubq_u64(x, comb[s]);
+			comb[s] = t;
+		}
+		/* The integrators wrap, the comb output is exact */
+		y = (int64_t)vgetq_lane_u64(x, 0);
+		cicI[out] = DDC_Sat16((y * ddc->cicGain) >> (ddc->cicShift + 15));
+		y = (int64_t)vgetq_lane_u64(x, 1);
+		cicQ[out] = DDC_Sat16((y * ddc->cicGain) >> (ddc->cicShift + 15));
+		out++;
+	}
+	for(s = 0; s < DDC_CIC_STAGES; s++)
+	{
+		vst1_u64(&ddc->integ[0][s], vget_low_u64(integ[s]));
+		vst1_u64(&ddc->integ[1][s], vget_high_u64(integ[s]));
+		vst1_u64(&ddc->comb[0][s], vget_low_u64(comb[s]));
+		vst1_u64(&ddc->comb[1][s], vget_high_u64(comb[s]));
+	}
+
+	return out;
+#else
+	uint64_t x[2];
+	uint64_t t;
+	int64_t y;
+	uint32_t out = 0;
+	uint32_t c;
+	uint32_t s;
+	uint32_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		x[0] = (uint64_t)(int64_t)mixI[i];
+		x[1] = (uint64_t)(int64_t)mixQ[i];
+		for(c = 0; c < 2; c++)
+		{
+			for(s = 0; s < DDC_CIC_STAGES; s++)
+			{
+				ddc->integ[c][s] += x[c];
+				x[c] = ddc->integ[c][s];
+			}
+		}
+		if(++ddc->cicCount < ddc->cicRatio)
+		{
+			continue;
+		}
+		ddc->cicCount = 0;
+		for(c = 0; c < 2; c++)
+		{
+			for(s = 0; s < DDC_CIC_STAGES; s++)
+			{
+				t = x[c];
+				x[c] -= ddc->comb[c][s];
+				ddc->comb[c][s] = t;
+			}
+			/* The integrators wrap, the comb output is exact */
+			y = (int64_t)x[c];
+			y = (y * ddc->cicGain) >> (ddc->cicShift + 15);
+			(c ? cicQ : cicI)[out] = DDC_Sat16(y);
+		}
+		out++;
+	}
+
+	return out;
+#endif
+}
+
+/**************************************************************************//**
+* @brief Runs a block of CIC outputs through the compensating FIR filter and
+*        decimates them by 2. The delay lines hold each sample twice, so the
+*        taps are read without wrapping. With NEON the taps are summed eight
+*        at a time and the last ones in the scalar loop.
+*
+* @param ddc - The downconverter.
+* @param cicI - In phase CIC outputs.
+* @param cicQ - Quadrature CIC outputs.
+* @param count - Number of CIC outputs.
+* @param out - Output words, I in the low 16 bits and Q in the high 16 bits.
+*
+* @return Number of output words.
+******************************************************************************/
+static uint32_t DDC_Fir(stDdc* ddc, const int16_t* cicI, const int16_t* cicQ,
+						uint32_t count, uint32_t* out)
+{
+	const int16_t* lineI;
+	const int16_t* lineQ;
+	int32_t accI;
+	int32_t accQ;
+	uint32_t words = 0;
+	uint32_t i;
+	uint32_t k;
+#ifdef __ARM_NEON__
+	int16x8_t taps[DDC_FIR_TAPS / 8];
+	int16x8_t tap;
+	int16x8_t x;
+	int32x4_t sumI;
+	int32x4_t sumQ;
+	int32x2_t pair;
+
+	for(k = 0; k < DDC_FIR_TAPS / 8; k++)
+	{
+		taps[k] = vld1q_s16(&ddcFir[8 * k]);
+	}
+#endif
+
+	for(i = 0; i < count; i++)
+	{
+		ddc->firPos = ddc->firPos ? (ddc->firPos - 1) : (DDC_FIR_TAPS - 1);
+		ddc->firLine[0][ddc->firPos] = cicI[i];
+		ddc->firLine[0][ddc->firPos + DDC_FIR_TAPS] = cicI[i];
+		ddc->firLine[1][ddc->firPos] = cicQ[i];
+		ddc->firLine[1][ddc->firPos + DDC_FIR_TAPS] = cicQ[i];
+		if(++ddc->firPhase < 2)
+		{
+			continue;
+		}
+		ddc->firPhase = 0;
+		lineI = &ddc->firLine[0][ddc->firPos];
+		lineQ = &ddc->firLine[1][ddc->firPos];
+		/* The sum of the magnitudes of the taps is below 2, the accumulators
+		   do not overflow */
+		accI = 1 << 14;
+		accQ = 1 << 14;
+		k = 0;
+#ifdef __ARM_NEON__
+		sumI = vdupq_n_s32(0);
+		sumQ = vdupq_n_s32(0);
+		for(; (k + 8) <= DDC_FIR_TAPS; k += 8)
+		{
+			tap = taps[k / 8];
+			x = vld1q_s16(&lineI[k]);
+			sumI = vmlal_s16(sumI, vget_low_s16(tap), vget_low_s16(x));
+			sumI = vmlal_s16(sumI, vget_high_s16(tap), vget_high_s16(x));
+			x = vld1q_s16(&lineQ[k]);
+			sumQ = vmlal_s16(sumQ, vget_low_s16(tap), vget_low_s16(x));
+			sumQ = vmlal_s16(sumQ, vget_high_s16(tap), vget_high_s16(x));
+		}
+		pair = vpadd_s32(vget_low_s32(sumI), vget_high_s32(sumI));
+		accI += vget_lane_s32(vpadd_s32(pair, pair), 0);
+		pair = vpadd_s32(vget_low_s32(sumQ), vget_high_s32(sumQ));
+		accQ += vget_lane_s32(vpadd_s32(pair, pair), 0);
+#endif
+		for(; k < DDC_FIR_TAPS; k++)
+		{
+			accI += ddcFir[k] * lineI[k];
+			accQ += ddcFir[k] * lineQ[k];
+		}
+		out[words++] = ((uint32_t)(uint16_t)DDC_Sat16(accI >> 15)) |
+					   ((uint32_t)(uint16_t)DDC_Sat16(accQ >> 15) << 16);
+	}
+
+	return words;
+}
+
+/**************************************************************************//**
+* @brief Downconverts a block of samples of one channel: the samples are
+*        mixed with the NCO, decimated by the CIC filter and by the
+*        compensating FIR filter. The state is kept between the calls, so a
+*        stream can be processed in blocks of any size.
+*
+* @param ddc - The downconverter.
+* @param in - Sign extended samples of the channel, as written by
+*             adc_deinterleave().
+* @param count - Number of samples.
+* @param out - Output words, I in the low 16 bits and Q in the high 16 bits,
+*              room for DDC_MAX_OUTPUT(count, decimation) words.
+*
+* @return Number of output words.
+******************************************************************************/
+uint32_t DDC_Process(stDdc* ddc, const int16_t* in, uint32_t count,
+					 uint32_t* out)
+{
+	int32_t mixI[DDC_BLOCK];
+	int32_t mixQ[DDC_BLOCK];
+	int16_t cicI[DDC_BLOCK];
+	int16_t cicQ[DDC_BLOCK];
+	uint32_t words = 0;
+	uint32_t cicCnt;
+	uint32_t n;
+
+	while(count)
+	{
+		n = (count > DDC_BLOCK) ? DDC_BLOCK : count;
+		DDC_Mix(ddc, in, n, mixI, mixQ);
+		cicCnt = DDC_Cic(ddc, mixI, mixQ, n, cicI, cicQ);
+		words += DDC_Fir(ddc, cicI, cicQ, cicCnt, out + words);
+		in += n;
+		count -= n;
+	}
+
+	return words;
+}
+
+#endif
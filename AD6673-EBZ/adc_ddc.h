@@ -0,0 +1,124 @@
+/**************************************************************************//**
+*   @file   adc_ddc.h
+*   @brief  Digital downconverter header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __ADC_DDC_H__
+#define __ADC_DDC_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* The downconverter is built only if ADC_DDC_EN is defined. The NCO table
+   needs 2.5 * 2^DDC_NCO_BITS bytes of RAM. */
+
+/* Phase resolution of the NCO, the phase truncation spurs are at about
+   -6 dBc per bit. */
+#ifndef DDC_NCO_BITS
+#define DDC_NCO_BITS			12
+#endif
+
+/* Number of samples processed by each stage in one pass */
+#ifndef DDC_BLOCK
+#define DDC_BLOCK				64
+#endif
+
+/* Integrator and comb stages of the CIC filter */
+#define DDC_CIC_STAGES			4
+
+/* Taps of the compensating FIR filter, which decimates by 2 */
+#define DDC_FIR_TAPS			31
+
+/* Range of the total decimation, which must be even */
+#define DDC_MIN_DECIMATION		2
+#define DDC_MAX_DECIMATION		256
+
+/* Maximum number of words written by DDC_Process for a number of input
+   samples */
+#define DDC_MAX_OUTPUT(count, decimation)	((count) / (decimation) + 1)
+
+/*****************************************************************************/
+/************************ Types Declarations *********************************/
+/*****************************************************************************/
+typedef struct _stDdcConfig
+{
+	uint32_t	sampleRate;	/*!< ADC sampling rate in Hz */
+	uint32_t	ncoFreq;	/*!< Center frequency of the channel in Hz */
+	uint32_t	decimation;	/*!< Total decimation, even, from 2 to 256 */
+	uint32_t	width;		/*!< Resolution of the input samples in bits */
+}stDdcConfig;
+
+typedef struct _stDdc
+{
+	uint32_t	phase;			/*!< NCO phase accumulator */
+	uint32_t	phaseInc;		/*!< NCO phase increment per sample */
+	uint32_t	mixShift;		/*!< Scaling of the mixer products */
+	uint32_t	cicRatio;		/*!< Decimation of the CIC filter */
+	uint32_t	cicCount;		/*!< Input samples since the last CIC output */
+	uint32_t	cicShift;		/*!< Bit growth of the CIC filter */
+	int32_t		cicGain;		/*!< CIC gain correction in Q15 */
+	uint64_t	integ[2][DDC_CIC_STAGES];	/*!< Integrators, I and Q */
+	uint64_t	comb[2][DDC_CIC_STAGES];	/*!< Comb delays, I and Q */
+	int16_t		firLine[2][2 * DDC_FIR_TAPS];	/*!< FIR delay lines, I and Q */
+	uint32_t	firPos;			/*!< Newest sample of the FIR delay lines */
+	uint32_t	firPhase;		/*!< CIC outputs since the last FIR output */
+}stDdc;
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+#ifdef ADC_DDC_EN
+/** Configures a downconverter */
+int32_t DDC_Init(stDdc* ddc, stDdcConfig* cfg);
+/** Clears the filter state of a downconverter */
+void DDC_Reset(stDdc* ddc);
+/** Downconverts a block of samples of one channel */
+uint32_t DDC_Process(stDdc* ddc, const int16_t* in, uint32_t count,
+					 uint32_t* out);
+#endif
+
+#endif /* __ADC_DDC_H__ */
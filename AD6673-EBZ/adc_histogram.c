@@ -0,0 +1,437 @@
+/**************************************************************************//**
+*   @file   adc_histogram.c
+*   @brief  ADC code density histogram implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "adc_histogram.h"
+
+#ifdef ADC_HISTOGRAM_EN
+
+#include "xil_io.h"
+
+extern void xil_printf(const char *ctrl1, ...);
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Fixed point one and pi in Q30 */
+#define HIST_ONE_Q30			(1LL << 30)
+#define HIST_PI_Q30				3373259426LL
+
+/* The cumulative counts are scaled so the total stays below 2^33 */
+#define HIST_CUM_BITS			33
+
+/**************************************************************************//**
+* @brief Attaches the bins to a histogram and clears them.
+*
+* @param hist - The histogram.
+* @param bins - Room for HIST_BINS(width) counters.
+* @param width - Resolution of the codes in bits.
+*
+* @return 0 in case of success, -1 if the resolution is not supported.
+******************************************************************************/
+int32_t HIST_Init(stHistogram* hist, uint32_t* bins, uint32_t width)
+{
+	if((width < 4) || (width > 16))
+	{
+		return -1;
+	}
+	hist->bins = bins;
+	hist->width = width;
+	HIST_Clear(hist);
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Clears the bins of a histogram.
+*
+* @param hist - The histogram.
+*
+* @return None.
+******************************************************************************/
+void HIST_Clear(stHistogram* hist)
+{
+	uint32_t i;
+
+	for(i = 0; i < HIST_BINS(hist->width); i++)
+	{
+		hist->bins[i] = 0;
+	}
+	hist->samples = 0;
+}
+
+/**************************************************************************//**
+* @brief Bins the samples of a captured buffer. The codes are binned in
+*        offset binary, so bin 0 is the negative full scale. Four words are
+*        read per iteration to keep the bus busy.
+*
+* @param hist - The histogram.
+* @param cfg - Layout and format of the samples.
+* @param address - Start address of the captured buffer.
+* @param words - Number of 32 bit words of the buffer.
+*
+* @return 0 in case of success, -1 if the configuration is not supported.
+******************************************************************************/
+int32_t HIST_Accumulate(stHistogram* hist, stHistConfig* cfg,
+						uint32_t address, uint32_t words)
+{
+	uint32_t* bins = hist->bins;
+	uint32_t mask = HIST_BINS(cfg->width) - 1;
+	uint32_t flip = 0;
+	uint32_t shift0 = cfg->shift;
+	uint32_t shift1 = cfg->shift + 16;
+	uint32_t d[4];
+	uint32_t n;
+	uint32_t i;
+
+	if((cfg->width != hist->width) || (cfg->layout > ANALYSIS_LAYOUT_IQ) ||
+	   (cfg->channel > 1))
+	{
+		return -1;
+	}
+	if(cfg->format == ANALYSIS_TWOS_COMPLEMENT)
+	{
+		flip = 1 << (cfg->width - 1);
+	}
+
+	if(cfg->layout == ANALYSIS_LAYOUT_SINGLE)
+	{
+		/* Both lanes are successive samples */
+		for(n = 0; (n + 4) <= words; n += 4)
+		{
+			for(i = 0; i < 4; i++)
+			{
+				d[i] = Xil_In32(address + ((n + i) * 4));
+			}
+			for(i = 0; i < 4; i++)
+			{
+				bins[((d[i] >> shift0) & mask) ^ flip]++;
+				bins[((d[i] >> shift1) & mask) ^ flip]++;
+			}
+		}
+		for(; n < words; n++)
+		{
+			d[0] = Xil_In32(address + (n * 4));
+			bins[((d[0] >> shift0) & mask) ^ flip]++;
+			bins[((d[0] >> shift1) & mask) ^ flip]++;
+		}
+		hist->samples += 2 * (uint64_t)words;
+	}
+	else
+	{
+		/* One lane per word belongs to the channel */
+		if(cfg->channel)
+		{
+			shift0 = shift1;
+		}
+		for(n = 0; (n + 4) <= words; n += 4)
+		{
+			for(i = 0; i < 4; i++)
+			{
+				d[i] = Xil_In32(address + ((n + i) * 4));
+			}
+			for(i = 0; i < 4; i++)
+			{
+				bins[((d[i] >> shift0) & mask) ^ flip]++;
+			}
+		}
+		for(; n < words; n++)
+		{
+			d[0] = Xil_In32(address + (n * 4));
+			bins[((d[0] >> shift0) & mask) ^ flip]++;
+		}
+		hist->samples += words;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Adds the bins of a histogram to another one, to combine the
+*        histograms filled over separate parts of the data.
+*
+* @param dst - The histogram receiving the sum.
+* @param src - The histogram added.
+*
+* @return 0 in case of success, -1 if the resolutions differ.
+******************************************************************************/
+int32_t HIST_Merge(stHistogram* dst, const stHistogram* src)
+{
+	uint32_t i;
+
+	if(dst->width != src->width)
+	{
+		return -1;
+	}
+	for(i = 0; i < HIST_BINS(dst->width); i++)
+	{
+		dst->bins[i] += src->bins[i];
+	}
+	dst->samples += src->samples;
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Computes cos(pi * x) with the Taylor series, after reducing the
+*        angle to the first octant.
+*
+* @param x - The angle over pi in Q30, from 0 to 1.
+*
+* @return The cosine in Q30.
+******************************************************************************/
+static int64_t HIST_CosPi(int64_t x)
+{
+	int64_t sign = 1;
+	int64_t theta;
+	int64_t theta2;
+	int64_t term;
+	int64_t sum;
+	uint32_t useSin = 0;
+	uint32_t i;
+
+	if(x > HIST_ONE_Q30 / 2)
+	{
+		x = HIST_ONE_Q30 - x;
+		sign = -1;
+	}
+	if(x > HIST_ONE_Q30 / 4)
+	{
+		x = HIST_ONE_Q30 / 2 - x;
+		useSin = 1;
+	}
+	theta = (x * HIST_PI_Q30) >> 30;
+	theta2 = (theta * theta) >> 30;
+	term = useSin ? theta : HIST_ONE_Q30;
+	sum = term;
+	for(i = 1; i <= 6; i++)
+	{
+		if(useSin)
+		{
+			term = -((term * theta2) >> 30) / ((2 * i) * (2 * i + 1));
+		}
+		else
+		{
+			term = -((term * theta2) >> 30) / ((2 * i - 1) * (2 * i));
+		}
+		sum += term;
+	}
+
+	return sign * sum;
+}
+
+/**************************************************************************//**
+* @brief Transition level of a code from the cumulative count below it, for
+*        a sine wave input: -cos(pi * cum / total), in Q30 of the amplitude.
+*
+* @param cum - Samples below the code.
+* @param total - Samples of the histogram.
+* @param scale - Shift which keeps the total below 2^HIST_CUM_BITS.
+*
+* @return The transition level in Q30.
+******************************************************************************/
+static int64_t HIST_Transition(uint64_t cum, uint64_t total, uint32_t scale)
+{
+	uint64_t x;
+
+	x = (((cum >> scale) << 30) + ((total >> scale) / 2)) / (total >> scale);
+
+	return -HIST_CosPi((int64_t)x);
+}
+
+/**************************************************************************//**
+* @brief Computes the DNL and INL of the codes from the histogram of a sine
+*        wave, with the cumulative histogram method: the transition level of
+*        each code follows from the sine wave PDF, so the amplitude and
+*        offset of the sine wave need not be known. The sine wave must
+*        slightly overdrive the ADC; the end codes, which collect the
+*        overrange, have no DNL and INL.
+*
+* @param hist - The histogram of a sine wave.
+* @param dnl - DNL of each code, HIST_BINS(width) words, can be NULL.
+* @param inl - INL of each code, HIST_BINS(width) words, can be NULL.
+* @param result - Extremes of the DNL and INL and missing codes.
+*
+* @return 0 in case of success, -1 if the histogram has too few samples or
+*         the sine wave does not reach both end codes.
+******************************************************************************/
+int32_t HIST_Linearity(stHistogram* hist, int32_t* dnl, int32_t* inl,
+					   stLinearityResult* result)
+{
+	uint32_t codes = HIST_BINS(hist->width);
+	uint64_t total = hist->samples;
+	uint64_t cum;
+	uint32_t scale = 0;
+	uint32_t k;
+	int64_t first;
+	int64_t range;
+	int64_t level;
+	int64_t next;
+	int32_t d;
+	int32_t l;
+
+	if((total < codes) || !hist->bins[0] || !hist->bins[codes - 1])
+	{
+		return -1;
+	}
+	while((total >> scale) >= (1ULL << HIST_CUM_BITS))
+	{
+		scale++;
+	}
+
+	/* The ideal code width is the mean width of the inner codes */
+	first = HIST_Transition(hist->bins[0], total, scale);
+	range = HIST_Transition(total - hist->bins[codes - 1], total, scale) -
+			first;
+	if(range <= 0)
+	{
+		return -1;
+	}
+
+	result->dnlMin = 0x7FFFFFFF;
+	result->dnlMax = -0x7FFFFFFF;
+	result->inlMin = 0x7FFFFFFF;
+	result->inlMax = -0x7FFFFFFF;
+	result->dnlMinCode = 0;
+	result->dnlMaxCode = 0;
+	result->inlMinCode = 0;
+	result->inlMaxCode = 0;
+	result->missingCodes = 0;
+	if(dnl)
+	{
+		dnl[0] = 0;
+		dnl[codes - 1] = 0;
+	}
+	if(inl)
+	{
+		inl[0] = 0;
+		inl[codes - 1] = 0;
+	}
+
+	cum = hist->bins[0];
+	level = first;
+	for(k = 1; k < codes - 1; k++)
+	{
+		cum += hist->bins[k];
+		next = HIST_Transition(cum, total, scale);
+		if(!hist->bins[k])
+		{
+			result->missingCodes++;
+		}
+		/* width / (range / (codes - 2)) - 1 and the deviation of the
+		   transition level from the end point line, in 0.01 LSB */
+		d = (int32_t)(((next - level) * (codes - 2) * 100) / range) - 100;
+		l = (int32_t)(((level - first) * (codes - 2) * 100) / range) -
+			(int32_t)((k - 1) * 100);
+		if(dnl)
+		{
+			dnl[k] = d;
+		}
+		if(inl)
+		{
+			inl[k] = l;
+		}
+		if(d < result->dnlMin)
+		{
+			result->dnlMin = d;
+			result->dnlMinCode = k;
+		}
+		if(d > result->dnlMax)
+		{
+			result->dnlMax = d;
+			result->dnlMaxCode = k;
+		}
+		if(l < result->inlMin)
+		{
+			result->inlMin = l;
+			result->inlMinCode = k;
+		}
+		if(l > result->inlMax)
+		{
+			result->inlMax = l;
+			result->inlMaxCode = k;
+		}
+		level = next;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Prints a value given in hundredths.
+*
+* @param name - Name of the value.
+* @param value - The value in hundredths.
+* @param code - Code at which the value was found.
+*
+* @return None.
+******************************************************************************/
+static void HIST_PrintValue(const char* name, int32_t value, uint32_t code)
+{
+	uint32_t abs = (value < 0) ? -value : value;
+
+	xil_printf("%s: %s%d.%02d LSB at code %d\n\r", name, (value < 0) ? "-" : "",
+			   abs / 100, abs % 100, code);
+}
+
+/**************************************************************************//**
+* @brief Prints a linearity result over UART.
+*
+* @param result - The linearity result.
+*
+* @return None.
+******************************************************************************/
+void HIST_Print(stLinearityResult* result)
+{
+	HIST_PrintValue("DNL min", result->dnlMin, result->dnlMinCode);
+	HIST_PrintValue("DNL max", result->dnlMax, result->dnlMaxCode);
+	HIST_PrintValue("INL min", result->inlMin, result->inlMinCode);
+	HIST_PrintValue("INL max", result->inlMax, result->inlMaxCode);
+	xil_printf("Missing codes: %d\n\r", result->missingCodes);
+}
+
+#endif
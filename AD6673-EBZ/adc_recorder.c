@@ -0,0 +1,373 @@
+/**************************************************************************//**
+*   @file   adc_recorder.c
+*   @brief  SD card recorder implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <string.h>
+#include "xil_cache.h"
+#include "timer.h"
+#include "adc_recorder.h"
+
+#ifdef ADC_RECORDER_EN
+
+/**************************************************************************//**
+* @brief Copies data to the staging buffers. A staging buffer which becomes
+*        full is left for REC_Process and the copy goes on in the other one.
+*        The caller checks that there is room for the data.
+*
+* @param rec - The recorder.
+* @param data - The data.
+* @param size - Number of bytes.
+*
+* @return None.
+******************************************************************************/
+static void REC_Stage(stRecorder* rec, const uint8_t* data, uint32_t size)
+{
+	uint32_t n;
+
+	while(size)
+	{
+		n = rec->cfg.chunkSize - rec->level;
+		if(n > size)
+		{
+			n = size;
+		}
+		memcpy(rec->cfg.buffer[rec->fill] + rec->level, data, n);
+		rec->level += n;
+		data += n;
+		size -= n;
+		if(rec->level == rec->cfg.chunkSize)
+		{
+			rec->pending = 1;
+			rec->fill ^= 1;
+			rec->level = 0;
+		}
+	}
+}
+
+/**************************************************************************//**
+* @brief Writes a staging buffer to the card. The file is preallocated, so
+*        the write only touches the data clusters, and a full chunk covers
+*        whole clusters, so it goes to the card as one multiple block write.
+*
+* @param rec - The recorder.
+* @param buf - The staging buffer.
+* @param size - Number of bytes.
+*
+* @return 0 in case of success, -1 if the write failed.
+******************************************************************************/
+static int32_t REC_WriteChunk(stRecorder* rec, const uint8_t* buf,
+							  uint32_t size)
+{
+	uint64_t start;
+	uint32_t us;
+	UINT written;
+	FRESULT res;
+
+	/* The SD controller reads the staging buffer by DMA */
+	Xil_DCacheFlushRange((uint32_t)buf, size);
+	start = TIMER_GetTimeUs();
+	res = f_write(&rec->file, buf, size, &written);
+	us = (uint32_t)(TIMER_GetTimeUs() - start);
+	if((res == FR_OK) && (written != size))
+	{
+		res = FR_DENIED;
+	}
+	if(res != FR_OK)
+	{
+		if(!rec->stats.error)
+		{
+			rec->stats.error = res;
+		}
+		return -1;
+	}
+	rec->stats.chunks++;
+	rec->stats.bytes += size;
+	rec->stats.totalWriteUs += us;
+	if(us > rec->stats.maxWriteUs)
+	{
+		rec->stats.maxWriteUs = us;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Mounts the card and creates the recording. The whole file is
+*        allocated up front, so no cluster is allocated while recording and
+*        the data starts on a cluster boundary. When the filesystem is built
+*        with _USE_FASTSEEK the cluster map of the file is kept, which also
+*        gives the number of fragments of the file; a card formatted just
+*        before the recording gives a single fragment.
+*
+* @param rec - The recorder.
+* @param cfg - File, sizes and staging buffers. The file size is rounded
+*              down to a multiple of the chunk size.
+*
+* @return 0 in case of success, -1 if the configuration is not supported or
+*         the card could not be prepared, the FatFs code is in stats.error.
+******************************************************************************/
+int32_t REC_Open(stRecorder* rec, stRecConfig* cfg)
+{
+	uint32_t fileSize;
+	FRESULT res;
+
+	memset(&rec->stats, 0, sizeof(rec->stats));
+	rec->open = 0;
+	if(!cfg->path || !cfg->chunkSize || !cfg->buffer[0] || !cfg->buffer[1] ||
+	   ((uint32_t)cfg->buffer[0] & (REC_ALIGN - 1)) ||
+	   ((uint32_t)cfg->buffer[1] & (REC_ALIGN - 1)) ||
+	   (cfg->fileSize < cfg->chunkSize))
+	{
+		return -1;
+	}
+	res = f_mount(&rec->fs, "", 1);
+	if(res != FR_OK)
+	{
+		rec->stats.error = res;
+		return -1;
+	}
+	if(cfg->chunkSize % (rec->fs.csize * REC_SECTOR_SIZE))
+	{
+		f_mount(0, "", 0);
+		return -1;
+	}
+	fileSize = cfg->fileSize - (cfg->fileSize % cfg->chunkSize);
+
+	res = f_open(&rec->file, cfg->path, FA_CREATE_ALWAYS | FA_WRITE);
+	if(res == FR_OK)
+	{
+		/* Seeking past the end allocates the clusters, a short file means
+		   that the card is full */
+		res = f_lseek(&rec->file, fileSize);
+		if((res == FR_OK) && (f_tell(&rec->file) != fileSize))
+		{
+			res = FR_DENIED;
+		}
+#if _USE_FASTSEEK
+		if(res == FR_OK)
+		{
+			rec->clmt[0] = REC_CLMT_SIZE;
+			rec->file.cltbl = rec->clmt;
+			if(f_lseek(&rec->file, CREATE_LINKMAP) != FR_OK)
+			{
+				/* More fragments than the map holds, clmt[0] is the size
+				   the map would need */
+				rec->file.cltbl = 0;
+			}
+			rec->stats.fragments = (rec->clmt[0] - 1) / 2;
+		}
+#endif
+		if(res == FR_OK)
+		{
+			res = f_lseek(&rec->file, 0);
+		}
+		if(res == FR_OK)
+		{
+			res = f_sync(&rec->file);
+		}
+		if(res != FR_OK)
+		{
+			f_close(&rec->file);
+		}
+	}
+	if(res != FR_OK)
+	{
+		rec->stats.error = res;
+		f_mount(0, "", 0);
+		return -1;
+	}
+
+	rec->cfg = *cfg;
+	rec->cfg.fileSize = fileSize;
+	rec->fill = 0;
+	rec->level = 0;
+	rec->pending = 0;
+	rec->queued = 0;
+	rec->seq = 0;
+	rec->full = 0;
+	rec->open = 1;
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Appends a capture buffer to the recording, after its header. The
+*        data is copied to the staging buffers, so the capture buffer can be
+*        reused as soon as the function returns. A record can span the two
+*        staging buffers; it is refused if the staging buffer being written
+*        would be needed.
+*
+* @param rec - The recorder.
+* @param address - Start address of the capture buffer.
+* @param bytes - Size of the capture buffer in bytes.
+* @param overflow - 1 if an overflow occurred during the capture.
+*
+* @return 0 in case of success, -1 if the staging buffers are full, -2 if the
+*         record does not fit in the file.
+******************************************************************************/
+int32_t REC_Write(stRecorder* rec, uint32_t address, uint32_t bytes,
+				  uint32_t overflow)
+{
+	stRecHeader header;
+	uint32_t total = sizeof(header) + bytes;
+	uint32_t room;
+
+	if(!rec->open)
+	{
+		return -1;
+	}
+	if(total > (rec->cfg.fileSize - rec->queued))
+	{
+		rec->full = 1;
+		rec->stats.refused++;
+		return -2;
+	}
+	room = rec->cfg.chunkSize - rec->level;
+	if(!rec->pending)
+	{
+		room += rec->cfg.chunkSize;
+	}
+	if(total > room)
+	{
+		rec->stats.refused++;
+		return -1;
+	}
+
+	header.magic = REC_MAGIC;
+	header.version = REC_VERSION;
+	header.size = sizeof(header);
+	header.seq = rec->seq;
+	header.bytes = bytes;
+	header.flags = overflow ? REC_FLAG_OVERFLOW : 0;
+	header.tag = rec->cfg.tag;
+	header.timestamp = TIMER_GetTimeUs();
+	REC_Stage(rec, (const uint8_t*)&header, sizeof(header));
+	REC_Stage(rec, (const uint8_t*)address, bytes);
+	rec->seq++;
+	rec->queued += total;
+	rec->stats.records++;
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Writes the full staging buffer, if any, to the card. Must be called
+*        often enough to keep a staging buffer free.
+*
+* @param rec - The recorder.
+*
+* @return 1 if a chunk was written, 0 if no staging buffer is full, -1 if a
+*         write failed or the recording is full.
+******************************************************************************/
+int32_t REC_Process(stRecorder* rec)
+{
+	if(!rec->open)
+	{
+		return -1;
+	}
+	if(rec->pending)
+	{
+		if(REC_WriteChunk(rec, rec->cfg.buffer[rec->fill ^ 1],
+						  rec->cfg.chunkSize) < 0)
+		{
+			return -1;
+		}
+		rec->pending = 0;
+		return 1;
+	}
+
+	return (rec->stats.error || rec->full) ? -1 : 0;
+}
+
+/**************************************************************************//**
+* @brief Writes the staged data, trims the recording to the data written and
+*        unmounts the card.
+*
+* @param rec - The recorder.
+* @param stats - The counters, can be NULL.
+*
+* @return 0 in case of success, -1 if a write failed.
+******************************************************************************/
+int32_t REC_Close(stRecorder* rec, stRecStats* stats)
+{
+	int32_t ret = 0;
+
+	if(!rec->open)
+	{
+		return -1;
+	}
+	if(rec->pending)
+	{
+		ret = REC_WriteChunk(rec, rec->cfg.buffer[rec->fill ^ 1],
+							 rec->cfg.chunkSize);
+		rec->pending = 0;
+	}
+	if((ret == 0) && rec->level)
+	{
+		ret = REC_WriteChunk(rec, rec->cfg.buffer[rec->fill], rec->level);
+		rec->level = 0;
+	}
+#if _USE_FASTSEEK
+	rec->file.cltbl = 0;
+#endif
+	if(f_truncate(&rec->file) != FR_OK)
+	{
+		ret = -1;
+	}
+	if(f_close(&rec->file) != FR_OK)
+	{
+		ret = -1;
+	}
+	f_mount(0, "", 0);
+	rec->open = 0;
+	if(stats)
+	{
+		*stats = rec->stats;
+	}
+
+	return ret;
+}
+
+#endif
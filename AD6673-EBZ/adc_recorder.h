@@ -0,0 +1,158 @@
+/**************************************************************************//**
+*   @file   adc_recorder.h
+*   @brief  Header file of the SD card recorder.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __ADC_RECORDER_H__
+#define __ADC_RECORDER_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+#ifdef ADC_RECORDER_EN
+#include "ff.h"
+#endif
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* The recorder is built only if ADC_RECORDER_EN is defined. It needs the
+   xilffs FAT filesystem library in the board support package, with write
+   access enabled. */
+
+/* Sector size of the SD cards */
+#define REC_SECTOR_SIZE			512
+
+/* Alignment of the staging buffers, one cache line */
+#define REC_ALIGN				32
+
+/* Entries of the cluster link map used to check that the preallocated file
+   is contiguous, 2 per fragment plus 1. Used only with _USE_FASTSEEK. */
+#ifndef REC_CLMT_SIZE
+#define REC_CLMT_SIZE			33
+#endif
+
+/* Marker and version of the record headers */
+#define REC_MAGIC				0x52434441	/* "ADCR" */
+#define REC_VERSION				1
+
+/* Flags of the record headers */
+#define REC_FLAG_OVERFLOW		(1 << 0)	/* overflow during the capture */
+
+/*****************************************************************************/
+/************************ Types Declarations *********************************/
+/*****************************************************************************/
+/* Header written in front of each capture buffer of the recording. The
+   records follow each other with no padding, a reader finds the next header
+   bytes after the current one. */
+typedef struct _stRecHeader
+{
+	uint32_t	magic;		/*!< REC_MAGIC */
+	uint16_t	version;	/*!< REC_VERSION */
+	uint16_t	size;		/*!< Size of the header in bytes */
+	uint32_t	seq;		/*!< Number of the record since REC_Open */
+	uint32_t	bytes;		/*!< Bytes of capture data after the header */
+	uint32_t	flags;		/*!< REC_FLAG_x */
+	uint32_t	tag;		/*!< Application value from the configuration */
+	uint64_t	timestamp;	/*!< Time the buffer reached the recorder in us */
+}stRecHeader;
+
+typedef struct _stRecConfig
+{
+	const char*	path;		/*!< Name of the file, on the default drive */
+	uint32_t	fileSize;	/*!< Bytes preallocated for the recording */
+	uint32_t	chunkSize;	/*!< Bytes of each write, a multiple of the
+								 cluster size of the card */
+	uint8_t*	buffer[2];	/*!< Staging buffers of chunkSize bytes, aligned
+								 to REC_ALIGN */
+	uint32_t	tag;		/*!< Copied to the tag of the record headers */
+}stRecConfig;
+
+typedef struct _stRecStats
+{
+	uint32_t	records;	/*!< Capture buffers recorded */
+	uint32_t	refused;	/*!< Buffers refused, the staging buffers were full */
+	uint32_t	chunks;		/*!< Chunks written to the card */
+	uint32_t	bytes;		/*!< Bytes written to the file */
+	uint32_t	fragments;	/*!< Fragments of the preallocated file, 0 if not
+								 checked */
+	uint32_t	maxWriteUs;	/*!< Longest write of a chunk */
+	uint32_t	totalWriteUs;	/*!< Time spent writing the chunks */
+	uint32_t	error;		/*!< FatFs code of the first failure, 0 if none */
+}stRecStats;
+
+#ifdef ADC_RECORDER_EN
+typedef struct _stRecorder
+{
+	FATFS		fs;			/*!< Filesystem of the card */
+	FIL			file;		/*!< The recording */
+#if _USE_FASTSEEK
+	DWORD		clmt[REC_CLMT_SIZE];	/*!< Cluster link map of the file */
+#endif
+	stRecConfig	cfg;		/*!< The configuration */
+	uint32_t	open;		/*!< Set to 1 between REC_Open and REC_Close */
+	uint32_t	fill;		/*!< Staging buffer being filled */
+	uint32_t	level;		/*!< Bytes in the staging buffer being filled */
+	uint32_t	pending;	/*!< Set to 1 if the other staging buffer is full */
+	uint32_t	queued;		/*!< Bytes accepted, written or staged */
+	uint32_t	seq;		/*!< Number of the next record */
+	uint32_t	full;		/*!< Set to 1 once a record did not fit in the file */
+	stRecStats	stats;		/*!< The counters */
+}stRecorder;
+#endif
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+#ifdef ADC_RECORDER_EN
+/** Mounts the card and creates the preallocated recording */
+int32_t REC_Open(stRecorder* rec, stRecConfig* cfg);
+/** Appends a capture buffer and its header to the staging buffers */
+int32_t REC_Write(stRecorder* rec, uint32_t address, uint32_t bytes,
+				  uint32_t overflow);
+/** Writes the full staging buffer to the card */
+int32_t REC_Process(stRecorder* rec);
+/** Writes the staged data, trims the recording and unmounts the card */
+int32_t REC_Close(stRecorder* rec, stRecStats* stats);
+#endif
+
+#endif /* __ADC_RECORDER_H__ */
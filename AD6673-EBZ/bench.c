@@ -0,0 +1,327 @@
+/**************************************************************************//**
+*   @file   bench.c
+*   @brief  Bus and converter throughput benchmarks.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <string.h>
+#include "xil_io.h"
+#include "spi.h"
+#include "timer.h"
+#include "bus_profile.h"
+#include "AD6673.h"
+#include "cf_ad6673.h"
+#include "bench.h"
+
+#ifdef BENCH_EN
+
+extern void xil_printf(const char *ctrl1, ...);
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* SPI transfers: a read of the chip ID, the extra bytes clock out the
+   following registers, so nothing is written to the device. */
+#define BENCH_SPI_SS			1
+#define BENCH_SPI_ITER			256
+/* Streaming read instruction of the chip ID register */
+#define BENCH_SPI_CMD0			0xE0
+#define BENCH_SPI_CMD1			0x01
+
+/* DDR fill, in a region which is not used by the capture buffer */
+#define BENCH_FILL_ADDR			(DDR_BASEADDR + 0x1000000)
+#define BENCH_FILL_SIZE			0x100000
+
+/* ADC captures */
+#define BENCH_CAPTURE_ITER		4
+
+/* Bring-up sequences, each one is run from reset this many times */
+#define BENCH_BRINGUP_ITER		5
+
+/*****************************************************************************/
+/*************************** Types Declarations ******************************/
+/*****************************************************************************/
+/* Bring-up sequence, returns a negative value in case of error */
+typedef int32_t (*BENCH_BringUpFunc)(void);
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+static const uint8_t benchSpiSizes[] = {3, 4, 8, 12, 16};
+static const uint32_t benchCaptureSizes[] = {256, 1024, 4096, 16384};
+
+/**************************************************************************//**
+* @brief Prints one result as a comma separated record:
+*        BENCH,group,metric,parameter,value,unit
+*
+* @param group - Benchmark group.
+* @param metric - Measured quantity.
+* @param param - Parameter of the measure, a transfer size for example.
+* @param value - Measured value.
+* @param unit - Unit of the value.
+*
+* @return None.
+******************************************************************************/
+static void BENCH_Print(const char* group, const char* metric, uint32_t param,
+						uint32_t value, const char* unit)
+{
+	xil_printf("BENCH,%s,%s,%d,%d,%s\n\r", group, metric, param, value, unit);
+}
+
+/**************************************************************************//**
+* @brief Computes a rate in bytes per second.
+*
+* @param bytes - Number of bytes transferred.
+* @param us - Duration of the transfer in us.
+*
+* @return The rate or 0 if the duration is 0.
+******************************************************************************/
+static uint32_t BENCH_Rate(uint64_t bytes, uint64_t us)
+{
+	return us ? (uint32_t)(bytes * 1000000 / us) : 0;
+}
+
+/**************************************************************************//**
+* @brief Measures the SPI_TransferData duration by transfer size, with the
+*        Tx FIFO burst mode disabled and enabled.
+*
+* @return None.
+******************************************************************************/
+static void BENCH_Spi(void)
+{
+	SPI_Handle spi;
+	char txBuf[16] = {BENCH_SPI_CMD0, BENCH_SPI_CMD1};
+	char rxBuf[16];
+	uint64_t start;
+	uint64_t us;
+	uint32_t burst;
+	uint32_t size;
+	uint32_t i;
+	uint32_t j;
+
+	spi = SPI_Init(SPI_BASEADDR, 0, 0, 0);
+	if(spi == NULL)
+	{
+		return;
+	}
+	for(burst = 0; burst < 2; burst++)
+	{
+		SPI_SetBurstMode(spi, burst);
+		for(i = 0; i < sizeof(benchSpiSizes); i++)
+		{
+			size = benchSpiSizes[i];
+			start = TIMER_GetTimeUs();
+			for(j = 0; j < BENCH_SPI_ITER; j++)
+			{
+				SPI_TransferData(spi, size, txBuf, size, rxBuf, BENCH_SPI_SS);
+			}
+			us = TIMER_GetTimeUs() - start;
+			BENCH_Print("spi", burst ? "burst_time" : "byte_time", size,
+						(uint32_t)(us * 1000 / BENCH_SPI_ITER), "ns");
+			BENCH_Print("spi", burst ? "burst_rate" : "byte_rate", size,
+						BENCH_Rate((uint64_t)size * BENCH_SPI_ITER, us), "B/s");
+		}
+	}
+	SPI_SetBurstMode(spi, 1);
+}
+
+/**************************************************************************//**
+* @brief Measures the adc_capture latency by capture size.
+*
+* @return None.
+******************************************************************************/
+static void BENCH_Capture(void)
+{
+	uint64_t start;
+	uint64_t us;
+	uint32_t i;
+	uint32_t j;
+
+	for(i = 0; i < sizeof(benchCaptureSizes) / sizeof(benchCaptureSizes[0]); i++)
+	{
+		start = TIMER_GetTimeUs();
+		for(j = 0; j < BENCH_CAPTURE_ITER; j++)
+		{
+			adc_capture(benchCaptureSizes[i], DDR_BASEADDR);
+		}
+		us = TIMER_GetTimeUs() - start;
+		BENCH_Print("adc", "capture_time", benchCaptureSizes[i],
+					(uint32_t)(us / BENCH_CAPTURE_ITER), "us");
+	}
+}
+
+/**************************************************************************//**
+* @brief Measures the DDR fill rate with a Xil_Out32 loop and with memset.
+*
+* @return None.
+******************************************************************************/
+static void BENCH_Fill(void)
+{
+	uint64_t start;
+	uint64_t us;
+	uint32_t addr;
+
+	start = TIMER_GetTimeUs();
+	for(addr = 0; addr < BENCH_FILL_SIZE; addr += 4)
+	{
+		Xil_Out32(BENCH_FILL_ADDR + addr, addr);
+	}
+	us = TIMER_GetTimeUs() - start;
+	BENCH_Print("ddr", "out32_rate", BENCH_FILL_SIZE,
+				BENCH_Rate(BENCH_FILL_SIZE, us), "B/s");
+
+	start = TIMER_GetTimeUs();
+	memset((void*)BENCH_FILL_ADDR, 0, BENCH_FILL_SIZE);
+	us = TIMER_GetTimeUs() - start;
+	BENCH_Print("ddr", "memset_rate", BENCH_FILL_SIZE,
+				BENCH_Rate(BENCH_FILL_SIZE, us), "B/s");
+}
+
+/**************************************************************************//**
+* @brief Sorts values in ascending order.
+*
+* @param data - Values to sort.
+* @param size - Number of values.
+*
+* @return None.
+******************************************************************************/
+static void BENCH_Sort(uint32_t* data, uint32_t size)
+{
+	uint32_t value;
+	uint32_t i;
+	uint32_t j;
+
+	for(i = 1; i < size; i++)
+	{
+		value = data[i];
+		for(j = i; (j > 0) && (data[j - 1] > value); j--)
+		{
+			data[j] = data[j - 1];
+		}
+		data[j] = value;
+	}
+}
+
+/**************************************************************************//**
+* @brief Runs a bring-up sequence BENCH_BRINGUP_ITER times and prints the
+*        min, median and max time to ready and bus transactions. The bus
+*        transactions are counted by the bus profiler, so they are 0 without
+*        BUS_PROFILE_EN, and the profiler adds its own time to the measures.
+*
+* @param name - Name of the sequence.
+* @param func - Bring-up sequence.
+*
+* @return None.
+******************************************************************************/
+static void BENCH_BringUp(const char* name, BENCH_BringUpFunc func)
+{
+	uint32_t timeUs[BENCH_BRINGUP_ITER];
+	uint32_t trans[BENCH_BRINGUP_ITER];
+	uint32_t fail = 0;
+	uint32_t startCnt;
+	uint64_t start;
+	uint32_t i;
+
+	for(i = 0; i < BENCH_BRINGUP_ITER; i++)
+	{
+		startCnt = PROFILE_GetTransCount();
+		start = TIMER_GetTimeUs();
+		if(func() < 0)
+		{
+			fail++;
+		}
+		timeUs[i] = (uint32_t)(TIMER_GetTimeUs() - start);
+		trans[i] = PROFILE_GetTransCount() - startCnt;
+	}
+	BENCH_Sort(timeUs, BENCH_BRINGUP_ITER);
+	BENCH_Sort(trans, BENCH_BRINGUP_ITER);
+	BENCH_Print(name, "ready_min", BENCH_BRINGUP_ITER, timeUs[0], "us");
+	BENCH_Print(name, "ready_median", BENCH_BRINGUP_ITER,
+				timeUs[BENCH_BRINGUP_ITER / 2], "us");
+	BENCH_Print(name, "ready_max", BENCH_BRINGUP_ITER,
+				timeUs[BENCH_BRINGUP_ITER - 1], "us");
+	BENCH_Print(name, "trans_min", BENCH_BRINGUP_ITER, trans[0], "count");
+	BENCH_Print(name, "trans_median", BENCH_BRINGUP_ITER,
+				trans[BENCH_BRINGUP_ITER / 2], "count");
+	BENCH_Print(name, "trans_max", BENCH_BRINGUP_ITER,
+				trans[BENCH_BRINGUP_ITER - 1], "count");
+	BENCH_Print(name, "failures", BENCH_BRINGUP_ITER, fail, "count");
+}
+
+/**************************************************************************//**
+* @brief Bring-up sequences of the AD6673 and of its JESD204B link.
+******************************************************************************/
+static int32_t BENCH_Ad6673Setup(void)
+{
+	return ad6673_setup(SPI_BASEADDR, 1);
+}
+
+static int32_t BENCH_JesdLink(void)
+{
+	jesd_link_state link;
+
+	return jesd_link_bringup(JESD_BASEADDR, &link);
+}
+
+/**************************************************************************//**
+* @brief Runs the benchmarks and prints the results over UART, one record per
+*        line between a header and an end record. All the values are 0 when
+*        no hardware timer is available. The AD6673 is set up again by the
+*        bring-up measures, which end with the JESD204B link up.
+*
+* @return None.
+******************************************************************************/
+void BENCH_Run(void)
+{
+	xil_printf("BENCH,group,metric,param,value,unit\n\r");
+	BENCH_Print("info", "timer", 0, TIMER_GetTimeUs() ? 1 : 0, "bool");
+	BENCH_Spi();
+	BENCH_Capture();
+	BENCH_Fill();
+	BENCH_BringUp("ad6673_setup", BENCH_Ad6673Setup);
+	BENCH_BringUp("ad6673_jesd204b_setup", ad6673_jesd204b_setup);
+	BENCH_BringUp("jesd_link_bringup", BENCH_JesdLink);
+	xil_printf("BENCH,end\n\r");
+}
+
+#endif /* BENCH_EN */
@@ -0,0 +1,116 @@
+/**************************************************************************//**
+*   @file   bus_profile.h
+*   @brief  Bus transaction profiler header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __BUS_PROFILE_H__
+#define __BUS_PROFILE_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Bus types */
+#define PROFILE_BUS_SPI		0
+#define PROFILE_BUS_I2C		1
+
+/* Number of devices and calling functions that are tracked */
+#define PROFILE_MAX_DEVICES		16
+#define PROFILE_MAX_CONTEXTS	16
+
+/* Number of boot phases that are tracked */
+#define PROFILE_MAX_PHASES		24
+
+/*****************************************************************************/
+/************************ Macros Definitions *********************************/
+/*****************************************************************************/
+/* The profiler is built only if BUS_PROFILE_EN is defined, otherwise all the
+   hooks compile to nothing. */
+#ifdef BUS_PROFILE_EN
+#include "timer.h"
+/** Attributes the following bus transactions to the calling function */
+#define PROFILE_CONTEXT()				PROFILE_SetContext(__func__)
+/** Marks the start of a bus transaction, must be placed with the declarations */
+#define PROFILE_START(t)				uint64_t t = TIMER_GetTimeUs()
+/** Records a bus transaction started with PROFILE_START */
+#define PROFILE_END(t, bus, dev, bytes)	PROFILE_Record((bus), (dev), (bytes), \
+												(uint32_t)(TIMER_GetTimeUs() - (t)))
+/** Closes the running boot phase, if any, and opens a new one */
+#define PROFILE_PHASE(name)				PROFILE_PhaseMark(name)
+/** Closes the running boot phase */
+#define PROFILE_PHASE_END()				PROFILE_PhaseMark(0)
+#else
+#define PROFILE_CONTEXT()
+#define PROFILE_START(t)
+#define PROFILE_END(t, bus, dev, bytes)
+#define PROFILE_Reset()
+#define PROFILE_GetTransCount()		0
+#define PROFILE_Dump()
+#define PROFILE_PHASE(name)
+#define PROFILE_PHASE_END()
+#define PROFILE_PhaseDump()
+#endif
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+#ifdef BUS_PROFILE_EN
+/** Sets the function to which the following bus transactions are attributed */
+void PROFILE_SetContext(const char* name);
+/** Records a bus transaction */
+void PROFILE_Record(uint32_t bus, uint32_t dev, uint32_t bytes, uint32_t timeUs);
+/** Returns the number of bus transactions recorded */
+uint32_t PROFILE_GetTransCount(void);
+/** Clears the profiling data */
+void PROFILE_Reset(void);
+/** Prints the profiling data over UART */
+void PROFILE_Dump(void);
+/** Closes the running boot phase and opens the named one */
+void PROFILE_PhaseMark(const char* name);
+/** Prints the boot phases over UART, longest first */
+void PROFILE_PhaseDump(void);
+#endif
+
+#endif /* __BUS_PROFILE_H__ */
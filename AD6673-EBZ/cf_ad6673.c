@@ -43,14 +43,154 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include "xil_io.h"
+#include "xil_cache.h"
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+#include "timer.h"
+#include "bus_profile.h"
 #include "cf_ad6673.h"
 #include "AD6673.h"
+#include "fastmem.h"
+
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+/* State of the capture done interrupt path */
+static FAST_DATA volatile struct
+{
+    uint32_t enabled;
+    uint32_t done;      // the last capture completed
+    uint32_t overflow;  // an overflow occurred during the last capture
+    uint32_t address;   // start address of the last capture
+    uint32_t size;      // number of samples of the last capture
+} adc_irq;
+static FAST_DATA adc_capture_callback adc_irq_callback;
+/* The capture buffers are reached through the ACP, no cache maintenance */
+static FAST_DATA uint32_t adc_coherent = ADC_CAPTURE_ACP;
+
+/* State of the fast detect interrupt path */
+static FAST_DATA volatile adc_fd_stats adc_fd;
+static FAST_DATA adc_fd_callback adc_fd_cb;
+
+/* State of the continuous capture. The filled and released counters have a
+   single writer each, so the completion can run from the interrupt. */
+static FAST_DATA volatile struct
+{
+    uint32_t address[ADC_STREAM_MAX_BUFFERS];
+    uint32_t overflow[ADC_STREAM_MAX_BUFFERS];
+    uint32_t size;
+    uint32_t nb_buffers;
+    uint32_t wr;        // buffer being captured
+    uint32_t rd;        // oldest filled buffer
+    uint32_t filled;    // buffers filled
+    uint32_t released;  // buffers released
+    uint32_t sent;      // buffers handed to the sink
+    uint32_t stalled;   // all the buffers are filled
+    uint32_t running;
+    uint32_t batch;     // buffers of the capture in progress
+    uint32_t coalesce;  // buffers allowed in the next capture
+    uint32_t max_buffers;
+    uint32_t max_us;
+    uint32_t buffer_us;
+    uint64_t start_us;  // start of the capture in progress
+    adc_stream_sink sink;
+    adc_stream_stats stats;
+} adc_stream = {.max_buffers = 1};
+
+#ifdef ADC_DDC_EN
+/* Downconverter stage between the continuous capture and the sink */
+static struct
+{
+    stDdc *ddc;
+    uint32_t channel;
+    uint32_t format;
+    uint32_t out_address[ADC_STREAM_MAX_BUFFERS];
+    uint32_t pending;        // the last buffer was processed, the sink refused it
+    uint32_t pending_bytes;  // size of the output of the last buffer
+    adc_stream_sink sink;
+} adc_ddc;
+static int16_t adc_ddc_ch[2][ADC_DDC_CHUNK * 2];
+#endif
+
+#ifdef ADC_CHAN_EN
+/* Channelizer stage between the continuous capture and the sink */
+static struct
+{
+    stChan *chan;
+    uint32_t channel;
+    uint32_t format;
+    uint32_t out_address[ADC_STREAM_MAX_BUFFERS];
+    uint32_t pending;        // the last buffer was processed, the sink refused it
+    uint32_t pending_bytes;  // size of the output of the last buffer
+    adc_stream_sink sink;
+} adc_fb;
+static int16_t adc_fb_ch[2][ADC_CHAN_CHUNK * 2];
+#endif
+
+#ifdef ADC_RECORDER_EN
+/* SD card recorder fed by the continuous capture */
+static stRecorder *adc_rec;
+#endif
+
+/* State of the trigger stage of the continuous capture. The buffers are
+   numbered in capture order, like the filled and released counters. */
+static volatile struct
+{
+    uint32_t running;
+    adc_trigger_config cfg;
+    adc_stream_sink sink;
+    uint32_t examined;                        // buffers checked for a trigger
+    uint32_t handed;                          // buffers passed by the hand over
+    uint32_t txd;                             // buffers passed by the tx done
+    uint32_t post_left;                       // buffers left in the window
+    uint32_t mark[ADC_STREAM_MAX_BUFFERS];    // the buffer belongs to a window
+    uint32_t done[ADC_STREAM_MAX_BUFFERS];    // the sink transmitted the buffer
+    uint32_t forced;                          // adc_trigger_force() was called
+    uint32_t fd_pending;                      // a fast detect event is pending
+    uint32_t fd_seq;                          // buffer captured at the event
+    adc_trigger_stats stats;
+} adc_trigger;
+
+/* State of the JESD204B link monitor */
+static struct
+{
+    uint32_t baseaddr;
+    uint32_t running;
+    uint64_t deadline;
+    uint32_t errcnt[JESD_LINK_LANES];   // error count at the last sample
+    uint32_t ilacnt[JESD_LINK_LANES];   // ILA count at the last sample
+    uint32_t error_run;                 // consecutive samples with new errors
+    uint32_t margin_period;             // error free samples between margin scans
+    uint32_t margin_min_mui;            // eye width under which the link is fixed
+    uint32_t margin_run;                // error free samples since the last scan
+    jesd_monitor_stats stats;
+} jesd_monitor;
+
+/* Frame format of the JESD cores, changed by jesd_link_switch() */
+static struct
+{
+    uint32_t frames;    // frames per multi-frame (K)
+    uint32_t octets;    // octets per frame (F)
+} jesd_format = {32, 2};
 
-void Xil_DCacheFlush(void);
+/* Expected data of a lane of the software verifier. */
+typedef struct
+{
+    uint32_t mode;
+    uint32_t seed;   // samples left to seed the expected data
+    uint32_t value;  // fixed pattern or last expected sample
+    uint32_t state;  // PN generator state, the last bits of the sequence
+} adc_verify_lane;
 
 /******************************************************************************/
 /************************ Private Functions Prototypes ************************/
 /******************************************************************************/
+static void adc_capture_sync_cache(uint32_t address, uint32_t size);
+static void adc_stream_arm(void);
+static int32_t adc_stream_complete(uint32_t status);
+static void adc_trigger_tx_done(void);
 void DisplayTestMode(uint32_t mode, uint32_t format);
 
 /******************************************************************************/
@@ -66,164 +206,2716 @@ void DisplayTestMode(uint32_t mode, uint32_t format);
 *******************************************************************************/
 void delay_ms(uint32_t ms_count)
 {
-    volatile uint32_t count;
-
-    for (count = 0; count < ((ms_count * CYCLES_FOR_1_MS) + 1); count++)
-    {
-        asm("nop");
-    }
+    TIMER_DelayMs(ms_count);
 }
 
 /***************************************************************************//**
- * @brief Initializes JESD FPGA core.
+ * @brief Initializes a JESD FPGA core.
+ *
+ * @param baseaddr - base address of the JESD core
  *
  * @return None.
 *******************************************************************************/
-void jesd_core_setup(void)
+void jesd_core_init(uint32_t baseaddr)
 {
-    Xil_Out32((JESD_BASEADDR + 0x14), 0x30);        // reset
-    delay_ms(100);
-    Xil_Out32((JESD_BASEADDR + JESD_REG_LANE_CTRL),
+    Xil_Out32((baseaddr + 0x14), 0x30);             // reset
+    TIMER_DelayUs(JESD_RESET_US);
+    Xil_Out32((baseaddr + JESD_REG_LANE_CTRL),
               JESD_LANE_CTRL_SYSREF_SEL(0) |        // hardware sysref generation
               JESD_LANE_CTRL_LANE_SYNC_EN(1) |      // enable lane synchronization
               JESD_LANE_CTRL_SCR_EN(1) |            // enable scrambling
               JESD_LANE_CTRL_SYSREF_EN(0) |         // disable re-alignment at every sysref pulses
               JESD_LANE_CTRL_ERR_DISB(0));          // enable error reporting via sync
-    Xil_Out32((JESD_BASEADDR + JESD_REG_FRAMES),
-              JESD_FRAMES_FRM_CNT(32) |             // 32 frames per multi-frame
-              JESD_FRAMES_BYTE_CNT(2));             // 2 bytes (octets) per frame
+    Xil_Out32((baseaddr + JESD_REG_FRAMES),
+              JESD_FRAMES_FRM_CNT(jesd_format.frames) |     // 32 frames per multi-frame by default
+              JESD_FRAMES_BYTE_CNT(jesd_format.octets));    // 2 bytes (octets) per frame by default
 }
 
 /***************************************************************************//**
- * @brief Captures a specified number of samples from the ADC.
- *
- * @param size - number of bytes to read from the device
- * @param address - capture start address
+ * @brief Initializes JESD FPGA core.
  *
  * @return None.
 *******************************************************************************/
-void adc_capture(uint32_t size, uint32_t address)
+void jesd_core_setup(void)
 {
-    Xil_Out32((DMA_BASEADDR + 0x030), 0);               // clear dma operations
-    Xil_Out32((DMA_BASEADDR + 0x030), 1);               // enable dma operations
-    Xil_Out32((DMA_BASEADDR + 0x048), address);         // capture start address
-    Xil_Out32((DMA_BASEADDR + 0x058), (size * 8));      // number of bytes
-    Xil_Out32((CF_BASEADDR + CF_REG_CAPTURE_CTRL),
-               CF_CAPTURE_CTRL_CAPTURE_START(0));       // capture disable
-    Xil_Out32((CF_BASEADDR + CF_REG_ADC_STATUS),
-               CF_ADC_STATUS_UNDERFLOW |
-               CF_ADC_STATUS_OVERFLOW |
-               CF_ADC_STATUS_BUSY);                     // clear status
-    Xil_Out32((CF_BASEADDR + CF_REG_DATA_MONITOR),
-               CF_DATA_MONITOR_PN_ERR |
-               CF_DATA_MONITOR_PN_OUT_OF_SYNC |
-               CF_DATA_MONITOR_OVER_RNG);               // clear status
-    Xil_Out32((CF_BASEADDR + CF_REG_CAPTURE_CTRL),
-               CF_CAPTURE_CTRL_CAPTURE_START(1) |
-               CF_CAPTURE_CTRL_CAPTURE_COUNT(size));    // capture enable
+    PROFILE_PHASE("JESD core");
+    jesd_core_init(JESD_BASEADDR);
+    PROFILE_PHASE_END();
+}
+
+/***************************************************************************//**
+ * @brief Waits for the JESD204B link of a core to reach the data phase. The
+ *        ILA, buffer and error counts of each lane are polled until every
+ *        lane has seen the initial lane alignment, released its elastic
+ *        buffer and kept its error count for JESD_LINK_STABLE_POLLS polls.
+ *        Called once the converter is set up and transmits.
+ *
+ * @param baseaddr - base address of the JESD core
+ * @param state - stores the link state reached and the last lane counts
+ *
+ * @return Returns 0 if the link is in the data phase or -1 in case of
+ *         timeout.
+*******************************************************************************/
+int32_t jesd_link_bringup(uint32_t baseaddr, jesd_link_state *state)
+{
+    jesd_link_phase phase;
+    uint64_t start;
+    uint64_t deadline;
+    uint32_t errcnt;
+    uint32_t stable = 0;
+    uint32_t lane;
+
+    start = TIMER_GetTimeUs();
+    deadline = start + JESD_LINK_TIMEOUT_US;
+    state->polls = 0;
+    for(lane = 0; lane < JESD_LINK_LANES; lane++)
+    {
+        state->errcnt[lane] = 0;
+    }
+    /* The poll count bounds the wait when no hardware timer is available. */
     do
     {
-        delay_ms(1);
+        phase = JESD_LINK_DATA;
+        for(lane = 0; lane < JESD_LINK_LANES; lane++)
+        {
+            Xil_Out32((baseaddr + JESD_REG_TEST), JESD_TEST_LANE_SEL(lane));
+            state->bufcnt[lane] = Xil_In32(baseaddr + JESD_REG_BUFCNT);
+            state->ilacnt[lane] = Xil_In32(baseaddr + JESD_REG_TEST_ILACNT);
+            errcnt = Xil_In32(baseaddr + JESD_REG_TEST_ERRCNT);
+            if(errcnt != state->errcnt[lane])
+            {
+                stable = 0;
+            }
+            state->errcnt[lane] = errcnt;
+            if(state->ilacnt[lane] == 0)
+            {
+                phase = JESD_LINK_CGS;
+            }
+            else if((state->bufcnt[lane] == 0) && (phase == JESD_LINK_DATA))
+            {
+                phase = JESD_LINK_ILAS;
+            }
+        }
+        state->polls++;
+        if(phase != JESD_LINK_DATA)
+        {
+            stable = 0;
+        }
+        else if(++stable >= JESD_LINK_STABLE_POLLS)
+        {
+            break;
+        }
+        TIMER_DelayUs(JESD_LINK_POLL_US);
+    }
+    while(!TIMER_DeadlineExpired(deadline) &&
+          (state->polls < (JESD_LINK_TIMEOUT_US / JESD_LINK_POLL_US)));
+    state->time_us = (uint32_t)(TIMER_GetTimeUs() - start);
+    if(phase == JESD_LINK_DATA)
+    {
+        /* A data phase with errors seen in the last polls is not reported. */
+        state->phase = (stable >= JESD_LINK_STABLE_POLLS) ? JESD_LINK_DATA :
+                                                            JESD_LINK_ILAS;
     }
-    while ((Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_BUSY));
-    if ((Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_OVERFLOW))
+    else
     {
-        xil_printf("overflow occurred, capture may be corrupted\n\r");
+        state->phase = phase;
     }
-#ifdef _XPARAMETERS_PS_H_
-    Xil_DCacheFlush();
+
+    return (state->phase == JESD_LINK_DATA) ? 0 : -1;
+}
+
+/***************************************************************************//**
+ * @brief Reads the current error and ILA counts of the monitored link as the
+ *        reference of the next sample.
+ *
+ * @return None.
+*******************************************************************************/
+static void jesd_monitor_snapshot(void)
+{
+    uint32_t lane;
+
+    for(lane = 0; lane < JESD_LINK_LANES; lane++)
+    {
+        Xil_Out32((jesd_monitor.baseaddr + JESD_REG_TEST), JESD_TEST_LANE_SEL(lane));
+        jesd_monitor.errcnt[lane] = Xil_In32(jesd_monitor.baseaddr + JESD_REG_TEST_ERRCNT);
+        jesd_monitor.ilacnt[lane] = Xil_In32(jesd_monitor.baseaddr + JESD_REG_TEST_ILACNT);
+    }
+    jesd_monitor.error_run = 0;
+}
+
+/***************************************************************************//**
+ * @brief Resynchronizes the monitored link: the core is reset and
+ *        reprogrammed, the converter lanes are power cycled and the link
+ *        bring-up is run again. The converter keeps its configuration.
+ *
+ * @return Returns 1 if the link is in the data phase again, -1 in case of
+ *         timeout.
+*******************************************************************************/
+static int32_t jesd_monitor_relink(void)
+{
+    jesd_link_state link;
+    uint32_t baseaddr = jesd_monitor.baseaddr;
+    int32_t ret;
+
+    /* Reported as is when the converter setup fails before the bring-up */
+    link.phase = JESD_LINK_CGS;
+    jesd_core_init(baseaddr);
+    ret = ad6673_jesd204b_setup();
+    if(ret >= 0)
+    {
+        ret = ad6673_transfer();
+    }
+    if(ret >= 0)
+    {
+        ret = jesd_link_bringup(baseaddr, &link);
+    }
+    jesd_monitor.stats.relinks++;
+    jesd_monitor.stats.phase = (ret < 0) ? link.phase : JESD_LINK_DATA;
+    if(ret < 0)
+    {
+        jesd_monitor.stats.relink_failures++;
+    }
+    jesd_monitor_snapshot();
+    jesd_monitor.deadline = TIMER_SetDeadline(JESD_MONITOR_PERIOD_US);
+
+    return (ret < 0) ? -1 : 1;
+}
+
+#ifdef JESD_MARGIN_EN
+/***************************************************************************//**
+ * @brief Sets the eye margin check of the link monitor. Every period error free
+ *        samples, the eye of each lane is scanned; when a lane is narrower
+ *        than min_mui the CML drive level of the converter is raised, or the
+ *        link is resynchronized once the level is JESD_MONITOR_CML_MAX.
+ *        The link is thus fixed while it still runs without errors.
+ *
+ * @param period - error free samples between two scans, 0 disables the check
+ * @param min_mui - smallest eye width accepted, in UI/1000
+ *
+ * @return None.
+*******************************************************************************/
+void jesd_monitor_set_margin(uint32_t period, uint32_t min_mui)
+{
+    jesd_monitor.margin_period = period;
+    jesd_monitor.margin_min_mui = min_mui;
+    jesd_monitor.margin_run = 0;
+}
+
+/***************************************************************************//**
+ * @brief Runs the eye margin check of the link monitor when it is due.
+ *
+ * @return Returns 2 if the CML drive level was raised, 1 if the link was
+ *         resynchronized, -1 if the resync timed out, 0 otherwise.
+*******************************************************************************/
+static int32_t jesd_monitor_margin(void)
+{
+    stMarginResult margin[JESD_LINK_LANES];
+    uint32_t low = 0;
+    uint32_t lane;
+    int32_t level;
+
+    if((jesd_monitor.margin_period == 0) ||
+       (++jesd_monitor.margin_run < jesd_monitor.margin_period))
+    {
+        return 0;
+    }
+    jesd_monitor.margin_run = 0;
+    if(MARGIN_Scan(JESD_LINK_LANES, NULL, margin) < 0)
+    {
+        jesd_monitor.deadline = TIMER_SetDeadline(JESD_MONITOR_PERIOD_US);
+        return 0;
+    }
+    jesd_monitor.stats.margin_scans++;
+    for(lane = 0; lane < JESD_LINK_LANES; lane++)
+    {
+        jesd_monitor.stats.margin_mui[lane] = margin[lane].widthMui;
+        low |= (margin[lane].widthMui < jesd_monitor.margin_min_mui);
+    }
+    /* The scan took several sample periods. */
+    jesd_monitor_snapshot();
+    jesd_monitor.deadline = TIMER_SetDeadline(JESD_MONITOR_PERIOD_US);
+    if(!low)
+    {
+        return 0;
+    }
+    jesd_monitor.stats.margin_low++;
+    level = ad6673_jesd204b_cml_level(-1);
+    if((level >= 0) && (level < JESD_MONITOR_CML_MAX))
+    {
+        /* The levels above nominal are 3 and 6. */
+        level = (level < 3) ? (level + 1) : 6;
+        if(ad6673_jesd204b_cml_level(level) >= 0)
+        {
+            jesd_monitor.stats.cml_raises++;
+            return 2;
+        }
+    }
+
+    return jesd_monitor_relink();
+}
+#endif
+
+/***************************************************************************//**
+ * @brief Starts the monitor of a JESD204B link and clears its statistics. The
+ *        link is expected to be up, see jesd_link_bringup().
+ *
+ * @param baseaddr - base address of the JESD core
+ *
+ * @return None.
+*******************************************************************************/
+void jesd_monitor_start(uint32_t baseaddr)
+{
+    uint32_t i;
+
+    jesd_monitor.baseaddr = baseaddr;
+    jesd_monitor.stats.samples = 0;
+    jesd_monitor.stats.error_samples = 0;
+    jesd_monitor.stats.relinks = 0;
+    jesd_monitor.stats.relink_failures = 0;
+    jesd_monitor.stats.phase = JESD_LINK_DATA;
+    jesd_monitor.stats.margin_scans = 0;
+    jesd_monitor.stats.margin_low = 0;
+    jesd_monitor.stats.cml_raises = 0;
+    jesd_monitor.margin_run = 0;
+    for(i = 0; i < JESD_LINK_LANES; i++)
+    {
+        jesd_monitor.stats.errors[i] = 0;
+        jesd_monitor.stats.ilas[i] = 0;
+        jesd_monitor.stats.mfcnt[i] = 0;
+        jesd_monitor.stats.bufcnt[i] = 0;
+        jesd_monitor.stats.margin_mui[i] = 0;
+    }
+    jesd_monitor_snapshot();
+    jesd_monitor.deadline = TIMER_SetDeadline(JESD_MONITOR_PERIOD_US);
+    jesd_monitor.running = 1;
+}
+
+/***************************************************************************//**
+ * @brief Samples the status of the monitored link once every
+ *        JESD_MONITOR_PERIOD_US. Called from the main loop or from a timer
+ *        interrupt. The error count and the ILA count of each lane are
+ *        accumulated; a new ILA sequence means the receiver deasserted SYNC
+ *        and the link went through CGS again. After JESD_MONITOR_ERR_SAMPLES
+ *        consecutive samples with new errors the link is resynchronized: the
+ *        core is reset and reprogrammed, the converter lanes are power cycled
+ *        and the link bring-up is run again. With JESD_MARGIN_EN, the error
+ *        free samples also run the eye margin check, see
+ *        jesd_monitor_set_margin().
+ *
+ * @return Returns 2 if the CML drive level was raised, 1 if the link was
+ *         resynchronized, -1 if the resync timed out, 0 otherwise.
+*******************************************************************************/
+int32_t jesd_monitor_tick(void)
+{
+    uint32_t baseaddr = jesd_monitor.baseaddr;
+    uint32_t errcnt;
+    uint32_t ilacnt;
+    uint32_t errors = 0;
+    uint32_t lane;
+
+    if(!jesd_monitor.running || !TIMER_DeadlineExpired(jesd_monitor.deadline))
+    {
+        return 0;
+    }
+    jesd_monitor.deadline = TIMER_SetDeadline(JESD_MONITOR_PERIOD_US);
+    for(lane = 0; lane < JESD_LINK_LANES; lane++)
+    {
+        Xil_Out32((baseaddr + JESD_REG_TEST), JESD_TEST_LANE_SEL(lane));
+        errcnt = Xil_In32(baseaddr + JESD_REG_TEST_ERRCNT);
+        ilacnt = Xil_In32(baseaddr + JESD_REG_TEST_ILACNT);
+        jesd_monitor.stats.mfcnt[lane] = Xil_In32(baseaddr + JESD_REG_TEST_MFCNT);
+        jesd_monitor.stats.bufcnt[lane] = Xil_In32(baseaddr + JESD_REG_BUFCNT);
+        jesd_monitor.stats.errors[lane] += errcnt - jesd_monitor.errcnt[lane];
+        jesd_monitor.stats.ilas[lane] += ilacnt - jesd_monitor.ilacnt[lane];
+        errors |= errcnt - jesd_monitor.errcnt[lane];
+        jesd_monitor.errcnt[lane] = errcnt;
+        jesd_monitor.ilacnt[lane] = ilacnt;
+    }
+    jesd_monitor.stats.samples++;
+    if(errors == 0)
+    {
+        jesd_monitor.error_run = 0;
+#ifdef JESD_MARGIN_EN
+        return jesd_monitor_margin();
 #else
-    microblaze_flush_dcache();
-    microblaze_invalidate_dcache();
+        return 0;
 #endif
+    }
+    jesd_monitor.stats.error_samples++;
+    if(++jesd_monitor.error_run < JESD_MONITOR_ERR_SAMPLES)
+    {
+        return 0;
+    }
+
+    return jesd_monitor_relink();
 }
 
 /***************************************************************************//**
- * @brief Configures the AD6673 device to run in the selected test mode
- *           and checks if the read data pattern corresponds to the expected
- *           values for the set test mode.
+ * @brief Gets the statistics of the link monitor.
  *
- * @param mode - The test mode. Range 0 ..7
- *                        0 - test mode off
- *                        1 - midscale short
- *                        2 - +FS short
- *                        3 - -FS short
- *                        4 - checkerboard output
- *                        5 - PN 23 sequence
- *                        6 - PN 9 sequence
- *                        7 - one/zero word toggle
- * @param format - Sets the data format:
- *                 0 - offset binary
- *                 1 - twos complement
+ * @param stats - stores the statistics
+ *
+ * @return None.
+*******************************************************************************/
+void jesd_monitor_get_stats(jesd_monitor_stats *stats)
+{
+    *stats = jesd_monitor.stats;
+}
+
+/***************************************************************************//**
+ * @brief Switches a JESD204B link to another quick configuration option of
+ *        the converter. The core is reset with the frame format of the new
+ *        option, the converter writes only its link registers and the link
+ *        bring-up then waits on the lane status. Options whose lane count
+ *        differs from the lanes of the core are refused.
+ *
+ * @param baseaddr - base address of the JESD core
+ * @param quickCfgOption - quick configuration option of the converter
+ * @param state - stores the link state reached and the last lane counts
+ *
+ * @return Returns 0 if the link is in the data phase, -1 if the option is
+ *         not supported or in case of timeout.
+*******************************************************************************/
+int32_t jesd_link_switch(uint32_t baseaddr, int32_t quickCfgOption,
+                         jesd_link_state *state)
+{
+    const struct ad6673_jesd204b_link *link;
+    int32_t ret;
+
+    link = ad6673_jesd204b_get_link(quickCfgOption);
+    if((link == NULL) || (link->l != JESD_LINK_LANES))
+    {
+        return -1;
+    }
+    jesd_format.frames = link->k;
+    jesd_format.octets = link->f;
+    /* The reset also clears the lane counts the bring-up polls. */
+    jesd_core_init(baseaddr);
+    ret = ad6673_jesd204b_switch(quickCfgOption);
+    /* A link ready timeout is left to the bring-up, which reports the phase
+       the link reached. */
+    if(ret < -1)
+    {
+        return -1;
+    }
+    ret = jesd_link_bringup(baseaddr, state);
+    if(jesd_monitor.running && (jesd_monitor.baseaddr == baseaddr))
+    {
+        jesd_monitor_snapshot();
+    }
+
+    return ret;
+}
+
+/***************************************************************************//**
+ * @brief Selects the SYSREF source and mode of a JESD core.
+ *
+ * @param baseaddr - base address of the JESD core
+ * @param source - JESD_SYSREF_HW (SYSREF pin) or JESD_SYSREF_SW
+ *                 (jesd_sysref_trigger())
+ * @param continuous - 1 realigns the LMFC on every SYSREF, 0 only on the first
+ *                     one after the link setup (one-shot)
+ *
+ * @return None.
+*******************************************************************************/
+void jesd_sysref_setup(uint32_t baseaddr, uint32_t source, uint32_t continuous)
+{
+    uint32_t ctrl;
+
+    ctrl = Xil_In32(baseaddr + JESD_REG_LANE_CTRL);
+    ctrl &= ~(JESD_LANE_CTRL_SYSREF_SEL(1) | JESD_LANE_CTRL_SYSREF_EN(1));
+    Xil_Out32((baseaddr + JESD_REG_LANE_CTRL),
+              ctrl |
+              JESD_LANE_CTRL_SYSREF_SEL(source) |
+              JESD_LANE_CTRL_SYSREF_EN(continuous));
+}
+
+/***************************************************************************//**
+ * @brief Issues a software SYSREF (0 to 1 transition) to a JESD core.
+ *
+ * @param baseaddr - base address of the JESD core
  *
  * @return None.
 *******************************************************************************/
-void adc_test(uint32_t mode, uint32_t format)
+void jesd_sysref_trigger(uint32_t baseaddr)
+{
+    Xil_Out32((baseaddr + JESD_REG_SYSREF), JESD_SYSREF_INT(0));
+    Xil_Out32((baseaddr + JESD_REG_SYSREF), JESD_SYSREF_INT(1));
+}
+
+/***************************************************************************//**
+ * @brief Issues a SYSREF to every link, waits for the elastic buffers to be
+ *        released and reads back their depth. The software SYSREFs are
+ *        written back to back; a hardware SYSREF comes from the clock chip.
+ *
+ * @param link - links to measure
+ * @param nb_links - number of links
+ * @param source - JESD_SYSREF_HW or JESD_SYSREF_SW
+ *
+ * @return None.
+*******************************************************************************/
+static void jesd_sysref_measure(jesd_sysref_link *link, uint32_t nb_links,
+                                uint32_t source)
 {
     uint32_t i;
-    uint32_t n;
-    uint32_t rdata_2;
-    uint32_t rdata[2];
-    uint32_t edata[2];
+    uint32_t lane;
 
-    edata[0] = 0;
-    edata[1] = 0;
-    ad6673_output_format(format);
-    ad6673_test_mode(mode);
-    ad6673_transfer();
-    adc_capture(16, DDR_BASEADDR);
-    DisplayTestMode(mode, format);
-    for (n = 0; n < 32; n++)
+    if(source == JESD_SYSREF_SW)
     {
-        rdata_2 = Xil_In32(DDR_BASEADDR + (n * 4));
-        rdata[0] = (rdata_2 >> 3) & 0xffff;
-        rdata[1] = (rdata_2 >> 19) & 0xffff;
-        for (i = 0; i < 2; i++)
+        for(i = 0; i < nb_links; i++)
         {
-            if ((mode == MIDSCALE) && (format == OFFSET_BINARY))
-            {
-                edata[i] = 0x0400;
-            }
-            if ((mode == POS_FULLSCALE) && (format == OFFSET_BINARY))
-            {
-                edata[i] = 0x07ff;
-            }
-            if ((mode == NEG_FULLSCALE) && (format == OFFSET_BINARY))
-            {
-                edata[i] = 0x0000;
-            }
-            if ((mode == MIDSCALE) && (format == TWOS_COMPLEMENT))
-            {
-                edata[i] = 0x0000;
-            }
-            if ((mode == POS_FULLSCALE) && (format == TWOS_COMPLEMENT))
-            {
-                edata[i] = 0x03ff;
-            }
-            if ((mode == NEG_FULLSCALE) && (format == TWOS_COMPLEMENT))
-            {
-                edata[i] = 0x0400;
-            }
-            if (((mode == CHECKERBOARD) || (mode == ONE_ZERO_TOGGLE)) && (n == 0))
-            {
-                edata[i] = (rdata[i] & 0xffff);
-            }
-            if ((mode == CHECKERBOARD) && (n > 0))
-            {
-                edata[i] = (edata[i] == 0x02aa) ? 0x0555 : 0x02aa;
-            }
-            if ((mode == ONE_ZERO_TOGGLE) && (n > 0))
-            {
-                edata[i] = (edata[i] == 0x07ff) ? 0x0000 : 0x07ff;
-            }
-            if (rdata[i] != edata[i])
+            jesd_sysref_trigger(link[i].baseaddr);
+        }
+    }
+    TIMER_DelayUs(JESD_SYSREF_SETTLE_US);
+    for(i = 0; i < nb_links; i++)
+    {
+        link[i].depth = JESD_DELAY_MAX;
+        for(lane = 0; lane < JESD_LINK_LANES; lane++)
+        {
+            Xil_Out32((link[i].baseaddr + JESD_REG_TEST), JESD_TEST_LANE_SEL(lane));
+            link[i].bufcnt[lane] = Xil_In32(link[i].baseaddr + JESD_REG_BUFCNT);
+            if(link[i].bufcnt[lane] < link[i].depth)
             {
-                xil_printf("  ERROR[%2d]: ch(%d), rcv(%08x), exp(%08x)\n\r", n, i, rdata[i], edata[i]);
+                link[i].depth = link[i].bufcnt[lane];
             }
         }
     }
 }
 
+/***************************************************************************//**
+ * @brief Aligns several subclass 1 links to a common SYSREF derived LMFC. The
+ *        cores are set for one-shot SYSREF and their buffer depths are
+ *        measured on two successive SYSREFs; a link whose depth moves by more
+ *        than JESD_SYSREF_DEPTH_TOL is not locked to the LMFC. The arrival of
+ *        each link is its buffer delay less its depth; a common buffer delay
+ *        JESD_SYSREF_MARGIN after the latest arrival is then programmed in
+ *        every core, so all the links release their data on the same LMFC
+ *        edge and the channels are sample aligned on each boot. The
+ *        converters must have SYSREF enabled.
+ *
+ * @param link - links to align, baseaddr set by the caller
+ * @param nb_links - number of links
+ * @param source - JESD_SYSREF_HW or JESD_SYSREF_SW
+ *
+ * @return Returns 0 if the links are aligned with margin, -1 otherwise.
+*******************************************************************************/
+int32_t jesd_sysref_align(jesd_sysref_link *link, uint32_t nb_links,
+                          uint32_t source)
+{
+    int32_t  arrival;
+    int32_t  latest = 0;
+    int32_t  delay;
+    uint32_t depth;
+    uint32_t i;
+    int32_t  ret = 0;
+
+    for(i = 0; i < nb_links; i++)
+    {
+        jesd_sysref_setup(link[i].baseaddr, source, 0);
+        link[i].delay = Xil_In32(link[i].baseaddr + JESD_REG_DELAY) & JESD_DELAY_MAX;
+    }
+    jesd_sysref_measure(link, nb_links, source);
+    for(i = 0; i < nb_links; i++)
+    {
+        link[i].lmfc_ok = link[i].depth;
+    }
+    jesd_sysref_measure(link, nb_links, source);
+    for(i = 0; i < nb_links; i++)
+    {
+        depth = link[i].lmfc_ok;
+        link[i].lmfc_ok = ((depth > link[i].depth ? depth - link[i].depth :
+                            link[i].depth - depth) <= JESD_SYSREF_DEPTH_TOL);
+        arrival = (int32_t)link[i].delay - (int32_t)link[i].depth;
+        if((i == 0) || (arrival > latest))
+        {
+            latest = arrival;
+        }
+    }
+    /* Common buffer delay for all the links. */
+    delay = latest + JESD_SYSREF_MARGIN;
+    if(delay < 0)
+    {
+        delay = 0;
+    }
+    if(delay > JESD_DELAY_MAX)
+    {
+        delay = JESD_DELAY_MAX;
+    }
+    for(i = 0; i < nb_links; i++)
+    {
+        link[i].delay = delay;
+        Xil_Out32((link[i].baseaddr + JESD_REG_DELAY),
+                  JESD_DELAY_BUFF_DELAY(delay));
+    }
+    jesd_sysref_measure(link, nb_links, source);
+    for(i = 0; i < nb_links; i++)
+    {
+        if(!link[i].lmfc_ok ||
+           (link[i].depth + JESD_SYSREF_DEPTH_TOL < JESD_SYSREF_MARGIN))
+        {
+            ret = -1;
+        }
+    }
+
+    return ret;
+}
+
+/***************************************************************************//**
+ * @brief Clears the status of the core and starts the capture of a number of
+ *        samples into the DMA.
+ *
+ * @param size - number of samples to capture, up to ADC_CAPTURE_MAX_SAMPLES
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_capture_core_start(uint32_t size)
+{
+    Xil_Out32((CF_BASEADDR + CF_REG_CAPTURE_CTRL),
+               CF_CAPTURE_CTRL_CAPTURE_START(0));       // capture disable
+    Xil_Out32((CF_BASEADDR + CF_REG_ADC_STATUS),
+               CF_ADC_STATUS_UNDERFLOW |
+               CF_ADC_STATUS_OVERFLOW |
+               CF_ADC_STATUS_BUSY);                     // clear status
+    Xil_Out32((CF_BASEADDR + CF_REG_DATA_MONITOR),
+               CF_DATA_MONITOR_PN_ERR |
+               CF_DATA_MONITOR_PN_OUT_OF_SYNC |
+               CF_DATA_MONITOR_OVER_RNG);               // clear status
+    Xil_Out32((CF_BASEADDR + CF_REG_CAPTURE_CTRL),
+               CF_CAPTURE_CTRL_CAPTURE_START(1) |
+               CF_CAPTURE_CTRL_CAPTURE_COUNT(size));    // capture enable
+}
+
+/***************************************************************************//**
+ * @brief Sets up the DMA and starts the capture of a buffer.
+ *
+ * @param size - number of samples to capture
+ * @param address - capture start address
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_capture_arm(uint32_t size, uint32_t address)
+{
+    adc_irq.done = 0;
+    adc_irq.address = address;
+    adc_irq.size = size;
+    adc_capture_sync_cache(address, size);  // no dirty lines over the buffer
+    Xil_Out32((DMA_BASEADDR + 0x030), 0);               // clear dma operations
+    Xil_Out32((DMA_BASEADDR + 0x030), 1 |
+              (adc_irq.enabled ? DMA_S2MM_CR_IOC_IRQ_EN : 0)); // enable dma operations
+    Xil_Out32((DMA_BASEADDR + 0x048), address);         // capture start address
+    Xil_Out32((DMA_BASEADDR + 0x058), (size * 8));      // number of bytes
+    adc_capture_core_start(size);
+}
+
+/***************************************************************************//**
+ * @brief Invalidates the data cache over a capture buffer, so the processor
+ *        reads the data written by the DMA. Only the buffer is invalidated,
+ *        it must start and end on a cache line boundary (ADC_CACHE_LINE).
+ *        Nothing is done for the buffers written through the ACP.
+ *
+ * @param address - capture start address
+ * @param size - number of samples in the buffer
+ *
+ * @return None.
+*******************************************************************************/
+static FAST_CODE void adc_capture_sync_cache(uint32_t address, uint32_t size)
+{
+#ifdef _XPARAMETERS_PS_H_
+    if (adc_coherent)
+    {
+        return;
+    }
+    Xil_DCacheInvalidateRange(address, size * 8);
+#else
+    microblaze_invalidate_dcache_range(address, size * 8);
+#endif
+}
+
+/***************************************************************************//**
+ * @brief Starts the capture of a specified number of samples from the ADC
+ *        and returns without waiting for the capture to complete.
+ *
+ * @param size - number of samples to capture
+ * @param address - capture start address
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture_start(uint32_t size, uint32_t address)
+{
+    adc_capture_arm(size, address);
+}
+
+/***************************************************************************//**
+ * @brief Waits for the capture started by adc_capture_start() to complete.
+ *        With the capture done interrupt enabled the completion is signaled
+ *        by adc_capture_isr(), otherwise the busy bit of the core is polled
+ *        every ADC_CAPTURE_POLL_US microseconds.
+ *
+ * @return 1 if an overflow occurred during the capture, 0 otherwise.
+*******************************************************************************/
+uint32_t adc_capture_wait(void)
+{
+    if (adc_irq.enabled)
+    {
+        while (!adc_irq.done)
+        {
+            ;
+        }
+        return adc_irq.overflow;
+    }
+    while ((Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_BUSY))
+    {
+        TIMER_DelayUs(ADC_CAPTURE_POLL_US);
+    }
+    adc_irq.overflow = (Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) &
+                        CF_ADC_STATUS_OVERFLOW) ? 1 : 0;
+    adc_capture_sync_cache(adc_irq.address, adc_irq.size);
+
+    return adc_irq.overflow;
+}
+
+/***************************************************************************//**
+ * @brief Captures a specified number of samples from the ADC.
+ *
+ * @param size - number of samples to capture
+ * @param address - capture start address
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture(uint32_t size, uint32_t address)
+{
+    adc_capture_start(size, address);
+    if (adc_capture_wait())
+    {
+        xil_printf("overflow occurred, capture may be corrupted\n\r");
+    }
+}
+
+/***************************************************************************//**
+ * @brief Captures a number of samples spread over several DDR regions in one
+ *        go, using a chain of DMA descriptors. The regions are split in
+ *        descriptors of up to ADC_CAPTURE_MAX_SAMPLES samples, the capture
+ *        count of the core, and the core is started again as soon as each
+ *        descriptor is filled, without setting up the DMA again. Requires the
+ *        DMA to be built with scatter gather support.
+ *
+ * @param seg - the capture regions, aligned to ADC_CACHE_LINE
+ * @param nb_segments - number of capture regions
+ * @param desc_address - start address of the descriptors, aligned to
+ *                       DMA_DESC_SIZE, with room for ADC_SG_MAX_DESC
+ *                       descriptors
+ *
+ * @return 1 if an overflow occurred during the capture, 0 otherwise, -1 if the
+ *         regions are not aligned or need more than ADC_SG_MAX_DESC
+ *         descriptors, or if the DMA has no scatter gather support.
+*******************************************************************************/
+int32_t adc_capture_sg(adc_sg_segment *seg, uint32_t nb_segments, uint32_t desc_address)
+{
+    uint32_t desc_size[ADC_SG_MAX_DESC];
+    uint32_t nb_desc = 0;
+    uint32_t overflow = 0;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t ba = 0;
+    uint32_t i;
+
+    if ((desc_address & (DMA_DESC_SIZE - 1)) ||
+        !(Xil_In32(DMA_BASEADDR + DMA_REG_S2MM_SR) & DMA_S2MM_SR_SG_INCLD))
+    {
+        return -1;
+    }
+    for (i = 0; i < nb_segments; i++)
+    {
+        if (seg[i].address & (ADC_CACHE_LINE - 1))
+        {
+            return -1;
+        }
+        for (offset = 0; offset < seg[i].size; offset += size)
+        {
+            if (nb_desc == ADC_SG_MAX_DESC)
+            {
+                return -1;
+            }
+            size = seg[i].size - offset;
+            if (size > ADC_CAPTURE_MAX_SAMPLES)
+            {
+                size = ADC_CAPTURE_MAX_SAMPLES;
+            }
+            ba = desc_address + (nb_desc * DMA_DESC_SIZE);
+            Xil_Out32((ba + DMA_DESC_NEXT), (ba + DMA_DESC_SIZE));
+            Xil_Out32((ba + DMA_DESC_ADDR), (seg[i].address + (offset * 8)));
+            Xil_Out32((ba + DMA_DESC_CTRL), (size * 8));
+            Xil_Out32((ba + DMA_DESC_STATUS), 0);
+            desc_size[nb_desc++] = size;
+        }
+        adc_capture_sync_cache(seg[i].address, seg[i].size);
+    }
+    if (nb_desc == 0)
+    {
+        return -1;
+    }
+    Xil_Out32((ba + DMA_DESC_NEXT), desc_address);
+#ifdef _XPARAMETERS_PS_H_
+    Xil_DCacheFlushRange(desc_address, (nb_desc * DMA_DESC_SIZE));
+#else
+    microblaze_flush_dcache_range(desc_address, (nb_desc * DMA_DESC_SIZE));
+#endif
+
+    Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_CR), DMA_S2MM_CR_RESET);
+    while (Xil_In32(DMA_BASEADDR + DMA_REG_S2MM_CR) & DMA_S2MM_CR_RESET)
+    {
+        ;
+    }
+    Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_CURDESC), desc_address);
+    Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_CR), DMA_S2MM_CR_RUN);
+    Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_TAILDESC), ba);
+    for (i = 0; i < nb_desc; i++)
+    {
+        adc_capture_core_start(desc_size[i]);
+        while (Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_BUSY)
+        {
+            ;
+        }
+        if (Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_OVERFLOW)
+        {
+            overflow = 1;
+        }
+    }
+    /* The last descriptor completes once its data is in DDR. */
+    do
+    {
+#ifdef _XPARAMETERS_PS_H_
+        Xil_DCacheInvalidateRange(ba, DMA_DESC_SIZE);
+#else
+        microblaze_invalidate_dcache_range(ba, DMA_DESC_SIZE);
+#endif
+    }
+    while (!(Xil_In32(ba + DMA_DESC_STATUS) & DMA_DESC_STATUS_CMPLT));
+    for (i = 0; i < nb_segments; i++)
+    {
+        adc_capture_sync_cache(seg[i].address, seg[i].size);
+    }
+
+    return overflow;
+}
+
+/***************************************************************************//**
+ * @brief Starts a continuous capture into a ring of buffers. The buffers are
+ *        filled in order; the capture of the next buffer is started from the
+ *        completion path, so the application can process a filled buffer
+ *        while the following one is captured. When all the buffers are
+ *        filled the capture stalls until a buffer is released.
+ *
+ * @param size - number of samples to capture in each buffer
+ * @param address - start addresses of the buffers
+ * @param nb_buffers - number of buffers, 2 to ADC_STREAM_MAX_BUFFERS
+ *
+ * @return 0 in case of success, -1 if the number of buffers is not supported
+ *         or a buffer is not aligned to ADC_CACHE_LINE.
+*******************************************************************************/
+int32_t adc_stream_start(uint32_t size, uint32_t *address, uint32_t nb_buffers)
+{
+    uint32_t i;
+
+    if ((nb_buffers < 2) || (nb_buffers > ADC_STREAM_MAX_BUFFERS))
+    {
+        return -1;
+    }
+    for (i = 0; i < nb_buffers; i++)
+    {
+        if (address[i] & (ADC_CACHE_LINE - 1))
+        {
+            return -1;
+        }
+        adc_stream.address[i] = address[i];
+        adc_stream.overflow[i] = 0;
+    }
+    adc_stream.size = size;
+    adc_stream.nb_buffers = nb_buffers;
+    adc_stream.wr = 0;
+    adc_stream.rd = 0;
+    adc_stream.filled = 0;
+    adc_stream.released = 0;
+    adc_stream.sent = 0;
+    adc_stream.stalled = 0;
+    adc_stream.stats.captures = 0;
+    adc_stream.stats.overflows = 0;
+    adc_stream.stats.stalls = 0;
+    adc_stream.stats.sent = 0;
+    adc_stream.stats.completions = 0;
+    adc_stream.coalesce = 1;
+    adc_stream.buffer_us = 0;
+    adc_stream.running = 1;
+    adc_stream_arm();
+
+    return 0;
+}
+
+/***************************************************************************//**
+ * @brief Sets the completion coalescing of the continuous capture. Buffers
+ *        which follow each other in memory are captured in one go, so one
+ *        interrupt completes several buffers. The number of buffers per
+ *        capture adapts to the backlog of the consumer: it doubles when more
+ *        buffers wait than one capture brings and halves when the consumer
+ *        has caught up, so the latency stays low at light load and the
+ *        interrupt rate stays bounded at full rate. It is also limited by
+ *        the free buffers, by ADC_CAPTURE_MAX_SAMPLES and by max_us.
+ *
+ * @param max_buffers - buffers completed at once at most, 1 to complete each
+ *                      buffer on its own
+ * @param max_us - capture time after which the buffers are completed
+ *                 whatever their number, 0 for no limit
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_set_coalesce(uint32_t max_buffers, uint32_t max_us)
+{
+    adc_stream.max_buffers = max_buffers ? max_buffers : 1;
+    adc_stream.max_us = max_us;
+    if (adc_stream.coalesce > adc_stream.max_buffers)
+    {
+        adc_stream.coalesce = adc_stream.max_buffers;
+    }
+}
+
+/***************************************************************************//**
+ * @brief Starts the capture of the next buffers of the continuous capture.
+ *        The capture covers up to the number of buffers allowed by the
+ *        coalescing, as long as they are free, contiguous in memory and not
+ *        past the end of the ring.
+ *
+ * @return None.
+*******************************************************************************/
+static FAST_CODE void adc_stream_arm(void)
+{
+    uint32_t free = adc_stream.nb_buffers - (adc_stream.filled - adc_stream.released);
+    uint32_t max = adc_stream.coalesce;
+    uint32_t wr = adc_stream.wr;
+    uint32_t n = 1;
+
+    if (adc_stream.max_us && adc_stream.buffer_us &&
+        ((adc_stream.max_us / adc_stream.buffer_us) < max))
+    {
+        max = adc_stream.max_us / adc_stream.buffer_us;
+    }
+    while ((n < max) && (n < free) && ((wr + n) < adc_stream.nb_buffers) &&
+           (((n + 1) * adc_stream.size) <= ADC_CAPTURE_MAX_SAMPLES) &&
+           (adc_stream.address[wr + n] ==
+            (adc_stream.address[wr] + (n * adc_stream.size * 8))))
+    {
+        n++;
+    }
+    adc_stream.batch = n;
+    adc_stream.start_us = TIMER_GetTimeUs();
+    adc_capture_arm(n * adc_stream.size, adc_stream.address[wr]);
+}
+
+/***************************************************************************//**
+ * @brief Checks the continuous capture for completion when the capture done
+ *        interrupt is not used. Must be called often enough to keep the
+ *        capture running.
+ *
+ * @return Index of the first buffer which was filled, -1 if no capture
+ *         completed.
+*******************************************************************************/
+int32_t adc_stream_poll(void)
+{
+    uint32_t status;
+
+    if (!adc_stream.running || adc_stream.stalled || adc_irq.enabled)
+    {
+        return -1;
+    }
+    status = Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS);
+    if (status & CF_ADC_STATUS_BUSY)
+    {
+        return -1;
+    }
+
+    return adc_stream_complete(status);
+}
+
+/***************************************************************************//**
+ * @brief Completion path of the continuous capture. Records the overflow
+ *        status of the buffers which were filled, adapts the coalescing to
+ *        the backlog and starts the capture of the next ones. An overflow is
+ *        reported on all the buffers of the capture.
+ *
+ * @param status - the ADC status at the end of the capture
+ *
+ * @return Index of the first buffer which was filled.
+*******************************************************************************/
+static FAST_CODE int32_t adc_stream_complete(uint32_t status)
+{
+    uint32_t overflow = (status & CF_ADC_STATUS_OVERFLOW) ? 1 : 0;
+    uint32_t backlog;
+    uint32_t i;
+    int32_t done;
+
+    done = adc_stream.wr;
+    adc_stream.buffer_us = (uint32_t)(TIMER_GetTimeUs() - adc_stream.start_us) /
+                           adc_stream.batch;
+    adc_capture_sync_cache(adc_stream.address[done],
+                           adc_stream.batch * adc_stream.size);
+    for (i = 0; i < adc_stream.batch; i++)
+    {
+        adc_stream.overflow[adc_stream.wr] = overflow;
+        adc_stream.filled++;
+        adc_stream.wr = (adc_stream.wr + 1) % adc_stream.nb_buffers;
+    }
+    adc_stream.stats.captures += adc_stream.batch;
+    adc_stream.stats.overflows += overflow * adc_stream.batch;
+    adc_stream.stats.completions++;
+    backlog = adc_stream.filled - adc_stream.released;
+    if ((backlog > adc_stream.batch) && (adc_stream.coalesce < adc_stream.max_buffers))
+    {
+        adc_stream.coalesce *= 2;
+        if (adc_stream.coalesce > adc_stream.max_buffers)
+        {
+            adc_stream.coalesce = adc_stream.max_buffers;
+        }
+    }
+    else if ((backlog <= adc_stream.batch) && (adc_stream.coalesce > 1))
+    {
+        adc_stream.coalesce /= 2;
+    }
+    if (backlog < adc_stream.nb_buffers)
+    {
+        adc_stream_arm();
+    }
+    else
+    {
+        adc_stream.stalled = 1;
+        adc_stream.stats.stalls++;
+    }
+
+    return done;
+}
+
+/***************************************************************************//**
+ * @brief Gets the oldest filled buffer of the continuous capture.
+ *
+ * @param address - the start address of the buffer
+ * @param overflow - set to 1 if an overflow occurred while the buffer was
+ *                   captured, 0 otherwise
+ *
+ * @return Index of the buffer, -1 if no buffer is filled.
+*******************************************************************************/
+int32_t adc_stream_get(uint32_t *address, uint32_t *overflow)
+{
+    adc_stream_poll();
+    if (adc_stream.filled == adc_stream.released)
+    {
+        return -1;
+    }
+    *address = adc_stream.address[adc_stream.rd];
+    *overflow = adc_stream.overflow[adc_stream.rd];
+
+    return adc_stream.rd;
+}
+
+/***************************************************************************//**
+ * @brief Releases the oldest filled buffer of the continuous capture, so it
+ *        can be captured again.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_release(void)
+{
+    if (adc_stream.filled == adc_stream.released)
+    {
+        return;
+    }
+    adc_stream.rd = (adc_stream.rd + 1) % adc_stream.nb_buffers;
+    adc_stream.released++;
+    if (adc_stream.running && adc_stream.stalled)
+    {
+        adc_stream.stalled = 0;
+        adc_stream_arm();
+    }
+}
+
+/***************************************************************************//**
+ * @brief Sets the streaming sink of the continuous capture. The filled
+ *        buffers are handed to the sink in place, without copying.
+ *
+ * @param sink - the streaming sink, NULL to read the buffers with
+ *               adc_stream_get() and adc_stream_release()
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_set_sink(adc_stream_sink sink)
+{
+    adc_stream.sent = adc_stream.released;
+    adc_stream.sink = sink;
+}
+
+/***************************************************************************//**
+ * @brief Hands the filled buffers of the continuous capture to the streaming
+ *        sink, in capture order. A buffer refused by the sink is handed again
+ *        on the next call. Must be called often enough to keep the capture
+ *        running.
+ *
+ * @return Number of buffers handed to the sink, -1 if no sink is set.
+*******************************************************************************/
+int32_t adc_stream_sink_process(void)
+{
+    uint32_t idx;
+    int32_t nb = 0;
+
+    if (!adc_stream.sink)
+    {
+        return -1;
+    }
+    adc_stream_poll();
+    while (adc_stream.sent != adc_stream.filled)
+    {
+        idx = (adc_stream.rd + (adc_stream.sent - adc_stream.released)) %
+              adc_stream.nb_buffers;
+        if (adc_stream.sink(adc_stream.address[idx], adc_stream.size * 8,
+                            adc_stream.overflow[idx]) < 0)
+        {
+            break;
+        }
+        adc_stream.sent++;
+        adc_stream.stats.sent++;
+        nb++;
+    }
+
+    return nb;
+}
+
+/***************************************************************************//**
+ * @brief Returns the oldest buffer handed to the streaming sink to the
+ *        continuous capture once it is transmitted. The transmit path must
+ *        complete the buffers in the order they were handed.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_tx_done(void)
+{
+    if (adc_trigger.running)
+    {
+        adc_trigger_tx_done();
+        return;
+    }
+    if (adc_stream.sent == adc_stream.released)
+    {
+        return;
+    }
+    adc_stream_release();
+}
+
+/***************************************************************************//**
+ * @brief Stops the continuous capture. The capture in progress, if any, is
+ *        left to complete.
+ *
+ * @param stats - the capture counters, can be NULL
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_stop(adc_stream_stats *stats)
+{
+    adc_stream.running = 0;
+    if (stats)
+    {
+        *stats = adc_stream.stats;
+    }
+}
+
+/***************************************************************************//**
+ * @brief Gets the counters of the continuous capture.
+ *
+ * @param stats - the capture counters
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_get_stats(adc_stream_stats *stats)
+{
+    *stats = adc_stream.stats;
+    stats->coalesce = adc_stream.coalesce;
+    stats->buffer_us = adc_stream.buffer_us;
+}
+
+#ifdef ADC_DDC_EN
+/***************************************************************************//**
+ * @brief Streaming sink of the downconverter stage. Each capture buffer is
+ *        deinterleaved and downconverted by chunks into its output buffer,
+ *        which is handed to the sink set with adc_stream_set_ddc(). A buffer
+ *        refused by the sink is not processed again when it is handed back.
+ *
+ * @param address - the filled capture buffer
+ * @param bytes - size of the capture buffer in bytes
+ * @param overflow - 1 if an overflow occurred during the capture
+ *
+ * @return 0 if the output was queued, negative if the sink is busy.
+*******************************************************************************/
+static int32_t adc_ddc_sink(uint32_t address, uint32_t bytes, uint32_t overflow)
+{
+    uint32_t idx;
+    uint32_t out;
+    uint32_t qwords;
+    uint32_t words = 0;
+    uint32_t n;
+
+    for (idx = 0; (idx + 1) < adc_stream.nb_buffers; idx++)
+    {
+        if (adc_stream.address[idx] == address)
+        {
+            break;
+        }
+    }
+    out = adc_ddc.out_address[idx];
+    if (!adc_ddc.pending)
+    {
+        for (qwords = 0; qwords < (bytes / 8); qwords += n)
+        {
+            n = (bytes / 8) - qwords;
+            if (n > ADC_DDC_CHUNK)
+            {
+                n = ADC_DDC_CHUNK;
+            }
+            adc_deinterleave(address + (qwords * 8), n, adc_ddc.format,
+                             adc_ddc_ch[0], adc_ddc_ch[1]);
+            words += DDC_Process(adc_ddc.ddc, adc_ddc_ch[adc_ddc.channel],
+                                 n * 2, (uint32_t *)out + words);
+        }
+        if (!adc_coherent)
+        {
+            Xil_DCacheFlushRange(out, words * 4);
+        }
+        adc_ddc.pending = 1;
+        adc_ddc.pending_bytes = words * 4;
+    }
+    if (adc_ddc.sink(out, adc_ddc.pending_bytes, overflow) < 0)
+    {
+        return -1;
+    }
+    adc_ddc.pending = 0;
+
+    return 0;
+}
+
+/***************************************************************************//**
+ * @brief Routes the continuous capture through a digital downconverter, so
+ *        only the decimated I/Q samples of one channel reach the sink. Must
+ *        be called after adc_stream_start(). The output buffers are handed
+ *        to the sink like the capture buffers and returned with
+ *        adc_stream_tx_done(); the capture buffer is kept until then.
+ *
+ * @param ddc - the downconverter, configured with DDC_Init()
+ * @param channel - the channel to downconvert, 0 or 1
+ * @param format - the output format of the ADC
+ * @param out_address - one output buffer per capture buffer, each with room
+ *                      for DDC_MAX_OUTPUT(size * 2, decimation) words
+ * @param sink - the sink of the decimated samples
+ *
+ * @return 0 in case of success, -1 if a parameter is not supported or an
+ *         output buffer is not aligned to ADC_CACHE_LINE.
+*******************************************************************************/
+int32_t adc_stream_set_ddc(stDdc *ddc, uint32_t channel, uint32_t format,
+                           uint32_t *out_address, adc_stream_sink sink)
+{
+    uint32_t i;
+
+    if (!ddc || !sink || (channel > 1) || !adc_stream.nb_buffers)
+    {
+        return -1;
+    }
+    for (i = 0; i < adc_stream.nb_buffers; i++)
+    {
+        if (out_address[i] & (ADC_CACHE_LINE - 1))
+        {
+            return -1;
+        }
+        adc_ddc.out_address[i] = out_address[i];
+    }
+    adc_ddc.ddc = ddc;
+    adc_ddc.channel = channel;
+    adc_ddc.format = format;
+    adc_ddc.pending = 0;
+    adc_ddc.sink = sink;
+    DDC_Reset(ddc);
+    adc_stream_set_sink(adc_ddc_sink);
+
+    return 0;
+}
+#endif
+
+#ifdef ADC_CHAN_EN
+/***************************************************************************//**
+ * @brief Streaming sink of the channelizer stage. Each capture buffer is
+ *        deinterleaved and channelized by chunks into its output buffer,
+ *        which is handed to the sink set with adc_stream_set_chan(). A buffer
+ *        refused by the sink is not processed again when it is handed back.
+ *
+ * @param address - the filled capture buffer
+ * @param bytes - size of the capture buffer in bytes
+ * @param overflow - 1 if an overflow occurred during the capture
+ *
+ * @return 0 if the output was queued, negative if the sink is busy.
+*******************************************************************************/
+static int32_t adc_fb_sink(uint32_t address, uint32_t bytes, uint32_t overflow)
+{
+    uint32_t idx;
+    uint32_t out;
+    uint32_t qwords;
+    uint32_t words = 0;
+    uint32_t n;
+
+    for (idx = 0; (idx + 1) < adc_stream.nb_buffers; idx++)
+    {
+        if (adc_stream.address[idx] == address)
+        {
+            break;
+        }
+    }
+    out = adc_fb.out_address[idx];
+    if (!adc_fb.pending)
+    {
+        for (qwords = 0; qwords < (bytes / 8); qwords += n)
+        {
+            n = (bytes / 8) - qwords;
+            if (n > ADC_CHAN_CHUNK)
+            {
+                n = ADC_CHAN_CHUNK;
+            }
+            adc_deinterleave(address + (qwords * 8), n, adc_fb.format,
+                             adc_fb_ch[0], adc_fb_ch[1]);
+            words += CHAN_Process(adc_fb.chan, adc_fb_ch[adc_fb.channel],
+                                  n * 2, (uint32_t *)out + words);
+        }
+        if (!adc_coherent)
+        {
+            Xil_DCacheFlushRange(out, words * 4);
+        }
+        adc_fb.pending = 1;
+        adc_fb.pending_bytes = words * 4;
+    }
+    if (adc_fb.sink(out, adc_fb.pending_bytes, overflow) < 0)
+    {
+        return -1;
+    }
+    adc_fb.pending = 0;
+
+    return 0;
+}
+
+/***************************************************************************//**
+ * @brief Routes the continuous capture through a polyphase channelizer, so
+ *        the sink gets the decimated I/Q samples or the power of all the
+ *        channels of one ADC channel. Must be called after
+ *        adc_stream_start(). The output buffers are handed to the sink like
+ *        the capture buffers and returned with adc_stream_tx_done(); the
+ *        capture buffer is kept until then.
+ *
+ * @param chan - the channelizer, configured with CHAN_Init()
+ * @param channel - the ADC channel to channelize, 0 or 1
+ * @param format - the output format of the ADC
+ * @param out_address - one output buffer per capture buffer, each with room
+ *                      for CHAN_MAX_OUTPUT(size * 2, points, oversample) words
+ * @param sink - the sink of the channelizer output
+ *
+ * @return 0 in case of success, -1 if a parameter is not supported or an
+ *         output buffer is not aligned to ADC_CACHE_LINE.
+*******************************************************************************/
+int32_t adc_stream_set_chan(stChan *chan, uint32_t channel, uint32_t format,
+                            uint32_t *out_address, adc_stream_sink sink)
+{
+    uint32_t i;
+
+    if (!chan || !sink || (channel > 1) || !adc_stream.nb_buffers)
+    {
+        return -1;
+    }
+    for (i = 0; i < adc_stream.nb_buffers; i++)
+    {
+        if (out_address[i] & (ADC_CACHE_LINE - 1))
+        {
+            return -1;
+        }
+        adc_fb.out_address[i] = out_address[i];
+    }
+    adc_fb.chan = chan;
+    adc_fb.channel = channel;
+    adc_fb.format = format;
+    adc_fb.pending = 0;
+    adc_fb.sink = sink;
+    CHAN_Reset(chan);
+    adc_stream_set_sink(adc_fb_sink);
+
+    return 0;
+}
+#endif
+
+#ifdef ADC_RECORDER_EN
+/***************************************************************************//**
+ * @brief Streaming sink of the SD card recorder. The buffer is copied to the
+ *        staging buffers of the recorder, so it is returned to the capture
+ *        by adc_stream_record_process() right after.
+ *
+ * @param address - the filled capture buffer
+ * @param bytes - size of the capture buffer in bytes
+ * @param overflow - 1 if an overflow occurred during the capture
+ *
+ * @return 0 if the buffer was recorded, negative if the recorder is busy or
+ *         full.
+*******************************************************************************/
+static int32_t adc_rec_sink(uint32_t address, uint32_t bytes, uint32_t overflow)
+{
+    return REC_Write(adc_rec, address, bytes, overflow);
+}
+
+/***************************************************************************//**
+ * @brief Routes the continuous capture to an SD card recorder. Must be called
+ *        after adc_stream_start(), with the recorder opened by REC_Open().
+ *        The buffers are then recorded with adc_stream_record_process()
+ *        instead of adc_stream_sink_process().
+ *
+ * @param rec - the recorder
+ *
+ * @return 0 in case of success, -1 if the recorder is not open or a capture
+ *         buffer and its header do not fit in a chunk of the recorder.
+*******************************************************************************/
+int32_t adc_stream_set_recorder(stRecorder *rec)
+{
+    if (!rec || !rec->open || !adc_stream.nb_buffers ||
+        ((adc_stream.size * 8 + sizeof(stRecHeader)) > rec->cfg.chunkSize))
+    {
+        return -1;
+    }
+    adc_rec = rec;
+    adc_stream_set_sink(adc_rec_sink);
+
+    return 0;
+}
+
+/***************************************************************************//**
+ * @brief Records the filled buffers of the continuous capture. The buffers
+ *        are copied to the staging buffers of the recorder and returned to
+ *        the capture, then at most one full staging buffer is written to the
+ *        card. The capture done interrupt keeps the capture running during
+ *        the write, so the ring must hold the buffers captured during the
+ *        longest write of the card (maxWriteUs of the recorder counters).
+ *
+ * @return 1 if a chunk was written, 0 if not, -1 if a write failed or the
+ *         recording is full.
+*******************************************************************************/
+int32_t adc_stream_record_process(void)
+{
+    if (!adc_rec)
+    {
+        return -1;
+    }
+    adc_stream_sink_process();
+    while (adc_stream.sent != adc_stream.released)
+    {
+        adc_stream_release();
+    }
+
+    return REC_Process(adc_rec);
+}
+#endif
+
+/***************************************************************************//**
+ * @brief Enables the capture done interrupt. adc_capture_isr() must be
+ *        connected to the S2MM interrupt of the DMA by the application.
+ *
+ * @param callback - function called from the interrupt with the start
+ *                   address and the overflow status of each completed
+ *                   capture, can be NULL
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture_irq_enable(adc_capture_callback callback)
+{
+    adc_irq_callback = callback;
+    adc_irq.enabled = 1;
+}
+
+/***************************************************************************//**
+ * @brief Disables the capture done interrupt, the captures are polled again.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture_irq_disable(void)
+{
+    adc_irq.enabled = 0;
+    Xil_Out32((DMA_BASEADDR + 0x030),
+              Xil_In32(DMA_BASEADDR + 0x030) & ~DMA_S2MM_CR_IOC_IRQ_EN);
+    adc_irq_callback = 0;
+}
+
+/***************************************************************************//**
+ * @brief Selects whether the capture buffers are coherent with the caches.
+ *        On Zynq, a capture DMA connected to the ACP port writes through the
+ *        SCU and the captures can be read as soon as they complete, without
+ *        any cache maintenance. The buffers still have to be in memory
+ *        reached through the ACP, the MicroBlaze builds ignore the setting.
+ *
+ * @param enable - 1 if the capture DMA writes through the ACP port.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture_set_coherent(uint32_t enable)
+{
+#ifdef _XPARAMETERS_PS_H_
+    adc_coherent = enable;
+#else
+    adc_coherent = 0;
+#endif
+}
+
+/***************************************************************************//**
+ * @brief Capture done interrupt handler. Completes the single capture or the
+ *        buffer of the continuous capture and calls the completion callback.
+ *
+ * @param ref - not used
+ *
+ * @return None.
+*******************************************************************************/
+FAST_CODE void adc_capture_isr(void *ref)
+{
+    uint32_t status;
+    uint32_t address;
+    int32_t done;
+
+    Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_SR), DMA_S2MM_SR_IOC_IRQ);
+    status = Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS);
+    if (adc_stream.running && !adc_stream.stalled)
+    {
+        done = adc_stream_complete(status);
+        address = adc_stream.address[done];
+        adc_irq.overflow = adc_stream.overflow[done];
+    }
+    else
+    {
+        address = adc_irq.address;
+        adc_irq.overflow = (status & CF_ADC_STATUS_OVERFLOW) ? 1 : 0;
+        adc_capture_sync_cache(adc_irq.address, adc_irq.size);
+    }
+    adc_irq.done = 1;
+    if (adc_irq_callback)
+    {
+        adc_irq_callback(address, adc_irq.overflow);
+    }
+}
+
+/***************************************************************************//**
+ * @brief Enables the fast detect interrupt and clears the overrange event
+ *        statistics. adc_fd_isr() must be connected to the interrupt of the
+ *        GPIO receiving the FDA/FDB pins, and the converter fast detect
+ *        output must be enabled (enFd) with the FD pin function.
+ *
+ * @param callback - called from the interrupt on each overrange event, or 0
+ *
+ * @return Returns 0 in case of success or -1 if the design has no fast
+ *         detect GPIO.
+*******************************************************************************/
+int32_t adc_fd_enable(adc_fd_callback callback)
+{
+#ifdef FD_GPIO_BASEADDR
+    uint32_t data;
+    uint32_t ch;
+
+    adc_fd_cb = callback;
+    for (ch = 0; ch < 2; ch++)
+    {
+        adc_fd.events[ch] = 0;
+        adc_fd.last_us[ch] = 0;
+    }
+    Xil_Out32((FD_GPIO_BASEADDR + GPIO_REG_TRI),
+              Xil_In32(FD_GPIO_BASEADDR + GPIO_REG_TRI) |
+              FD_GPIO_FDA | FD_GPIO_FDB);               // inputs
+    data = Xil_In32(FD_GPIO_BASEADDR + GPIO_REG_DATA);
+    adc_fd.active = ((data & FD_GPIO_FDA) ? 1 : 0) | ((data & FD_GPIO_FDB) ? 2 : 0);
+    Xil_Out32((FD_GPIO_BASEADDR + GPIO_REG_ISR),
+              Xil_In32(FD_GPIO_BASEADDR + GPIO_REG_ISR)); // clear pending
+    Xil_Out32((FD_GPIO_BASEADDR + GPIO_REG_IER), GPIO_IER_CH1);
+    Xil_Out32((FD_GPIO_BASEADDR + GPIO_REG_GIER), GPIO_GIER_EN);
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+/***************************************************************************//**
+ * @brief Disables the fast detect interrupt.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_fd_disable(void)
+{
+#ifdef FD_GPIO_BASEADDR
+    Xil_Out32((FD_GPIO_BASEADDR + GPIO_REG_GIER), 0);
+    Xil_Out32((FD_GPIO_BASEADDR + GPIO_REG_IER), 0);
+#endif
+    adc_fd_cb = 0;
+}
+
+/***************************************************************************//**
+ * @brief Fast detect interrupt handler. The GPIO interrupts on any change of
+ *        the FDA/FDB inputs; each low to high transition is an overrange
+ *        event which is timestamped, counted and passed to the callback.
+ *
+ * @param ref - unused
+ *
+ * @return None.
+*******************************************************************************/
+FAST_CODE void adc_fd_isr(void *ref)
+{
+#ifdef FD_GPIO_BASEADDR
+    uint64_t timestamp;
+    uint32_t data;
+    uint32_t active;
+    uint32_t rising;
+    uint32_t ch;
+
+    Xil_Out32((FD_GPIO_BASEADDR + GPIO_REG_ISR),
+              Xil_In32(FD_GPIO_BASEADDR + GPIO_REG_ISR)); // acknowledge
+    data = Xil_In32(FD_GPIO_BASEADDR + GPIO_REG_DATA);
+    active = ((data & FD_GPIO_FDA) ? 1 : 0) | ((data & FD_GPIO_FDB) ? 2 : 0);
+    rising = active & ~adc_fd.active;
+    adc_fd.active = active;
+    if (rising == 0)
+    {
+        return;
+    }
+    /* Opens a window of the trigger stage on the buffer being captured */
+    if (adc_trigger.running && (adc_trigger.cfg.mode == ADC_TRIGGER_FD) &&
+        (rising & (1 << adc_trigger.cfg.channel)) && !adc_trigger.fd_pending)
+    {
+        adc_trigger.fd_seq = adc_stream.filled;
+        adc_trigger.fd_pending = 1;
+    }
+    timestamp = TIMER_GetTimeUs();
+    for (ch = 0; ch < 2; ch++)
+    {
+        if (rising & (1 << ch))
+        {
+            adc_fd.events[ch]++;
+            adc_fd.last_us[ch] = timestamp;
+            if (adc_fd_cb)
+            {
+                adc_fd_cb(ch, timestamp);
+            }
+        }
+    }
+#endif
+}
+
+/***************************************************************************//**
+ * @brief Gets the overrange event statistics.
+ *
+ * @param stats - stores the statistics
+ *
+ * @return None.
+*******************************************************************************/
+void adc_fd_get_stats(adc_fd_stats *stats)
+{
+    uint32_t ch;
+
+    for (ch = 0; ch < 2; ch++)
+    {
+        stats->events[ch] = adc_fd.events[ch];
+        stats->last_us[ch] = adc_fd.last_us[ch];
+    }
+    stats->active = adc_fd.active;
+}
+
+/***************************************************************************//**
+ * @brief Counts the bits set in a word.
+ *
+ * @param data - the word
+ *
+ * @return Number of bits set.
+*******************************************************************************/
+static uint32_t adc_popcount(uint32_t data)
+{
+    data = data - ((data >> 1) & 0x55555555);
+    data = (data & 0x33333333) + ((data >> 2) & 0x33333333);
+    data = (data + (data >> 4)) & 0x0f0f0f0f;
+
+    return (data * 0x01010101) >> 24;
+}
+
+/***************************************************************************//**
+ * @brief Generates the next sample of a PN sequence x^n + x^k + 1, most
+ *        significant bit first. The bits are generated k at a time, as they
+ *        only depend on bits which are already known.
+ *
+ * @param state - the PN generator state, bit 0 is the last bit of the sequence
+ * @param n - degree of the generator polynomial
+ * @param k - degree of the middle term of the generator polynomial
+ *
+ * @return The next ADC_SAMPLE_WIDTH bits of the sequence.
+*******************************************************************************/
+static uint32_t adc_pn_next(uint32_t *state, uint32_t n, uint32_t k)
+{
+    uint32_t sample = 0;
+    uint32_t width = ADC_SAMPLE_WIDTH;
+    uint32_t bits;
+    uint32_t data;
+
+    while (width)
+    {
+        bits = (width < k) ? width : k;
+        data = ((*state >> (n - bits)) ^ (*state >> (k - bits))) &
+               ((1 << bits) - 1);
+        *state = (*state << bits) | data;
+        sample = (sample << bits) | data;
+        width -= bits;
+    }
+
+    return sample;
+}
+
+/***************************************************************************//**
+ * @brief Converts a sample to offset binary, the format the expected data of
+ *        the software verifier is generated in.
+ *
+ * @param sample - the sample
+ * @param format - the output format of the ADC
+ *
+ * @return The sample in offset binary.
+*******************************************************************************/
+static uint32_t adc_verify_convert(uint32_t sample, uint32_t format)
+{
+    if (format == TWOS_COMPLEMENT)
+    {
+        sample ^= (1 << (ADC_SAMPLE_WIDTH - 1));
+    }
+    return sample;
+}
+
+/***************************************************************************//**
+ * @brief Advances the expected data of a lane by one sample.
+ *
+ * @param lane - the expected data of the lane, seeded
+ *
+ * @return The expected sample, in offset binary.
+*******************************************************************************/
+static uint32_t adc_verify_expected(adc_verify_lane *lane)
+{
+    switch (lane->mode)
+    {
+        case CHECKERBOARD:
+        case ONE_ZERO_TOGGLE:
+            lane->value ^= ADC_SAMPLE_MASK;
+            return lane->value;
+        case PN_9_SEQUENCE:
+            return adc_pn_next(&lane->state, 9, 5);
+        case PN_23_SEQUENCE:
+            return adc_pn_next(&lane->state, 23, 18);
+        default:
+            return lane->value;
+    }
+}
+
+/***************************************************************************//**
+ * @brief Checks a sample of a lane against the expected data.
+ *
+ * @param lane - the expected data of the lane
+ * @param sample - the sample, in offset binary
+ * @param result - the counters of the lane are updated
+ * @param idx - index of the lane in the result
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_verify_check(adc_verify_lane *lane, uint32_t sample,
+                             adc_verify_result *result, uint32_t idx)
+{
+    uint32_t diff;
+
+    if (lane->seed)
+    {
+        lane->seed--;
+        lane->state = (lane->state << ADC_SAMPLE_WIDTH) | sample;
+        lane->value = sample;
+        return;
+    }
+    diff = sample ^ adc_verify_expected(lane);
+    result->samples[idx]++;
+    if (diff)
+    {
+        result->errors[idx]++;
+        result->bit_errors[idx] += adc_popcount(diff);
+    }
+}
+
+/***************************************************************************//**
+ * @brief Checks both lanes of a captured word against the expected data.
+ *
+ * @param lane - the expected data of the lanes
+ * @param format - the output format of the ADC
+ * @param data - the captured word
+ * @param result - the counters of the lanes are updated
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_verify_word(adc_verify_lane *lane, uint32_t format,
+                            uint32_t data, adc_verify_result *result)
+{
+    adc_verify_check(&lane[0],
+                     adc_verify_convert((data >> ADC_SAMPLE_SHIFT) &
+                                        ADC_SAMPLE_MASK, format),
+                     result, 0);
+    adc_verify_check(&lane[ADC_VERIFY_STREAMS - 1],
+                     adc_verify_convert((data >> (16 + ADC_SAMPLE_SHIFT)) &
+                                        ADC_SAMPLE_MASK, format),
+                     result, 1);
+}
+
+#ifdef __ARM_NEON__
+/***************************************************************************//**
+ * @brief Checks a captured buffer eight words at a time with NEON, for the
+ *        fixed and the alternating patterns. Their expected data repeats
+ *        every eight samples of a lane, so it is generated once and compared
+ *        against every block. The first word is checked by adc_verify_word()
+ *        to seed the alternating patterns, the PN sequences are left to it.
+ *
+ * @param lane - the expected data of the lanes
+ * @param format - the output format of the ADC
+ * @param address - capture start address
+ * @param words - number of words captured
+ * @param result - the counters of the lanes are updated
+ *
+ * @return Number of words checked.
+*******************************************************************************/
+static uint32_t adc_verify_neon(adc_verify_lane *lane, uint32_t format,
+                                uint32_t address, uint32_t words,
+                                adc_verify_result *result)
+{
+    uint16_t expected[2][8];
+    uint16x8_t expect[2];
+    uint32x4_t errors[2];
+    uint32x4_t bits[2];
+    uint16x8x2_t data;
+    uint16x8_t sample;
+    uint16x8_t diff;
+    uint8x16_t count;
+    uint32x2_t sum;
+    uint32_t n;
+    uint32_t i;
+
+    if ((lane[0].mode == PN_9_SEQUENCE) || (lane[0].mode == PN_23_SEQUENCE) ||
+        (words < 9))
+    {
+        return 0;
+    }
+    adc_verify_word(lane, format, Xil_In32(address), result);
+    for (i = 0; i < 8; i++)
+    {
+        expected[0][i] = adc_verify_expected(&lane[0]);
+        expected[1][i] = adc_verify_expected(&lane[ADC_VERIFY_STREAMS - 1]);
+    }
+    for (i = 0; i < 2; i++)
+    {
+        expect[i] = vld1q_u16(expected[i]);
+        errors[i] = vdupq_n_u32(0);
+        bits[i] = vdupq_n_u32(0);
+    }
+    for (n = 1; (n + 8) <= words; n += 8)
+    {
+        /* val[0] holds the low lanes of the words, val[1] the high lanes */
+        data = vld2q_u16((const uint16_t *)(address + (n * 4)));
+        for (i = 0; i < 2; i++)
+        {
+            sample = data.val[i];
+#if ADC_SAMPLE_SHIFT
+            sample = vshrq_n_u16(sample, ADC_SAMPLE_SHIFT);
+#endif
+            sample = vandq_u16(sample, vdupq_n_u16(ADC_SAMPLE_MASK));
+            if (format == TWOS_COMPLEMENT)
+            {
+                sample = veorq_u16(sample,
+                                   vdupq_n_u16(1 << (ADC_SAMPLE_WIDTH - 1)));
+            }
+            diff = veorq_u16(sample, expect[i]);
+            /* A sample in error adds one, its bits in error are counted per
+             * byte and summed pairwise */
+            errors[i] = vpadalq_u16(errors[i],
+                                    vshrq_n_u16(vtstq_u16(diff, diff), 15));
+            count = vcntq_u8(vreinterpretq_u8_u16(diff));
+            bits[i] = vpadalq_u16(bits[i], vpaddlq_u8(count));
+        }
+    }
+    for (i = 0; i < 2; i++)
+    {
+        result->samples[i] += n - 1;
+        sum = vpadd_u32(vget_low_u32(errors[i]), vget_high_u32(errors[i]));
+        result->errors[i] += vget_lane_u32(vpadd_u32(sum, sum), 0);
+        sum = vpadd_u32(vget_low_u32(bits[i]), vget_high_u32(bits[i]));
+        result->bit_errors[i] += vget_lane_u32(vpadd_u32(sum, sum), 0);
+    }
+
+    return n;
+}
+#endif
+
+/***************************************************************************//**
+ * @brief Checks a captured buffer against the data of a test mode in
+ *        software, in both output formats. The alternating patterns take
+ *        their phase from the first sample and the PN sequences are seeded
+ *        from the first samples of the lane, which are not counted. With
+ *        NEON the fixed and the alternating patterns are checked eight words
+ *        at a time and the remaining words go through the scalar check.
+ *
+ * @param mode - the test mode of the ADC
+ * @param format - the output format of the ADC
+ * @param address - capture start address
+ * @param size - number of samples captured, as passed to adc_capture()
+ * @param result - samples, samples in error and bit errors of each lane
+ *
+ * @return 0 if no error was found, 1 if errors were found, -1 if the test mode
+ *         has no known data.
+*******************************************************************************/
+int32_t adc_verify(uint32_t mode, uint32_t format, uint32_t address, uint32_t size,
+                   adc_verify_result *result)
+{
+    adc_verify_lane lane[ADC_VERIFY_STREAMS];
+    uint32_t words = size * 2;
+    uint32_t n;
+    uint32_t i;
+
+    for (i = 0; i < ADC_VERIFY_STREAMS; i++)
+    {
+        lane[i].mode = mode;
+        lane[i].seed = 0;
+        lane[i].state = 0;
+        switch (mode)
+        {
+            case MIDSCALE:
+                lane[i].value = (1 << (ADC_SAMPLE_WIDTH - 1));
+                break;
+            case POS_FULLSCALE:
+                lane[i].value = ADC_SAMPLE_MASK;
+                break;
+            case NEG_FULLSCALE:
+                lane[i].value = 0;
+                break;
+            case CHECKERBOARD:
+            case ONE_ZERO_TOGGLE:
+                lane[i].seed = 1;
+                break;
+            case PN_9_SEQUENCE:
+                lane[i].seed = (9 + ADC_SAMPLE_WIDTH - 1) / ADC_SAMPLE_WIDTH;
+                break;
+            case PN_23_SEQUENCE:
+                lane[i].seed = (23 + ADC_SAMPLE_WIDTH - 1) / ADC_SAMPLE_WIDTH;
+                break;
+            default:
+                return -1;
+        }
+    }
+    for (i = 0; i < 2; i++)
+    {
+        result->samples[i] = 0;
+        result->errors[i] = 0;
+        result->bit_errors[i] = 0;
+    }
+    n = 0;
+#ifdef __ARM_NEON__
+    n = adc_verify_neon(lane, format, address, words, result);
+#endif
+    for (; n < words; n++)
+    {
+        adc_verify_word(lane, format, Xil_In32(address + (n * 4)), result);
+    }
+
+    return (result->errors[0] || result->errors[1]) ? 1 : 0;
+}
+
+/***************************************************************************//**
+ * @brief Converts a sample of a captured word to a signed value.
+ *
+ * @param data - the captured lane, the sample is at ADC_SAMPLE_SHIFT
+ * @param flip - the sign bit for two's complement data, 0 for offset binary
+ *
+ * @return The signed sample.
+*******************************************************************************/
+static int16_t adc_sample_signed(uint32_t data, uint32_t flip)
+{
+    return (int16_t)((((data >> ADC_SAMPLE_SHIFT) & ADC_SAMPLE_MASK) ^ flip) -
+                     (1 << (ADC_SAMPLE_WIDTH - 1)));
+}
+
+/***************************************************************************//**
+ * @brief Splits a captured buffer into one buffer per channel (planar) and
+ *        converts the samples to sign extended 16 bit values. Two words are
+ *        processed per iteration, eight with NEON.
+ *
+ * @param address - capture start address
+ * @param size - number of samples captured, as passed to adc_capture()
+ * @param format - the output format of the ADC
+ * @param ch0 - the samples of channel 0, room for size * 2 samples
+ * @param ch1 - the samples of channel 1, room for size * 2 samples
+ *
+ * @return Number of samples written to each channel buffer.
+*******************************************************************************/
+uint32_t adc_deinterleave(uint32_t address, uint32_t size, uint32_t format,
+                          int16_t *ch0, int16_t *ch1)
+{
+    uint32_t words = size * 2;
+    uint32_t flip = (format == TWOS_COMPLEMENT) ?
+                    (1 << (ADC_SAMPLE_WIDTH - 1)) : 0;
+    uint32_t data0;
+    uint32_t data1;
+    uint32_t n = 0;
+#ifdef __ARM_NEON__
+    const uint16x8_t mask = vdupq_n_u16(ADC_SAMPLE_MASK);
+    const uint16x8_t sign = vdupq_n_u16(flip);
+    const uint16x8_t mid = vdupq_n_u16(1 << (ADC_SAMPLE_WIDTH - 1));
+    uint16x8x2_t data;
+    uint16x8_t raw;
+    uint32_t c;
+
+    for (; (n + 8) <= words; n += 8)
+    {
+        /* val[0] holds channel 0 and val[1] channel 1 */
+        data = vld2q_u16((const uint16_t *)(address + (n * 4)));
+        for (c = 0; c < 2; c++)
+        {
+            raw = data.val[c];
+#if ADC_SAMPLE_SHIFT
+            raw = vshrq_n_u16(raw, ADC_SAMPLE_SHIFT);
+#endif
+            raw = vsubq_u16(veorq_u16(vandq_u16(raw, mask), sign), mid);
+            vst1q_s16(&(c ? ch1 : ch0)[n], vreinterpretq_s16_u16(raw));
+        }
+    }
+#endif
+    for (; (n + 1) < words; n += 2)
+    {
+        data0 = Xil_In32(address + (n * 4));
+        data1 = Xil_In32(address + (n * 4) + 4);
+        ch0[n] = adc_sample_signed(data0, flip);
+        ch1[n] = adc_sample_signed(data0 >> 16, flip);
+        ch0[n + 1] = adc_sample_signed(data1, flip);
+        ch1[n + 1] = adc_sample_signed(data1 >> 16, flip);
+    }
+    if (n < words)
+    {
+        data0 = Xil_In32(address + (n * 4));
+        ch0[n] = adc_sample_signed(data0, flip);
+        ch1[n] = adc_sample_signed(data0 >> 16, flip);
+    }
+
+    return words;
+}
+
+/***************************************************************************//**
+ * @brief Packs signed samples densely, ADC_SAMPLE_WIDTH bits each, for
+ *        storage or transmission. The samples are packed least significant
+ *        bit first, the last word is padded with zeros. With NEON the samples
+ *        are masked and joined in pairs eight at a time, so the bit stream is
+ *        built two samples at a time.
+ *
+ * @param src - the samples, as written by adc_deinterleave()
+ * @param count - number of samples
+ * @param dst - the packed words, room for
+ *              (count * ADC_SAMPLE_WIDTH + 31) / 32 words
+ *
+ * @return Number of words written.
+*******************************************************************************/
+uint32_t adc_pack(const int16_t *src, uint32_t count, uint32_t *dst)
+{
+    uint64_t acc = 0;
+    uint32_t bits = 0;
+    uint32_t words = 0;
+    uint32_t n = 0;
+#ifdef __ARM_NEON__
+    uint32_t pairs[4];
+    uint32x4_t x;
+    uint32_t k;
+
+    for (; (n + 8) <= count; n += 8)
+    {
+        x = vreinterpretq_u32_u16(vandq_u16(vreinterpretq_u16_s16(
+                vld1q_s16(&src[n])), vdupq_n_u16(ADC_SAMPLE_MASK)));
+        /* The second sample of each word moves down next to the first */
+        x = vorrq_u32(vandq_u32(x, vdupq_n_u32(0xFFFF)),
+                      vshlq_n_u32(vshrq_n_u32(x, 16), ADC_SAMPLE_WIDTH));
+        vst1q_u32(pairs, x);
+        for (k = 0; k < 4; k++)
+        {
+            acc |= (uint64_t)pairs[k] << bits;
+            bits += 2 * ADC_SAMPLE_WIDTH;
+            if (bits >= 32)
+            {
+                dst[words++] = (uint32_t)acc;
+                acc >>= 32;
+                bits -= 32;
+            }
+        }
+    }
+#endif
+    for (; n < count; n++)
+    {
+        acc |= (uint64_t)((uint16_t)src[n] & ADC_SAMPLE_MASK) << bits;
+        bits += ADC_SAMPLE_WIDTH;
+        if (bits >= 32)
+        {
+            dst[words++] = (uint32_t)acc;
+            acc >>= 32;
+            bits -= 32;
+        }
+    }
+    if (bits)
+    {
+        dst[words++] = (uint32_t)acc;
+    }
+
+    return words;
+}
+
+/***************************************************************************//**
+ * @brief Converts the 16 bit lanes of a buffer to signed samples and adds
+ *        them to the accumulator. Eight lanes are processed at a time with
+ *        NEON in the builds with ADC_AVG_NEON for a NEON target.
+ *
+ * @param address - start of the lanes, 2 byte aligned
+ * @param lanes - number of lanes
+ * @param flip - the sign bit for two's complement data, 0 for offset binary
+ * @param acc - the accumulator, one word per lane
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_avg_accumulate(uint32_t address, uint32_t lanes, uint32_t flip,
+                               int32_t *acc)
+{
+    const uint16_t *src = (const uint16_t *)address;
+    uint32_t n = 0;
+#if defined(ADC_AVG_NEON) && defined(__ARM_NEON__)
+    const uint16x8_t mask = vdupq_n_u16(ADC_SAMPLE_MASK);
+    const uint16x8_t sign = vdupq_n_u16(flip);
+    const uint16x8_t mid = vdupq_n_u16(1 << (ADC_SAMPLE_WIDTH - 1));
+    uint16x8_t raw;
+    int16x8_t sample;
+
+    for (; (n + 8) <= lanes; n += 8)
+    {
+        raw = vld1q_u16(src + n);
+#if ADC_SAMPLE_SHIFT
+        raw = vshrq_n_u16(raw, ADC_SAMPLE_SHIFT);
+#endif
+        /* Reaches the signed value modulo 2^16, exact for 16 bit samples */
+        raw = vsubq_u16(veorq_u16(vandq_u16(raw, mask), sign), mid);
+        sample = vreinterpretq_s16_u16(raw);
+        vst1q_s32(acc + n, vaddw_s16(vld1q_s32(acc + n), vget_low_s16(sample)));
+        vst1q_s32(acc + n + 4, vaddw_s16(vld1q_s32(acc + n + 4),
+                                         vget_high_s16(sample)));
+    }
+#endif
+    for (; n < lanes; n++)
+    {
+        acc[n] += adc_sample_signed(src[n], flip);
+    }
+}
+
+/***************************************************************************//**
+ * @brief Software trigger of the averaged capture: finds the first rising
+ *        crossing of midscale of a channel, after the channel was at least
+ *        ADC_AVG_HYSTERESIS below midscale, in the first
+ *        ADC_AVG_TRIGGER_WINDOW samples of the channel.
+ *
+ * @param address - start address of the buffer
+ * @param channel - the trigger channel
+ * @param flip - the sign bit for two's complement data, 0 for offset binary
+ *
+ * @return Offset of the trigger in lanes, -1 if the channel did not cross.
+*******************************************************************************/
+static int32_t adc_avg_trigger(uint32_t address, uint32_t channel, uint32_t flip)
+{
+    const uint16_t *src = (const uint16_t *)address;
+    uint32_t armed = 0;
+    uint32_t k;
+    int32_t sample;
+
+    for (k = 0; k < ADC_AVG_TRIGGER_WINDOW; k++)
+    {
+        sample = adc_sample_signed(src[channel + (k * ADC_AVG_LANE_STRIDE)], flip);
+        if (sample < -ADC_AVG_HYSTERESIS)
+        {
+            armed = 1;
+        }
+        else if (armed && (sample >= 0))
+        {
+            return k * ADC_AVG_LANE_STRIDE;
+        }
+    }
+
+    return -1;
+}
+
+/***************************************************************************//**
+ * @brief Sums a number of captures into a 32 bit accumulator, one word per
+ *        16 bit lane of the buffers, for averaging at the full ADC
+ *        resolution. The captures run through the continuous capture ring,
+ *        so the capture of a buffer overlaps the accumulation of the
+ *        previous one. With the trigger enabled each buffer is summed from
+ *        the trigger point, so the captures of a periodic signal add up
+ *        coherently; the buffers without a trigger are skipped. The average
+ *        of a lane is acc[lane] / result->captures.
+ *
+ * @param cfg - number of captures, lanes, format and trigger
+ * @param size - number of samples to capture in each buffer; the buffers
+ *               hold size * 4 lanes, of which the trigger search uses
+ *               ADC_AVG_TRIGGER_WINDOW * ADC_AVG_LANE_STRIDE
+ * @param address - start addresses of the buffers of the ring
+ * @param nb_buffers - number of buffers, 2 to ADC_STREAM_MAX_BUFFERS
+ * @param acc - the accumulator, room for cfg->lanes words
+ * @param result - the counters of the averaging
+ *
+ * @return 0 in case of success, -1 if a parameter is not supported, the
+ *         trigger missed more buffers than the captures requested or no
+ *         buffer completed for ADC_AVG_TIMEOUT_US.
+*******************************************************************************/
+int32_t adc_average(adc_avg_config *cfg, uint32_t size, uint32_t *address,
+                    uint32_t nb_buffers, int32_t *acc, adc_avg_result *result)
+{
+    adc_stream_stats stats;
+    uint32_t flip = (cfg->format == TWOS_COMPLEMENT) ?
+                    (1 << (ADC_SAMPLE_WIDTH - 1)) : 0;
+    uint32_t window = cfg->trigger ?
+                      (ADC_AVG_TRIGGER_WINDOW * ADC_AVG_LANE_STRIDE) : 0;
+    uint32_t buffer;
+    uint32_t overflow;
+    uint32_t polls = 0;
+    uint32_t n;
+    int32_t offset;
+
+    if (!cfg->captures || (cfg->captures > ADC_AVG_MAX_CAPTURES) ||
+        !cfg->lanes || ((cfg->lanes + window) > (size * 4)) ||
+        (cfg->channel >= ADC_AVG_LANE_STRIDE) || (cfg->format > TWOS_COMPLEMENT))
+    {
+        return -1;
+    }
+    for (n = 0; n < cfg->lanes; n++)
+    {
+        acc[n] = 0;
+    }
+    result->captures = 0;
+    result->overflows = 0;
+    result->missed = 0;
+    result->stalls = 0;
+    if (adc_stream_start(size, address, nb_buffers) < 0)
+    {
+        return -1;
+    }
+    while ((result->captures < cfg->captures) &&
+           (result->missed <= cfg->captures))
+    {
+        if (adc_stream_get(&buffer, &overflow) < 0)
+        {
+            /* A stalled DMA or ADC core ends the averaging */
+            if (++polls > (ADC_AVG_TIMEOUT_US / ADC_CAPTURE_POLL_US))
+            {
+                break;
+            }
+            TIMER_DelayUs(ADC_CAPTURE_POLL_US);
+            continue;
+        }
+        polls = 0;
+        offset = cfg->trigger ? adc_avg_trigger(buffer, cfg->channel, flip) : 0;
+        if (offset < 0)
+        {
+            result->missed++;
+        }
+        else
+        {
+            adc_avg_accumulate(buffer + (offset * 2), cfg->lanes, flip, acc);
+            result->captures++;
+            result->overflows += overflow;
+        }
+        adc_stream_release();
+    }
+    adc_stream_stop(&stats);
+    result->stalls = stats.stalls;
+    /* The buffers are reused by the caller, let the last capture land */
+    polls = 0;
+    while ((Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_BUSY) &&
+           (polls++ < (ADC_AVG_TIMEOUT_US / ADC_CAPTURE_POLL_US)))
+    {
+        TIMER_DelayUs(ADC_CAPTURE_POLL_US);
+    }
+
+    return (result->captures == cfg->captures) ? 0 : -1;
+}
+
+/***************************************************************************//**
+ * @brief Gets the ring index of a buffer of the continuous capture from its
+ *        number in capture order.
+ *
+ * @param seq - number of the buffer, not yet released
+ *
+ * @return Index of the buffer in the ring.
+*******************************************************************************/
+static uint32_t adc_trigger_index(uint32_t seq)
+{
+    return (adc_stream.rd + (seq - adc_stream.released)) % adc_stream.nb_buffers;
+}
+
+/***************************************************************************//**
+ * @brief Checks a sample of the trigger channel against the trigger.
+ *
+ * @param s - the sample, negated for a falling level or edge trigger
+ * @param prev - the previous sample, negated likewise
+ * @param mode - the trigger mode
+ * @param level - the level, negated likewise
+ * @param low - low limit of the window
+ * @param high - high limit of the window
+ *
+ * @return 1 if the sample fires the trigger, 0 otherwise.
+*******************************************************************************/
+static uint32_t adc_trigger_fires(int32_t s, int32_t prev, uint32_t mode,
+                                  int32_t level, int32_t low, int32_t high)
+{
+    switch (mode)
+    {
+        case ADC_TRIGGER_LEVEL:
+            return (s >= level);
+        case ADC_TRIGGER_EDGE:
+            return ((prev < level) & (s >= level));
+        default:
+            return ((s < low) | (s > high));
+    }
+}
+
+/***************************************************************************//**
+ * @brief Scans the trigger channel of a buffer. The samples are checked by
+ *        blocks of ADC_TRIGGER_BLOCK with a branch free loop per mode, which
+ *        the compiler can vectorize, and only the block which fired is
+ *        searched for the trigger position. The edges are detected within
+ *        a buffer.
+ *
+ * @param address - start address of the buffer
+ *
+ * @return Offset of the trigger in samples of the channel, -1 if the buffer
+ *         did not trigger.
+*******************************************************************************/
+static int32_t adc_trigger_scan(uint32_t address)
+{
+    const uint16_t *src = (const uint16_t *)address + adc_trigger.cfg.channel;
+    uint32_t samples = adc_stream.size * 2;
+    uint32_t mode = adc_trigger.cfg.mode;
+    uint32_t flip = (adc_trigger.cfg.format == TWOS_COMPLEMENT) ?
+                    (1 << (ADC_SAMPLE_WIDTH - 1)) : 0;
+    int32_t dir = (adc_trigger.cfg.falling && (mode != ADC_TRIGGER_WINDOW)) ?
+                  -1 : 1;
+    int32_t level = dir * adc_trigger.cfg.level;
+    int32_t low = adc_trigger.cfg.low;
+    int32_t high = adc_trigger.cfg.high;
+    int32_t prev;
+    int32_t s;
+    uint32_t hit;
+    uint32_t start;
+    uint32_t end;
+    uint32_t n;
+
+    prev = dir * adc_sample_signed(src[0], flip);
+    for (start = 0; start < samples; start = end)
+    {
+        end = start + ADC_TRIGGER_BLOCK;
+        if (end > samples)
+        {
+            end = samples;
+        }
+        hit = 0;
+        switch (mode)
+        {
+            case ADC_TRIGGER_LEVEL:
+                for (n = start; n < end; n++)
+                {
+                    hit |= ((dir * adc_sample_signed(src[n * 2], flip)) >= level);
+                }
+                break;
+            case ADC_TRIGGER_EDGE:
+                for (n = start; n < end; n++)
+                {
+                    s = dir * adc_sample_signed(src[n * 2], flip);
+                    hit |= ((prev < level) & (s >= level));
+                    prev = s;
+                }
+                break;
+            default:
+                for (n = start; n < end; n++)
+                {
+                    s = adc_sample_signed(src[n * 2], flip);
+                    hit |= ((s < low) | (s > high));
+                }
+                break;
+        }
+        if (!hit)
+        {
+            continue;
+        }
+        /* Locate the sample which fired */
+        prev = dir * adc_sample_signed(src[(start ? (start - 1) : 0) * 2], flip);
+        for (n = start; n < end; n++)
+        {
+            s = dir * adc_sample_signed(src[n * 2], flip);
+            if (adc_trigger_fires(s, prev, mode, level, low, high))
+            {
+                return n;
+            }
+            prev = s;
+        }
+        return start;
+    }
+
+    return -1;
+}
+
+/***************************************************************************//**
+ * @brief Releases the oldest buffers of the ring which the trigger stage no
+ *        longer needs: the buffers of a window once they are transmitted and
+ *        the other ones once they are older than the pre-trigger history.
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_trigger_release(void)
+{
+    uint32_t idx;
+
+    while (adc_stream.released != adc_trigger.examined)
+    {
+        idx = adc_stream.rd;
+        if (adc_trigger.mark[idx])
+        {
+            if (!adc_trigger.done[idx])
+            {
+                break;
+            }
+        }
+        else if ((adc_trigger.examined - adc_stream.released) <=
+                 adc_trigger.cfg.pre_buffers)
+        {
+            break;
+        }
+        adc_trigger.mark[idx] = 0;
+        adc_trigger.done[idx] = 0;
+        if (adc_trigger.handed == adc_stream.released)
+        {
+            adc_trigger.handed++;
+        }
+        if (adc_trigger.txd == adc_stream.released)
+        {
+            adc_trigger.txd++;
+        }
+        adc_stream_release();
+    }
+}
+
+/***************************************************************************//**
+ * @brief Returns the oldest buffer handed to the sink by the trigger stage,
+ *        called through adc_stream_tx_done().
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_trigger_tx_done(void)
+{
+    uint32_t idx;
+
+    while (adc_trigger.txd != adc_trigger.handed)
+    {
+        idx = adc_trigger_index(adc_trigger.txd);
+        adc_trigger.txd++;
+        if (adc_trigger.mark[idx])
+        {
+            adc_trigger.done[idx] = 1;
+            break;
+        }
+    }
+    adc_trigger_release();
+}
+
+/***************************************************************************//**
+ * @brief Starts the trigger stage of the continuous capture. Each filled
+ *        buffer is checked for a trigger; when it fires, the pre_buffers
+ *        buffers kept before it, the buffer itself and the post_buffers
+ *        following ones are handed to the sink, the other buffers are
+ *        returned to the capture without leaving the board. Must be called
+ *        after adc_stream_start(), then adc_trigger_process() must be called
+ *        often enough to keep the capture running. The sink returns the
+ *        buffers with adc_stream_tx_done().
+ *
+ * @param cfg - the trigger configuration
+ * @param sink - the sink of the triggered windows
+ *
+ * @return 0 in case of success, -1 if the configuration is not supported
+ *         or the ring has too few buffers for the pre-trigger history.
+*******************************************************************************/
+int32_t adc_trigger_start(adc_trigger_config *cfg, adc_stream_sink sink)
+{
+    uint32_t i;
+
+    if (!sink || (cfg->mode > ADC_TRIGGER_FD) || (cfg->channel > 1) ||
+        ((cfg->pre_buffers + 2) > adc_stream.nb_buffers))
+    {
+        return -1;
+    }
+    adc_trigger.running = 0;
+    adc_trigger.cfg = *cfg;
+    adc_trigger.sink = sink;
+    adc_trigger.examined = adc_stream.released;
+    adc_trigger.handed = adc_stream.released;
+    adc_trigger.txd = adc_stream.released;
+    adc_trigger.post_left = 0;
+    adc_trigger.forced = 0;
+    adc_trigger.fd_pending = 0;
+    for (i = 0; i < ADC_STREAM_MAX_BUFFERS; i++)
+    {
+        adc_trigger.mark[i] = 0;
+        adc_trigger.done[i] = 0;
+    }
+    adc_trigger.stats.triggers = 0;
+    adc_trigger.stats.fd_triggers = 0;
+    adc_trigger.stats.handed = 0;
+    adc_trigger.stats.dropped = 0;
+    adc_trigger.stats.last_address = 0;
+    adc_trigger.stats.last_offset = 0;
+    adc_stream_set_sink(0);
+    adc_trigger.running = 1;
+
+    return 0;
+}
+
+/***************************************************************************//**
+ * @brief Fires the trigger on the next buffer checked, whatever the mode.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_trigger_force(void)
+{
+    adc_trigger.forced = 1;
+}
+
+/***************************************************************************//**
+ * @brief Checks the filled buffers of the continuous capture for a trigger
+ *        and hands the buffers of the triggered windows to the sink, in
+ *        capture order. A buffer refused by the sink is handed again on the
+ *        next call.
+ *
+ * @return Number of buffers handed to the sink, -1 if the trigger stage is
+ *         not running.
+*******************************************************************************/
+int32_t adc_trigger_process(void)
+{
+    uint32_t seq;
+    uint32_t idx;
+    uint32_t address;
+    int32_t offset;
+    int32_t nb = 0;
+
+    if (!adc_trigger.running)
+    {
+        return -1;
+    }
+    adc_stream_poll();
+    while (adc_trigger.examined != adc_stream.filled)
+    {
+        seq = adc_trigger.examined;
+        idx = adc_trigger_index(seq);
+        address = adc_stream.address[idx];
+        offset = -1;
+        if (adc_trigger.post_left)
+        {
+            adc_trigger.post_left--;
+            adc_trigger.mark[idx] = 1;
+        }
+        else
+        {
+            if (adc_trigger.forced)
+            {
+                adc_trigger.forced = 0;
+                offset = 0;
+            }
+            else if (adc_trigger.cfg.mode == ADC_TRIGGER_FD)
+            {
+                if (adc_trigger.fd_pending &&
+                    ((int32_t)(seq - adc_trigger.fd_seq) >= 0))
+                {
+                    adc_trigger.fd_pending = 0;
+                    adc_trigger.stats.fd_triggers++;
+                    offset = 0;
+                }
+            }
+            else
+            {
+                offset = adc_trigger_scan(address);
+            }
+        }
+        if (offset >= 0)
+        {
+            /* The history and the buffer which fired open the window */
+            for (nb = 0; nb <= (int32_t)adc_trigger.cfg.pre_buffers; nb++)
+            {
+                if ((seq - nb) == (adc_stream.released - 1))
+                {
+                    break;
+                }
+                adc_trigger.mark[adc_trigger_index(seq - nb)] = 1;
+            }
+            nb = 0;
+            adc_trigger.post_left = adc_trigger.cfg.post_buffers;
+            adc_trigger.stats.triggers++;
+            adc_trigger.stats.last_address = address;
+            adc_trigger.stats.last_offset = offset;
+        }
+        adc_trigger.examined++;
+        /* Buffers out of the history can no longer join a window */
+        while ((adc_trigger.handed != adc_trigger.examined) &&
+               !adc_trigger.mark[adc_trigger_index(adc_trigger.handed)] &&
+               ((adc_trigger.examined - adc_trigger.handed) >
+                adc_trigger.cfg.pre_buffers))
+        {
+            adc_trigger.handed++;
+            adc_trigger.stats.dropped++;
+        }
+        adc_trigger_release();
+    }
+    while (adc_trigger.handed != adc_trigger.examined)
+    {
+        idx = adc_trigger_index(adc_trigger.handed);
+        if (!adc_trigger.mark[idx])
+        {
+            if ((adc_trigger.examined - adc_trigger.handed) <=
+                adc_trigger.cfg.pre_buffers)
+            {
+                break;
+            }
+            adc_trigger.handed++;
+            adc_trigger.stats.dropped++;
+            continue;
+        }
+        if (adc_trigger.sink(adc_stream.address[idx], adc_stream.size * 8,
+                             adc_stream.overflow[idx]) < 0)
+        {
+            break;
+        }
+        adc_trigger.handed++;
+        adc_trigger.stats.handed++;
+        nb++;
+    }
+
+    return nb;
+}
+
+/***************************************************************************//**
+ * @brief Stops the trigger stage. The buffers still held are left in the
+ *        ring, which is restarted with adc_stream_start().
+ *
+ * @param stats - the trigger counters, can be NULL
+ *
+ * @return None.
+*******************************************************************************/
+void adc_trigger_stop(adc_trigger_stats *stats)
+{
+    adc_trigger.running = 0;
+    if (stats)
+    {
+        *stats = adc_trigger.stats;
+    }
+}
+
+/***************************************************************************//**
+ * @brief Configures the AD6673 device to run in the selected test mode
+ *           and checks if the read data pattern corresponds to the expected
+ *           values for the set test mode.
+ *
+ * @param mode - The test mode. Range 0 ..7
+ *                        0 - test mode off
+ *                        1 - midscale short
+ *                        2 - +FS short
+ *                        3 - -FS short
+ *                        4 - checkerboard output
+ *                        5 - PN 23 sequence
+ *                        6 - PN 9 sequence
+ *                        7 - one/zero word toggle
+ * @param format - Sets the data format:
+ *                 0 - offset binary
+ *                 1 - twos complement
+ *
+ * @return 0 if the test passed or the mode has no known data, -1 if errors
+ *         were found.
+*******************************************************************************/
+int32_t adc_test(uint32_t mode, uint32_t format)
+{
+    adc_verify_result result;
+    int32_t ret = 0;
+    uint32_t n;
+
+    ad6673_stage_begin();
+    ad6673_output_format(format);
+    ad6673_test_mode(mode);
+    ad6673_stage_commit();
+    adc_capture(ADC_TEST_SAMPLES, DDR_BASEADDR);
+    DisplayTestMode(mode, format);
+    if (adc_verify(mode, format, DDR_BASEADDR, ADC_TEST_SAMPLES, &result) < 0)
+    {
+        return ret;
+    }
+    for (n = 0; n < 2; n++)
+    {
+        if (result.errors[n])
+        {
+            xil_printf("  ERROR: lane(%d), samples(%d/%d), bit errors(%d)\n\r",
+                       n, result.errors[n], result.samples[n],
+                       result.bit_errors[n]);
+            ret = -1;
+        }
+    }
+
+    return ret;
+}
+
+/***************************************************************************//**
+ * @brief Runs the power-on self-test of the data path. The fast level runs
+ *        a single checkerboard test, checked on one capture by adc_verify().
+ *        The full level runs adc_test() for all the test modes but the PN
+ *        sequences, in both output formats, and is kept as a diagnostic.
+ *        The test mode and the output format are left as set by the last
+ *        test.
+ *
+ * @param level - ADC_POST_NONE, ADC_POST_FAST or ADC_POST_FULL
+ *
+ * @return 0 if the tests passed, -1 if a test failed.
+*******************************************************************************/
+int32_t adc_post(uint32_t level)
+{
+    int32_t ret = 0;
+    uint32_t mode;
+
+    if (level == ADC_POST_NONE)
+    {
+        return 0;
+    }
+    if (level == ADC_POST_FAST)
+    {
+        return adc_test(CHECKERBOARD, OFFSET_BINARY);
+    }
+    for (mode = MIDSCALE; mode <= ONE_ZERO_TOGGLE; mode++)
+    {
+        if ((mode == PN_23_SEQUENCE) || (mode == PN_9_SEQUENCE))
+        {
+            continue;   // skip PN23 and PN9 test modes
+        }
+        if (adc_test(mode, OFFSET_BINARY) < 0)
+        {
+            ret = -1;
+        }
+        if (adc_test(mode, TWOS_COMPLEMENT) < 0)
+        {
+            ret = -1;
+        }
+    }
+
+    return ret;
+}
+
 void DisplayTestMode(uint32_t mode, uint32_t format)
 {
     char *sMode;
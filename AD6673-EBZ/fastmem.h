@@ -0,0 +1,75 @@
+/**************************************************************************//**
+*   @file   fastmem.h
+*   @brief  Placement of the time critical code and data in on-chip memory.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+
+#ifndef __FASTMEM_H__
+#define __FASTMEM_H__
+
+/*****************************************************************************/
+/************************ Macros Definitions *********************************/
+/*****************************************************************************/
+/* The interrupt handlers, the bus transfer loops, the timer service and the
+   rings are tagged FAST_CODE and FAST_DATA. With FAST_MEM_EN defined they are
+   placed in the .fast_text and .fast_data sections, out of the DDR used by
+   the capture and DAC DMA. The linker script (lscript.ld) generated for the
+   application must then place the two sections in on-chip memory, before
+   the DDR sections:
+
+       .fast_text : { *(.fast_text) } > FAST_MEM
+       .fast_data : { *(.fast_data) } > FAST_MEM
+
+   FAST_MEM is the local BRAM of the MicroBlaze (microblaze_0_i_bram_ctrl_
+   microblaze_0_d_bram_ctrl) or the OCM of the Zynq (ps7_ram_0_S_AXI_BASEADDR).
+   The calls between the DDR and the OCM are out of the branch range of the
+   ARM, the linker adds the long branch veneers. The .fast_data section is
+   loaded with the application, its variables do not have to be initialized
+   by the startup code. Without FAST_MEM_EN the macros expand to nothing. */
+#ifdef FAST_MEM_EN
+#define FAST_CODE	__attribute__((section(".fast_text")))
+#define FAST_DATA	__attribute__((section(".fast_data")))
+#else
+#define FAST_CODE
+#define FAST_DATA
+#endif
+
+#endif /* __FASTMEM_H__ */
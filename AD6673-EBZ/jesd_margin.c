@@ -0,0 +1,451 @@
+/**************************************************************************//**
+*   @file   jesd_margin.c
+*   @brief  JESD204B lane margining with the GTX eye scan implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "xil_io.h"
+#include "timer.h"
+#include "jesd_margin.h"
+
+#ifdef JESD_MARGIN_EN
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Time given to a DRP access */
+#define MARGIN_DRP_TIMEOUT_US	100
+
+/* First bit of the sampled data in ES_SDATA_MASK, the bits below hold the
+   offset sampler data and are masked */
+#define MARGIN_SDATA_FIRST		40
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+static const stMarginConfig marginDefault =
+{
+	MARGIN_PRESCALE,
+	MARGIN_DATA_WIDTH,
+	MARGIN_HORZ_MAX,
+	MARGIN_COARSE_HORZ,
+	MARGIN_COARSE_VERT,
+	0
+};
+
+extern void xil_printf(const char *ctrl1, ...);
+
+/**************************************************************************//**
+* @brief Waits for the end of a DRP access.
+*
+* @param data - Stores the data read, can be NULL.
+*
+* @return Returns 0 in case of success or -1 in case of timeout.
+******************************************************************************/
+static int32_t MARGIN_DrpWait(uint32_t* data)
+{
+#ifdef GT_BASEADDR
+	uint64_t deadline = TIMER_SetDeadline(MARGIN_DRP_TIMEOUT_US);
+	uint32_t status;
+
+	do
+	{
+		status = Xil_In32(GT_BASEADDR + GT_REG_DRP_STATUS);
+		if((status & GT_DRP_STATUS_BUSY) == 0)
+		{
+			if(data)
+			{
+				*data = GT_DRP_STATUS_RDATA(status);
+			}
+			return 0;
+		}
+	}while(!TIMER_DeadlineExpired(deadline));
+#endif
+
+	return -1;
+}
+
+/**************************************************************************//**
+* @brief Selects the lane reached by the next DRP accesses.
+*
+* @param lane - Lane number.
+*
+* @return Returns 0 in case of success or -1 if the design has no DRP access.
+******************************************************************************/
+static int32_t MARGIN_DrpSelect(uint32_t lane)
+{
+#ifdef GT_BASEADDR
+	Xil_Out32((GT_BASEADDR + GT_REG_DRP_SEL), lane);
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
+/**************************************************************************//**
+* @brief Reads a DRP register of the selected lane.
+*
+* @param addr - DRP address.
+* @param data - Stores the data read.
+*
+* @return Returns 0 in case of success or -1 in case of error.
+******************************************************************************/
+static int32_t MARGIN_DrpRead(uint32_t addr, uint32_t* data)
+{
+#ifdef GT_BASEADDR
+	Xil_Out32((GT_BASEADDR + GT_REG_DRP_CNTRL),
+			  GT_DRP_CNTRL_READ | GT_DRP_CNTRL_ADDR(addr));
+#endif
+
+	return MARGIN_DrpWait(data);
+}
+
+/**************************************************************************//**
+* @brief Writes a DRP register of the selected lane.
+*
+* @param addr - DRP address.
+* @param data - Data to write.
+*
+* @return Returns 0 in case of success or -1 in case of error.
+******************************************************************************/
+static int32_t MARGIN_DrpWrite(uint32_t addr, uint32_t data)
+{
+#ifdef GT_BASEADDR
+	Xil_Out32((GT_BASEADDR + GT_REG_DRP_CNTRL),
+			  GT_DRP_CNTRL_ADDR(addr) | GT_DRP_CNTRL_WDATA(data));
+#endif
+
+	return MARGIN_DrpWait(0);
+}
+
+/**************************************************************************//**
+* @brief Changes some bits of a DRP register of the selected lane.
+*
+* @param addr - DRP address.
+* @param data - New value of the bits.
+* @param mask - Bits changed.
+*
+* @return Returns 0 in case of success or -1 in case of error.
+******************************************************************************/
+static int32_t MARGIN_DrpUpdate(uint32_t addr, uint32_t data, uint32_t mask)
+{
+	uint32_t value;
+
+	if(MARGIN_DrpRead(addr, &value) < 0)
+	{
+		return -1;
+	}
+
+	return MARGIN_DrpWrite(addr, (value & ~mask) | (data & mask));
+}
+
+/**************************************************************************//**
+* @brief Prepares the eye scan of the selected lane: all the qualifier bits
+*        are masked and the data width bits of the sampled data are compared,
+*        so the error counter runs in statistical mode. ES_EYE_SCAN_EN is
+*        expected to be set in the transceiver attributes of the design, a
+*        change at run time takes effect at the next PMA reset only.
+*
+* @param cfg - Scan configuration.
+*
+* @return Returns 0 in case of success or -1 in case of error.
+******************************************************************************/
+static int32_t MARGIN_Setup(const stMarginConfig* cfg)
+{
+	uint32_t mask;
+	uint32_t bit;
+	uint32_t i;
+
+	for(i = 0; i < 5; i++)
+	{
+		mask = 0;
+		for(bit = i * 16; bit < (i + 1) * 16; bit++)
+		{
+			if((bit < MARGIN_SDATA_FIRST) ||
+			   (bit >= MARGIN_SDATA_FIRST + cfg->dataWidth))
+			{
+				mask |= 1 << (bit - (i * 16));
+			}
+		}
+		if((MARGIN_DrpWrite(GTX_ES_QUAL_MASK + i, 0xFFFF) < 0) ||
+		   (MARGIN_DrpWrite(GTX_ES_SDATA_MASK + i, mask) < 0))
+		{
+			return -1;
+		}
+	}
+
+	return MARGIN_DrpUpdate(GTX_ES_CONTROL,
+							GTX_ES_EYE_SCAN_EN | GTX_ES_ERRDET_EN,
+							GTX_ES_RUN | GTX_ES_EYE_SCAN_EN | GTX_ES_ERRDET_EN);
+}
+
+/**************************************************************************//**
+* @brief Measures one point of the eye of the selected lane. The measurement
+*        ends when the sample counter or the error counter saturates.
+*
+* @param cfg - Scan configuration.
+* @param horz - Horizontal offset from the center.
+* @param vert - Vertical offset from the center.
+* @param open - Set to 1 if no more than cfg->maxErrors errors were counted.
+*
+* @return Returns 0 in case of success or -1 in case of error.
+******************************************************************************/
+static int32_t MARGIN_Point(const stMarginConfig* cfg, int32_t horz,
+							int32_t vert, uint32_t* open)
+{
+	uint64_t deadline;
+	uint32_t status;
+	uint32_t errors;
+
+	if((MARGIN_DrpUpdate(GTX_ES_HORZ_OFFSET, GTX_ES_HORZ(horz), 0xFFF) < 0) ||
+	   (MARGIN_DrpUpdate(GTX_ES_PRESCALE_VERT,
+						 GTX_ES_PRESCALE(cfg->prescale) | GTX_ES_VERT_OFFSET(vert),
+						 GTX_ES_PRESCALE(0x1F) | 0x1FF) < 0) ||
+	   (MARGIN_DrpUpdate(GTX_ES_CONTROL, GTX_ES_RUN, GTX_ES_RUN) < 0))
+	{
+		return -1;
+	}
+	deadline = TIMER_SetDeadline(MARGIN_POINT_TIMEOUT_US);
+	do
+	{
+		if(MARGIN_DrpRead(GTX_ES_CONTROL_STATUS, &status) < 0)
+		{
+			return -1;
+		}
+		if(TIMER_DeadlineExpired(deadline))
+		{
+			MARGIN_DrpUpdate(GTX_ES_CONTROL, 0, GTX_ES_RUN);
+			return -1;
+		}
+	}while((status & GTX_ES_DONE) == 0);
+	if((MARGIN_DrpRead(GTX_ES_ERROR_COUNT, &errors) < 0) ||
+	   (MARGIN_DrpUpdate(GTX_ES_CONTROL, 0, GTX_ES_RUN) < 0))
+	{
+		return -1;
+	}
+	*open = (errors <= cfg->maxErrors);
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Finds the edge of the eye of the selected lane in one direction from
+*        the center. The coarse grid is walked outwards to the first closed
+*        point, then the edge is found by bisection between the last open
+*        point and the closed one.
+*
+* @param cfg - Scan configuration.
+* @param vertical - 1 to move the vertical offset, 0 the horizontal one.
+* @param sign - Direction, 1 or -1.
+* @param limit - Largest offset in the direction.
+* @param step - Step of the coarse grid.
+* @param edge - Stores the largest open offset.
+* @param points - Incremented by the number of points measured.
+*
+* @return Returns 0 in case of success or -1 in case of error.
+******************************************************************************/
+static int32_t MARGIN_Edge(const stMarginConfig* cfg, uint32_t vertical,
+						   int32_t sign, uint32_t limit, uint32_t step,
+						   uint32_t* edge, uint32_t* points)
+{
+	uint32_t pass = 0;
+	uint32_t fail = limit + 1;
+	uint32_t pos;
+	uint32_t open;
+	int32_t offset;
+
+	if(step == 0)
+	{
+		step = 1;
+	}
+	for(pos = step; pos <= limit; pos += step)
+	{
+		offset = sign * (int32_t)pos;
+		if(MARGIN_Point(cfg, vertical ? 0 : offset, vertical ? offset : 0,
+						&open) < 0)
+		{
+			return -1;
+		}
+		(*points)++;
+		if(!open)
+		{
+			fail = pos;
+			break;
+		}
+		pass = pos;
+	}
+	while((fail - pass) > 1)
+	{
+		pos = (pass + fail) / 2;
+		offset = sign * (int32_t)pos;
+		if(MARGIN_Point(cfg, vertical ? 0 : offset, vertical ? offset : 0,
+						&open) < 0)
+		{
+			return -1;
+		}
+		(*points)++;
+		if(open)
+		{
+			pass = pos;
+		}
+		else
+		{
+			fail = pos;
+		}
+	}
+	*edge = pass;
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Measures the eye margins of a lane with the eye scan of its GTX
+*        receiver. The scan runs on the live link without disturbing the
+*        data sampler; the edges are searched along the horizontal and the
+*        vertical axis through the center, on a coarse grid then refined.
+*
+* @param lane - Lane number.
+* @param cfg - Scan configuration, NULL for the defaults.
+* @param result - Stores the margins.
+*
+* @return Returns 0 in case of success or -1 if the design has no DRP access
+*         or in case of timeout.
+******************************************************************************/
+int32_t MARGIN_ScanLane(uint32_t lane, const stMarginConfig* cfg,
+						stMarginResult* result)
+{
+	uint64_t startUs = TIMER_GetTimeUs();
+	uint32_t open;
+
+	if(cfg == 0)
+	{
+		cfg = &marginDefault;
+	}
+	result->left = 0;
+	result->right = 0;
+	result->low = 0;
+	result->high = 0;
+	result->points = 1;
+	if((MARGIN_DrpSelect(lane) < 0) || (MARGIN_Setup(cfg) < 0) ||
+	   (MARGIN_Point(cfg, 0, 0, &open) < 0))
+	{
+		return -1;
+	}
+	if(open &&
+	   ((MARGIN_Edge(cfg, 0, -1, cfg->horzMax, cfg->coarseHorz,
+					 &result->left, &result->points) < 0) ||
+		(MARGIN_Edge(cfg, 0, 1, cfg->horzMax, cfg->coarseHorz,
+					 &result->right, &result->points) < 0) ||
+		(MARGIN_Edge(cfg, 1, -1, MARGIN_VERT_MAX, cfg->coarseVert,
+					 &result->low, &result->points) < 0) ||
+		(MARGIN_Edge(cfg, 1, 1, MARGIN_VERT_MAX, cfg->coarseVert,
+					 &result->high, &result->points) < 0)))
+	{
+		return -1;
+	}
+	/* Leave the offset sampler on the center of the eye */
+	MARGIN_DrpUpdate(GTX_ES_HORZ_OFFSET, 0, 0xFFF);
+	MARGIN_DrpUpdate(GTX_ES_PRESCALE_VERT, 0, 0x1FF);
+	result->widthMui = ((result->left + result->right) * 1000) /
+					   (2 * cfg->horzMax);
+	result->heightPct = ((result->low + result->high) * 100) /
+						(2 * MARGIN_VERT_MAX);
+	result->timeUs = (uint32_t)(TIMER_GetTimeUs() - startUs);
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Measures the eye margins of the first lanes of the link.
+*
+* @param lanes - Number of lanes, up to MARGIN_MAX_LANES.
+* @param cfg - Scan configuration, NULL for the defaults.
+* @param result - Stores the margins of each lane.
+*
+* @return Returns 0 in case of success or -1 in case of error.
+******************************************************************************/
+int32_t MARGIN_Scan(uint32_t lanes, const stMarginConfig* cfg,
+					stMarginResult* result)
+{
+	uint32_t lane;
+
+	if(lanes > MARGIN_MAX_LANES)
+	{
+		return -1;
+	}
+	for(lane = 0; lane < lanes; lane++)
+	{
+		if(MARGIN_ScanLane(lane, cfg, &result[lane]) < 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Prints the eye margins of the lanes over UART.
+*
+* @param lanes - Number of lanes.
+* @param result - Margins of each lane.
+*
+* @return None.
+******************************************************************************/
+void MARGIN_Print(uint32_t lanes, const stMarginResult* result)
+{
+	uint32_t lane;
+
+	for(lane = 0; lane < lanes; lane++)
+	{
+		xil_printf("  lane %d: eye %d mUI (-%d/+%d), %d%% (-%d/+%d), %d points in %dus\n\r",
+				   lane, result[lane].widthMui, result[lane].left,
+				   result[lane].right, result[lane].heightPct,
+				   result[lane].low, result[lane].high,
+				   result[lane].points, result[lane].timeUs);
+	}
+}
+
+#endif
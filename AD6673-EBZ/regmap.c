@@ -0,0 +1,659 @@
+/**************************************************************************//**
+*   @file   regmap.c
+*   @brief  Register map access layer implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "regmap.h"
+
+/*****************************************************************************/
+/************************ Macros Definitions *********************************/
+/*****************************************************************************/
+#define REGMAP_BIT_TEST(map, reg)	(((map)[(reg) >> 3] >> ((reg) & 7)) & 1)
+#define REGMAP_BIT_SET(map, reg)	((map)[(reg) >> 3] |= (1 << ((reg) & 7)))
+#define REGMAP_BIT_CLEAR(map, reg)	((map)[(reg) >> 3] &= ~(1 << ((reg) & 7)))
+
+/**************************************************************************//**
+* @brief Checks if the value of a register may be kept in the cache.
+*
+* @param pMap - Register map.
+* @param reg - Register address.
+*
+* @return Returns 1 if the register is cached, 0 otherwise.
+******************************************************************************/
+static uint32_t REGMAP_Cacheable(stRegmap* pMap, uint32_t reg)
+{
+	const stRegmapConfig* pCfg = pMap->pConfig;
+
+	if((pMap->cache == 0) || (reg >= pCfg->numRegs))
+	{
+		return 0;
+	}
+	if(pCfg->volatileMap && REGMAP_BIT_TEST(pCfg->volatileMap, reg))
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+/**************************************************************************//**
+* @brief Finds a register in the reset values table.
+*
+* @param pCfg - Register map description.
+* @param reg - Register address.
+* @param pIdx - Bit of the register in the atReset map.
+*
+* @return Returns the range of the register or NULL if it is not in the table.
+******************************************************************************/
+static const stRegmapDefault* REGMAP_DefaultFind(const stRegmapConfig* pCfg,
+												 uint32_t reg, uint32_t* pIdx)
+{
+	const stRegmapDefault* pRange;
+	uint32_t idx = 0;
+	uint32_t i;
+
+	for(i = 0; i < pCfg->numDefaults; i++)
+	{
+		pRange = &pCfg->defaults[i];
+		if(reg < pRange->addr)
+		{
+			break;
+		}
+		if(reg < (uint32_t)pRange->addr + pRange->count)
+		{
+			*pIdx = idx + reg - pRange->addr;
+			return pRange;
+		}
+		idx += pRange->count;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Checks if a register write can be skipped because the register
+*        kept its reset value since the last reset and the value to write
+*        is the reset value.
+*
+* @param pMap - Register map.
+* @param reg - Register address.
+* @param value - The value to write.
+*
+* @return Returns 1 if the write can be skipped, 0 otherwise.
+******************************************************************************/
+static uint32_t REGMAP_AtReset(stRegmap* pMap, uint32_t reg, uint8_t value)
+{
+	const stRegmapDefault* pRange;
+	uint32_t idx;
+
+	if(pMap->atReset == 0)
+	{
+		return 0;
+	}
+	pRange = REGMAP_DefaultFind(pMap->pConfig, reg, &idx);
+
+	return (pRange && (pRange->value == value) &&
+			REGMAP_BIT_TEST(pMap->atReset, idx));
+}
+
+/**************************************************************************//**
+* @brief Clears the reset state of the written registers which received a
+*        value different from their reset value. A register is not marked
+*        again when the reset value is written back, since it may be banked
+*        or buffered in the device.
+*
+* @param pMap - Register map.
+* @param addr - Address of the first register, the address decrements.
+* @param data - Register values.
+* @param count - Number of registers.
+*
+* @return None.
+******************************************************************************/
+static void REGMAP_ResetStore(stRegmap* pMap, uint32_t addr,
+							  const uint8_t* data, uint32_t count)
+{
+	const stRegmapDefault* pRange;
+	uint32_t idx;
+	uint32_t i;
+
+	if(pMap->atReset == 0)
+	{
+		return;
+	}
+	for(i = 0; i < count; i++)
+	{
+		pRange = REGMAP_DefaultFind(pMap->pConfig, addr - i, &idx);
+		if(pRange && (pRange->value != data[i]))
+		{
+			REGMAP_BIT_CLEAR(pMap->atReset, idx);
+		}
+	}
+}
+
+/**************************************************************************//**
+* @brief Builds the instruction word of a transfer.
+*
+* @param pCfg - Register map description.
+* @param flag - Read or write flag.
+* @param addr - Address of the first register of the transfer.
+* @param cnt - Number of data bytes of the transfer.
+*
+* @return Returns the instruction word.
+******************************************************************************/
+static uint32_t REGMAP_Instr(const stRegmapConfig* pCfg, uint32_t flag,
+							 uint32_t addr, uint32_t cnt)
+{
+	uint32_t instr;
+
+	instr = flag | (addr & pCfg->addrMask);
+	if(pCfg->cntShift)
+	{
+		/* W1:W0 = 3 selects the streaming mode */
+		instr |= (((cnt > 3) ? 4 : cnt) - 1) << pCfg->cntShift;
+	}
+
+	return instr;
+}
+
+/**************************************************************************//**
+* @brief Stores register values in the cache.
+*
+* @param pMap - Register map.
+* @param addr - Address of the first register, the address decrements.
+* @param data - Register values.
+* @param count - Number of registers.
+*
+* @return None.
+******************************************************************************/
+static void REGMAP_CacheStore(stRegmap* pMap, uint32_t addr,
+							  const uint8_t* data, uint32_t count)
+{
+	uint32_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		if(REGMAP_Cacheable(pMap, addr - i))
+		{
+			pMap->cache[addr - i] = data[i];
+			REGMAP_BIT_SET(pMap->cacheValid, addr - i);
+		}
+	}
+}
+
+/**************************************************************************//**
+* @brief Initializes a register map. All the cached values are dropped and
+*        the registers are always written, see REGMAP_InitDefaults().
+*
+* @param pMap - Register map.
+* @param pConfig - Register map description.
+* @param busId - Value passed to the bus access functions.
+* @param cache - Storage for numRegs register values, NULL to disable the cache.
+* @param cacheValid - Storage for REGMAP_BITMAP_SIZE(numRegs) bytes.
+*
+* @return None.
+******************************************************************************/
+void REGMAP_Init(stRegmap* pMap, const stRegmapConfig* pConfig, uint32_t busId,
+				 uint8_t* cache, uint8_t* cacheValid)
+{
+	pMap->pConfig    = pConfig;
+	pMap->busId      = busId;
+	pMap->cache      = cache;
+	pMap->cacheValid = cacheValid;
+	pMap->atReset    = 0;
+	pMap->elided     = 0;
+	REGMAP_CacheInvalidate(pMap);
+}
+
+/**************************************************************************//**
+* @brief Sets the storage of the reset state of the registers of the reset
+*        values table. No register is considered to hold its reset value
+*        until REGMAP_Reset() is called.
+*
+* @param pMap - Register map.
+* @param atReset - Storage for a bit per register of the reset values table,
+*                  NULL to always write the registers.
+*
+* @return None.
+******************************************************************************/
+void REGMAP_InitDefaults(stRegmap* pMap, uint8_t* atReset)
+{
+	const stRegmapConfig* pCfg = pMap->pConfig;
+	uint32_t regs = 0;
+	uint32_t i;
+
+	pMap->atReset = atReset;
+	if(atReset == 0)
+	{
+		return;
+	}
+	for(i = 0; i < pCfg->numDefaults; i++)
+	{
+		regs += pCfg->defaults[i].count;
+	}
+	for(i = 0; i < REGMAP_BITMAP_SIZE(regs); i++)
+	{
+		atReset[i] = 0;
+	}
+}
+
+/**************************************************************************//**
+* @brief Reads count consecutive registers starting from addr down, as the
+*        device sends them in MSB first mode. The transfer is split in chunks
+*        of maxRead bytes. If the cache holds all the registers no transfer
+*        is made.
+*
+* @param pMap - Register map.
+* @param addr - Address of the first register.
+* @param data - Buffer for the values, data[i] holds register addr - i.
+* @param count - Number of registers to read.
+*
+* @return Returns 0 in case of success or negative error code.
+******************************************************************************/
+int32_t REGMAP_RawRead(stRegmap* pMap, uint32_t addr, uint8_t* data, uint32_t count)
+{
+	const stRegmapConfig* pCfg = pMap->pConfig;
+	uint32_t cnt;
+	uint32_t i;
+	int32_t ret;
+
+	if(count > addr + 1)
+	{
+		return -1;
+	}
+	for(i = 0; i < count; i++)
+	{
+		if(!REGMAP_Cacheable(pMap, addr - i) ||
+		   !REGMAP_BIT_TEST(pMap->cacheValid, addr - i))
+		{
+			break;
+		}
+	}
+	if(i == count)
+	{
+		for(i = 0; i < count; i++)
+		{
+			data[i] = pMap->cache[addr - i];
+		}
+		return 0;
+	}
+	while(count > 0)
+	{
+		cnt = (count > pCfg->maxRead) ? pCfg->maxRead : count;
+		ret = pCfg->busRead(pMap->busId,
+							REGMAP_Instr(pCfg, pCfg->readFlag, addr, cnt),
+							data, cnt);
+		if(ret < 0)
+		{
+			return ret;
+		}
+		REGMAP_CacheStore(pMap, addr, data, cnt);
+		addr  -= cnt;
+		data  += cnt;
+		count -= cnt;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Writes count consecutive registers starting from addr down, as the
+*        device receives them in MSB first mode. The transfer is split in
+*        chunks of maxWrite bytes. The registers which kept their reset value
+*        since the last REGMAP_Reset() and are written with that value are
+*        left out of the transfers when they are at the ends of a chunk.
+*
+* @param pMap - Register map.
+* @param addr - Address of the first register.
+* @param data - Register values, data[i] goes to register addr - i.
+* @param count - Number of registers to write.
+*
+* @return Returns 0 in case of success or negative error code.
+******************************************************************************/
+int32_t REGMAP_RawWrite(stRegmap* pMap, uint32_t addr, const uint8_t* data, uint32_t count)
+{
+	const stRegmapConfig* pCfg = pMap->pConfig;
+	uint32_t cnt;
+	int32_t ret;
+
+	if(count > addr + 1)
+	{
+		return -1;
+	}
+	while(count > 0)
+	{
+		if(REGMAP_AtReset(pMap, addr, data[0]))
+		{
+			pMap->elided++;
+			addr--;
+			data++;
+			count--;
+			continue;
+		}
+		cnt = (count > pCfg->maxWrite) ? pCfg->maxWrite : count;
+		/* The trailing registers are checked again by the next chunk */
+		while((cnt > 1) && REGMAP_AtReset(pMap, addr - cnt + 1, data[cnt - 1]))
+		{
+			cnt--;
+		}
+		ret = pCfg->busWrite(pMap->busId,
+							 REGMAP_Instr(pCfg, pCfg->writeFlag, addr, cnt),
+							 data, cnt);
+		if(ret < 0)
+		{
+			return ret;
+		}
+		REGMAP_CacheStore(pMap, addr, data, cnt);
+		REGMAP_ResetStore(pMap, addr, data, cnt);
+		addr  -= cnt;
+		data  += cnt;
+		count -= cnt;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Reads a register. The bytes of a multi-byte register are at addr
+*        for the most significant one and at the next lower addresses.
+*
+* @param pMap - Register map.
+* @param addr - Address of the most significant byte of the register.
+* @param size - Register size in bytes, 1 to 4.
+* @param value - The register value.
+*
+* @return Returns 0 in case of success or negative error code.
+******************************************************************************/
+int32_t REGMAP_Read(stRegmap* pMap, uint32_t addr, uint32_t size, uint32_t* value)
+{
+	uint8_t data[4];
+	uint32_t i;
+	int32_t ret;
+
+	if((size == 0) || (size > 4))
+	{
+		return -1;
+	}
+	ret = REGMAP_RawRead(pMap, addr, data, size);
+	if(ret < 0)
+	{
+		return ret;
+	}
+	*value = 0;
+	for(i = 0; i < size; i++)
+	{
+		*value = (*value << 8) | data[i];
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Writes a register. The bytes of a multi-byte register are at addr
+*        for the most significant one and at the next lower addresses.
+*
+* @param pMap - Register map.
+* @param addr - Address of the most significant byte of the register.
+* @param size - Register size in bytes, 1 to 4.
+* @param value - The value to write.
+*
+* @return Returns 0 in case of success or negative error code.
+******************************************************************************/
+int32_t REGMAP_Write(stRegmap* pMap, uint32_t addr, uint32_t size, uint32_t value)
+{
+	uint8_t data[4];
+	uint32_t i;
+
+	if((size == 0) || (size > 4))
+	{
+		return -1;
+	}
+	for(i = 0; i < size; i++)
+	{
+		data[i] = (value >> ((size - i - 1) * 8)) & 0xFF;
+	}
+
+	return REGMAP_RawWrite(pMap, addr, data, size);
+}
+
+/**************************************************************************//**
+* @brief Changes the masked bits of a register without modifying the other
+*        bits. The current value comes from the cache when it holds the
+*        register and no write is made if the masked bits already have the
+*        requested value.
+*
+* @param pMap - Register map.
+* @param addr - Address of the most significant byte of the register.
+* @param size - Register size in bytes, 1 to 4.
+* @param mask - The bits to change.
+* @param value - The new value of the masked bits.
+*
+* @return Returns 0 in case of success or negative error code.
+******************************************************************************/
+int32_t REGMAP_UpdateBits(stRegmap* pMap, uint32_t addr, uint32_t size,
+						  uint32_t mask, uint32_t value)
+{
+	uint32_t regVal;
+	uint32_t newVal;
+	int32_t ret;
+
+	ret = REGMAP_Read(pMap, addr, size, &regVal);
+	if(ret < 0)
+	{
+		return ret;
+	}
+	newVal = (regVal & ~mask) | (value & mask);
+	if(newVal == regVal)
+	{
+		return 0;
+	}
+
+	return REGMAP_Write(pMap, addr, size, newVal);
+}
+
+/**************************************************************************//**
+* @brief Reads a block of consecutive registers. The transfers start at the
+*        highest address of the block.
+*
+* @param pMap - Register map.
+* @param addr - Address of the first register of the block.
+* @param data - Buffer for the values, data[i] holds register addr + i.
+* @param count - Number of registers to read.
+*
+* @return Returns 0 in case of success or negative error code.
+******************************************************************************/
+int32_t REGMAP_BulkRead(stRegmap* pMap, uint32_t addr, uint8_t* data, uint32_t count)
+{
+	uint8_t buf[REGMAP_MAX_TRANSFER];
+	uint32_t chunk;
+	uint32_t top;
+	uint32_t cnt;
+	uint32_t i;
+	int32_t ret;
+
+	/* Each chunk is sent in a single transfer when the device allows it */
+	chunk = pMap->pConfig->maxRead;
+	if(chunk > REGMAP_MAX_TRANSFER)
+	{
+		chunk = REGMAP_MAX_TRANSFER;
+	}
+	top = addr + count - 1;
+	while(count > 0)
+	{
+		cnt = (count > chunk) ? chunk : count;
+		ret = REGMAP_RawRead(pMap, top, buf, cnt);
+		if(ret < 0)
+		{
+			return ret;
+		}
+		for(i = 0; i < cnt; i++)
+		{
+			data[top - i - addr] = buf[i];
+		}
+		top   -= cnt;
+		count -= cnt;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Writes a block of consecutive registers. The transfers start at the
+*        highest address of the block.
+*
+* @param pMap - Register map.
+* @param addr - Address of the first register of the block.
+* @param data - Register values, data[i] goes to register addr + i.
+* @param count - Number of registers to write.
+*
+* @return Returns 0 in case of success or negative error code.
+******************************************************************************/
+int32_t REGMAP_BulkWrite(stRegmap* pMap, uint32_t addr, const uint8_t* data, uint32_t count)
+{
+	uint8_t buf[REGMAP_MAX_TRANSFER];
+	uint32_t chunk;
+	uint32_t top;
+	uint32_t cnt;
+	uint32_t i;
+	int32_t ret;
+
+	/* Each chunk is sent in a single transfer when the device allows it */
+	chunk = pMap->pConfig->maxWrite;
+	if(chunk > REGMAP_MAX_TRANSFER)
+	{
+		chunk = REGMAP_MAX_TRANSFER;
+	}
+	top = addr + count - 1;
+	while(count > 0)
+	{
+		cnt = (count > chunk) ? chunk : count;
+		for(i = 0; i < cnt; i++)
+		{
+			buf[i] = data[top - i - addr];
+		}
+		ret = REGMAP_RawWrite(pMap, top, buf, cnt);
+		if(ret < 0)
+		{
+			return ret;
+		}
+		top   -= cnt;
+		count -= cnt;
+	}
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Drops all the cached register values, the next reads are made from
+*        the device. Must be called after a reset of the device.
+*
+* @param pMap - Register map.
+*
+* @return None.
+******************************************************************************/
+void REGMAP_CacheInvalidate(stRegmap* pMap)
+{
+	uint32_t i;
+
+	if(pMap->cache == 0)
+	{
+		return;
+	}
+	for(i = 0; i < REGMAP_BITMAP_SIZE(pMap->pConfig->numRegs); i++)
+	{
+		pMap->cacheValid[i] = 0;
+	}
+}
+
+/**************************************************************************//**
+* @brief Updates the register map state after a reset of the device. The
+*        cached values are dropped and the registers of the reset values
+*        table are considered to hold their reset value, the writes which
+*        would not change them are skipped until they receive another value.
+*        With REGMAP_VERIFY_DEFAULTS the registers are read back first and
+*        the ones which do not match the table are always written.
+*
+* @param pMap - Register map.
+*
+* @return Returns 0 in case of success or negative error code.
+******************************************************************************/
+int32_t REGMAP_Reset(stRegmap* pMap)
+{
+	const stRegmapConfig* pCfg = pMap->pConfig;
+	const stRegmapDefault* pRange;
+	uint32_t idx = 0;
+	uint32_t i;
+	uint32_t j;
+#ifdef REGMAP_VERIFY_DEFAULTS
+	uint32_t value;
+	int32_t ret;
+#endif
+
+	REGMAP_CacheInvalidate(pMap);
+	if(pMap->atReset == 0)
+	{
+		return 0;
+	}
+	for(i = 0; i < pCfg->numDefaults; i++)
+	{
+		pRange = &pCfg->defaults[i];
+		for(j = 0; j < pRange->count; j++, idx++)
+		{
+			REGMAP_BIT_CLEAR(pMap->atReset, idx);
+#ifdef REGMAP_VERIFY_DEFAULTS
+			ret = REGMAP_Read(pMap, pRange->addr + j, 1, &value);
+			if(ret < 0)
+			{
+				return ret;
+			}
+			if(value != pRange->value)
+			{
+				continue;
+			}
+#endif
+			REGMAP_BIT_SET(pMap->atReset, idx);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,117 @@
+/**************************************************************************//**
+*   @file   adc_analysis.h
+*   @brief  Captured ADC data analysis header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __ADC_ANALYSIS_H__
+#define __ADC_ANALYSIS_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* The analysis is built only if ADC_ANALYSIS_EN is defined, it needs about
+   9 bytes of RAM per point of ANALYSIS_MAX_POINTS. */
+
+/* Maximum number of FFT points */
+#ifndef ANALYSIS_MAX_POINTS
+#define ANALYSIS_MAX_POINTS		4096
+#endif
+
+/* Number of bins on each side of a tone which belong to the tone. The
+   Blackman-Harris window leaks less than -92 dB past its main lobe of 4 bins. */
+#ifndef ANALYSIS_TONE_SPAN
+#define ANALYSIS_TONE_SPAN		5
+#endif
+
+/* Layouts of the captured data, two 16 bit lanes per 32 bit word */
+#define ANALYSIS_LAYOUT_SINGLE	0	/*!< Successive samples of one channel (AD9467) */
+#define ANALYSIS_LAYOUT_DUAL	1	/*!< One channel per lane (AD9250, AD6673) */
+#define ANALYSIS_LAYOUT_IQ		2	/*!< I in the low lane, Q in the high lane (AD9643) */
+
+/* Formats of the samples */
+#define ANALYSIS_OFFSET_BINARY	0
+#define ANALYSIS_TWOS_COMPLEMENT	1
+
+/*****************************************************************************/
+/************************ Types Declarations *********************************/
+/*****************************************************************************/
+typedef struct _stAnalysisConfig
+{
+	uint32_t	layout;		/*!< ANALYSIS_LAYOUT_x */
+	uint32_t	width;		/*!< Resolution of the samples in bits */
+	uint32_t	shift;		/*!< Position of the samples in the lanes */
+	uint32_t	format;		/*!< ANALYSIS_OFFSET_BINARY or ANALYSIS_TWOS_COMPLEMENT */
+	uint32_t	channel;	/*!< Lane analyzed with ANALYSIS_LAYOUT_DUAL */
+	uint32_t	points;		/*!< FFT points, a power of 2 up to ANALYSIS_MAX_POINTS */
+	uint32_t	harmonics;	/*!< Highest harmonic counted as distortion */
+}stAnalysisConfig;
+
+/* The levels are in 0.01 dB, the DC offset in 0.01 LSB and the ENOB in 0.01
+   bit, as xil_printf has no floating point support. */
+typedef struct _stAnalysisResult
+{
+	int32_t		dcOffset[2];	/*!< Mean of the samples, I and Q for ANALYSIS_LAYOUT_IQ */
+	uint32_t	fundBin;		/*!< Bin of the fundamental */
+	int32_t		fundDbfs;		/*!< Level of the fundamental in dBFS */
+	int32_t		snr;			/*!< Signal to noise ratio in dB */
+	int32_t		sinad;			/*!< Signal to noise and distortion ratio in dB */
+	uint32_t	spurBin;		/*!< Bin of the largest spur */
+	int32_t		sfdr;			/*!< Spurious free dynamic range in dBc */
+	int32_t		enob;			/*!< Effective number of bits */
+}stAnalysisResult;
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+#ifdef ADC_ANALYSIS_EN
+/** Analyzes a captured buffer */
+int32_t ANALYSIS_Run(stAnalysisConfig* cfg, uint32_t address,
+					 stAnalysisResult* result);
+/** Prints the result of an analysis over UART */
+void ANALYSIS_Print(stAnalysisResult* result);
+#endif
+
+#endif /* __ADC_ANALYSIS_H__ */
@@ -0,0 +1,629 @@
+/**************************************************************************//**
+*   @file   adc_chan.c
+*   @brief  Polyphase filter bank channelizer implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "adc_chan.h"
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+#ifdef ADC_CHAN_EN
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Fixed point one, pi and 2*pi in Q30 */
+#define CHAN_ONE_Q30			(1LL << 30)
+#define CHAN_PI_Q30				3373259426LL
+#define CHAN_2PI_Q30			6746518852LL
+
+/* Blackman window coefficients in Q30 */
+#define CHAN_BLACKMAN_A0		450971566LL
+#define CHAN_BLACKMAN_A1		536870912LL
+#define CHAN_BLACKMAN_A2		85899346LL
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+/* Quarter wave cosine table of the largest FFT in Q30, the smaller FFTs
+   read it with a stride */
+static int32_t chanCos[CHAN_MAX_POINTS / 4 + 1];
+static uint32_t chanCosValid = 0;
+
+/**************************************************************************//**
+* @brief Computes the cosine and the sine of 2 * pi / points with the Taylor
+*        series, in Q30.
+*
+* @param points - Number of steps per period.
+* @param cosStep - The cosine.
+* @param sinStep - The sine.
+*
+* @return None.
+******************************************************************************/
+static void CHAN_Step(uint32_t points, int64_t* cosStep, int64_t* sinStep)
+{
+	int64_t x;
+	int64_t x2;
+	int64_t term;
+	uint32_t i;
+
+	x  = CHAN_2PI_Q30 / points;
+	x2 = (x * x) >> 30;
+	*cosStep = CHAN_ONE_Q30;
+	*sinStep = x;
+	term = CHAN_ONE_Q30;
+	for(i = 1; i <= 4; i++)
+	{
+		term = -((term * x2) >> 30) / ((2 * i - 1) * (2 * i));
+		*cosStep += term;
+	}
+	term = x;
+	for(i = 1; i <= 4; i++)
+	{
+		term = -((term * x2) >> 30) / ((2 * i) * (2 * i + 1));
+		*sinStep += term;
+	}
+}
+
+/**************************************************************************//**
+* @brief Rotates a vector in Q30 by a step computed with CHAN_Step.
+*
+* @param c - The cosine of the vector.
+* @param s - The sine of the vector.
+* @param cosStep - The cosine of the step.
+* @param sinStep - The sine of the step.
+*
+* @return None.
+******************************************************************************/
+static void CHAN_Rotate(int64_t* c, int64_t* s, int64_t cosStep, int64_t sinStep)
+{
+	int64_t t;
+
+	t  = ((*c * cosStep) - (*s * sinStep) + (1LL << 29)) >> 30;
+	*s = ((*s * cosStep) + (*c * sinStep) + (1LL << 29)) >> 30;
+	*c = t;
+}
+
+/**************************************************************************//**
+* @brief Builds the quarter wave cosine table, with rotations so no floating
+*        point library is needed.
+*
+* @return None.
+******************************************************************************/
+static void CHAN_InitCos(void)
+{
+	int64_t cosStep;
+	int64_t sinStep;
+	int64_t c;
+	int64_t s;
+	uint32_t i;
+
+	if(chanCosValid)
+	{
+		return;
+	}
+	CHAN_Step(CHAN_MAX_POINTS, &cosStep, &sinStep);
+	c = CHAN_ONE_Q30;
+	s = 0;
+	for(i = 0; i < CHAN_MAX_POINTS / 4; i++)
+	{
+		chanCos[i] = (int32_t)c;
+		CHAN_Rotate(&c, &s, cosStep, sinStep);
+	}
+	chanCos[CHAN_MAX_POINTS / 4] = 0;
+	chanCosValid = 1;
+}
+
+/**************************************************************************//**
+* @brief Gets cos(2 * pi * idx / CHAN_MAX_POINTS) from the quarter wave table.
+*
+* @param idx - Phase index.
+*
+* @return The cosine in Q30.
+******************************************************************************/
+static int32_t CHAN_Cos(uint32_t idx)
+{
+	uint32_t q = CHAN_MAX_POINTS / 4;
+
+	idx &= (CHAN_MAX_POINTS - 1);
+	if(idx <= q)
+	{
+		return chanCos[idx];
+	}
+	if(idx <= 2 * q)
+	{
+		return -chanCos[2 * q - idx];
+	}
+	if(idx <= 3 * q)
+	{
+		return -chanCos[idx - 2 * q];
+	}
+
+	return chanCos[CHAN_MAX_POINTS - idx];
+}
+
+/**************************************************************************//**
+* @brief Builds the prototype low pass filter: a sinc with its first zero at
+*        the channel spacing, shaped by a Blackman window. Adjacent channels
+*        cross at -6 dB, the pass band is flat within 0.1 dB up to a quarter
+*        of the spacing and the stop band is 75 dB down from 0.9 of the
+*        spacing.
+*
+* @param chan - The channelizer.
+*
+* @return The sum of the taps.
+******************************************************************************/
+static int64_t CHAN_InitProto(stChan* chan)
+{
+	int64_t sincCos;
+	int64_t sincSin;
+	int64_t winCos;
+	int64_t winSin;
+	int64_t sc;
+	int64_t ss = 0;
+	int64_t wc = CHAN_ONE_Q30;
+	int64_t ws = 0;
+	int64_t sinc;
+	int64_t win;
+	int64_t x;
+	int64_t sum = 0;
+	int32_t n;
+	uint32_t j;
+
+	/* The sinc starts CHAN_TAPS / 2 periods before its center, so its
+	   numerator starts at sin(0), going up or down */
+	sc = ((CHAN_TAPS / 2) & 1) ? -CHAN_ONE_Q30 : CHAN_ONE_Q30;
+	CHAN_Step(2 * chan->points, &sincCos, &sincSin);
+	CHAN_Step(chan->length, &winCos, &winSin);
+	for(j = 0; j < chan->length; j++)
+	{
+		n = (int32_t)j - (int32_t)(chan->length / 2);
+		if(n == 0)
+		{
+			sinc = CHAN_ONE_Q30;
+		}
+		else
+		{
+			x = (CHAN_PI_Q30 * n) / (int32_t)chan->points;
+			sinc = (ss << 30) / x;
+		}
+		/* cos(2x) = 2 * cos(x)^2 - 1 */
+		win = CHAN_BLACKMAN_A0 - ((CHAN_BLACKMAN_A1 * wc) >> 30) +
+			  ((CHAN_BLACKMAN_A2 * (((wc * wc) >> 29) - CHAN_ONE_Q30)) >> 30);
+		chan->proto[j] = (int16_t)(((sinc * win) >> 30) >> 16);
+		sum += chan->proto[j];
+		CHAN_Rotate(&sc, &ss, sincCos, sincSin);
+		CHAN_Rotate(&wc, &ws, winCos, winSin);
+	}
+
+	return sum;
+}
+
+/**************************************************************************//**
+* @brief Clears the filter state of a channelizer.
+*
+* @param chan - The channelizer.
+*
+* @return None.
+******************************************************************************/
+void CHAN_Reset(stChan* chan)
+{
+	uint32_t i;
+
+	for(i = 0; i < 2 * chan->length; i++)
+	{
+		chan->line[i] = 0;
+	}
+	for(i = 0; i < chan->channels; i++)
+	{
+		chan->power[i] = 0;
+	}
+	chan->linePos = 0;
+	chan->fill = 0;
+	chan->half = 0;
+	chan->frame = 0;
+	chan->powerCnt = 0;
+}
+
+/**************************************************************************//**
+* @brief Configures a channelizer. An FFT of N points gives N / 2 channels
+*        spaced by fs / N from DC, so channel k is centered on k * fs / N.
+*        The channels are decimated by N, or by N / 2 when oversampled. The
+*        gain is 1 in the pass band, so a full scale tone at the center of a
+*        channel comes out at half of the 16 bit full scale.
+*
+* @param chan - The channelizer.
+* @param cfg - FFT size, oversampling, resolution and output.
+*
+* @return 0 in case of success, -1 if the configuration is not supported.
+******************************************************************************/
+int32_t CHAN_Init(stChan* chan, stChanConfig* cfg)
+{
+	int64_t sum;
+
+	if((cfg->points < CHAN_MIN_POINTS) || (cfg->points > CHAN_MAX_POINTS) ||
+	   (cfg->points & (cfg->points - 1)) ||
+	   ((cfg->oversample != 1) && (cfg->oversample != 2)) ||
+	   (cfg->width < 2) || (cfg->width > 16) ||
+	   (cfg->output > CHAN_OUT_POWER) ||
+	   ((cfg->output == CHAN_OUT_POWER) && !cfg->average))
+	{
+		return -1;
+	}
+	CHAN_InitCos();
+
+	chan->points = cfg->points;
+	chan->channels = cfg->points / 2;
+	chan->decimation = cfg->points / cfg->oversample;
+	chan->length = cfg->points * CHAN_TAPS;
+	chan->output = cfg->output;
+	chan->average = cfg->average;
+
+	/* The branch outputs keep 16 bits for any resolution, the taps sum to
+	   less than 2 in Q14 on each branch */
+	chan->vShift = cfg->width - 2;
+	sum = CHAN_InitProto(chan);
+	chan->outGain = (int32_t)((1LL << 44) / sum);
+	CHAN_Reset(chan);
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Runs the polyphase filter on the delay line. With NEON eight
+*        branches are filtered at a time, the sums are kept in registers over
+*        the taps. The FFT size is a multiple of 8, so no branch is left over.
+*
+* @param chan - The channelizer.
+* @param v - Output of each branch.
+*
+* @return None.
+******************************************************************************/
+static void CHAN_Branches(stChan* chan, int32_t* v)
+{
+	const int16_t* line = &chan->line[chan->linePos];
+	const int16_t* h;
+	const int16_t* x;
+	uint32_t p;
+	uint32_t t;
+#ifdef __ARM_NEON__
+	const int32x4_t shift = vdupq_n_s32(-(int32_t)chan->vShift);
+	int16x8_t taps;
+	int16x8_t samples;
+	int32x4_t lo;
+	int32x4_t hi;
+
+	for(p = 0; p < chan->points; p += 8)
+	{
+		lo = vdupq_n_s32(0);
+		hi = vdupq_n_s32(0);
+		for(t = 0; t < CHAN_TAPS; t++)
+		{
+			h = &chan->proto[t * chan->points + p];
+			x = &line[t * chan->points + p];
+			taps = vld1q_s16(h);
+			samples = vld1q_s16(x);
+			lo = vmlal_s16(lo, vget_low_s16(taps), vget_low_s16(samples));
+			hi = vmlal_s16(hi, vget_high_s16(taps), vget_high_s16(samples));
+		}
+		vst1q_s32(&v[p], vshlq_s32(lo, shift));
+		vst1q_s32(&v[p + 4], vshlq_s32(hi, shift));
+	}
+#else
+	for(p = 0; p < chan->points; p++)
+	{
+		v[p] = 0;
+	}
+	for(t = 0; t < CHAN_TAPS; t++)
+	{
+		h = &chan->proto[t * chan->points];
+		x = &line[t * chan->points];
+		for(p = 0; p < chan->points; p++)
+		{
+			v[p] += h[p] * x[p];
+		}
+	}
+	for(p = 0; p < chan->points; p++)
+	{
+		v[p] >>= chan->vShift;
+	}
+#endif
+}
+
+/**************************************************************************//**
+* @brief In place radix-4 FFT of the frame buffers, with a radix-2 first
+*        stage when the size is an odd power of 2. The input is put in bit
+*        reversed order, so the 4 inputs of a butterfly are the sub
+*        transforms of the residues 0, 2, 1 and 3. The samples have a margin
+*        for the growth, so the stages are not scaled.
+*
+* @param chan - The channelizer.
+*
+* @return None.
+******************************************************************************/
+static void CHAN_Fft(stChan* chan)
+{
+	int32_t* re = chan->re;
+	int32_t* im = chan->im;
+	uint32_t points = chan->points;
+	uint32_t stride;
+	uint32_t bits = 0;
+	uint32_t h;
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+	uint32_t r;
+	int32_t ar[4];
+	int32_t ai[4];
+	int32_t wr;
+	int32_t wi;
+	int32_t tr;
+	int32_t ti;
+
+	for(i = 1, j = 0; i < points; i++)
+	{
+		k = points >> 1;
+		while(j & k)
+		{
+			j ^= k;
+			k >>= 1;
+		}
+		j |= k;
+		if(i < j)
+		{
+			tr = re[i];
+			re[i] = re[j];
+			re[j] = tr;
+			ti = im[i];
+			im[i] = im[j];
+			im[j] = ti;
+		}
+	}
+	for(k = points; k > 1; k >>= 1)
+	{
+		bits++;
+	}
+	h = 1;
+	if(bits & 1)
+	{
+		for(i = 0; i < points; i += 2)
+		{
+			tr = re[i + 1];
+			ti = im[i + 1];
+			re[i + 1] = re[i] - tr;
+			im[i + 1] = im[i] - ti;
+			re[i] += tr;
+			im[i] += ti;
+		}
+		h = 2;
+	}
+	for(; h < points; h <<= 2)
+	{
+		stride = CHAN_MAX_POINTS / (4 * h);
+		for(k = 0; k < h; k++)
+		{
+			for(i = k; i < points; i += 4 * h)
+			{
+				ar[0] = re[i];
+				ai[0] = im[i];
+				/* Residue 1 is in the third block, residue 2 in the second */
+				for(r = 1; r < 4; r++)
+				{
+					j = i + ((r == 1) ? 2 : ((r == 2) ? 1 : 3)) * h;
+					wr = CHAN_Cos(r * k * stride);
+					wi = -CHAN_Cos(r * k * stride + 3 * (CHAN_MAX_POINTS / 4));
+					ar[r] = (int32_t)((((int64_t)re[j] * wr) -
+									   ((int64_t)im[j] * wi)) >> 30);
+					ai[r] = (int32_t)((((int64_t)re[j] * wi) +
+									   ((int64_t)im[j] * wr)) >> 30);
+				}
+				/* 4 point DFT, X[k + m * h] of the transform of size 4 * h */
+				tr = ar[0] + ar[2];
+				ti = ai[0] + ai[2];
+				re[i] = tr + ar[1] + ar[3];
+				im[i] = ti + ai[1] + ai[3];
+				re[i + 2 * h] = tr - ar[1] - ar[3];
+				im[i + 2 * h] = ti - ai[1] - ai[3];
+				tr = ar[0] - ar[2];
+				ti = ai[0] - ai[2];
+				/* -j * (a1 - a3) and +j * (a1 - a3) */
+				re[i + h] = tr + (ai[1] - ai[3]);
+				im[i + h] = ti - (ar[1] - ar[3]);
+				re[i + 3 * h] = tr - (ai[1] - ai[3]);
+				im[i + 3 * h] = ti + (ar[1] - ar[3]);
+			}
+		}
+	}
+}
+
+/**************************************************************************//**
+* @brief Saturates a value to 16 bits.
+*
+* @param x - The value.
+*
+* @return The saturated value.
+******************************************************************************/
+static int16_t CHAN_Sat16(int64_t x)
+{
+	if(x > 32767)
+	{
+		return 32767;
+	}
+	if(x < -32768)
+	{
+		return -32768;
+	}
+
+	return (int16_t)x;
+}
+
+/**************************************************************************//**
+* @brief Separates the two frames of the FFT and writes their channels. The
+*        even frame was in the real part and the odd frame in the imaginary
+*        part, so the transform of each frame comes from the bins k and N - k.
+*        The filter bank output of channel k is the conjugate of bin k. When
+*        oversampled, the frames start N / 2 samples apart and the odd frames
+*        of the odd channels are negated to keep the phase continuous.
+*
+* @param chan - The channelizer.
+* @param out - Output words.
+*
+* @return Number of output words.
+******************************************************************************/
+static uint32_t CHAN_Output(stChan* chan, uint32_t* out)
+{
+	int32_t* re = chan->re;
+	int32_t* im = chan->im;
+	int64_t yr;
+	int64_t yi;
+	int16_t sr;
+	int16_t si;
+	uint32_t words = 0;
+	uint32_t f;
+	uint32_t k;
+	uint32_t m;
+	uint32_t flip;
+
+	for(f = 0; f < 2; f++)
+	{
+		flip = (chan->decimation != chan->points) && ((chan->frame + f) & 1);
+		for(k = 0; k < chan->channels; k++)
+		{
+			m = (chan->points - k) & (chan->points - 1);
+			if(f == 0)
+			{
+				yr = (int64_t)re[k] + re[m];
+				yi = -((int64_t)im[k] - im[m]);
+			}
+			else
+			{
+				yr = (int64_t)im[k] + im[m];
+				yi = (int64_t)re[k] - re[m];
+			}
+			if(flip && (k & 1))
+			{
+				yr = -yr;
+				yi = -yi;
+			}
+			/* The separation doubled the values */
+			sr = CHAN_Sat16(((yr * chan->outGain) + (1LL << 30)) >> 31);
+			si = CHAN_Sat16(((yi * chan->outGain) + (1LL << 30)) >> 31);
+			if(chan->output == CHAN_OUT_IQ)
+			{
+				out[words++] = ((uint32_t)(uint16_t)sr) |
+							   ((uint32_t)(uint16_t)si << 16);
+			}
+			else
+			{
+				chan->power[k] += (uint32_t)(sr * sr) + (uint32_t)(si * si);
+			}
+		}
+		if((chan->output == CHAN_OUT_POWER) && (++chan->powerCnt == chan->average))
+		{
+			for(k = 0; k < chan->channels; k++)
+			{
+				out[words++] = (uint32_t)(chan->power[k] / chan->average);
+				chan->power[k] = 0;
+			}
+			chan->powerCnt = 0;
+		}
+	}
+	chan->frame += 2;
+
+	return words;
+}
+
+/**************************************************************************//**
+* @brief Channelizes a block of samples of one channel. A frame is computed
+*        every N or N / 2 input samples, two frames share one FFT. With
+*        CHAN_OUT_IQ each frame writes one word per channel, I in the low 16
+*        bits and Q in the high 16 bits, so channel k of frame f is the word
+*        f * N / 2 + k. With CHAN_OUT_POWER the power of each channel, in
+*        square LSBs of the I/Q outputs, is written once per average frames.
+*        The state is kept between the calls, so a stream can be processed in
+*        blocks of any size.
+*
+* @param chan - The channelizer.
+* @param in - Sign extended samples of the channel, as written by
+*             adc_deinterleave().
+* @param count - Number of samples.
+* @param out - Output words, with room for
+*              CHAN_MAX_OUTPUT(count, points, oversample) words.
+*
+* @return Number of output words.
+******************************************************************************/
+uint32_t CHAN_Process(stChan* chan, const int16_t* in, uint32_t count,
+					  uint32_t* out)
+{
+	uint32_t words = 0;
+	uint32_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		chan->linePos = chan->linePos ? (chan->linePos - 1) : (chan->length - 1);
+		chan->line[chan->linePos] = in[i];
+		chan->line[chan->linePos + chan->length] = in[i];
+		if(++chan->fill < chan->decimation)
+		{
+			continue;
+		}
+		chan->fill = 0;
+		if(!chan->half)
+		{
+			CHAN_Branches(chan, chan->re);
+			chan->half = 1;
+			continue;
+		}
+		CHAN_Branches(chan, chan->im);
+		chan->half = 0;
+		CHAN_Fft(chan);
+		words += CHAN_Output(chan, out + words);
+	}
+
+	return words;
+}
+
+#endif
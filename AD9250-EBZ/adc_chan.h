@@ -0,0 +1,129 @@
+/**************************************************************************//**
+*   @file   adc_chan.h
+*   @brief  Polyphase filter bank channelizer header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __ADC_CHAN_H__
+#define __ADC_CHAN_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* The channelizer is built only if ADC_CHAN_EN is defined. A channelizer
+   needs 6 * CHAN_TAPS + 12 bytes of RAM per point of CHAN_MAX_POINTS. */
+
+/* Maximum FFT size, the channelizer has half as many channels */
+#ifndef CHAN_MAX_POINTS
+#define CHAN_MAX_POINTS			512
+#endif
+
+/* Minimum FFT size */
+#define CHAN_MIN_POINTS			16
+
+/* Taps of each branch of the polyphase filter, an even number */
+#ifndef CHAN_TAPS
+#define CHAN_TAPS				8
+#endif
+
+/* Outputs of the channelizer */
+#define CHAN_OUT_IQ				0	/*!< Decimated I/Q samples of each channel */
+#define CHAN_OUT_POWER			1	/*!< Average power of each channel */
+
+/* Maximum number of words written by CHAN_Process for a number of input
+   samples. The FFT runs on pairs of frames, so up to two frames come out
+   at once. */
+#define CHAN_MAX_OUTPUT(count, points, oversample) \
+	((((count) * (oversample)) / (points) + 2) * ((points) / 2))
+
+/*****************************************************************************/
+/************************ Types Declarations *********************************/
+/*****************************************************************************/
+typedef struct _stChanConfig
+{
+	uint32_t	points;		/*!< FFT size, a power of 2 up to CHAN_MAX_POINTS */
+	uint32_t	oversample;	/*!< 1 for critical sampling, 2 for 2x oversampling */
+	uint32_t	width;		/*!< Resolution of the input samples in bits */
+	uint32_t	output;		/*!< CHAN_OUT_IQ or CHAN_OUT_POWER */
+	uint32_t	average;	/*!< Frames averaged by CHAN_OUT_POWER */
+}stChanConfig;
+
+typedef struct _stChan
+{
+	uint32_t	points;			/*!< FFT size */
+	uint32_t	channels;		/*!< Channels, half of the FFT size */
+	uint32_t	decimation;		/*!< Input samples per frame */
+	uint32_t	length;			/*!< Taps of the prototype filter */
+	uint32_t	output;			/*!< CHAN_OUT_IQ or CHAN_OUT_POWER */
+	uint32_t	average;		/*!< Frames per power output */
+	uint32_t	vShift;			/*!< Scaling of the branch outputs */
+	int32_t		outGain;		/*!< Output gain in Q30 */
+	uint32_t	linePos;		/*!< Newest sample of the delay line */
+	uint32_t	fill;			/*!< Input samples of the current frame */
+	uint32_t	half;			/*!< A frame waits in the imaginary part */
+	uint32_t	frame;			/*!< Frames computed */
+	uint32_t	powerCnt;		/*!< Frames in the power accumulators */
+	int16_t		proto[CHAN_MAX_POINTS * CHAN_TAPS];		/*!< Prototype filter in Q14 */
+	int16_t		line[2 * CHAN_MAX_POINTS * CHAN_TAPS];	/*!< Delay line */
+	int32_t		re[CHAN_MAX_POINTS];	/*!< FFT buffer, even frames */
+	int32_t		im[CHAN_MAX_POINTS];	/*!< FFT buffer, odd frames */
+	uint64_t	power[CHAN_MAX_POINTS / 2];	/*!< Power accumulators */
+}stChan;
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+#ifdef ADC_CHAN_EN
+/** Configures a channelizer */
+int32_t CHAN_Init(stChan* chan, stChanConfig* cfg);
+/** Clears the filter state of a channelizer */
+void CHAN_Reset(stChan* chan);
+/** Channelizes a block of samples of one channel */
+uint32_t CHAN_Process(stChan* chan, const int16_t* in, uint32_t count,
+					  uint32_t* out);
+#endif
+
+#endif /* __ADC_CHAN_H__ */
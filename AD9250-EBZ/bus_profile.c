@@ -0,0 +1,315 @@
+/**************************************************************************//**
+*   @file   bus_profile.c
+*   @brief  Bus transaction profiler implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "bus_profile.h"
+
+#ifdef BUS_PROFILE_EN
+
+extern void xil_printf(const char *ctrl1, ...);
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+typedef struct _stProfileEntry
+{
+	uint32_t	bus;		/*!< Bus type */
+	uint32_t	dev;		/*!< Device select or I2C address */
+	const char*	name;		/*!< Calling function, NULL for device entries */
+	uint32_t	count;		/*!< Number of transactions */
+	uint32_t	bytes;		/*!< Number of bytes transferred */
+	uint64_t	timeUs;		/*!< Accumulated bus time in us */
+}stProfileEntry;
+
+typedef struct _stProfilePhase
+{
+	const char*	name;		/*!< Name of the phase */
+	uint64_t	startUs;	/*!< Time at which the phase was opened */
+	uint32_t	timeUs;		/*!< Duration of the phase in us */
+	uint32_t	startCnt;	/*!< Bus transactions before the phase was opened */
+	uint32_t	count;		/*!< Bus transactions during the phase */
+}stProfilePhase;
+
+static stProfileEntry profileDevices[PROFILE_MAX_DEVICES];
+static stProfileEntry profileContexts[PROFILE_MAX_CONTEXTS];
+static uint32_t profileDeviceCnt = 0;
+static uint32_t profileContextCnt = 0;
+static uint32_t profileDropped = 0;
+static const char* profileContext = "other";
+static stProfilePhase profilePhases[PROFILE_MAX_PHASES];
+static uint32_t profilePhaseCnt = 0;
+static uint32_t profilePhaseOpen = 0;
+static uint32_t profilePhaseDropped = 0;
+static uint32_t profileTransCnt = 0;
+
+static const char* profileBusName[] = {"SPI", "I2C"};
+
+/**************************************************************************//**
+* @brief Sets the function to which the following bus transactions are
+*        attributed. The context stays active until it is set again.
+*
+* @param name - Name of the calling function.
+*
+* @return None.
+******************************************************************************/
+void PROFILE_SetContext(const char* name)
+{
+	profileContext = name;
+}
+
+/**************************************************************************//**
+* @brief Adds a transaction to an entry of a profiling table. A new entry is
+*        created if no entry matches.
+*
+* @param table - Profiling table.
+* @param pCnt - Number of used entries in the table.
+* @param size - Number of entries in the table.
+* @param bus - Bus type.
+* @param dev - Device select or I2C address.
+* @param name - Calling function, NULL for the device table.
+* @param bytes - Number of bytes transferred.
+* @param timeUs - Duration of the transaction in us.
+*
+* @return None.
+******************************************************************************/
+static void PROFILE_AddEntry(stProfileEntry* table, uint32_t* pCnt, uint32_t size,
+							 uint32_t bus, uint32_t dev, const char* name,
+							 uint32_t bytes, uint32_t timeUs)
+{
+	uint32_t i;
+
+	for(i = 0; i < *pCnt; i++)
+	{
+		if((table[i].bus == bus) && (table[i].dev == dev) && (table[i].name == name))
+		{
+			break;
+		}
+	}
+	if(i == *pCnt)
+	{
+		if(*pCnt == size)
+		{
+			profileDropped++;
+			return;
+		}
+		table[i].bus    = bus;
+		table[i].dev    = dev;
+		table[i].name   = name;
+		table[i].count  = 0;
+		table[i].bytes  = 0;
+		table[i].timeUs = 0;
+		(*pCnt)++;
+	}
+	table[i].count++;
+	table[i].bytes  += bytes;
+	table[i].timeUs += timeUs;
+}
+
+/**************************************************************************//**
+* @brief Records a bus transaction for its device and for the active context.
+*
+* @param bus - Bus type.
+* @param dev - Device select or I2C address.
+* @param bytes - Number of bytes transferred.
+* @param timeUs - Duration of the transaction in us.
+*
+* @return None.
+******************************************************************************/
+void PROFILE_Record(uint32_t bus, uint32_t dev, uint32_t bytes, uint32_t timeUs)
+{
+	PROFILE_AddEntry(profileDevices, &profileDeviceCnt, PROFILE_MAX_DEVICES,
+					 bus, dev, NULL, bytes, timeUs);
+	PROFILE_AddEntry(profileContexts, &profileContextCnt, PROFILE_MAX_CONTEXTS,
+					 bus, 0, profileContext, bytes, timeUs);
+	profileTransCnt++;
+}
+
+/**************************************************************************//**
+* @brief Returns the number of bus transactions recorded since the last
+*        PROFILE_Reset, the tables being full or not.
+*
+* @return Number of transactions.
+******************************************************************************/
+uint32_t PROFILE_GetTransCount(void)
+{
+	return profileTransCnt;
+}
+
+/**************************************************************************//**
+* @brief Clears the profiling data.
+*
+* @return None.
+******************************************************************************/
+void PROFILE_Reset(void)
+{
+	profileDeviceCnt = 0;
+	profileContextCnt = 0;
+	profileDropped = 0;
+	profilePhaseCnt = 0;
+	profilePhaseOpen = 0;
+	profilePhaseDropped = 0;
+	profileTransCnt = 0;
+}
+
+/**************************************************************************//**
+* @brief Prints the profiling data over UART, one table per device and one
+*        table per calling function.
+*
+* @return None.
+******************************************************************************/
+void PROFILE_Dump(void)
+{
+	uint32_t i;
+
+	xil_printf("\n\rBus  Device      Count      Bytes    Time[us]\n\r");
+	for(i = 0; i < profileDeviceCnt; i++)
+	{
+		xil_printf("%s  0x%02x   %10d %10d %11d\n\r",
+				   profileBusName[profileDevices[i].bus],
+				   profileDevices[i].dev,
+				   profileDevices[i].count,
+				   profileDevices[i].bytes,
+				   (uint32_t)profileDevices[i].timeUs);
+	}
+	xil_printf("\n\rBus  Function\n\r");
+	for(i = 0; i < profileContextCnt; i++)
+	{
+		xil_printf("%s  %s\n\r     %18d %10d %11d\n\r",
+				   profileBusName[profileContexts[i].bus],
+				   profileContexts[i].name,
+				   profileContexts[i].count,
+				   profileContexts[i].bytes,
+				   (uint32_t)profileContexts[i].timeUs);
+	}
+	if(profileDropped)
+	{
+		xil_printf("%d transactions not tracked, tables full\n\r", profileDropped);
+	}
+}
+
+/**************************************************************************//**
+* @brief Closes the running boot phase and opens a new one. The phases are
+*        not nested, a marker placed at the start of each stage is enough;
+*        a phase left open by an early return is closed by the next marker.
+*
+* @param name - Name of the new phase, NULL to only close the running one.
+*
+* @return None.
+******************************************************************************/
+void PROFILE_PhaseMark(const char* name)
+{
+	uint64_t now = TIMER_GetTimeUs();
+	stProfilePhase* pPhase;
+
+	if(profilePhaseOpen)
+	{
+		pPhase = &profilePhases[profilePhaseCnt - 1];
+		pPhase->timeUs = (uint32_t)(now - pPhase->startUs);
+		pPhase->count  = profileTransCnt - pPhase->startCnt;
+		profilePhaseOpen = 0;
+	}
+	if(name == NULL)
+	{
+		return;
+	}
+	if(profilePhaseCnt == PROFILE_MAX_PHASES)
+	{
+		profilePhaseDropped++;
+		return;
+	}
+	pPhase = &profilePhases[profilePhaseCnt++];
+	pPhase->name     = name;
+	pPhase->startUs  = now;
+	pPhase->timeUs   = 0;
+	pPhase->startCnt = profileTransCnt;
+	pPhase->count    = 0;
+	profilePhaseOpen = 1;
+}
+
+/**************************************************************************//**
+* @brief Closes the running boot phase and prints the boot phases over UART,
+*        sorted by duration, with the bus transactions of each phase.
+*
+* @return None.
+******************************************************************************/
+void PROFILE_PhaseDump(void)
+{
+	uint8_t  order[PROFILE_MAX_PHASES];
+	uint32_t totalUs = 0;
+	uint32_t i;
+	uint32_t j;
+	uint8_t  idx;
+
+	PROFILE_PhaseMark(NULL);
+	/* Insertion sort of the phase indexes, longest phase first */
+	for(i = 0; i < profilePhaseCnt; i++)
+	{
+		idx = (uint8_t)i;
+		for(j = i; (j > 0) &&
+			(profilePhases[order[j - 1]].timeUs < profilePhases[idx].timeUs); j--)
+		{
+			order[j] = order[j - 1];
+		}
+		order[j] = idx;
+		totalUs += profilePhases[i].timeUs;
+	}
+	xil_printf("\n\rPhase                       Time[us]   Percent  Transactions\n\r");
+	for(i = 0; i < profilePhaseCnt; i++)
+	{
+		xil_printf("%-24s %11d %9d %13d\n\r",
+				   profilePhases[order[i]].name,
+				   profilePhases[order[i]].timeUs,
+				   totalUs ? (uint32_t)((uint64_t)profilePhases[order[i]].timeUs *
+										100 / totalUs) : 0,
+				   profilePhases[order[i]].count);
+	}
+	xil_printf("Total                    %11d\n\r", totalUs);
+	if(profilePhaseDropped)
+	{
+		xil_printf("%d phases not tracked, table full\n\r", profilePhaseDropped);
+	}
+}
+
+#endif /* BUS_PROFILE_EN */
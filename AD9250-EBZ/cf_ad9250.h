@@ -46,6 +46,10 @@
 /******************************************************************************/
 #include <stdint.h>
 #include "xparameters.h"
+#include "adc_ddc.h"
+#include "adc_chan.h"
+#include "adc_recorder.h"
+#include "jesd_margin.h"
 
 /******************************************************************************/
 /******************* Macros and Constants Definitions *************************/
@@ -56,7 +60,11 @@
 	#define DDR_BASEADDR     XPAR_DDR_MEM_BASEADDR + 128*1024*1024
 	#define DMA_BASEADDR     XPAR_AXI_DMA_0_BASEADDR
 	#define UART_BASEADDR    XPS_UART1_BASEADDR
-	#define SPI_BASEADDR     XPAR_AXI_SPI_0_BASEADDR
+	#ifdef SPI_PS7
+		#define SPI_BASEADDR     XPAR_PS7_SPI_0_BASEADDR
+	#else
+		#define SPI_BASEADDR     XPAR_AXI_SPI_0_BASEADDR
+	#endif
 	#define LCD_BASEADDR     XPAR_AXI_GPIO_0_BASEADDR
 #else
 	#define CF_BASEADDR      XPAR_AXI_AD9250_0_BASEADDR
@@ -67,11 +75,9 @@
 	#define SPI_BASEADDR     XPAR_AXI_SPI_0_BASEADDR
 	#define LCD_BASEADDR     XPAR_AXI_GPIO_0_BASEADDR
 #endif
-
-#ifdef _XPARAMETERS_PS_H_
-	#define CYCLES_FOR_1_MS     100000
-#else
-	#define CYCLES_FOR_1_MS     800000
+/* GPIO receiving the FDA/FDB fast detect pins, if the design has one. */
+#if !defined(FD_GPIO_BASEADDR) && defined(XPAR_AXI_GPIO_1_BASEADDR)
+	#define FD_GPIO_BASEADDR XPAR_AXI_GPIO_1_BASEADDR
 #endif
 
 /* CF register map. */
@@ -176,9 +182,343 @@
     JESD_REG_TEST_ERRCNT - Test ERROR count (?)
 */
 
+/* AXI DMA S2MM registers used for the capture done interrupt. */
+#define DMA_REG_S2MM_SR                 0x034
+#define DMA_S2MM_CR_IOC_IRQ_EN          (1 << 12)
+#define DMA_S2MM_SR_IOC_IRQ             (1 << 12) // (Write 1 to clear)
+
+/* Busy bit poll period when the capture done interrupt is not used. */
+#ifndef ADC_CAPTURE_POLL_US
+#define ADC_CAPTURE_POLL_US             1
+#endif
+
+/* Data cache line size, the capture buffers must be aligned to it. */
+#define ADC_CACHE_LINE                  32
+
+/* Set to 1 when the capture DMA writes through the Zynq ACP port. The
+   buffers are then coherent with the caches and need no maintenance. */
+#ifndef ADC_CAPTURE_ACP
+#define ADC_CAPTURE_ACP                 0
+#endif
+
+/* Maximum number of buffers of the continuous capture. */
+#ifndef ADC_STREAM_MAX_BUFFERS
+#define ADC_STREAM_MAX_BUFFERS          8
+#endif
+
+/* Quad words deinterleaved at a time by the downconverter stage of the
+   continuous capture, one DDC_BLOCK of samples per channel. */
+#define ADC_DDC_CHUNK                   (DDC_BLOCK / 2)
+
+/* Quad words deinterleaved at a time by the channelizer stage of the
+   continuous capture. */
+#define ADC_CHAN_CHUNK                  32
+
+/* AXI DMA S2MM registers and descriptors used for the scatter gather capture. */
+#define DMA_REG_S2MM_CR                 0x030
+#define DMA_REG_S2MM_CURDESC            0x038
+#define DMA_REG_S2MM_TAILDESC           0x040
+#define DMA_S2MM_CR_RESET               (1 << 2)
+#define DMA_S2MM_CR_RUN                 (1 << 0)
+#define DMA_S2MM_SR_SG_INCLD            (1 << 3) // (Read Only)
+#define DMA_DESC_NEXT                   0x00
+#define DMA_DESC_ADDR                   0x08
+#define DMA_DESC_CTRL                   0x18
+#define DMA_DESC_STATUS                 0x1C
+#define DMA_DESC_STATUS_CMPLT           (1 << 31)
+#define DMA_DESC_SIZE                   0x40
+
+/* AXI GPIO registers and inputs used for the fast detect interrupt. */
+#define GPIO_REG_DATA                   0x000
+#define GPIO_REG_TRI                    0x004
+#define GPIO_REG_GIER                   0x11C
+#define GPIO_REG_ISR                    0x120 // (Toggle on write)
+#define GPIO_REG_IER                    0x128
+#define GPIO_GIER_EN                    (1 << 31)
+#define GPIO_IER_CH1                    (1 << 0)
+#ifndef FD_GPIO_FDA
+#define FD_GPIO_FDA                     (1 << 0)
+#endif
+#ifndef FD_GPIO_FDB
+#define FD_GPIO_FDB                     (1 << 1)
+#endif
+
+/* Capture count of the core, longer captures are split in descriptors. */
+#define ADC_CAPTURE_MAX_SAMPLES         65536
+
+/* Maximum number of descriptors of the scatter gather capture. */
+#ifndef ADC_SG_MAX_DESC
+#define ADC_SG_MAX_DESC                 64
+#endif
+
+/* Maximum number of converters of the synchronized capture. */
+#ifndef ADC_SYNC_MAX_ENGINES
+#define ADC_SYNC_MAX_ENGINES            4
+#endif
+
+/* Offset search range and correlation length of adc_sync_align(), in
+   samples of a channel. */
+#ifndef ADC_SYNC_MAX_LAG
+#define ADC_SYNC_MAX_LAG                64
+#endif
+#ifndef ADC_SYNC_CORR_SAMPLES
+#define ADC_SYNC_CORR_SAMPLES           1024
+#endif
+
+/* Power-on self-test levels of adc_post(). */
+#define ADC_POST_NONE                   0   // no test
+#define ADC_POST_FAST                   1   // one PN23 check
+#define ADC_POST_FULL                   2   // all the test modes in both formats
+#ifndef ADC_POST_LEVEL
+#define ADC_POST_LEVEL                  ADC_POST_FAST
+#endif
+
+/* Number of samples captured and checked in software by adc_test(). */
+#ifndef ADC_TEST_SAMPLES
+#define ADC_TEST_SAMPLES                16384
+#endif
+
+/* Resolution and position of the samples in each 16 bit lane. */
+#define ADC_SAMPLE_WIDTH                14
+#define ADC_SAMPLE_SHIFT                0
+#define ADC_SAMPLE_MASK                 ((1 << ADC_SAMPLE_WIDTH) - 1)
+
+/* Each lane of a word carries the sequence of one channel. */
+#define ADC_VERIFY_STREAMS              2
+
+/* Averaged capture: maximum number of captures summed, which keeps the 32 bit
+   accumulators from overflowing, software trigger search window, in samples
+   of the trigger channel, and trigger hysteresis below midscale, in LSBs. */
+#define ADC_AVG_MAX_CAPTURES            65535
+#ifndef ADC_AVG_TRIGGER_WINDOW
+#define ADC_AVG_TRIGGER_WINDOW          1024
+#endif
+#ifndef ADC_AVG_HYSTERESIS
+#define ADC_AVG_HYSTERESIS              64
+#endif
+/* Longest wait for a buffer of the averaged capture, in us. Build with
+   ADC_AVG_NEON to accumulate the captures with NEON on Zynq. */
+#ifndef ADC_AVG_TIMEOUT_US
+#define ADC_AVG_TIMEOUT_US              1000000
+#endif
+/* Lanes between two samples of a channel. */
+#define ADC_AVG_LANE_STRIDE             2
+
+/* Modes of the trigger stage of the continuous capture. */
+#define ADC_TRIGGER_LEVEL               0 // a sample at or above the level
+#define ADC_TRIGGER_EDGE                1 // the samples cross the level upwards
+#define ADC_TRIGGER_WINDOW              2 // a sample out of the low..high window
+#define ADC_TRIGGER_FD                  3 // a fast detect (overrange) event
+
+/* Samples of the trigger channel checked at a time by the trigger scan. */
+#ifndef ADC_TRIGGER_BLOCK
+#define ADC_TRIGGER_BLOCK               64
+#endif
+
+/* JESD204B link bring-up: reset pulse, status poll period, timeout and number
+   of polls with a steady error count before the link is reported up. */
+#define JESD_LINK_LANES                 2
+#ifndef JESD_RESET_US
+#define JESD_RESET_US                   100
+#endif
+#ifndef JESD_LINK_POLL_US
+#define JESD_LINK_POLL_US               100
+#endif
+#ifndef JESD_LINK_TIMEOUT_US
+#define JESD_LINK_TIMEOUT_US            100000
+#endif
+#ifndef JESD_LINK_STABLE_POLLS
+#define JESD_LINK_STABLE_POLLS          4
+#endif
+
+/* JESD204B link monitor: sample period and number of consecutive samples
+   with new errors before the link is resynchronized. */
+#ifndef JESD_MONITOR_PERIOD_US
+#define JESD_MONITOR_PERIOD_US          10000
+#endif
+#ifndef JESD_MONITOR_ERR_SAMPLES
+#define JESD_MONITOR_ERR_SAMPLES        3
+#endif
+
+/* Highest CML drive level the link monitor raises the converter to when the
+   eye margin of a lane gets too small. */
+#ifndef JESD_MONITOR_CML_MAX
+#define JESD_MONITOR_CML_MAX            6
+#endif
+
+/* Eye margin check of the link monitor: error free samples between two scans
+   and smallest eye width accepted, in UI/1000. */
+#ifndef JESD_MONITOR_MARGIN_PERIOD
+#define JESD_MONITOR_MARGIN_PERIOD      100
+#endif
+#ifndef JESD_MONITOR_MARGIN_MUI
+#define JESD_MONITOR_MARGIN_MUI         300
+#endif
+
+/* SYSREF source of the JESD core. */
+#define JESD_SYSREF_HW                  0
+#define JESD_SYSREF_SW                  1
+
+/* SYSREF alignment: wait after a SYSREF for the buffers to be released,
+   elastic buffer margin kept on the latest link and depth variation accepted
+   between two realignments, in buffer count units. */
+#ifndef JESD_SYSREF_SETTLE_US
+#define JESD_SYSREF_SETTLE_US           1000
+#endif
+#ifndef JESD_SYSREF_MARGIN
+#define JESD_SYSREF_MARGIN              4
+#endif
+#ifndef JESD_SYSREF_DEPTH_TOL
+#define JESD_SYSREF_DEPTH_TOL           1
+#endif
+#define JESD_DELAY_MAX                  0x1FFF
+
 /******************************************************************************/
 /************************** Types Declarations ********************************/
 /******************************************************************************/
+typedef struct _adc_sg_segment
+{
+    uint32_t address;  // start address of the region
+    uint32_t size;     // number of samples in the region
+}adc_sg_segment;
+
+typedef struct _adc_sync_engine
+{
+    uint32_t cf_baseaddr;    // base address of the CF core
+    uint32_t jesd_baseaddr;  // base address of the JESD core
+    uint32_t dma_baseaddr;   // base address of the DMA
+    uint32_t address;        // capture start address
+    uint32_t latency;        // elastic buffer count of lane 0 at the trigger
+    uint32_t overflow;       // an overflow occurred during the capture
+    int32_t offset;          // first sample offset against the first engine
+}adc_sync_engine;
+
+typedef struct _adc_verify_result
+{
+    uint32_t samples[2];     // samples checked per lane
+    uint32_t errors[2];      // samples in error per lane
+    uint32_t bit_errors[2];  // bit errors per lane
+}adc_verify_result;
+
+/* Phase reached by the JESD204B link. */
+typedef enum _jesd_link_phase
+{
+    JESD_LINK_CGS = 0,  // code group synchronization, no ILA seen yet
+    JESD_LINK_ILAS,     // initial lane alignment seen, buffers not released
+    JESD_LINK_DATA      // data phase, buffers released and no new errors
+
+}jesd_link_phase;
+
+typedef struct _jesd_link_state
+{
+    jesd_link_phase phase;                 // lowest phase of all the lanes
+    uint32_t time_us;                      // time spent in the bring-up
+    uint32_t polls;                        // status polls done
+    uint32_t bufcnt[JESD_LINK_LANES];      // elastic buffer count per lane
+    uint32_t ilacnt[JESD_LINK_LANES];      // ILA count per lane
+    uint32_t errcnt[JESD_LINK_LANES];      // error count per lane
+}jesd_link_state;
+
+typedef struct _jesd_sysref_link
+{
+    uint32_t baseaddr;                     // base address of the JESD core
+    uint32_t delay;                        // buffer delay from the multi-frame
+    uint32_t depth;                        // smallest elastic buffer count of the lanes
+    uint32_t bufcnt[JESD_LINK_LANES];      // elastic buffer count per lane
+    uint32_t lmfc_ok;                      // the depth repeats after a realignment
+}jesd_sysref_link;
+
+typedef struct _jesd_monitor_stats
+{
+    uint32_t samples;                      // status samples taken
+    uint32_t error_samples;                // samples with new errors
+    uint32_t errors[JESD_LINK_LANES];      // errors counted per lane
+    uint32_t ilas[JESD_LINK_LANES];        // ILA sequences, one per SYNC deassertion
+    uint32_t mfcnt[JESD_LINK_LANES];       // last multi-frame count per lane
+    uint32_t bufcnt[JESD_LINK_LANES];      // last elastic buffer count per lane
+    uint32_t relinks;                      // link resynchronizations
+    uint32_t relink_failures;              // resynchronizations that timed out
+    jesd_link_phase phase;                 // phase reached by the last resync
+    uint32_t margin_scans;                 // eye margin scans done
+    uint32_t margin_low;                   // scans with a lane under the margin
+    uint32_t cml_raises;                   // CML drive level increases
+    uint32_t margin_mui[JESD_LINK_LANES];  // eye width of the last scan per lane
+}jesd_monitor_stats;
+
+typedef struct _adc_stream_stats
+{
+    uint32_t captures;  // buffers captured
+    uint32_t overflows; // buffers captured with an overflow
+    uint32_t stalls;    // times all the buffers were filled
+    uint32_t sent;      // buffers handed to the streaming sink
+    uint32_t completions; // captures completed, one interrupt each
+    uint32_t coalesce;  // buffers completed at once by the next capture
+    uint32_t buffer_us; // capture time of one buffer
+}adc_stream_stats;
+
+typedef struct _adc_avg_config
+{
+    uint32_t captures;  // number of captures summed, up to ADC_AVG_MAX_CAPTURES
+    uint32_t lanes;     // 16 bit lanes summed per capture, both channels
+    uint32_t format;    // the output format of the ADC
+    uint32_t trigger;   // 1 to sum each capture from the trigger point
+    uint32_t channel;   // the trigger channel, 0 or 1
+}adc_avg_config;
+
+typedef struct _adc_avg_result
+{
+    uint32_t captures;  // captures summed
+    uint32_t overflows; // captures summed with an overflow
+    uint32_t missed;    // captures skipped without a trigger
+    uint32_t stalls;    // times the ring was full during the accumulation
+}adc_avg_result;
+
+typedef struct _adc_trigger_config
+{
+    uint32_t mode;          // ADC_TRIGGER_x
+    uint32_t channel;       // channel checked, or fast detect pin (FDA 0, FDB 1)
+    uint32_t format;        // the output format of the ADC
+    uint32_t falling;       // 1 to fire below the level or on a falling edge
+    int32_t level;          // level of the level and edge modes, signed LSBs
+    int32_t low;            // low limit of the window mode, signed LSBs
+    int32_t high;           // high limit of the window mode, signed LSBs
+    uint32_t pre_buffers;   // buffers kept before the trigger, up to the
+                            // number of buffers of the ring minus 2
+    uint32_t post_buffers;  // buffers handed after the one which fired
+}adc_trigger_config;
+
+typedef struct _adc_trigger_stats
+{
+    uint32_t triggers;      // windows opened
+    uint32_t fd_triggers;   // windows opened by a fast detect event
+    uint32_t handed;        // buffers handed to the sink
+    uint32_t dropped;       // buffers returned to the capture unsent
+    uint32_t last_address;  // buffer which fired last
+    uint32_t last_offset;   // offset of the trigger in the buffer, in samples
+                            // of the channel
+}adc_trigger_stats;
+
+/* Streaming sink of the continuous capture, called with a filled buffer, its
+   size in bytes and 1 if an overflow occurred. The buffer is transmitted in
+   place and returned with adc_stream_tx_done() once it is sent. Returns 0 if
+   the buffer was queued, negative if the transmit path is busy. */
+typedef int32_t (*adc_stream_sink)(uint32_t address, uint32_t bytes, uint32_t overflow);
+
+typedef struct _adc_fd_stats
+{
+    uint32_t events[2];   // overrange events per channel (FDA, FDB)
+    uint64_t last_us[2];  // timestamp of the last event per channel
+    uint32_t active;      // channels currently over the threshold, bit per channel
+}adc_fd_stats;
+
+/* Fast detect callback, called from the interrupt with the channel (0 for
+   FDA, 1 for FDB) and the timestamp of the overrange event. */
+typedef void (*adc_fd_callback)(uint32_t channel, uint64_t timestamp_us);
+
+/* Capture completion callback, called with the start address of the capture
+   and 1 if an overflow occurred. */
+typedef void (*adc_capture_callback)(uint32_t address, uint32_t overflow);
+
 typedef enum _TestModes
 {
     TEST_DISABLE = 0,
@@ -205,11 +545,120 @@ typedef enum _OutputModes
 
 /*! Initializes JESD FPGA core. */
 void jesd_core_setup(void);
+/*! Initializes a JESD FPGA core. */
+void jesd_core_init(uint32_t baseaddr);
+/*! Waits for the JESD204B link to reach the data phase. */
+int32_t jesd_link_bringup(uint32_t baseaddr, jesd_link_state *state);
+/*! Starts the monitor of a JESD204B link. */
+void jesd_monitor_start(uint32_t baseaddr);
+/*! Samples the link status and resynchronizes the link on sustained errors. */
+int32_t jesd_monitor_tick(void);
+/*! Gets the statistics of the link monitor. */
+void jesd_monitor_get_stats(jesd_monitor_stats *stats);
+#ifdef JESD_MARGIN_EN
+/*! Sets the eye margin check of the link monitor. */
+void jesd_monitor_set_margin(uint32_t period, uint32_t min_mui);
+#endif
+/*! Switches a JESD204B link to another quick configuration option. */
+int32_t jesd_link_switch(uint32_t baseaddr, int32_t quickCfgOption,
+                         jesd_link_state *state);
+/*! Selects the SYSREF source and mode of a JESD core. */
+void jesd_sysref_setup(uint32_t baseaddr, uint32_t source, uint32_t continuous);
+/*! Issues a software SYSREF to a JESD core. */
+void jesd_sysref_trigger(uint32_t baseaddr);
+/*! Aligns the release of several links to a common SYSREF derived LMFC. */
+int32_t jesd_sysref_align(jesd_sysref_link *link, uint32_t nb_links,
+                          uint32_t source);
 
 /*! Captures a specified number of samples from the ADC. */
 void adc_capture(uint32_t size, uint32_t address);
+/*! Starts a capture without waiting for it to complete. */
+void adc_capture_start(uint32_t size, uint32_t address);
+/*! Waits for the started capture to complete. */
+uint32_t adc_capture_wait(void);
+/*! Enables the capture done interrupt. */
+void adc_capture_irq_enable(adc_capture_callback callback);
+/*! Disables the capture done interrupt. */
+void adc_capture_irq_disable(void);
+/*! Selects whether the capture buffers are coherent with the caches. */
+void adc_capture_set_coherent(uint32_t enable);
+/*! Capture done interrupt handler. */
+void adc_capture_isr(void *ref);
+/*! Enables the fast detect interrupt. */
+int32_t adc_fd_enable(adc_fd_callback callback);
+/*! Disables the fast detect interrupt. */
+void adc_fd_disable(void);
+/*! Fast detect interrupt handler. */
+void adc_fd_isr(void *ref);
+/*! Gets the overrange event statistics. */
+void adc_fd_get_stats(adc_fd_stats *stats);
+/*! Captures a number of samples spread over several regions in one go. */
+int32_t adc_capture_sg(adc_sg_segment *seg, uint32_t nb_segments, uint32_t desc_address);
+/*! Captures the same number of samples on several converters at once. */
+int32_t adc_capture_sync(adc_sync_engine *engine, uint32_t nb_engines, uint32_t size);
+/*! Measures the first sample offset of each engine of a synchronized capture. */
+int32_t adc_sync_align(adc_sync_engine *engine, uint32_t nb_engines,
+                       uint32_t size, uint32_t format);
+/*! Starts a continuous capture into a ring of buffers. */
+int32_t adc_stream_start(uint32_t size, uint32_t *address, uint32_t nb_buffers);
+/*! Completion path of the continuous capture. */
+int32_t adc_stream_poll(void);
+/*! Gets the oldest filled buffer of the continuous capture. */
+int32_t adc_stream_get(uint32_t *address, uint32_t *overflow);
+/*! Releases the oldest filled buffer of the continuous capture. */
+void adc_stream_release(void);
+/*! Sets the streaming sink of the continuous capture. */
+void adc_stream_set_sink(adc_stream_sink sink);
+/*! Hands the filled buffers of the continuous capture to the streaming sink. */
+int32_t adc_stream_sink_process(void);
+/*! Returns the oldest buffer handed to the streaming sink. */
+void adc_stream_tx_done(void);
+/*! Stops the continuous capture. */
+void adc_stream_stop(adc_stream_stats *stats);
+/*! Gets the counters of the continuous capture. */
+void adc_stream_get_stats(adc_stream_stats *stats);
+/*! Sets the completion coalescing of the continuous capture. */
+void adc_stream_set_coalesce(uint32_t max_buffers, uint32_t max_us);
+#ifdef ADC_DDC_EN
+/*! Routes the continuous capture through a digital downconverter. */
+int32_t adc_stream_set_ddc(stDdc *ddc, uint32_t channel, uint32_t format,
+                           uint32_t *out_address, adc_stream_sink sink);
+#endif
+#ifdef ADC_CHAN_EN
+/*! Routes the continuous capture through a polyphase channelizer. */
+int32_t adc_stream_set_chan(stChan *chan, uint32_t channel, uint32_t format,
+                            uint32_t *out_address, adc_stream_sink sink);
+#endif
+#ifdef ADC_RECORDER_EN
+/*! Routes the continuous capture to an SD card recorder. */
+int32_t adc_stream_set_recorder(stRecorder *rec);
+/*! Records the filled buffers of the continuous capture. */
+int32_t adc_stream_record_process(void);
+#endif
+
+/*! Starts the trigger stage of the continuous capture. */
+int32_t adc_trigger_start(adc_trigger_config *cfg, adc_stream_sink sink);
+/*! Fires the trigger on the next buffer checked. */
+void adc_trigger_force(void);
+/*! Hands the triggered windows of the continuous capture to the sink. */
+int32_t adc_trigger_process(void);
+/*! Stops the trigger stage of the continuous capture. */
+void adc_trigger_stop(adc_trigger_stats *stats);
 
+/*! Splits a captured buffer into one sign extended buffer per channel. */
+uint32_t adc_deinterleave(uint32_t address, uint32_t size, uint32_t format,
+                          int16_t *ch0, int16_t *ch1);
+/*! Packs signed samples densely, ADC_SAMPLE_WIDTH bits each. */
+uint32_t adc_pack(const int16_t *src, uint32_t count, uint32_t *dst);
+/*! Sums a number of trigger aligned captures for averaging. */
+int32_t adc_average(adc_avg_config *cfg, uint32_t size, uint32_t *address,
+                    uint32_t nb_buffers, int32_t *acc, adc_avg_result *result);
+/*! Checks a captured buffer against the data of a test mode. */
+int32_t adc_verify(uint32_t mode, uint32_t format, uint32_t address, uint32_t size,
+                   adc_verify_result *result);
 /*! Configures the AD9250 device to run in the selected test mode. */
-void adc_test(uint32_t mode, uint32_t format);
+int32_t adc_test(uint32_t mode, uint32_t format);
+/*! Runs the power-on self-test of the data path. */
+int32_t adc_post(uint32_t level);
 
 #endif /* __CF_AD9250_H__ */
@@ -0,0 +1,172 @@
+/**************************************************************************//**
+*   @file   jesd_margin.h
+*   @brief  JESD204B lane margining with the GTX eye scan header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __JESD_MARGIN_H__
+#define __JESD_MARGIN_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+#include "xparameters.h"
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* The lane margining is built only if JESD_MARGIN_EN is defined. It needs
+   the DRP ports of the GTX receivers, reached through the transceiver core of
+   the design at GT_BASEADDR; without it the scans return -1. */
+#if !defined(GT_BASEADDR) && defined(XPAR_AXI_JESD_GT_0_BASEADDR)
+#define GT_BASEADDR				XPAR_AXI_JESD_GT_0_BASEADDR
+#endif
+
+/* DRP window of the transceiver core: the lane selected, then the access and
+   its status. An access is started by writing GT_REG_DRP_CNTRL and is done
+   when GT_DRP_STATUS_BUSY clears. */
+#ifndef GT_REG_DRP_SEL
+#define GT_REG_DRP_SEL			0x0080
+#endif
+#ifndef GT_REG_DRP_CNTRL
+#define GT_REG_DRP_CNTRL		0x0090
+#endif
+#ifndef GT_REG_DRP_STATUS
+#define GT_REG_DRP_STATUS		0x0094
+#endif
+#define GT_DRP_CNTRL_READ		(1 << 28)
+#define GT_DRP_CNTRL_ADDR(x)	(((x) & 0xFFF) << 16)
+#define GT_DRP_CNTRL_WDATA(x)	(((x) & 0xFFFF) << 0)
+#define GT_DRP_STATUS_BUSY		(1 << 16)
+#define GT_DRP_STATUS_RDATA(x)	((x) & 0xFFFF)
+
+/* GTX eye scan attributes, DRP addresses of the 7 series GTX */
+#define GTX_ES_QUAL_MASK		0x031	// 5 words
+#define GTX_ES_SDATA_MASK		0x036	// 5 words
+#define GTX_ES_PRESCALE_VERT	0x03B	// ES_PRESCALE[15:11], ES_VERT_OFFSET[8:0]
+#define GTX_ES_HORZ_OFFSET		0x03C	// ES_HORZ_OFFSET[11:0]
+#define GTX_ES_CONTROL			0x03D	// ES_CONTROL[15:10], ES_ERRDET_EN, ES_EYE_SCAN_EN
+#define GTX_ES_ERROR_COUNT		0x14F
+#define GTX_ES_SAMPLE_COUNT		0x150
+#define GTX_ES_CONTROL_STATUS	0x151
+
+#define GTX_ES_PRESCALE(x)		(((x) & 0x1F) << 11)
+#define GTX_ES_VERT_OFFSET(x)	(((x) < 0) ? ((1 << 7) | ((-(x)) & 0x7F)) : ((x) & 0x7F))
+#define GTX_ES_HORZ(x)			((x) & 0xFFF)
+#define GTX_ES_RUN				(1 << 10)
+#define GTX_ES_ERRDET_EN		(1 << 9)
+#define GTX_ES_EYE_SCAN_EN		(1 << 8)
+#define GTX_ES_DONE				(1 << 0)
+
+/* Largest vertical offset of the eye scan */
+#define MARGIN_VERT_MAX			127
+
+/* Lanes scanned at most */
+#ifndef MARGIN_MAX_LANES
+#define MARGIN_MAX_LANES		4
+#endif
+
+/* Default configuration: ES_PRESCALE, receiver data width, horizontal
+   offsets per half UI (32 at full rate, doubled by each RXOUT_DIV) and the
+   steps of the coarse grid. At 3.125 Gbps and prescale 0 a point takes
+   1.7 ms, a lane about 40 points. */
+#ifndef MARGIN_PRESCALE
+#define MARGIN_PRESCALE			0
+#endif
+#ifndef MARGIN_DATA_WIDTH
+#define MARGIN_DATA_WIDTH		40
+#endif
+#ifndef MARGIN_HORZ_MAX
+#define MARGIN_HORZ_MAX			32
+#endif
+#ifndef MARGIN_COARSE_HORZ
+#define MARGIN_COARSE_HORZ		8
+#endif
+#ifndef MARGIN_COARSE_VERT
+#define MARGIN_COARSE_VERT		16
+#endif
+
+/* Time given to one point of the eye scan */
+#ifndef MARGIN_POINT_TIMEOUT_US
+#define MARGIN_POINT_TIMEOUT_US	100000
+#endif
+
+/*****************************************************************************/
+/************************ Types Declarations *********************************/
+/*****************************************************************************/
+typedef struct _stMarginConfig
+{
+	uint32_t	prescale;	/*!< ES_PRESCALE, a sample counts 2^(1+prescale) words */
+	uint32_t	dataWidth;	/*!< Receiver internal data width, 20 or 40 bits */
+	uint32_t	horzMax;	/*!< Horizontal offsets per half UI */
+	uint32_t	coarseHorz;	/*!< Horizontal step of the coarse grid */
+	uint32_t	coarseVert;	/*!< Vertical step of the coarse grid */
+	uint32_t	maxErrors;	/*!< Errors accepted on an open point */
+}stMarginConfig;
+
+typedef struct _stMarginResult
+{
+	uint32_t	left;		/*!< Open horizontal offsets left of the center */
+	uint32_t	right;		/*!< Open horizontal offsets right of the center */
+	uint32_t	low;		/*!< Open vertical offsets below the center */
+	uint32_t	high;		/*!< Open vertical offsets above the center */
+	uint32_t	widthMui;	/*!< Horizontal opening in UI/1000 */
+	uint32_t	heightPct;	/*!< Vertical opening in percent of the offset range */
+	uint32_t	points;		/*!< Points measured */
+	uint32_t	timeUs;		/*!< Duration of the scan */
+}stMarginResult;
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+#ifdef JESD_MARGIN_EN
+/** Measures the eye margins of a lane */
+int32_t MARGIN_ScanLane(uint32_t lane, const stMarginConfig* cfg,
+						stMarginResult* result);
+/** Measures the eye margins of several lanes */
+int32_t MARGIN_Scan(uint32_t lanes, const stMarginConfig* cfg,
+					stMarginResult* result);
+/** Prints the margins of several lanes over UART */
+void MARGIN_Print(uint32_t lanes, const stMarginResult* result);
+#endif
+
+#endif /* __JESD_MARGIN_H__ */
@@ -46,9 +46,53 @@
 #include "xil_cache.h"
 #include "cf_ad9250.h"
 #include "AD9250.h"
+#include "bus_profile.h"
+#include "scheduler.h"
+#include "bench.h"
 
 void xil_printf(const char *ctrl1, ...);
 
+/***************************************************************************//**
+ * @brief Captures a block of samples. Background task, run on every pass of
+ *        the scheduler.
+ *
+ * @param events - Unused.
+ *
+ * @return None.
+*******************************************************************************/
+static void capture_task(uint32_t events)
+{
+    adc_capture(1024, DDR_BASEADDR);
+}
+
+/***************************************************************************//**
+ * @brief Samples the state of the JESD204B link and reports the resyncs.
+ *        Periodic task.
+ *
+ * @param events - Unused.
+ *
+ * @return None.
+*******************************************************************************/
+static void jesd_monitor_task(uint32_t events)
+{
+    jesd_monitor_stats stats;
+    int32_t ret;
+
+    ret = jesd_monitor_tick();
+    if(ret == 2)
+    {
+        jesd_monitor_get_stats(&stats);
+        xil_printf("JESD204B eye margin low, CML level raised (%d raises).\n\r",
+                   stats.cml_raises);
+    }
+    else if(ret != 0)
+    {
+        jesd_monitor_get_stats(&stats);
+        xil_printf("JESD204B link resynchronized (phase %d, %d resyncs).\n\r",
+                   stats.phase, stats.relinks);
+    }
+}
+
 /***************************************************************************//**
  * @brief Main function.
  *
@@ -56,7 +100,12 @@ void xil_printf(const char *ctrl1, ...);
 *******************************************************************************/
 int main(void)
 {
-    uint32_t mode;
+    uint32_t lane;
+    int32_t ret;
+    jesd_link_state link;
+#ifdef JESD_MARGIN_EN
+    stMarginResult margin[JESD_LINK_LANES];
+#endif
 
     Xil_ICacheEnable();
     Xil_DCacheEnable();
@@ -74,24 +123,57 @@ int main(void)
     xil_printf("  AD9250 SPEED GRADE: 0x%02x", ad9250_read(AD9250_REG_CHIP_INFO));
     xil_printf("\n\r********************************************************************\r\n");
 
-    for (mode = MIDSCALE; mode <= ONE_ZERO_TOGGLE; mode++)    // Data pattern checks
+    /* Wait for the JESD204B link. */
+    PROFILE_PHASE("JESD204B link");
+    ret = jesd_link_bringup(JESD_BASEADDR, &link);
+    PROFILE_PHASE_END();
+    if(ret < 0)
+    {
+        xil_printf("JESD204B link not up (phase %d) after %dus.\n\r",
+                   link.phase, link.time_us);
+    }
+    else
+    {
+        xil_printf("JESD204B link up after %dus.\n\r", link.time_us);
+    }
+    for (lane = 0; lane < JESD_LINK_LANES; lane++)
     {
-        adc_test(mode, OFFSET_BINARY);      // Data format is offset binary
-        adc_test(mode, TWOS_COMPLEMENT);    // Data format is twos complement
+        xil_printf("  lane %d: buffer count %d, ILA count %d, error count %d\n\r",
+                   lane, link.bufcnt[lane], link.ilacnt[lane], link.errcnt[lane]);
     }
+#ifdef JESD_MARGIN_EN
+    if(MARGIN_Scan(JESD_LINK_LANES, NULL, margin) == 0)
+    {
+        MARGIN_Print(JESD_LINK_LANES, margin);
+    }
+#endif
+
+    /* Startup time of each stage, compiled out without BUS_PROFILE_EN. */
+    PROFILE_PhaseDump();
+    /* Throughput benchmarks, compiled out without BENCH_EN. */
+    BENCH_Run();
 
+    if (adc_post(ADC_POST_LEVEL) < 0)       // Data pattern checks
+    {
+        xil_printf("Self-test failed.\n\r");
+    }
+
+    ad9250_stage_begin();                   // Collect the register changes
     ad9250_output_format(OFFSET_BINARY);    // Offset binary
     ad9250_output_invert(0);                // Output invert Off
     ad9250_output_disable(0);               // Output disable Off
     ad9250_test_mode(TEST_DISABLE);         // Test mode Off
-    ad9250_transfer();                      // Synchronously update registers
+    ad9250_stage_commit();                  // Synchronously update registers
 
     xil_printf("Done\n\r");
 
-    while(1)
-    {
-        adc_capture(1024, DDR_BASEADDR);
-    }
+    jesd_monitor_start(JESD_BASEADDR);
+#ifdef JESD_MARGIN_EN
+    jesd_monitor_set_margin(JESD_MONITOR_MARGIN_PERIOD, JESD_MONITOR_MARGIN_MUI);
+#endif
+    SCHED_AddTask("capture", capture_task, 0, 0);
+    SCHED_AddTask("jesd monitor", jesd_monitor_task, JESD_MONITOR_PERIOD_US, 0);
+    SCHED_Run();
 
     Xil_DCacheDisable();
     Xil_ICacheDisable();
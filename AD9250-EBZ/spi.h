@@ -48,6 +48,7 @@
 /***************************** Include Files *********************************/
 /*****************************************************************************/
 #include "xil_types.h"
+#include "bus_profile.h"
 
 /*****************************************************************************/
 /******************* SPI Registers Definitions *******************************/
@@ -99,11 +100,89 @@
 #define SlaveMODF           1
 #define MODF_int            0
 
+/*****************************************************************************/
+/******************* PS SPI Registers Definitions ****************************/
+/*****************************************************************************/
+/* The Zynq PS SPI controller is used instead of the AXI SPI core when
+   SPI_PS7 is defined, spi_ps7.c is then built instead of spi.c. */
+#define PS7_SPI_CR			0x00
+#define PS7_SPI_SR			0x04
+#define PS7_SPI_IER			0x08
+#define PS7_SPI_IDR			0x0C
+#define PS7_SPI_IMR			0x10
+#define PS7_SPI_ER			0x14
+#define PS7_SPI_DR			0x18
+#define PS7_SPI_TXD			0x1C
+#define PS7_SPI_RXD			0x20
+#define PS7_SPI_SICR		0x24
+#define PS7_SPI_TX_THRES	0x28
+#define PS7_SPI_RX_THRES	0x2C
+
+// Configuration Register (PS7_SPI_CR)
+#define PS7_SPI_CR_MODE_FAIL_EN		(1 << 17)
+#define PS7_SPI_CR_MAN_START		(1 << 16)
+#define PS7_SPI_CR_MAN_START_EN		(1 << 15)
+#define PS7_SPI_CR_MANUAL_CS		(1 << 14)
+#define PS7_SPI_CR_CS(x)			(((x) & 0xF) << 10)
+#define PS7_SPI_CR_BAUD_DIV(x)		(((x) & 0x7) << 3) // ref clock / 2^(x + 1)
+#define PS7_SPI_CR_CPHA				(1 << 2)
+#define PS7_SPI_CR_CPOL				(1 << 1)
+#define PS7_SPI_CR_MODE_SEL			(1 << 0)
+#define PS7_SPI_CS_NONE				0xF
+
+// Interrupt Status Register, also the status of the FIFOs
+#define PS7_SPI_IXR_TX_UNDERFLOW	(1 << 6) // (Write 1 to clear)
+#define PS7_SPI_IXR_RX_FULL			(1 << 5)
+#define PS7_SPI_IXR_RX_NEMPTY		(1 << 4) // Rx FIFO level >= PS7_SPI_RX_THRES
+#define PS7_SPI_IXR_TX_FULL			(1 << 3)
+#define PS7_SPI_IXR_TX_NFULL		(1 << 2)
+#define PS7_SPI_IXR_MODE_FAIL		(1 << 1) // (Write 1 to clear)
+#define PS7_SPI_IXR_RX_OVERFLOW		(1 << 0) // (Write 1 to clear)
+#define PS7_SPI_IXR_ALL				0x7F
+
+// Enable Register (PS7_SPI_ER)
+#define PS7_SPI_ER_ENABLE			(1 << 0)
+
+/* Reference clock of the PS SPI controllers and maximum SCLK frequency */
+#ifndef PS7_SPI_REF_CLK_HZ
+#define PS7_SPI_REF_CLK_HZ			166666667
+#endif
+#ifndef PS7_SPI_SCLK_HZ
+#define PS7_SPI_SCLK_HZ				10000000
+#endif
+
+/*****************************************************************************/
+/************************ Types Definitions **********************************/
+/*****************************************************************************/
+/*! Transfer completion callback, status is TRUE on success and FALSE on timeout */
+typedef void (*SPI_Callback)(void* param, u32 status);
+
+/*! Opaque handle of an initialized SPI core, returned by SPI_Init() */
+typedef struct _stSpiConfig stSpiConfig;
+typedef stSpiConfig* SPI_Handle;
+
+typedef struct _stSpiTransfer
+{
+	char	txSize;	 /*!< Number of bytes to transmit */
+	char*	txBuf;	 /*!< Transmit buffer, zeros are sent if txSize is 0 */
+	char	rxSize;	 /*!< Number of bytes to receive */
+	char*	rxBuf;	 /*!< Receive buffer */
+	char	ssNo;	 /*!< Slave select line of the target device */
+	u32		delayMs; /*!< Delay inserted after the transfer, 0 for none */
+}stSpiTransfer;
+
 /*****************************************************************************/
 /************************ Functions Declarations *****************************/
 /*****************************************************************************/
-u32	SPI_Init(u32 axiBaseAddr, char lsbFirst, char cpha, char cpol);
-u32 SPI_TransferData(u32 axiBaseAddr, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo);
+SPI_Handle SPI_Init(u32 axiBaseAddr, char lsbFirst, char cpha, char cpol);
+u32 SPI_SetBurstMode(SPI_Handle pSpi, char enable);
+u32 SPI_TransferData(SPI_Handle pSpi, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo);
+u32 SPI_TransferList(SPI_Handle pSpi, stSpiTransfer* transferList, u32 transferCnt);
+u32 SPI_TransferDataAsync(SPI_Handle pSpi, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo,
+						  SPI_Callback callback, void* callbackParam);
+u32 SPI_IsTransferBusy(SPI_Handle pSpi);
+u32 SPI_GetTransferStatus(SPI_Handle pSpi);
+void SPI_IntrHandler(void* callbackRef);
 
 #endif /*__SPI_H__*/
 
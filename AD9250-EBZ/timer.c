@@ -0,0 +1,273 @@
+/**************************************************************************//**
+*   @file   timer.c
+*   @brief  Time base functions implementations.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "xparameters.h"
+#include "xil_io.h"
+#include "timer.h"
+#include "fastmem.h"
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+#ifdef _XPARAMETERS_PS_H_
+	/* Cortex-A9 SCU private timer, clocked at half the CPU clock */
+	#define TIMER_BASEADDR		XPAR_PS7_SCUTIMER_0_BASEADDR
+	#define TIMER_CLK_FREQ_HZ	(XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2)
+	#define SCU_TIMER_LOAD		0x00
+	#define SCU_TIMER_COUNTER	0x04
+	#define SCU_TIMER_CONTROL	0x08
+	#define SCU_TIMER_ISR		0x0C
+	#define SCU_TIMER_ENABLE	(1 << 0)
+	#define SCU_TIMER_AUTO_LOAD	(1 << 1)
+#elif defined(XPAR_AXI_TIMER_0_BASEADDR)
+	/* AXI timer, counter 0 */
+	#define TIMER_BASEADDR		XPAR_AXI_TIMER_0_BASEADDR
+	#ifdef XPAR_AXI_TIMER_0_CLOCK_FREQ_HZ
+		#define TIMER_CLK_FREQ_HZ	XPAR_AXI_TIMER_0_CLOCK_FREQ_HZ
+	#else
+		#define TIMER_CLK_FREQ_HZ	(1000000000 / CPU_CYCLE_TIME)
+	#endif
+#endif
+
+#ifdef TIMER_BASEADDR
+	#define TIMER_TICKS_PER_US	(TIMER_CLK_FREQ_HZ / 1000000)
+#endif
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+static FAST_DATA uint32_t timerStarted = 0;
+static FAST_DATA uint32_t lastTicks	 = 0;
+static FAST_DATA uint64_t highTicks	 = 0;
+
+/**************************************************************************//**
+* @brief Starts the free running counter used as time base. The function is
+*        called on the first use of the time service, calling it explicitly
+*        only moves the counter start.
+*
+* @return Returns 0 if a hardware timer is used or -1 if the time base falls
+*         back to calibrated delay loops.
+******************************************************************************/
+int32_t TIMER_Init(void)
+{
+	timerStarted = 1;
+	lastTicks	 = 0;
+	highTicks	 = 0;
+#ifdef _XPARAMETERS_PS_H_
+	Xil_Out32(TIMER_BASEADDR + SCU_TIMER_CONTROL, 0);
+	Xil_Out32(TIMER_BASEADDR + SCU_TIMER_ISR, 1);
+	Xil_Out32(TIMER_BASEADDR + SCU_TIMER_LOAD, 0xFFFFFFFF);
+	Xil_Out32(TIMER_BASEADDR + SCU_TIMER_CONTROL,
+			  SCU_TIMER_AUTO_LOAD | SCU_TIMER_ENABLE);
+
+	return 0;
+#elif defined(TIMER_BASEADDR)
+	Xil_Out32(TIMER_BASEADDR + TCSR0, 0);
+	Xil_Out32(TIMER_BASEADDR + TLR0, 0);
+	Xil_Out32(TIMER_BASEADDR + TCSR0, LOAD);
+	Xil_Out32(TIMER_BASEADDR + TCSR0, ARHT | ENT);
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
+#ifdef TIMER_BASEADDR
+/**************************************************************************//**
+* @brief Masks the IRQs and returns the previous interrupt state, so that the
+*        counter extension can be updated from the main loop and from the
+*        interrupt handlers which read the time.
+*
+* @return The state to pass to TIMER_IrqRestore.
+******************************************************************************/
+static inline uint32_t TIMER_IrqSave(void)
+{
+	uint32_t state = 0;
+
+#ifdef _XPARAMETERS_PS_H_
+	__asm__ __volatile__("mrs %0, cpsr\n\tcpsid i" : "=r" (state) : : "memory");
+#elif defined(__MICROBLAZE__)
+	__asm__ __volatile__("mfs %0, rmsr" : "=r" (state));
+	__asm__ __volatile__("mts rmsr, %0" : : "r" (state & ~0x2) : "memory");
+#endif
+
+	return state;
+}
+
+/**************************************************************************//**
+* @brief Restores the interrupt state saved by TIMER_IrqSave.
+*
+* @param state - The saved state.
+*
+* @return None.
+******************************************************************************/
+static inline void TIMER_IrqRestore(uint32_t state)
+{
+#ifdef _XPARAMETERS_PS_H_
+	__asm__ __volatile__("msr cpsr_c, %0" : : "r" (state) : "memory");
+#elif defined(__MICROBLAZE__)
+	__asm__ __volatile__("mts rmsr, %0" : : "r" (state) : "memory");
+#else
+	(void)state;
+#endif
+}
+
+/**************************************************************************//**
+* @brief Reads the free running counter and extends it to 64 bits. The read
+*        and the wrap tracking are done with the IRQs masked, a handler which
+*        reads the time in between would otherwise count a wrap twice or
+*        lose it.
+*
+* @return Number of timer ticks since the time base was started.
+******************************************************************************/
+static FAST_CODE uint64_t TIMER_GetTicks(void)
+{
+	uint64_t time;
+	uint32_t state;
+	uint32_t ticks;
+
+	if(!timerStarted)
+	{
+		TIMER_Init();
+	}
+	state = TIMER_IrqSave();
+#ifdef _XPARAMETERS_PS_H_
+	/* The SCU private timer counts down */
+	ticks = 0xFFFFFFFF - Xil_In32(TIMER_BASEADDR + SCU_TIMER_COUNTER);
+#else
+	ticks = Xil_In32(TIMER_BASEADDR + TCR0);
+#endif
+	if(ticks < lastTicks)
+	{
+		highTicks += 0x100000000ULL;
+	}
+	lastTicks = ticks;
+	time = highTicks | ticks;
+	TIMER_IrqRestore(state);
+
+	return time;
+}
+#endif
+
+/**************************************************************************//**
+* @brief Returns a monotonic timestamp. The counter wrap is tracked in
+*        software, so the function has to be called at least once per
+*        counter period (about 12 s on Zynq, 42 s with a 100 MHz AXI timer).
+*
+* @return Microseconds elapsed since the time base was started, or 0 if no
+*         hardware timer is available.
+******************************************************************************/
+FAST_CODE uint64_t TIMER_GetTimeUs(void)
+{
+#ifdef TIMER_BASEADDR
+	return TIMER_GetTicks() / TIMER_TICKS_PER_US;
+#else
+	return 0;
+#endif
+}
+
+/**************************************************************************//**
+* @brief Delays the program execution with the specified number of us.
+*
+* @param us_count - Number of us with which the program must be delayed.
+* @return None.
+******************************************************************************/
+FAST_CODE void TIMER_DelayUs(uint32_t us_count)
+{
+#ifdef TIMER_BASEADDR
+	uint64_t endTicks;
+
+	endTicks = TIMER_GetTicks() + (uint64_t)us_count * TIMER_TICKS_PER_US;
+	while(TIMER_GetTicks() < endTicks);
+#else
+	volatile uint32_t i;
+
+	for(i = 0; i < us_count * TIMER_LOOPS_PER_US; i++);
+#endif
+}
+
+/**************************************************************************//**
+* @brief Delays the program execution with the specified number of ms.
+*
+* @param ms_count - Number of ms with which the program must be delayed.
+* @return None.
+******************************************************************************/
+void TIMER_DelayMs(uint32_t ms_count)
+{
+	while(ms_count--)
+	{
+		TIMER_DelayUs(1000);
+	}
+}
+
+/**************************************************************************//**
+* @brief Computes a deadline for use with TIMER_DeadlineExpired().
+*
+* @param us_count - Number of us from now until the deadline.
+* @return The deadline timestamp.
+******************************************************************************/
+uint64_t TIMER_SetDeadline(uint32_t us_count)
+{
+	return TIMER_GetTimeUs() + us_count;
+}
+
+/**************************************************************************//**
+* @brief Checks if a deadline set with TIMER_SetDeadline() has passed.
+*        Without a hardware timer the deadline never expires, so callers
+*        must keep their own iteration limit.
+*
+* @param deadline - The deadline timestamp.
+* @return 1 if the deadline has passed, 0 otherwise.
+******************************************************************************/
+uint32_t TIMER_DeadlineExpired(uint64_t deadline)
+{
+#ifdef TIMER_BASEADDR
+	return (TIMER_GetTimeUs() >= deadline) ? 1 : 0;
+#else
+	return 0;
+#endif
+}
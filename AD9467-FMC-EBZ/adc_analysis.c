@@ -0,0 +1,581 @@
+/**************************************************************************//**
+*   @file   adc_analysis.c
+*   @brief  Captured ADC data analysis implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "adc_analysis.h"
+
+#ifdef ADC_ANALYSIS_EN
+
+#include "xil_io.h"
+
+extern void xil_printf(const char *ctrl1, ...);
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Fixed point one and 2*pi in Q30 */
+#define ANALYSIS_ONE_Q30		(1LL << 30)
+#define ANALYSIS_2PI_Q30		6746518852LL
+
+/* Blackman-Harris 4 term window coefficients in Q30 */
+#define ANALYSIS_BH_A0			385204879LL
+#define ANALYSIS_BH_A1			524297395LL
+#define ANALYSIS_BH_A2			151698245LL
+#define ANALYSIS_BH_A3			12541305LL
+
+/* The windowed samples keep 2 fractional bits */
+#define ANALYSIS_FRAC_BITS		2
+
+/* Bin classes */
+#define ANALYSIS_BIN_NOISE		0
+#define ANALYSIS_BIN_DC			1
+#define ANALYSIS_BIN_SIGNAL		2
+#define ANALYSIS_BIN_HARMONIC	3
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+static int32_t analysisRe[ANALYSIS_MAX_POINTS];
+static int32_t analysisIm[ANALYSIS_MAX_POINTS];
+static uint8_t analysisBin[ANALYSIS_MAX_POINTS];
+static int32_t analysisCos[ANALYSIS_MAX_POINTS / 4 + 1];
+static uint32_t analysisCosPoints = 0;
+
+/**************************************************************************//**
+* @brief Builds the quarter wave cosine table of an FFT size. The first step
+*        is computed with the Taylor series and the table with rotations, in
+*        Q30, so no floating point library is needed.
+*
+* @param points - Number of FFT points.
+*
+* @return None.
+******************************************************************************/
+static void ANALYSIS_InitCos(uint32_t points)
+{
+	int64_t x;
+	int64_t x2;
+	int64_t term;
+	int64_t cosStep;
+	int64_t sinStep;
+	int64_t c;
+	int64_t s;
+	int64_t t;
+	uint32_t i;
+
+	if(analysisCosPoints == points)
+	{
+		return;
+	}
+	x  = ANALYSIS_2PI_Q30 / points;
+	x2 = (x * x) >> 30;
+	cosStep = ANALYSIS_ONE_Q30;
+	sinStep = x;
+	term = ANALYSIS_ONE_Q30;
+	for(i = 1; i <= 4; i++)
+	{
+		term = -((term * x2) >> 30) / ((2 * i - 1) * (2 * i));
+		cosStep += term;
+	}
+	term = x;
+	for(i = 1; i <= 4; i++)
+	{
+		term = -((term * x2) >> 30) / ((2 * i) * (2 * i + 1));
+		sinStep += term;
+	}
+	c = ANALYSIS_ONE_Q30;
+	s = 0;
+	for(i = 0; i < points / 4; i++)
+	{
+		analysisCos[i] = (int32_t)c;
+		t = ((c * cosStep) - (s * sinStep) + (1LL << 29)) >> 30;
+		s = ((s * cosStep) + (c * sinStep) + (1LL << 29)) >> 30;
+		c = t;
+	}
+	analysisCos[points / 4] = 0;
+	analysisCosPoints = points;
+}
+
+/**************************************************************************//**
+* @brief Gets cos(2 * pi * idx / points) from the quarter wave table.
+*
+* @param idx - Phase index.
+* @param points - Number of FFT points.
+*
+* @return The cosine in Q30.
+******************************************************************************/
+static int32_t ANALYSIS_Cos(uint32_t idx, uint32_t points)
+{
+	uint32_t q = points / 4;
+
+	idx &= (points - 1);
+	if(idx <= q)
+	{
+		return analysisCos[idx];
+	}
+	if(idx <= 2 * q)
+	{
+		return -analysisCos[2 * q - idx];
+	}
+	if(idx <= 3 * q)
+	{
+		return -analysisCos[idx - 2 * q];
+	}
+
+	return analysisCos[points - idx];
+}
+
+/**************************************************************************//**
+* @brief Computes a coefficient of the Blackman-Harris 4 term window.
+*
+* @param idx - Index of the sample.
+* @param points - Number of FFT points.
+*
+* @return The window coefficient in Q30.
+******************************************************************************/
+static int32_t ANALYSIS_Window(uint32_t idx, uint32_t points)
+{
+	int64_t w;
+
+	w = ANALYSIS_BH_A0 -
+		((ANALYSIS_BH_A1 * ANALYSIS_Cos(idx, points)) >> 30) +
+		((ANALYSIS_BH_A2 * ANALYSIS_Cos(2 * idx, points)) >> 30) -
+		((ANALYSIS_BH_A3 * ANALYSIS_Cos(3 * idx, points)) >> 30);
+
+	return (int32_t)w;
+}
+
+/**************************************************************************//**
+* @brief Extracts a sample from a lane and converts it to a signed value.
+*
+* @param data - Lane of the captured word, in the low 16 bits.
+* @param cfg - Layout and format of the samples.
+*
+* @return The signed sample.
+******************************************************************************/
+static int32_t ANALYSIS_Sample(uint32_t data, stAnalysisConfig* cfg)
+{
+	int32_t msb = 1 << (cfg->width - 1);
+	int32_t sample;
+
+	sample = (data >> cfg->shift) & ((1 << cfg->width) - 1);
+	if(cfg->format == ANALYSIS_OFFSET_BINARY)
+	{
+		return sample - msb;
+	}
+
+	return (sample ^ msb) - msb;
+}
+
+/**************************************************************************//**
+* @brief In place radix-2 FFT of the work buffers. The samples have a margin
+*        for the growth of one bit per stage, so the stages are not scaled.
+*
+* @param points - Number of FFT points.
+*
+* @return None.
+******************************************************************************/
+static void ANALYSIS_Fft(uint32_t points)
+{
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+	uint32_t len;
+	uint32_t half;
+	int32_t wr;
+	int32_t wi;
+	int32_t tr;
+	int32_t ti;
+
+	for(i = 1, j = 0; i < points; i++)
+	{
+		k = points >> 1;
+		while(j & k)
+		{
+			j ^= k;
+			k >>= 1;
+		}
+		j |= k;
+		if(i < j)
+		{
+			tr = analysisRe[i];
+			analysisRe[i] = analysisRe[j];
+			analysisRe[j] = tr;
+			ti = analysisIm[i];
+			analysisIm[i] = analysisIm[j];
+			analysisIm[j] = ti;
+		}
+	}
+	for(len = 2; len <= points; len <<= 1)
+	{
+		half = len >> 1;
+		for(k = 0; k < half; k++)
+		{
+			wr = ANALYSIS_Cos(k * (points / len), points);
+			wi = -ANALYSIS_Cos(k * (points / len) + 3 * (points / 4), points);
+			for(i = k; i < points; i += len)
+			{
+				j = i + half;
+				tr = (int32_t)((((int64_t)analysisRe[j] * wr) -
+								((int64_t)analysisIm[j] * wi)) >> 30);
+				ti = (int32_t)((((int64_t)analysisRe[j] * wi) +
+								((int64_t)analysisIm[j] * wr)) >> 30);
+				analysisRe[j] = analysisRe[i] - tr;
+				analysisIm[j] = analysisIm[i] - ti;
+				analysisRe[i] += tr;
+				analysisIm[i] += ti;
+			}
+		}
+	}
+}
+
+/**************************************************************************//**
+* @brief Computes the power of a bin of the spectrum.
+*
+* @param bin - Index of the bin.
+*
+* @return The power of the bin.
+******************************************************************************/
+static uint64_t ANALYSIS_Power(uint32_t bin)
+{
+	return (uint64_t)((int64_t)analysisRe[bin] * analysisRe[bin]) +
+		   (uint64_t)((int64_t)analysisIm[bin] * analysisIm[bin]);
+}
+
+/**************************************************************************//**
+* @brief Assigns the bins of a tone which are not assigned yet to a class.
+*
+* @param center - Bin of the tone.
+* @param bins - Number of bins of the spectrum.
+* @param circular - The spectrum wraps around (complex samples).
+* @param cls - Class of the bins.
+*
+* @return Number of bins assigned.
+******************************************************************************/
+static uint32_t ANALYSIS_Mark(int32_t center, uint32_t bins, uint32_t circular,
+							  uint8_t cls)
+{
+	uint32_t cnt = 0;
+	int32_t i;
+	int32_t k;
+
+	for(i = center - ANALYSIS_TONE_SPAN; i <= center + ANALYSIS_TONE_SPAN; i++)
+	{
+		k = i;
+		if(circular)
+		{
+			k = (i + (int32_t)bins) % (int32_t)bins;
+		}
+		else if((k < 0) || (k >= (int32_t)bins))
+		{
+			continue;
+		}
+		if(analysisBin[k] == ANALYSIS_BIN_NOISE)
+		{
+			analysisBin[k] = cls;
+			cnt++;
+		}
+	}
+
+	return cnt;
+}
+
+/**************************************************************************//**
+* @brief Computes log2 of a power.
+*
+* @param x - The power.
+*
+* @return log2(x) in Q16, 0 for x = 0.
+******************************************************************************/
+static int32_t ANALYSIS_Log2(uint64_t x)
+{
+	uint64_t m;
+	int32_t msb = 0;
+	int32_t frac = 0;
+	int32_t i;
+
+	if(x == 0)
+	{
+		return 0;
+	}
+	while((x >> msb) > 1)
+	{
+		msb++;
+	}
+	m = (msb >= 31) ? (x >> (msb - 31)) : (x << (31 - msb));
+	for(i = 15; i >= 0; i--)
+	{
+		m = (m * m) >> 31;
+		if(m >= (1ULL << 32))
+		{
+			m >>= 1;
+			frac |= (1 << i);
+		}
+	}
+
+	return (msb << 16) | frac;
+}
+
+/**************************************************************************//**
+* @brief Converts a ratio of powers given as log2 values to 0.01 dB.
+*
+* @param num - log2 of the numerator in Q16.
+* @param den - log2 of the denominator in Q16.
+*
+* @return 10 * log10(num / den) in 0.01 dB.
+******************************************************************************/
+static int32_t ANALYSIS_Db(int32_t num, int32_t den)
+{
+	/* 10 * log10(2) = 3.0103 dB per octave */
+	return (int32_t)(((int64_t)(num - den) * 30103) / 6553600);
+}
+
+/**************************************************************************//**
+* @brief Analyzes a captured buffer. The samples are windowed with a
+*        Blackman-Harris window and transformed with a fixed point FFT. The
+*        tone with the most power is the fundamental, the bins of the DC, of
+*        the fundamental and of its harmonics are replaced by the average
+*        noise level.
+*
+* @param cfg - Layout, format and FFT size of the analysis.
+* @param address - Start address of the captured buffer.
+* @param result - Result of the analysis.
+*
+* @return 0 in case of success, -1 if the configuration is not supported.
+******************************************************************************/
+int32_t ANALYSIS_Run(stAnalysisConfig* cfg, uint32_t address,
+					 stAnalysisResult* result)
+{
+	uint32_t points = cfg->points;
+	uint32_t circular = (cfg->layout == ANALYSIS_LAYOUT_IQ);
+	uint32_t bins;
+	uint32_t data;
+	uint32_t noiseBins;
+	uint32_t harmBins;
+	uint32_t h;
+	uint32_t i;
+	int64_t sum[2];
+	int32_t mean[2];
+	int32_t w;
+	int32_t log2Points = 0;
+	int32_t log2Ref;
+	uint64_t sumW2 = 0;
+	uint64_t power;
+	uint64_t peak = 0;
+	uint64_t spur = 0;
+	uint64_t signal = 0;
+	uint64_t harm = 0;
+	uint64_t noise = 0;
+	uint64_t noiseAvg;
+
+	if((points < 16) || (points > ANALYSIS_MAX_POINTS) ||
+	   (points & (points - 1)) || (cfg->width < 2) || (cfg->width > 16) ||
+	   (cfg->layout > ANALYSIS_LAYOUT_IQ))
+	{
+		return -1;
+	}
+	ANALYSIS_InitCos(points);
+
+	/* Samples */
+	sum[0] = 0;
+	sum[1] = 0;
+	for(i = 0; i < points; i++)
+	{
+		if(cfg->layout == ANALYSIS_LAYOUT_SINGLE)
+		{
+			data = Xil_In32(address + ((i / 2) * 4)) >> ((i & 1) * 16);
+		}
+		else
+		{
+			data = Xil_In32(address + (i * 4));
+		}
+		if(cfg->layout == ANALYSIS_LAYOUT_DUAL)
+		{
+			data >>= (cfg->channel & 1) * 16;
+		}
+		analysisRe[i] = ANALYSIS_Sample(data & 0xffff, cfg);
+		analysisIm[i] = circular ? ANALYSIS_Sample(data >> 16, cfg) : 0;
+		sum[0] += analysisRe[i];
+		sum[1] += analysisIm[i];
+	}
+	for(i = 0; i < 2; i++)
+	{
+		mean[i] = (int32_t)(sum[i] / (int32_t)points);
+		result->dcOffset[i] = (int32_t)((sum[i] * 100) / (int32_t)points);
+	}
+
+	/* Window and transform, the DC offset is removed first */
+	for(i = 0; i < points; i++)
+	{
+		w = ANALYSIS_Window(i, points);
+		sumW2 += (uint64_t)(((int64_t)w * w) >> 30);
+		analysisRe[i] = (int32_t)(((int64_t)(analysisRe[i] - mean[0]) * w) >>
+								  (30 - ANALYSIS_FRAC_BITS));
+		analysisIm[i] = (int32_t)(((int64_t)(analysisIm[i] - mean[1]) * w) >>
+								  (30 - ANALYSIS_FRAC_BITS));
+	}
+	ANALYSIS_Fft(points);
+
+	/* Classify the bins: DC, fundamental, harmonics and noise */
+	bins = circular ? points : (points / 2 + 1);
+	for(i = 0; i < bins; i++)
+	{
+		analysisBin[i] = ANALYSIS_BIN_NOISE;
+	}
+	ANALYSIS_Mark(0, bins, circular, ANALYSIS_BIN_DC);
+	result->fundBin = 0;
+	for(i = 0; i < bins; i++)
+	{
+		power = ANALYSIS_Power(i);
+		if((analysisBin[i] == ANALYSIS_BIN_NOISE) && (power > peak))
+		{
+			peak = power;
+			result->fundBin = i;
+		}
+	}
+	ANALYSIS_Mark(result->fundBin, bins, circular, ANALYSIS_BIN_SIGNAL);
+	harmBins = 0;
+	for(h = 2; h <= cfg->harmonics; h++)
+	{
+		i = (h * result->fundBin) & (points - 1);
+		if(!circular && (i > points / 2))
+		{
+			i = points - i;
+		}
+		harmBins += ANALYSIS_Mark(i, bins, circular, ANALYSIS_BIN_HARMONIC);
+	}
+
+	/* Powers of the classes */
+	noiseBins = 0;
+	result->spurBin = 0;
+	for(i = 0; i < bins; i++)
+	{
+		power = ANALYSIS_Power(i);
+		switch(analysisBin[i])
+		{
+			case ANALYSIS_BIN_SIGNAL:
+				signal += power;
+				break;
+			case ANALYSIS_BIN_HARMONIC:
+				harm += power;
+				break;
+			case ANALYSIS_BIN_NOISE:
+				noise += power;
+				noiseBins++;
+				break;
+			default:
+				break;
+		}
+		if((analysisBin[i] != ANALYSIS_BIN_DC) &&
+		   (analysisBin[i] != ANALYSIS_BIN_SIGNAL) && (power > spur))
+		{
+			spur = power;
+			result->spurBin = i;
+		}
+	}
+	noiseAvg = noiseBins ? (noise / noiseBins) : 0;
+	noise += noiseAvg * (bins - noiseBins);
+	harm = (harm > (noiseAvg * harmBins)) ? (harm - (noiseAvg * harmBins)) : 0;
+
+	/* Full scale tone power with this window, in Q16 log2 */
+	while((1U << log2Points) < points)
+	{
+		log2Points++;
+	}
+	log2Ref = ((2 * (cfg->width - 1) + log2Points - 30 +
+				(2 * ANALYSIS_FRAC_BITS) - (circular ? 0 : 2)) << 16) +
+			  ANALYSIS_Log2(sumW2);
+
+	result->fundDbfs = ANALYSIS_Db(ANALYSIS_Log2(signal), log2Ref);
+	result->snr = ANALYSIS_Db(ANALYSIS_Log2(signal), ANALYSIS_Log2(noise));
+	result->sinad = ANALYSIS_Db(ANALYSIS_Log2(signal),
+								ANALYSIS_Log2(noise + harm));
+	result->sfdr = ANALYSIS_Db(ANALYSIS_Log2(peak), ANALYSIS_Log2(spur));
+	result->enob = ((result->sinad - 176) * 100) / 602;
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Prints a value given in hundredths.
+*
+* @param name - Name of the value.
+* @param value - The value in hundredths.
+* @param unit - Unit of the value.
+*
+* @return None.
+******************************************************************************/
+static void ANALYSIS_PrintValue(const char* name, int32_t value,
+								const char* unit)
+{
+	uint32_t abs = (value < 0) ? -value : value;
+
+	xil_printf("%s: %s%d.%02d %s\n\r", name, (value < 0) ? "-" : "",
+			   abs / 100, abs % 100, unit);
+}
+
+/**************************************************************************//**
+* @brief Prints the result of an analysis over UART.
+*
+* @param result - Result of the analysis.
+*
+* @return None.
+******************************************************************************/
+void ANALYSIS_Print(stAnalysisResult* result)
+{
+	xil_printf("Fundamental bin: %d\n\r", result->fundBin);
+	ANALYSIS_PrintValue("Fundamental", result->fundDbfs, "dBFS");
+	ANALYSIS_PrintValue("SNR", result->snr, "dB");
+	ANALYSIS_PrintValue("SINAD", result->sinad, "dB");
+	xil_printf("Largest spur bin: %d\n\r", result->spurBin);
+	ANALYSIS_PrintValue("SFDR", result->sfdr, "dBc");
+	ANALYSIS_PrintValue("ENOB", result->enob, "bits");
+	ANALYSIS_PrintValue("DC offset", result->dcOffset[0], "LSB");
+	if(result->dcOffset[1])
+	{
+		ANALYSIS_PrintValue("DC offset Q", result->dcOffset[1], "LSB");
+	}
+}
+
+#endif
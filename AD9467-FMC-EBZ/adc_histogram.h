@@ -0,0 +1,122 @@
+/**************************************************************************//**
+*   @file   adc_histogram.h
+*   @brief  ADC code density histogram header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+
+#ifndef __ADC_HISTOGRAM_H__
+#define __ADC_HISTOGRAM_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+#include "adc_analysis.h"
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* The histogram is built only if ADC_HISTOGRAM_EN is defined. The bins are
+   provided by the caller, 4 bytes per code: 256 KB at 16 bits, 64 KB at
+   14 bits. */
+
+/* Number of bins of a resolution */
+#define HIST_BINS(width)		(1UL << (width))
+
+/*****************************************************************************/
+/************************ Types Declarations *********************************/
+/*****************************************************************************/
+typedef struct _stHistConfig
+{
+	uint32_t	layout;		/*!< ANALYSIS_LAYOUT_x */
+	uint32_t	width;		/*!< Resolution of the samples in bits */
+	uint32_t	shift;		/*!< Position of the samples in the lanes */
+	uint32_t	format;		/*!< ANALYSIS_OFFSET_BINARY or ANALYSIS_TWOS_COMPLEMENT */
+	uint32_t	channel;	/*!< Lane binned with ANALYSIS_LAYOUT_DUAL and
+								 ANALYSIS_LAYOUT_IQ */
+}stHistConfig;
+
+/* A histogram owns its bins, so each processor can fill a private one over
+   its part of the data; the histograms are then merged. */
+typedef struct _stHistogram
+{
+	uint32_t*	bins;		/*!< One counter per code, in offset binary */
+	uint32_t	width;		/*!< Resolution of the codes in bits */
+	uint64_t	samples;	/*!< Samples binned */
+}stHistogram;
+
+/* The DNL and INL are in 0.01 LSB, as xil_printf has no floating point
+   support. The INL is relative to the end point line. */
+typedef struct _stLinearityResult
+{
+	int32_t		dnlMin;			/*!< Lowest DNL */
+	uint32_t	dnlMinCode;		/*!< Code of the lowest DNL */
+	int32_t		dnlMax;			/*!< Highest DNL */
+	uint32_t	dnlMaxCode;		/*!< Code of the highest DNL */
+	int32_t		inlMin;			/*!< Lowest INL */
+	uint32_t	inlMinCode;		/*!< Code of the lowest INL */
+	int32_t		inlMax;			/*!< Highest INL */
+	uint32_t	inlMaxCode;		/*!< Code of the highest INL */
+	uint32_t	missingCodes;	/*!< Codes without any hit, end codes excluded */
+}stLinearityResult;
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+#ifdef ADC_HISTOGRAM_EN
+/** Attaches the bins to a histogram and clears them */
+int32_t HIST_Init(stHistogram* hist, uint32_t* bins, uint32_t width);
+/** Clears the bins of a histogram */
+void HIST_Clear(stHistogram* hist);
+/** Bins the samples of a captured buffer */
+int32_t HIST_Accumulate(stHistogram* hist, stHistConfig* cfg,
+						uint32_t address, uint32_t words);
+/** Adds the bins of a histogram to another one */
+int32_t HIST_Merge(stHistogram* dst, const stHistogram* src);
+/** Computes the DNL and INL from the histogram of a sine wave */
+int32_t HIST_Linearity(stHistogram* hist, int32_t* dnl, int32_t* inl,
+					   stLinearityResult* result);
+/** Prints a linearity result over UART */
+void HIST_Print(stLinearityResult* result);
+#endif
+
+#endif /* __ADC_HISTOGRAM_H__ */
@@ -1,405 +1,2036 @@
-/***************************************************************************//**
- *   @file   cf_ad9467.c
- *   @brief  Implementation of cf_ad9467 Driver.
-********************************************************************************
- * Copyright 2012(c) Analog Devices, Inc.
- *
- * All rights reserved.
- *
- * Redistribution and use in source and binary forms, with or without
- * modification, are permitted provided that the following conditions are met:
- *  - Redistributions of source code must retain the above copyright
- *    notice, this list of conditions and the following disclaimer.
- *  - Redistributions in binary form must reproduce the above copyright
- *    notice, this list of conditions and the following disclaimer in
- *    the documentation and/or other materials provided with the
- *    distribution.
- *  - Neither the name of Analog Devices, Inc. nor the names of its
- *    contributors may be used to endorse or promote products derived
- *    from this software without specific prior written permission.
- *  - The use of this software may or may not infringe the patent rights
- *    of one or more patent holders.  This license does not release you
- *    from the requirement that you obtain separate licenses from these
- *    patent holders to use this software.
- *  - Use of the software either in source or binary form, must be run
- *    on or directly connected to an Analog Devices Inc. component.
- *
- * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
- * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
- * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
- * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
- * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
- * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
- * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
- * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
- * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
- * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
- *
-********************************************************************************
- *   SVN Revision: $WCREV$
-*******************************************************************************/
-
-/******************************************************************************/
-/***************************** Include Files **********************************/
-/******************************************************************************/
-#include "cf_ad9467.h"
-#include "xil_io.h"
-#include "AD9467.h"
-
-extern char inbyte(void);
-void Xil_DCacheFlush(void);
-void xil_printf(const char *ctrl1, ...);
-
-/*****************************************************************************/
-/************************ Private Functions Prototypes ***********************/
-/*****************************************************************************/
-void DisplayTestMode(u32 mode, u32 format);
-
-/******************************************************************************/
-/************************ Functions Definitions *******************************/
-/******************************************************************************/
-
-/***************************************************************************//**
- * @brief Creates a delay of milliseconds.
- *
- * @param ms_count - Delay in milliseconds.
- *
- * @return None.
-*******************************************************************************/
-void delay_ms(u32 ms_count)
-{
-	u32 count;
-
-	for (count = 0; count < ((ms_count * 100000) + 1); count++)
-	{
-		asm("nop");
-	}
-}
-
-/***************************************************************************//**
- * @brief Captures a specified number of samples from the ADC.
- *
- * @param size - number of bytes to read from the device
- * @param address - capture start address
- *
- * @return None.
-*******************************************************************************/
-void adc_capture(u32 size, u32 address)
-{
-	Xil_Out32((DMA_BASEADDR + 0x030), 0); 				// clear dma operations
-	Xil_Out32((DMA_BASEADDR + 0x030), 1); 				// enable dma operations
-	Xil_Out32((DMA_BASEADDR + 0x048), address); 		// capture start address
-	Xil_Out32((DMA_BASEADDR + 0x058), (size * 8));  	// number of bytes
-	Xil_Out32((CF_BASEADDR + CF_REG_CAPTURE_CTRL),
-			   CF_CAPTURE_CTRL_CAPTURE_START(0));   	// capture disable
-	Xil_Out32((CF_BASEADDR + CF_REG_ADC_STATUS),
-			   CF_ADC_STATUS_UNDERFLOW |
-			   CF_ADC_STATUS_OVERFLOW |
-			   CF_ADC_STATUS_BUSY);						// clear status
-	Xil_Out32((CF_BASEADDR + CF_REG_DATA_MONITOR),
-			   CF_DATA_MONITOR_PN_ERR |
-			   CF_DATA_MONITOR_PN_SYNC |
-			   CF_DATA_MONITOR_PN_OVER_RNG);			// clear status
-	Xil_Out32((CF_BASEADDR + CF_REG_CAPTURE_CTRL),
-			   CF_CAPTURE_CTRL_CAPTURE_START(1) |
-			   CF_CAPTURE_CTRL_CAPTURE_COUNT(size)); 	// capture enable
-	do
-	{
-		delay_ms(1);
-	}
-	while ((Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_BUSY));
-	if ((Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_OVERFLOW))
-	{
-		xil_printf("overflow occurred, capture may be corrupted\n\r");
-	}
-#ifdef _XPARAMETERS_PS_H_
-	Xil_DCacheFlush();
-#else
-	microblaze_flush_dcache();
-	microblaze_invalidate_dcache();
-#endif
-}
-
-/***************************************************************************//**
- * @brief ADC delay.
- *
- * @param delay - Value of the delay.
- *
- * @return 0.
-*******************************************************************************/
-u32 adc_delay_1(u32 delay)
-{
-	u32 i;
-	u32 rdata;
-
-	for (i = 0; i < 8; i++)
-	{
-		Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL), 0x000000);	// clear bits
-		Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL),
-				   CF_DELAY_CTRL_SEL(1) |
-				   CF_DELAY_CTRL_RW_ENABLE(0) |
-				   CF_DELAY_CTRL_WR_ADDR(i) |
-				  CF_DELAY_CTRL_WR_DATA(delay));				// delay write
-		Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL),
-				   CF_DELAY_CTRL_SEL(1) |
-				   CF_DELAY_CTRL_RW_ENABLE(0) |
-				   CF_DELAY_CTRL_WR_ADDR(i) |
-				   CF_DELAY_CTRL_WR_DATA(delay));				// delay write
-	}
-	for (i = 0; i < 8; i++)
-	{
-		Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL), 0x000000);	// clear bits
-		Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL),
-				   CF_DELAY_CTRL_SEL(1) |
-				   CF_DELAY_CTRL_RW_ENABLE(1) |
-				   CF_DELAY_CTRL_WR_ADDR(i));					// delay read
-		Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL),
-				   CF_DELAY_CTRL_SEL(1) |
-				   CF_DELAY_CTRL_RW_ENABLE(1) |
-			       CF_DELAY_CTRL_WR_ADDR(i));					// delay read
-
-		rdata = Xil_In32(CF_BASEADDR + CF_REG_DELAY_STATUS);
-		if (rdata != (CF_DELAY_STATUS_LOCKED | CF_DELAY_CTRL_WR_DATA(delay)))
-		{
-			xil_printf("adc_delay_1: sel(%2d), data(%04x)\n\r", i, rdata);
-		}
-	}
-
-	return(0);
-}
-
-/***************************************************************************//**
- * @brief ADC delay.
- *
- * @return 0.
-*******************************************************************************/
-u32 adc_delay(void)
-{
-	u32 delay;
-	u32 error;
-	u32 lasterr;
-	u32 startdelay;
-	u32 stopdelay;
-
-	lasterr = 1;
-	startdelay = 32;
-	stopdelay = 31;
-	for (delay = 0; delay < 32; delay++)
-	{
-		adc_delay_1(delay);
-		delay_ms(10);
-		Xil_Out32((CF_BASEADDR + CF_REG_DATA_MONITOR),
-				   CF_DATA_MONITOR_PN_ERR |
-				   CF_DATA_MONITOR_PN_SYNC |
-				   CF_DATA_MONITOR_PN_OVER_RNG);		// writer ones to clear bits
-		delay_ms(100);
-		error = Xil_In32(CF_BASEADDR + CF_REG_DATA_MONITOR) &
-						(CF_DATA_MONITOR_PN_ERR |
-					     CF_DATA_MONITOR_PN_SYNC |
-						 CF_DATA_MONITOR_PN_OVER_RNG);	// read the status of ADC data monitoring
-		if (error == 0)
-		{
-			if (lasterr == 1)
-			{
-				startdelay = delay;
-			}
-			lasterr = 0;
-		}
-		else
-		{
-			if (lasterr == 0)
-			{
-				stopdelay = delay;
-				break;
-			}
-			lasterr = 1;
-		}
-	}
-	if (startdelay > 31)
-	{
-		adc_delay_1(0);
-		return(1);
-	}
-	delay = startdelay + ((stopdelay - startdelay)/2);
-	adc_delay_1(delay);
-
-	return(0);
-}
-
-/***************************************************************************//**
- * @brief Configures the AD9467 device to run in the selected test mode
- * 		  and checks if the read data pattern corresponds to the expected
- * 		  values for the set test mode.
- *
- * @param mode - The test mode. Range 0 ..7
- *                        0 - test mode off
- *                        1 - midscale short
- *                        2 - +FS short
- *                        3 - -FS short
- *                        4 - checkerboard output
- *                        5 - PN 23 sequence
- *                        6 - PN 9 sequence
- *                        7 - one/zero word toggle
- * @param format - Sets the data format:
- *                 0 - offset binary
- *                 1 - twos complement
- *                 2 - gray code
- *
- * @return None.
-*******************************************************************************/
-void adc_test(u32 mode, u32 format)
-{
-	u32 n;
-	u32 rdata;
-	u32 edata = 0;
-	u32 error = 0;
-
-	ad9467_output_format(format);
-	ad9467_test_mode(mode);
-	ad9467_transfer();
-	adc_capture(16, DDR_BASEADDR);
-	DisplayTestMode(mode, format);
-	if ((mode == PN_23_SEQUENCE) || (mode == PN_9_SEQUENCE))
-	{
-		if (format == TWOS_COMPLEMENT) return;
-		Xil_Out32((CF_BASEADDR + CF_REG_PN_TYPE),
-				  ((mode == PN_23_SEQUENCE) ? 0x01 : 0x00));
-		delay_ms(10);
-		Xil_Out32((CF_BASEADDR + CF_REG_DATA_MONITOR),
-				   CF_DATA_MONITOR_PN_ERR |
-				   CF_DATA_MONITOR_PN_SYNC |
-				   CF_DATA_MONITOR_PN_OVER_RNG);	// write ones to clear bits
-		delay_ms(100);
-		if ((Xil_In32(CF_BASEADDR + CF_REG_DATA_MONITOR) &
-				     (CF_DATA_MONITOR_PN_ERR |
-				     CF_DATA_MONITOR_PN_SYNC |
-				     CF_DATA_MONITOR_PN_OVER_RNG)) != 0)
-		{
-			xil_printf("  ERROR: PN status(%04x).\n\r",
-					   Xil_In32(CF_BASEADDR + CF_REG_DATA_MONITOR));
-		}
-		return;
-	}
-	for (n = 0; n < 32; n++)
-	{
-		rdata = Xil_In32(DDR_BASEADDR+(n*4));
-		if ((mode == MIDSCALE) && (format == OFFSET_BINARY)) edata = 0x80008000;
-		if ((mode == POS_FULLSCALE) && (format == OFFSET_BINARY)) edata = 0xffffffff;
-		if ((mode == NEG_FULLSCALE) && (format == OFFSET_BINARY)) edata = 0x00000000;
-		if ((mode == MIDSCALE) && (format == TWOS_COMPLEMENT)) edata = 0x00000000;
-		if ((mode == POS_FULLSCALE) && (format == TWOS_COMPLEMENT)) edata = 0x7fff7fff;
-		if ((mode == NEG_FULLSCALE) && (format == TWOS_COMPLEMENT)) edata = 0x80008000;
-		if (((mode == CHECKERBOARD) || (mode == ONE_ZERO_TOGGLE)) && (n == 0))
-		{
-			edata = (rdata & 0xffff);
-		}
-		if ((mode == CHECKERBOARD) && (n == 0))
-			edata = (edata == 0xaaaa) ? 0x5555aaaa : 0xaaaa5555;
-		if ((mode == ONE_ZERO_TOGGLE) && (n == 0))
-			edata = (edata == 0xffff) ? 0x0000ffff : 0xffff0000;
-		if (rdata != edata)
-		{
-			xil_printf("  ERROR[%2d]: rcv(%08x), exp(%08x)\n\r", n, rdata,
-					   edata);
-			error = 1;
-		}
-	}
-	if(error == 0)
-	{
-		xil_printf("          Test passed\r\n");
-	}
-}
-
-/***************************************************************************//**
- * @brief Initializes the AD9467 FPGA core.
- *
- * @param dco_delay - ADC delay.
- *
- * @return None.
-*******************************************************************************/
-void adc_setup(u32 dco_delay)
-{
-	Xil_Out32((CF_BASEADDR + CF_REG_DATA_MODE), CF_DATA_MODE_BITS(0x1));		// Samples are interleaved rising edge first and then falling edge.
-	Xil_Out32((CF_BASEADDR + CF_REG_PN_TYPE), CF_PN_TYPE_BIT(0));			    // Select PN9
-	Xil_Out32((CF_BASEADDR + CF_REG_DATA_SELECT), CF_DATA_SELECT_BIT(0));		// First byte from DDR appears on rising edge
-	Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL), 0x00000);						// clear bits
-	Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL), CF_DELAY_CTRL_SEL(1) |
-											   CF_DELAY_CTRL_WR_ADDR(0xF) |		// delay write
-											   CF_DELAY_CTRL_WR_DATA(0x1F));
-	Xil_Out32((CF_BASEADDR + CF_REG_DELAY_CTRL), CF_DELAY_CTRL_SEL(1) |			// delay write
-											   CF_DELAY_CTRL_WR_ADDR(0xF) |
-											   CF_DELAY_CTRL_WR_DATA(0x1F));
-	ad9467_test_mode(PN_23_SEQUENCE);		// Select PN 23 sequence test mode
-	ad9467_output_format(OFFSET_BINARY);	// Select output format as offset binary
-	ad9467_transfer();				  		// Synchronously update registers
-	Xil_Out32((CF_BASEADDR + CF_REG_PN_TYPE), CF_PN_TYPE_BIT(1));
-	ad9467_dco_clock_invert(0);		  		// Activates the non-inverted DCO clock
-	ad9467_transfer();				  		// Synchronously update registers
-	delay_ms(10);
-	if (adc_delay())
-	{
-		ad9467_dco_clock_invert(1); 	// Activates the inverted DCO clock
-		ad9467_transfer();				// Synchronously update registers
-		xil_printf("AD9467[REG_OUT_PHASE]: %02x\n\r",
-					ad9467_dco_clock_invert(-1));	 // reads the dco clock invert bit state
-		delay_ms(10);
-		if (adc_delay())
-		{
-			xil_printf("adc_setup: can not set a zero error delay!\n\r");
-			adc_delay_1(0);
-		}
-	}
-}
-
-void DisplayTestMode(u32 mode, u32 format)
-{
-	char *sMode;
-	char *sFormat;
-
-	switch(format)
-	{
-		case OFFSET_BINARY:
-			sFormat = "OFFSET BINARY";
-			break;
-		case TWOS_COMPLEMENT:
-			sFormat = "TWOS_COMPLEMENT";
-			break;
-		case GRAY_CODE:
-			sFormat = "GRAY_CODE";
-			break;
-		default:
-			sFormat = "";
-			break;
-	}
-	switch(mode)
-		{
-			case TEST_DISABLE:
-				sMode = "TEST_DISABLE BINARY";
-				break;
-			case MIDSCALE:
-				sMode = "MIDSCALE";
-				break;
-			case POS_FULLSCALE:
-				sMode = "POS_FULLSCALE";
-				break;
-			case NEG_FULLSCALE:
-				sMode = "NEG_FULLSCALE BINARY";
-				break;
-			case CHECKERBOARD:
-				sMode = "CHECKERBOARD";
-				break;
-			case PN_23_SEQUENCE:
-				sMode = "PN_23_SEQUENCE";
-				break;
-			case PN_9_SEQUENCE:
-				sMode = "PN_9_SEQUENCE";
-				break;
-			case ONE_ZERO_TOGGLE:
-				sMode = "ONE_ZERO_TOGGLE";
-				break;
-			default:
-				sMode = "";
-				break;
-		}
-	xil_printf("ADC Test: mode - %s\r\n          format - %s\n\r", sMode, sFormat);
-}
+/***************************************************************************//**
+ *   @file   cf_ad9467.c
+ *   @brief  Implementation of cf_ad9467 Driver.
+********************************************************************************
+ * Copyright 2012(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+********************************************************************************
+ *   SVN Revision: $WCREV$
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "cf_ad9467.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+#include "timer.h"
+#include "AD9467.h"
+#include "log.h"
+#include "fastmem.h"
+
+extern char inbyte(void);
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+/* State of the capture done interrupt path */
+static FAST_DATA volatile struct
+{
+	u32 enabled;
+	u32 done;		// the last capture completed
+	u32 overflow;	// an overflow occurred during the last capture
+	u32 address;	// start address of the last capture
+	u32 size;		// number of samples of the last capture
+} adc_irq;
+static FAST_DATA adc_capture_callback adc_irq_callback;
+/* The capture buffers are reached through the ACP, no cache maintenance */
+static FAST_DATA u32 adc_coherent = ADC_CAPTURE_ACP;
+
+/* State of the continuous capture. The filled and released counters have a
+   single writer each, so the completion can run from the interrupt. */
+static FAST_DATA volatile struct
+{
+	u32 address[ADC_STREAM_MAX_BUFFERS];
+	u32 overflow[ADC_STREAM_MAX_BUFFERS];
+	u32 size;
+	u32 nb_buffers;
+	u32 wr;			// buffer being captured
+	u32 rd;			// oldest filled buffer
+	u32 filled;		// buffers filled
+	u32 released;	// buffers released
+	u32 sent;		// buffers handed to the sink
+	u32 stalled;	// all the buffers are filled
+	u32 running;
+	u32 batch;		// buffers of the capture in progress
+	u32 coalesce;	// buffers allowed in the next capture
+	u32 max_buffers;
+	u32 max_us;
+	u32 buffer_us;
+	uint64_t start_us;	// start of the capture in progress
+	adc_stream_sink sink;
+	adc_stream_stats stats;
+} adc_stream = {.max_buffers = 1};
+
+/* Expected data of a lane of the software verifier. */
+typedef struct
+{
+	u32 mode;
+	u32 seed;		// samples left to seed the expected data
+	u32 value;	// fixed pattern or last expected sample
+	u32 state;	// PN generator state, the last bits of the sequence
+} adc_verify_lane;
+
+/* IDELAY search mode and the taps selected for each lane. */
+static int32_t adc_delay_search = ADC_DELAY_SEARCH_EDGE;
+static u32 adc_delay_taps[ADC_DELAY_LANES];
+
+/*****************************************************************************/
+/************************ Private Functions Prototypes ***********************/
+/*****************************************************************************/
+static void adc_capture_sync_cache(u32 address, u32 size);
+static void adc_stream_arm(void);
+static int32_t adc_stream_complete(u32 status);
+void DisplayTestMode(u32 mode, u32 format);
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Creates a delay of milliseconds.
+ *
+ * @param ms_count - Delay in milliseconds.
+ *
+ * @return None.
+*******************************************************************************/
+void delay_ms(u32 ms_count)
+{
+	TIMER_DelayMs(ms_count);
+}
+
+/***************************************************************************//**
+ * @brief Clears the status of the core and starts the capture of a number of
+ *        samples into the DMA.
+ *
+ * @param size - number of samples to capture, up to ADC_CAPTURE_MAX_SAMPLES
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_capture_core_start(u32 size)
+{
+	cf_regs *regs = CF_REGS;
+
+	regs->capture_ctrl = CF_CAPTURE_CTRL_CAPTURE_START(0);	// capture disable
+	regs->adc_status = CF_ADC_STATUS_UNDERFLOW |
+					   CF_ADC_STATUS_OVERFLOW |
+					   CF_ADC_STATUS_BUSY;					// clear status
+	regs->data_monitor = CF_DATA_MONITOR_PN_ERR |
+						 CF_DATA_MONITOR_PN_SYNC |
+						 CF_DATA_MONITOR_PN_OVER_RNG;		// clear status
+	regs->capture_ctrl = CF_CAPTURE_CTRL_CAPTURE_START(1) |
+						 CF_CAPTURE_CTRL_CAPTURE_COUNT(size);	// capture enable
+}
+
+/***************************************************************************//**
+ * @brief Sets up the DMA and starts the capture of a buffer.
+ *
+ * @param size - number of samples to capture
+ * @param address - capture start address
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_capture_arm(u32 size, u32 address)
+{
+	adc_irq.done = 0;
+	adc_irq.address = address;
+	adc_irq.size = size;
+	adc_capture_sync_cache(address, size);	// no dirty lines over the buffer
+	Xil_Out32((DMA_BASEADDR + 0x030), 0); 				// clear dma operations
+	Xil_Out32((DMA_BASEADDR + 0x030), 1 |
+			  (adc_irq.enabled ? DMA_S2MM_CR_IOC_IRQ_EN : 0)); // enable dma operations
+	Xil_Out32((DMA_BASEADDR + 0x048), address); 		// capture start address
+	Xil_Out32((DMA_BASEADDR + 0x058), (size * 8));  	// number of bytes
+	adc_capture_core_start(size);
+}
+
+/***************************************************************************//**
+ * @brief Invalidates the data cache over a capture buffer, so the processor
+ *        reads the data written by the DMA. Only the buffer is invalidated,
+ *        it must start and end on a cache line boundary (ADC_CACHE_LINE).
+ *        Nothing is done for the buffers written through the ACP.
+ *
+ * @param address - capture start address
+ * @param size - number of samples in the buffer
+ *
+ * @return None.
+*******************************************************************************/
+static FAST_CODE void adc_capture_sync_cache(u32 address, u32 size)
+{
+#ifdef _XPARAMETERS_PS_H_
+	if (adc_coherent)
+	{
+		return;
+	}
+	Xil_DCacheInvalidateRange(address, size * 8);
+#else
+	microblaze_invalidate_dcache_range(address, size * 8);
+#endif
+}
+
+/***************************************************************************//**
+ * @brief Starts the capture of a specified number of samples from the ADC
+ *        and returns without waiting for the capture to complete.
+ *
+ * @param size - number of samples to capture
+ * @param address - capture start address
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture_start(u32 size, u32 address)
+{
+	adc_capture_arm(size, address);
+}
+
+/***************************************************************************//**
+ * @brief Waits for the capture started by adc_capture_start() to complete.
+ *        With the capture done interrupt enabled the completion is signaled
+ *        by adc_capture_isr(), otherwise the busy bit of the core is polled
+ *        every ADC_CAPTURE_POLL_US microseconds.
+ *
+ * @return 1 if an overflow occurred during the capture, 0 otherwise.
+*******************************************************************************/
+u32 adc_capture_wait(void)
+{
+	if (adc_irq.enabled)
+	{
+		while (!adc_irq.done)
+		{
+			;
+		}
+		return adc_irq.overflow;
+	}
+	while ((Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_BUSY))
+	{
+		TIMER_DelayUs(ADC_CAPTURE_POLL_US);
+	}
+	adc_irq.overflow = (Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) &
+						CF_ADC_STATUS_OVERFLOW) ? 1 : 0;
+	adc_capture_sync_cache(adc_irq.address, adc_irq.size);
+
+	return adc_irq.overflow;
+}
+
+/***************************************************************************//**
+ * @brief Captures a specified number of samples from the ADC.
+ *
+ * @param size - number of samples to capture
+ * @param address - capture start address
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture(u32 size, u32 address)
+{
+	adc_capture_start(size, address);
+	if (adc_capture_wait())
+	{
+		LOG_WARN("overflow occurred, capture may be corrupted\n\r");
+	}
+}
+
+/***************************************************************************//**
+ * @brief Captures a number of samples spread over several DDR regions in one
+ *        go, using a chain of DMA descriptors. The regions are split in
+ *        descriptors of up to ADC_CAPTURE_MAX_SAMPLES samples, the capture
+ *        count of the core, and the core is started again as soon as each
+ *        descriptor is filled, without setting up the DMA again. Requires the
+ *        DMA to be built with scatter gather support.
+ *
+ * @param seg - the capture regions, aligned to ADC_CACHE_LINE
+ * @param nb_segments - number of capture regions
+ * @param desc_address - start address of the descriptors, aligned to
+ *                       DMA_DESC_SIZE, with room for ADC_SG_MAX_DESC
+ *                       descriptors
+ *
+ * @return 1 if an overflow occurred during the capture, 0 otherwise, -1 if the
+ *         regions are not aligned or need more than ADC_SG_MAX_DESC
+ *         descriptors, or if the DMA has no scatter gather support.
+*******************************************************************************/
+int32_t adc_capture_sg(adc_sg_segment *seg, u32 nb_segments, u32 desc_address)
+{
+	u32 desc_size[ADC_SG_MAX_DESC];
+	u32 nb_desc = 0;
+	u32 overflow = 0;
+	u32 offset;
+	u32 size;
+	u32 ba = 0;
+	u32 i;
+
+	if ((desc_address & (DMA_DESC_SIZE - 1)) ||
+		!(Xil_In32(DMA_BASEADDR + DMA_REG_S2MM_SR) & DMA_S2MM_SR_SG_INCLD))
+	{
+		return -1;
+	}
+	for (i = 0; i < nb_segments; i++)
+	{
+		if (seg[i].address & (ADC_CACHE_LINE - 1))
+		{
+			return -1;
+		}
+		for (offset = 0; offset < seg[i].size; offset += size)
+		{
+			if (nb_desc == ADC_SG_MAX_DESC)
+			{
+				return -1;
+			}
+			size = seg[i].size - offset;
+			if (size > ADC_CAPTURE_MAX_SAMPLES)
+			{
+				size = ADC_CAPTURE_MAX_SAMPLES;
+			}
+			ba = desc_address + (nb_desc * DMA_DESC_SIZE);
+			Xil_Out32((ba + DMA_DESC_NEXT), (ba + DMA_DESC_SIZE));
+			Xil_Out32((ba + DMA_DESC_ADDR), (seg[i].address + (offset * 8)));
+			Xil_Out32((ba + DMA_DESC_CTRL), (size * 8));
+			Xil_Out32((ba + DMA_DESC_STATUS), 0);
+			desc_size[nb_desc++] = size;
+		}
+		adc_capture_sync_cache(seg[i].address, seg[i].size);
+	}
+	if (nb_desc == 0)
+	{
+		return -1;
+	}
+	Xil_Out32((ba + DMA_DESC_NEXT), desc_address);
+#ifdef _XPARAMETERS_PS_H_
+	Xil_DCacheFlushRange(desc_address, (nb_desc * DMA_DESC_SIZE));
+#else
+	microblaze_flush_dcache_range(desc_address, (nb_desc * DMA_DESC_SIZE));
+#endif
+
+	Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_CR), DMA_S2MM_CR_RESET);
+	while (Xil_In32(DMA_BASEADDR + DMA_REG_S2MM_CR) & DMA_S2MM_CR_RESET)
+	{
+		;
+	}
+	Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_CURDESC), desc_address);
+	Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_CR), DMA_S2MM_CR_RUN);
+	Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_TAILDESC), ba);
+	for (i = 0; i < nb_desc; i++)
+	{
+		adc_capture_core_start(desc_size[i]);
+		while (Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_BUSY)
+		{
+			;
+		}
+		if (Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_OVERFLOW)
+		{
+			overflow = 1;
+		}
+	}
+	/* The last descriptor completes once its data is in DDR. */
+	do
+	{
+#ifdef _XPARAMETERS_PS_H_
+		Xil_DCacheInvalidateRange(ba, DMA_DESC_SIZE);
+#else
+		microblaze_invalidate_dcache_range(ba, DMA_DESC_SIZE);
+#endif
+	}
+	while (!(Xil_In32(ba + DMA_DESC_STATUS) & DMA_DESC_STATUS_CMPLT));
+	for (i = 0; i < nb_segments; i++)
+	{
+		adc_capture_sync_cache(seg[i].address, seg[i].size);
+	}
+
+	return overflow;
+}
+
+/***************************************************************************//**
+ * @brief Starts a continuous capture into a ring of buffers. The buffers are
+ *        filled in order; the capture of the next buffer is started from the
+ *        completion path, so the application can process a filled buffer
+ *        while the following one is captured. When all the buffers are
+ *        filled the capture stalls until a buffer is released.
+ *
+ * @param size - number of samples to capture in each buffer
+ * @param address - start addresses of the buffers
+ * @param nb_buffers - number of buffers, 2 to ADC_STREAM_MAX_BUFFERS
+ *
+ * @return 0 in case of success, -1 if the number of buffers is not supported
+ *         or a buffer is not aligned to ADC_CACHE_LINE.
+*******************************************************************************/
+int32_t adc_stream_start(u32 size, u32 *address, u32 nb_buffers)
+{
+	u32 i;
+
+	if ((nb_buffers < 2) || (nb_buffers > ADC_STREAM_MAX_BUFFERS))
+	{
+		return -1;
+	}
+	for (i = 0; i < nb_buffers; i++)
+	{
+		if (address[i] & (ADC_CACHE_LINE - 1))
+		{
+			return -1;
+		}
+		adc_stream.address[i] = address[i];
+		adc_stream.overflow[i] = 0;
+	}
+	adc_stream.size = size;
+	adc_stream.nb_buffers = nb_buffers;
+	adc_stream.wr = 0;
+	adc_stream.rd = 0;
+	adc_stream.filled = 0;
+	adc_stream.released = 0;
+	adc_stream.sent = 0;
+	adc_stream.stalled = 0;
+	adc_stream.stats.captures = 0;
+	adc_stream.stats.overflows = 0;
+	adc_stream.stats.stalls = 0;
+	adc_stream.stats.sent = 0;
+	adc_stream.stats.completions = 0;
+	adc_stream.coalesce = 1;
+	adc_stream.buffer_us = 0;
+	adc_stream.running = 1;
+	adc_stream_arm();
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Sets the completion coalescing of the continuous capture. Buffers
+ *        which follow each other in memory are captured in one go, so one
+ *        interrupt completes several buffers. The number of buffers per
+ *        capture adapts to the backlog of the consumer: it doubles when more
+ *        buffers wait than one capture brings and halves when the consumer
+ *        has caught up, so the latency stays low at light load and the
+ *        interrupt rate stays bounded at full rate. It is also limited by
+ *        the free buffers, by ADC_CAPTURE_MAX_SAMPLES and by max_us.
+ *
+ * @param max_buffers - buffers completed at once at most, 1 to complete each
+ *                      buffer on its own
+ * @param max_us - capture time after which the buffers are completed
+ *                 whatever their number, 0 for no limit
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_set_coalesce(u32 max_buffers, u32 max_us)
+{
+	adc_stream.max_buffers = max_buffers ? max_buffers : 1;
+	adc_stream.max_us = max_us;
+	if (adc_stream.coalesce > adc_stream.max_buffers)
+	{
+		adc_stream.coalesce = adc_stream.max_buffers;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Starts the capture of the next buffers of the continuous capture.
+ *        The capture covers up to the number of buffers allowed by the
+ *        coalescing, as long as they are free, contiguous in memory and not
+ *        past the end of the ring.
+ *
+ * @return None.
+*******************************************************************************/
+static FAST_CODE void adc_stream_arm(void)
+{
+	u32 free = adc_stream.nb_buffers - (adc_stream.filled - adc_stream.released);
+	u32 max = adc_stream.coalesce;
+	u32 wr = adc_stream.wr;
+	u32 n = 1;
+
+	if (adc_stream.max_us && adc_stream.buffer_us &&
+		((adc_stream.max_us / adc_stream.buffer_us) < max))
+	{
+		max = adc_stream.max_us / adc_stream.buffer_us;
+	}
+	while ((n < max) && (n < free) && ((wr + n) < adc_stream.nb_buffers) &&
+		   (((n + 1) * adc_stream.size) <= ADC_CAPTURE_MAX_SAMPLES) &&
+		   (adc_stream.address[wr + n] ==
+			(adc_stream.address[wr] + (n * adc_stream.size * 8))))
+	{
+		n++;
+	}
+	adc_stream.batch = n;
+	adc_stream.start_us = TIMER_GetTimeUs();
+	adc_capture_arm(n * adc_stream.size, adc_stream.address[wr]);
+}
+
+/***************************************************************************//**
+ * @brief Checks the continuous capture for completion when the capture done
+ *        interrupt is not used. Must be called often enough to keep the
+ *        capture running.
+ *
+ * @return Index of the first buffer which was filled, -1 if no capture
+ *         completed.
+*******************************************************************************/
+int32_t adc_stream_poll(void)
+{
+	u32 status;
+
+	if (!adc_stream.running || adc_stream.stalled || adc_irq.enabled)
+	{
+		return -1;
+	}
+	status = Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS);
+	if (status & CF_ADC_STATUS_BUSY)
+	{
+		return -1;
+	}
+
+	return adc_stream_complete(status);
+}
+
+/***************************************************************************//**
+ * @brief Completion path of the continuous capture. Records the overflow
+ *        status of the buffers which were filled, adapts the coalescing to
+ *        the backlog and starts the capture of the next ones. An overflow is
+ *        reported on all the buffers of the capture.
+ *
+ * @param status - the ADC status at the end of the capture
+ *
+ * @return Index of the first buffer which was filled.
+*******************************************************************************/
+static FAST_CODE int32_t adc_stream_complete(u32 status)
+{
+	u32 overflow = (status & CF_ADC_STATUS_OVERFLOW) ? 1 : 0;
+	u32 backlog;
+	u32 i;
+	int32_t done;
+
+	done = adc_stream.wr;
+	adc_stream.buffer_us = (u32)(TIMER_GetTimeUs() - adc_stream.start_us) /
+						   adc_stream.batch;
+	adc_capture_sync_cache(adc_stream.address[done],
+						   adc_stream.batch * adc_stream.size);
+	for (i = 0; i < adc_stream.batch; i++)
+	{
+		adc_stream.overflow[adc_stream.wr] = overflow;
+		adc_stream.filled++;
+		adc_stream.wr = (adc_stream.wr + 1) % adc_stream.nb_buffers;
+	}
+	adc_stream.stats.captures += adc_stream.batch;
+	adc_stream.stats.overflows += overflow * adc_stream.batch;
+	adc_stream.stats.completions++;
+	backlog = adc_stream.filled - adc_stream.released;
+	if ((backlog > adc_stream.batch) && (adc_stream.coalesce < adc_stream.max_buffers))
+	{
+		adc_stream.coalesce *= 2;
+		if (adc_stream.coalesce > adc_stream.max_buffers)
+		{
+			adc_stream.coalesce = adc_stream.max_buffers;
+		}
+	}
+	else if ((backlog <= adc_stream.batch) && (adc_stream.coalesce > 1))
+	{
+		adc_stream.coalesce /= 2;
+	}
+	if (backlog < adc_stream.nb_buffers)
+	{
+		adc_stream_arm();
+	}
+	else
+	{
+		adc_stream.stalled = 1;
+		adc_stream.stats.stalls++;
+	}
+
+	return done;
+}
+
+/***************************************************************************//**
+ * @brief Gets the oldest filled buffer of the continuous capture.
+ *
+ * @param address - the start address of the buffer
+ * @param overflow - set to 1 if an overflow occurred while the buffer was
+ *                   captured, 0 otherwise
+ *
+ * @return Index of the buffer, -1 if no buffer is filled.
+*******************************************************************************/
+int32_t adc_stream_get(u32 *address, u32 *overflow)
+{
+	adc_stream_poll();
+	if (adc_stream.filled == adc_stream.released)
+	{
+		return -1;
+	}
+	*address = adc_stream.address[adc_stream.rd];
+	*overflow = adc_stream.overflow[adc_stream.rd];
+
+	return adc_stream.rd;
+}
+
+/***************************************************************************//**
+ * @brief Releases the oldest filled buffer of the continuous capture, so it
+ *        can be captured again.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_release(void)
+{
+	if (adc_stream.filled == adc_stream.released)
+	{
+		return;
+	}
+	adc_stream.rd = (adc_stream.rd + 1) % adc_stream.nb_buffers;
+	adc_stream.released++;
+	if (adc_stream.running && adc_stream.stalled)
+	{
+		adc_stream.stalled = 0;
+		adc_stream_arm();
+	}
+}
+
+/***************************************************************************//**
+ * @brief Sets the streaming sink of the continuous capture. The filled
+ *        buffers are handed to the sink in place, without copying.
+ *
+ * @param sink - the streaming sink, NULL to read the buffers with
+ *               adc_stream_get() and adc_stream_release()
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_set_sink(adc_stream_sink sink)
+{
+	adc_stream.sent = adc_stream.released;
+	adc_stream.sink = sink;
+}
+
+/***************************************************************************//**
+ * @brief Hands the filled buffers of the continuous capture to the streaming
+ *        sink, in capture order. A buffer refused by the sink is handed again
+ *        on the next call. Must be called often enough to keep the capture
+ *        running.
+ *
+ * @return Number of buffers handed to the sink, -1 if no sink is set.
+*******************************************************************************/
+int32_t adc_stream_sink_process(void)
+{
+	u32 idx;
+	int32_t nb = 0;
+
+	if (!adc_stream.sink)
+	{
+		return -1;
+	}
+	adc_stream_poll();
+	while (adc_stream.sent != adc_stream.filled)
+	{
+		idx = (adc_stream.rd + (adc_stream.sent - adc_stream.released)) %
+			  adc_stream.nb_buffers;
+		if (adc_stream.sink(adc_stream.address[idx], adc_stream.size * 8,
+							adc_stream.overflow[idx]) < 0)
+		{
+			break;
+		}
+		adc_stream.sent++;
+		adc_stream.stats.sent++;
+		nb++;
+	}
+
+	return nb;
+}
+
+/***************************************************************************//**
+ * @brief Returns the oldest buffer handed to the streaming sink to the
+ *        continuous capture once it is transmitted. The transmit path must
+ *        complete the buffers in the order they were handed.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_tx_done(void)
+{
+	if (adc_stream.sent == adc_stream.released)
+	{
+		return;
+	}
+	adc_stream_release();
+}
+
+/***************************************************************************//**
+ * @brief Stops the continuous capture. The capture in progress, if any, is
+ *        left to complete.
+ *
+ * @param stats - the capture counters, can be NULL
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_stop(adc_stream_stats *stats)
+{
+	adc_stream.running = 0;
+	if (stats)
+	{
+		*stats = adc_stream.stats;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Gets the counters of the continuous capture.
+ *
+ * @param stats - the capture counters
+ *
+ * @return None.
+*******************************************************************************/
+void adc_stream_get_stats(adc_stream_stats *stats)
+{
+	*stats = adc_stream.stats;
+	stats->coalesce = adc_stream.coalesce;
+	stats->buffer_us = adc_stream.buffer_us;
+}
+
+/***************************************************************************//**
+ * @brief Enables the capture done interrupt. adc_capture_isr() must be
+ *        connected to the S2MM interrupt of the DMA by the application.
+ *
+ * @param callback - function called from the interrupt with the start
+ *                   address and the overflow status of each completed
+ *                   capture, can be NULL
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture_irq_enable(adc_capture_callback callback)
+{
+	adc_irq_callback = callback;
+	adc_irq.enabled = 1;
+}
+
+/***************************************************************************//**
+ * @brief Disables the capture done interrupt, the captures are polled again.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture_irq_disable(void)
+{
+	adc_irq.enabled = 0;
+	Xil_Out32((DMA_BASEADDR + 0x030),
+			  Xil_In32(DMA_BASEADDR + 0x030) & ~DMA_S2MM_CR_IOC_IRQ_EN);
+	adc_irq_callback = 0;
+}
+
+/***************************************************************************//**
+ * @brief Selects whether the capture buffers are coherent with the caches.
+ *        On Zynq, a capture DMA connected to the ACP port writes through the
+ *        SCU and the captures can be read as soon as they complete, without
+ *        any cache maintenance. The buffers still have to be in memory
+ *        reached through the ACP, the MicroBlaze builds ignore the setting.
+ *
+ * @param enable - 1 if the capture DMA writes through the ACP port.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_capture_set_coherent(u32 enable)
+{
+#ifdef _XPARAMETERS_PS_H_
+	adc_coherent = enable;
+#else
+	adc_coherent = 0;
+#endif
+}
+
+/***************************************************************************//**
+ * @brief Capture done interrupt handler. Completes the single capture or the
+ *        buffer of the continuous capture and calls the completion callback.
+ *
+ * @param ref - not used
+ *
+ * @return None.
+*******************************************************************************/
+FAST_CODE void adc_capture_isr(void *ref)
+{
+	u32 status;
+	u32 address;
+	int32_t done;
+
+	Xil_Out32((DMA_BASEADDR + DMA_REG_S2MM_SR), DMA_S2MM_SR_IOC_IRQ);
+	status = Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS);
+	if (adc_stream.running && !adc_stream.stalled)
+	{
+		done = adc_stream_complete(status);
+		address = adc_stream.address[done];
+		adc_irq.overflow = adc_stream.overflow[done];
+	}
+	else
+	{
+		address = adc_irq.address;
+		adc_irq.overflow = (status & CF_ADC_STATUS_OVERFLOW) ? 1 : 0;
+		adc_capture_sync_cache(adc_irq.address, adc_irq.size);
+	}
+	adc_irq.done = 1;
+	if (adc_irq_callback)
+	{
+		adc_irq_callback(address, adc_irq.overflow);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Writes the IDELAY tap of a data lane.
+ *
+ * @param lane - the data lane
+ * @param delay - the tap
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_delay_write(u32 lane, u32 delay)
+{
+	cf_regs *regs = CF_REGS;
+
+	/* The core starts the IDELAY access on the rising edge of SEL, the
+	   clear makes the edge and a single write loads the tap. */
+	regs->delay_ctrl = 0x000000;							// clear bits
+	regs->delay_ctrl = CF_DELAY_CTRL_SEL(1) |
+					   CF_DELAY_CTRL_RW_ENABLE(0) |
+					   CF_DELAY_CTRL_WR_ADDR(lane) |
+					   CF_DELAY_CTRL_WR_DATA(delay);		// delay write
+}
+
+/***************************************************************************//**
+ * @brief Reads back the IDELAY status of a data lane.
+ *
+ * @param lane - the data lane
+ *
+ * @return The delay status register.
+*******************************************************************************/
+static u32 adc_delay_read(u32 lane)
+{
+	cf_regs *regs = CF_REGS;
+	u32 ctrl;
+
+	ctrl = CF_DELAY_CTRL_SEL(1) |
+		   CF_DELAY_CTRL_RW_ENABLE(1) |
+		   CF_DELAY_CTRL_WR_ADDR(lane);
+	regs->delay_ctrl = 0x000000;							// clear bits
+	regs->delay_ctrl = ctrl;								// delay read
+	/* The repeated write gives the status register the time to be updated
+	   from the IDELAY clock domain before it is read. */
+	regs->delay_ctrl = ctrl;
+
+	return regs->delay_status;
+}
+
+/***************************************************************************//**
+ * @brief ADC delay.
+ *
+ * @param delay - Value of the delay.
+ *
+ * @return 0.
+*******************************************************************************/
+u32 adc_delay_1(u32 delay)
+{
+	u32 i;
+	u32 rdata;
+
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		adc_delay_write(i, delay);
+		adc_delay_taps[i] = delay;
+	}
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		rdata = adc_delay_read(i);
+		if (rdata != (CF_DELAY_STATUS_LOCKED | CF_DELAY_CTRL_WR_DATA(delay)))
+		{
+			LOG_ERROR("adc_delay_1: sel(%2d), data(%04x)\n\r", i, rdata);
+		}
+	}
+
+	return(0);
+}
+
+/***************************************************************************//**
+ * @brief Writes a separate IDELAY tap to each data lane.
+ *
+ * @param delay - the taps, ADC_DELAY_LANES entries
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_delay_set_lanes(int32_t *delay)
+{
+	u32 i;
+
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		adc_delay_write(i, delay[i]);
+		adc_delay_taps[i] = delay[i];
+	}
+}
+
+/***************************************************************************//**
+ * @brief Captures the checkerboard test pattern and checks it in software.
+ *        Lane i carries the bits 2i and 2i + 1 of the samples, so a bit in
+ *        error points to its lane.
+ *
+ * @return Mask of the data lanes in error.
+*******************************************************************************/
+static u32 adc_delay_lane_errors(void)
+{
+	adc_verify_result result;
+	u32 mask;
+	u32 lanes = 0;
+	u32 i;
+
+	TIMER_DelayUs(ADC_DELAY_SETTLE_US);
+	adc_capture(ADC_DELAY_CAPTURE_SAMPLES, DDR_BASEADDR);
+	if (adc_verify(CHECKERBOARD, OFFSET_BINARY, DDR_BASEADDR,
+				   ADC_DELAY_CAPTURE_SAMPLES, &result) < 0)
+	{
+		return (1 << ADC_DELAY_LANES) - 1;
+	}
+	mask = result.diff_mask[0] | result.diff_mask[1];
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		if (mask & (0x3 << (2 * i)))
+		{
+			lanes |= (1 << i);
+		}
+	}
+
+	return lanes;
+}
+
+/***************************************************************************//**
+ * @brief Finds the eye of each data lane: a coarse pass over every
+ *        ADC_DELAY_COARSE_STEP taps with all the lanes together, then the
+ *        first and last good taps are bisected for all the lanes in
+ *        parallel, each lane with its own tap. The eye of a lane must be a
+ *        single window of good taps.
+ *
+ * @param delay - the center tap of each lane, ADC_DELAY_LANES entries
+ *
+ * @return 0 in case of success, 1 if a lane has no good tap.
+*******************************************************************************/
+static u32 adc_delay_search_edges(int32_t *delay)
+{
+	int32_t lo[ADC_DELAY_LANES];	// last bad tap before the eye
+	int32_t first[ADC_DELAY_LANES];	// first good tap found
+	int32_t last[ADC_DELAY_LANES];	// last good tap found
+	int32_t hi[ADC_DELAY_LANES];	// first bad tap after the eye
+	int32_t tap[ADC_DELAY_LANES];
+	u32 found = 0;
+	u32 busy;
+	u32 fail;
+	u32 i;
+	int32_t t;
+
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		lo[i] = -1;
+		hi[i] = ADC_DELAY_TAPS;
+	}
+	for (t = 0; t < ADC_DELAY_TAPS; t += ADC_DELAY_COARSE_STEP)
+	{
+		for (i = 0; i < ADC_DELAY_LANES; i++)
+		{
+			tap[i] = t;
+		}
+		adc_delay_set_lanes(tap);
+		fail = adc_delay_lane_errors();
+		for (i = 0; i < ADC_DELAY_LANES; i++)
+		{
+			if (!(found & (1 << i)))
+			{
+				if (fail & (1 << i))
+				{
+					lo[i] = t;
+				}
+				else
+				{
+					first[i] = t;
+					last[i] = t;
+					found |= (1 << i);
+				}
+			}
+			else if (hi[i] == ADC_DELAY_TAPS)
+			{
+				if (fail & (1 << i))
+				{
+					hi[i] = t;
+				}
+				else
+				{
+					last[i] = t;
+				}
+			}
+		}
+	}
+	if (found != ((1 << ADC_DELAY_LANES) - 1))
+	{
+		return 1;
+	}
+	/* First good taps, lo fails and first passes */
+	do
+	{
+		busy = 0;
+		for (i = 0; i < ADC_DELAY_LANES; i++)
+		{
+			tap[i] = first[i];
+			if ((first[i] - lo[i]) > 1)
+			{
+				tap[i] = (lo[i] + first[i]) / 2;
+				busy |= (1 << i);
+			}
+		}
+		if (busy)
+		{
+			adc_delay_set_lanes(tap);
+			fail = adc_delay_lane_errors();
+			for (i = 0; i < ADC_DELAY_LANES; i++)
+			{
+				if (busy & fail & (1 << i))
+				{
+					lo[i] = tap[i];
+				}
+				else if (busy & (1 << i))
+				{
+					first[i] = tap[i];
+				}
+			}
+		}
+	}
+	while (busy);
+	/* Last good taps, last passes and hi fails */
+	do
+	{
+		busy = 0;
+		for (i = 0; i < ADC_DELAY_LANES; i++)
+		{
+			tap[i] = last[i];
+			if ((hi[i] - last[i]) > 1)
+			{
+				tap[i] = (last[i] + hi[i]) / 2;
+				busy |= (1 << i);
+			}
+		}
+		if (busy)
+		{
+			adc_delay_set_lanes(tap);
+			fail = adc_delay_lane_errors();
+			for (i = 0; i < ADC_DELAY_LANES; i++)
+			{
+				if (busy & fail & (1 << i))
+				{
+					hi[i] = tap[i];
+				}
+				else if (busy & (1 << i))
+				{
+					last[i] = tap[i];
+				}
+			}
+		}
+	}
+	while (busy);
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		delay[i] = first[i] + ((last[i] - first[i]) / 2);
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Sets the same IDELAY tap to all the data lanes: every tap is checked
+ *        with the PN monitor and the center of the first window is selected.
+ *
+ * @return 0 in case of success, 1 if no tap is free of errors.
+*******************************************************************************/
+static u32 adc_delay_full(void)
+{
+	u32 delay;
+	u32 error;
+	u32 lasterr;
+	u32 startdelay;
+	u32 stopdelay;
+
+	lasterr = 1;
+	startdelay = 32;
+	stopdelay = 31;
+	for (delay = 0; delay < 32; delay++)
+	{
+		adc_delay_1(delay);
+		delay_ms(10);
+		Xil_Out32((CF_BASEADDR + CF_REG_DATA_MONITOR),
+				   CF_DATA_MONITOR_PN_ERR |
+				   CF_DATA_MONITOR_PN_SYNC |
+				   CF_DATA_MONITOR_PN_OVER_RNG);		// writer ones to clear bits
+		delay_ms(100);
+		error = Xil_In32(CF_BASEADDR + CF_REG_DATA_MONITOR) &
+						(CF_DATA_MONITOR_PN_ERR |
+					     CF_DATA_MONITOR_PN_SYNC |
+						 CF_DATA_MONITOR_PN_OVER_RNG);	// read the status of ADC data monitoring
+		if (error == 0)
+		{
+			if (lasterr == 1)
+			{
+				startdelay = delay;
+			}
+			lasterr = 0;
+		}
+		else
+		{
+			if (lasterr == 0)
+			{
+				stopdelay = delay;
+				break;
+			}
+			lasterr = 1;
+		}
+	}
+	if (startdelay > 31)
+	{
+		adc_delay_1(0);
+		return(1);
+	}
+	delay = startdelay + ((stopdelay - startdelay)/2);
+	adc_delay_1(delay);
+
+	return(0);
+}
+
+/***************************************************************************//**
+ * @brief Selects the IDELAY search mode of adc_delay().
+ *
+ * @param mode - ADC_DELAY_SEARCH_EDGE or ADC_DELAY_SEARCH_FULL. Any other
+ *               value returns the current mode.
+ *
+ * @return Returns the selected mode.
+*******************************************************************************/
+int32_t adc_delay_search_mode(int32_t mode)
+{
+	if ((mode == ADC_DELAY_SEARCH_EDGE) || (mode == ADC_DELAY_SEARCH_FULL))
+	{
+		adc_delay_search = mode;
+	}
+
+	return adc_delay_search;
+}
+
+/***************************************************************************//**
+ * @brief Gets the IDELAY taps selected by the last adc_delay().
+ *
+ * @param delay - the tap of each lane, ADC_DELAY_LANES entries
+ *
+ * @return None.
+*******************************************************************************/
+void adc_delay_get_lanes(u32 *delay)
+{
+	u32 i;
+
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		delay[i] = adc_delay_taps[i];
+	}
+}
+
+/***************************************************************************//**
+ * @brief ADC delay. With ADC_DELAY_SEARCH_EDGE each data lane gets the center
+ *        of its own eye, found with the checkerboard pattern, and the result
+ *        is checked with the PN 23 monitor for ADC_DELAY_CONFIRM_US. The full
+ *        scan is used if either step fails. The ADC is left in the PN 23
+ *        test mode.
+ *
+ * @return 0 in case of success, 1 if no tap is free of errors.
+*******************************************************************************/
+u32 adc_delay(void)
+{
+	int32_t delay[ADC_DELAY_LANES];
+	u32 ret;
+	u32 error;
+
+	if (adc_delay_search == ADC_DELAY_SEARCH_FULL)
+	{
+		return adc_delay_full();
+	}
+	ad9467_test_mode(CHECKERBOARD);
+	ad9467_transfer();
+	ret = adc_delay_search_edges(delay);
+	ad9467_test_mode(PN_23_SEQUENCE);
+	ad9467_transfer();
+	if (ret)
+	{
+		return adc_delay_full();
+	}
+	adc_delay_set_lanes(delay);
+	TIMER_DelayUs(ADC_DELAY_SETTLE_US);
+	Xil_Out32((CF_BASEADDR + CF_REG_DATA_MONITOR),
+			   CF_DATA_MONITOR_PN_ERR |
+			   CF_DATA_MONITOR_PN_SYNC |
+			   CF_DATA_MONITOR_PN_OVER_RNG);		// write ones to clear bits
+	TIMER_DelayUs(ADC_DELAY_CONFIRM_US);
+	error = Xil_In32(CF_BASEADDR + CF_REG_DATA_MONITOR) &
+					(CF_DATA_MONITOR_PN_ERR |
+					 CF_DATA_MONITOR_PN_SYNC |
+					 CF_DATA_MONITOR_PN_OVER_RNG);	// read the status of ADC data monitoring
+	if (error)
+	{
+		return adc_delay_full();
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Tracks the IDELAY margin of the data lanes. The checkerboard pattern
+ *        is checked at the tap of each lane and at its two neighbours, and a
+ *        lane moves one tap away from a failing neighbour while the other
+ *        neighbour passes, before the errors reach the current tap. Taps
+ *        outside the delay line are not checked and count as passing. The
+ *        ADC outputs the checkerboard pattern and the buffer at DDR_BASEADDR
+ *        is overwritten during the test window, the previous test mode is
+ *        restored at the end.
+ *
+ * @return Mask of the lanes which were moved, or -1 if a lane fails at its
+ *         tap and at both neighbours. The taps are then left unchanged and
+ *         adc_delay() must be run.
+*******************************************************************************/
+int32_t adc_delay_track(void)
+{
+	int32_t cur[ADC_DELAY_LANES];
+	int32_t tap[ADC_DELAY_LANES];
+	u32 fail[3];
+	u32 moved = 0;
+	u32 lost = 0;
+	u32 bit;
+	int32_t mode;
+	int32_t i;
+	int32_t k;
+
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		cur[i] = adc_delay_taps[i];
+	}
+	mode = ad9467_test_mode(-1);
+	ad9467_test_mode(CHECKERBOARD);
+	ad9467_transfer();
+	for (k = 0; k < 3; k++)
+	{
+		for (i = 0; i < ADC_DELAY_LANES; i++)
+		{
+			tap[i] = cur[i] + k - 1;
+			if ((tap[i] < 0) || (tap[i] >= ADC_DELAY_TAPS))
+			{
+				tap[i] = cur[i];
+			}
+		}
+		adc_delay_set_lanes(tap);
+		fail[k] = adc_delay_lane_errors();
+	}
+	for (i = 0; i < ADC_DELAY_LANES; i++)
+	{
+		bit = 1 << i;
+		if (cur[i] == 0)
+		{
+			fail[0] &= ~bit;
+		}
+		if (cur[i] == (ADC_DELAY_TAPS - 1))
+		{
+			fail[2] &= ~bit;
+		}
+		tap[i] = cur[i];
+		if (fail[1] & bit)
+		{
+			if ((cur[i] < (ADC_DELAY_TAPS - 1)) && !(fail[2] & bit))
+			{
+				tap[i] = cur[i] + 1;
+			}
+			else if ((cur[i] > 0) && !(fail[0] & bit))
+			{
+				tap[i] = cur[i] - 1;
+			}
+			else
+			{
+				lost |= bit;
+			}
+		}
+		else if ((fail[0] & bit) && !(fail[2] & bit) &&
+				 (cur[i] < (ADC_DELAY_TAPS - 1)))
+		{
+			tap[i] = cur[i] + 1;
+		}
+		else if ((fail[2] & bit) && !(fail[0] & bit) && (cur[i] > 0))
+		{
+			tap[i] = cur[i] - 1;
+		}
+		if (tap[i] != cur[i])
+		{
+			moved |= bit;
+		}
+	}
+	adc_delay_set_lanes(lost ? cur : tap);
+	if (mode >= 0)
+	{
+		ad9467_test_mode(mode);
+		ad9467_transfer();
+	}
+
+	return lost ? -1 : (int32_t)moved;
+}
+
+/***************************************************************************//**
+ * @brief Counts the bits set in a word.
+ *
+ * @param data - the word
+ *
+ * @return Number of bits set.
+*******************************************************************************/
+static u32 adc_popcount(u32 data)
+{
+	data = data - ((data >> 1) & 0x55555555);
+	data = (data & 0x33333333) + ((data >> 2) & 0x33333333);
+	data = (data + (data >> 4)) & 0x0f0f0f0f;
+
+	return (data * 0x01010101) >> 24;
+}
+
+/***************************************************************************//**
+ * @brief Generates the next sample of a PN sequence x^n + x^k + 1, most
+ *        significant bit first. The bits are generated k at a time, as they
+ *        only depend on bits which are already known.
+ *
+ * @param state - the PN generator state, bit 0 is the last bit of the sequence
+ * @param n - degree of the generator polynomial
+ * @param k - degree of the middle term of the generator polynomial
+ *
+ * @return The next ADC_SAMPLE_WIDTH bits of the sequence.
+*******************************************************************************/
+static u32 adc_pn_next(u32 *state, u32 n, u32 k)
+{
+	u32 sample = 0;
+	u32 width = ADC_SAMPLE_WIDTH;
+	u32 bits;
+	u32 data;
+
+	while (width)
+	{
+		bits = (width < k) ? width : k;
+		data = ((*state >> (n - bits)) ^ (*state >> (k - bits))) &
+			   ((1 << bits) - 1);
+		*state = (*state << bits) | data;
+		sample = (sample << bits) | data;
+		width -= bits;
+	}
+
+	return sample;
+}
+
+/***************************************************************************//**
+ * @brief Converts a sample to offset binary, the format the expected data of
+ *        the software verifier is generated in.
+ *
+ * @param sample - the sample
+ * @param format - the output format of the ADC
+ *
+ * @return The sample in offset binary.
+*******************************************************************************/
+static u32 adc_verify_convert(u32 sample, u32 format)
+{
+	if (format == TWOS_COMPLEMENT)
+	{
+		sample ^= (1 << (ADC_SAMPLE_WIDTH - 1));
+	}
+	if (format == GRAY_CODE)
+	{
+		sample ^= (sample >> 1);
+		sample ^= (sample >> 2);
+		sample ^= (sample >> 4);
+		sample ^= (sample >> 8);
+	}
+	return sample;
+}
+
+/***************************************************************************//**
+ * @brief Advances the expected data of a lane by one sample.
+ *
+ * @param lane - the expected data of the lane, seeded
+ *
+ * @return The expected sample, in offset binary.
+*******************************************************************************/
+static u32 adc_verify_expected(adc_verify_lane *lane)
+{
+	switch (lane->mode)
+	{
+		case CHECKERBOARD:
+		case ONE_ZERO_TOGGLE:
+			lane->value ^= ADC_SAMPLE_MASK;
+			return lane->value;
+		case PN_9_SEQUENCE:
+			return adc_pn_next(&lane->state, 9, 5);
+		case PN_23_SEQUENCE:
+			return adc_pn_next(&lane->state, 23, 18);
+		default:
+			return lane->value;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Checks a sample of a lane against the expected data.
+ *
+ * @param lane - the expected data of the lane
+ * @param sample - the sample, in offset binary
+ * @param result - the counters of the lane are updated
+ * @param idx - index of the lane in the result
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_verify_check(adc_verify_lane *lane, u32 sample,
+							 adc_verify_result *result, u32 idx)
+{
+	u32 diff;
+
+	if (lane->seed)
+	{
+		lane->seed--;
+		lane->state = (lane->state << ADC_SAMPLE_WIDTH) | sample;
+		lane->value = sample;
+		return;
+	}
+	diff = sample ^ adc_verify_expected(lane);
+	result->samples[idx]++;
+	if (diff)
+	{
+		result->errors[idx]++;
+		result->bit_errors[idx] += adc_popcount(diff);
+		result->diff_mask[idx] |= diff;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Checks both lanes of a captured word against the expected data.
+ *
+ * @param lane - the expected data of the lanes
+ * @param format - the output format of the ADC
+ * @param data - the captured word
+ * @param result - the counters of the lanes are updated
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_verify_word(adc_verify_lane *lane, u32 format, u32 data,
+							adc_verify_result *result)
+{
+	adc_verify_check(&lane[0],
+					 adc_verify_convert((data >> ADC_SAMPLE_SHIFT) &
+										ADC_SAMPLE_MASK, format),
+					 result, 0);
+	adc_verify_check(&lane[ADC_VERIFY_STREAMS - 1],
+					 adc_verify_convert((data >> (16 + ADC_SAMPLE_SHIFT)) &
+										ADC_SAMPLE_MASK, format),
+					 result, 1);
+}
+
+#ifdef __ARM_NEON__
+/***************************************************************************//**
+ * @brief Checks a captured buffer eight words at a time with NEON, for the
+ *        fixed and the alternating patterns. Their expected data repeats
+ *        every eight samples of a lane, so it is generated once and compared
+ *        against every block. The first word is checked by adc_verify_word()
+ *        to seed the alternating patterns, the PN sequences are left to it.
+ *
+ * @param lane - the expected data of the lanes
+ * @param format - the output format of the ADC
+ * @param address - capture start address
+ * @param words - number of words captured
+ * @param result - the counters of the lanes are updated
+ *
+ * @return Number of words checked.
+*******************************************************************************/
+static u32 adc_verify_neon(adc_verify_lane *lane, u32 format, u32 address,
+						   u32 words, adc_verify_result *result)
+{
+	uint16_t expected[2][8];
+	uint16x8_t expect[2];
+	uint32x4_t errors[2];
+	uint32x4_t bits[2];
+	uint16x8_t mask[2];
+	uint16x8x2_t data;
+	uint16x8_t sample;
+	uint16x8_t diff;
+	uint8x16_t count;
+	uint32x2_t sum;
+	uint16x4_t any;
+	u32 n;
+	u32 i;
+
+	if ((lane[0].mode == PN_9_SEQUENCE) || (lane[0].mode == PN_23_SEQUENCE) ||
+		(words < 9))
+	{
+		return 0;
+	}
+	adc_verify_word(lane, format, Xil_In32(address), result);
+	for (i = 0; i < 8; i++)
+	{
+		expected[0][i] = adc_verify_expected(&lane[0]);
+		expected[1][i] = adc_verify_expected(&lane[ADC_VERIFY_STREAMS - 1]);
+	}
+	for (i = 0; i < 2; i++)
+	{
+		expect[i] = vld1q_u16(expected[i]);
+		errors[i] = vdupq_n_u32(0);
+		bits[i] = vdupq_n_u32(0);
+		mask[i] = vdupq_n_u16(0);
+	}
+	for (n = 1; (n + 8) <= words; n += 8)
+	{
+		/* val[0] holds the low lanes of the words, val[1] the high lanes */
+		data = vld2q_u16((const uint16_t *)(address + (n * 4)));
+		for (i = 0; i < 2; i++)
+		{
+			sample = data.val[i];
+#if ADC_SAMPLE_SHIFT
+			sample = vshrq_n_u16(sample, ADC_SAMPLE_SHIFT);
+#endif
+			sample = vandq_u16(sample, vdupq_n_u16(ADC_SAMPLE_MASK));
+			if (format == TWOS_COMPLEMENT)
+			{
+				sample = veorq_u16(sample,
+								   vdupq_n_u16(1 << (ADC_SAMPLE_WIDTH - 1)));
+			}
+			if (format == GRAY_CODE)
+			{
+				sample = veorq_u16(sample, vshrq_n_u16(sample, 1));
+				sample = veorq_u16(sample, vshrq_n_u16(sample, 2));
+				sample = veorq_u16(sample, vshrq_n_u16(sample, 4));
+				sample = veorq_u16(sample, vshrq_n_u16(sample, 8));
+			}
+			diff = veorq_u16(sample, expect[i]);
+			/* A sample in error adds one, its bits in error are counted per
+			 * byte and summed pairwise */
+			errors[i] = vpadalq_u16(errors[i],
+									vshrq_n_u16(vtstq_u16(diff, diff), 15));
+			count = vcntq_u8(vreinterpretq_u8_u16(diff));
+			bits[i] = vpadalq_u16(bits[i], vpaddlq_u8(count));
+			mask[i] = vorrq_u16(mask[i], diff);
+		}
+	}
+	for (i = 0; i < 2; i++)
+	{
+		result->samples[i] += n - 1;
+		sum = vpadd_u32(vget_low_u32(errors[i]), vget_high_u32(errors[i]));
+		result->errors[i] += vget_lane_u32(vpadd_u32(sum, sum), 0);
+		sum = vpadd_u32(vget_low_u32(bits[i]), vget_high_u32(bits[i]));
+		result->bit_errors[i] += vget_lane_u32(vpadd_u32(sum, sum), 0);
+		any = vorr_u16(vget_low_u16(mask[i]), vget_high_u16(mask[i]));
+		result->diff_mask[i] |= vget_lane_u16(any, 0) | vget_lane_u16(any, 1) |
+								vget_lane_u16(any, 2) | vget_lane_u16(any, 3);
+	}
+
+	return n;
+}
+#endif
+
+/***************************************************************************//**
+ * @brief Checks a captured buffer against the data of a test mode in
+ *        software, in both output formats. The alternating patterns take
+ *        their phase from the first sample and the PN sequences are seeded
+ *        from the first samples of the lane, which are not counted. With
+ *        NEON the fixed and the alternating patterns are checked eight words
+ *        at a time and the remaining words go through the scalar check.
+ *
+ * @param mode - the test mode of the ADC
+ * @param format - the output format of the ADC
+ * @param address - capture start address
+ * @param size - number of samples captured, as passed to adc_capture()
+ * @param result - samples, samples in error and bit errors of each lane
+ *
+ * @return 0 if no error was found, 1 if errors were found, -1 if the test mode
+ *         has no known data.
+*******************************************************************************/
+int32_t adc_verify(u32 mode, u32 format, u32 address, u32 size,
+				   adc_verify_result *result)
+{
+	adc_verify_lane lane[ADC_VERIFY_STREAMS];
+	u32 words = size * 2;
+	u32 n;
+	u32 i;
+
+	for (i = 0; i < ADC_VERIFY_STREAMS; i++)
+	{
+		lane[i].mode = mode;
+		lane[i].seed = 0;
+		lane[i].state = 0;
+		switch (mode)
+		{
+			case MIDSCALE:
+				lane[i].value = (1 << (ADC_SAMPLE_WIDTH - 1));
+				break;
+			case POS_FULLSCALE:
+				lane[i].value = ADC_SAMPLE_MASK;
+				break;
+			case NEG_FULLSCALE:
+				lane[i].value = 0;
+				break;
+			case CHECKERBOARD:
+			case ONE_ZERO_TOGGLE:
+				lane[i].seed = 1;
+				break;
+			case PN_9_SEQUENCE:
+				lane[i].seed = (9 + ADC_SAMPLE_WIDTH - 1) / ADC_SAMPLE_WIDTH;
+				break;
+			case PN_23_SEQUENCE:
+				lane[i].seed = (23 + ADC_SAMPLE_WIDTH - 1) / ADC_SAMPLE_WIDTH;
+				break;
+			default:
+				return -1;
+		}
+	}
+	for (i = 0; i < 2; i++)
+	{
+		result->samples[i] = 0;
+		result->errors[i] = 0;
+		result->bit_errors[i] = 0;
+		result->diff_mask[i] = 0;
+	}
+	n = 0;
+#ifdef __ARM_NEON__
+	n = adc_verify_neon(lane, format, address, words, result);
+#endif
+	for (; n < words; n++)
+	{
+		adc_verify_word(lane, format, Xil_In32(address + (n * 4)), result);
+	}
+
+	return (result->errors[0] || result->errors[1]) ? 1 : 0;
+}
+
+/***************************************************************************//**
+ * @brief Converts a 16 bit lane to a signed sample.
+ *
+ * @param data - the lane
+ * @param flip - the sign bit for two's complement data, 0 for offset binary
+ *
+ * @return The signed sample.
+*******************************************************************************/
+static int32_t adc_avg_sample(u32 data, u32 flip)
+{
+	return (int32_t)((((data >> ADC_SAMPLE_SHIFT) & ADC_SAMPLE_MASK) ^ flip) -
+					 (1 << (ADC_SAMPLE_WIDTH - 1)));
+}
+
+/***************************************************************************//**
+ * @brief Converts the 16 bit lanes of a buffer to signed samples and adds
+ *        them to the accumulator. Eight lanes are processed at a time with
+ *        NEON in the builds with ADC_AVG_NEON for a NEON target.
+ *
+ * @param address - start of the lanes, 2 byte aligned
+ * @param lanes - number of lanes
+ * @param flip - the sign bit for two's complement data, 0 for offset binary
+ * @param acc - the accumulator, one word per lane
+ *
+ * @return None.
+*******************************************************************************/
+static void adc_avg_accumulate(u32 address, u32 lanes, u32 flip,
+							   int32_t *acc)
+{
+	const uint16_t *src = (const uint16_t *)address;
+	u32 n = 0;
+#if defined(ADC_AVG_NEON) && defined(__ARM_NEON__)
+	const uint16x8_t mask = vdupq_n_u16(ADC_SAMPLE_MASK);
+	const uint16x8_t sign = vdupq_n_u16(flip);
+	const uint16x8_t mid = vdupq_n_u16(1 << (ADC_SAMPLE_WIDTH - 1));
+	uint16x8_t raw;
+	int16x8_t sample;
+
+	for (; (n + 8) <= lanes; n += 8)
+	{
+		raw = vld1q_u16(src + n);
+#if ADC_SAMPLE_SHIFT
+		raw = vshrq_n_u16(raw, ADC_SAMPLE_SHIFT);
+#endif
+		/* Reaches the signed value modulo 2^16, exact for 16 bit samples */
+		raw = vsubq_u16(veorq_u16(vandq_u16(raw, mask), sign), mid);
+		sample = vreinterpretq_s16_u16(raw);
+		vst1q_s32(acc + n, vaddw_s16(vld1q_s32(acc + n), vget_low_s16(sample)));
+		vst1q_s32(acc + n + 4, vaddw_s16(vld1q_s32(acc + n + 4),
+										 vget_high_s16(sample)));
+	}
+#endif
+	for (; n < lanes; n++)
+	{
+		acc[n] += adc_avg_sample(src[n], flip);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Software trigger of the averaged capture: finds the first rising
+ *        crossing of midscale, after the signal was at least
+ *        ADC_AVG_HYSTERESIS below midscale, in the first
+ *        ADC_AVG_TRIGGER_WINDOW samples.
+ *
+ * @param address - start address of the buffer
+ * @param flip - the sign bit for two's complement data, 0 for offset binary
+ *
+ * @return Offset of the trigger in lanes, -1 if the channel did not cross.
+*******************************************************************************/
+static int32_t adc_avg_trigger(u32 address, u32 flip)
+{
+	const uint16_t *src = (const uint16_t *)address;
+	u32 armed = 0;
+	u32 k;
+	int32_t sample;
+
+	for (k = 0; k < ADC_AVG_TRIGGER_WINDOW; k++)
+	{
+		sample = adc_avg_sample(src[k * ADC_AVG_LANE_STRIDE], flip);
+		if (sample < -ADC_AVG_HYSTERESIS)
+		{
+			armed = 1;
+		}
+		else if (armed && (sample >= 0))
+		{
+			return k * ADC_AVG_LANE_STRIDE;
+		}
+	}
+
+	return -1;
+}
+
+/***************************************************************************//**
+ * @brief Sums a number of captures into a 32 bit accumulator, one word per
+ *        16 bit lane of the buffers, for averaging at the full ADC
+ *        resolution. The captures run through the continuous capture ring,
+ *        so the capture of a buffer overlaps the accumulation of the
+ *        previous one. With the trigger enabled each buffer is summed from
+ *        the trigger point, so the captures of a periodic signal add up
+ *        coherently; the buffers without a trigger are skipped. The average
+ *        of a lane is acc[lane] / result->captures.
+ *
+ * @param cfg - number of captures, lanes, format and trigger
+ * @param size - number of samples to capture in each buffer; the buffers
+ *               hold size * 4 lanes, of which the trigger search uses
+ *               ADC_AVG_TRIGGER_WINDOW * ADC_AVG_LANE_STRIDE
+ * @param address - start addresses of the buffers of the ring
+ * @param nb_buffers - number of buffers, 2 to ADC_STREAM_MAX_BUFFERS
+ * @param acc - the accumulator, room for cfg->lanes words
+ * @param result - the counters of the averaging
+ *
+ * @return 0 in case of success, -1 if a parameter is not supported, the
+ *         trigger missed more buffers than the captures requested or no
+ *         buffer completed for ADC_AVG_TIMEOUT_US.
+*******************************************************************************/
+int32_t adc_average(adc_avg_config *cfg, u32 size, u32 *address,
+					u32 nb_buffers, int32_t *acc, adc_avg_result *result)
+{
+	adc_stream_stats stats;
+	u32 flip = (cfg->format == TWOS_COMPLEMENT) ?
+					(1 << (ADC_SAMPLE_WIDTH - 1)) : 0;
+	u32 window = cfg->trigger ?
+					  (ADC_AVG_TRIGGER_WINDOW * ADC_AVG_LANE_STRIDE) : 0;
+	u32 buffer;
+	u32 overflow;
+	u32 polls = 0;
+	u32 n;
+	int32_t offset;
+
+	if (!cfg->captures || (cfg->captures > ADC_AVG_MAX_CAPTURES) ||
+		!cfg->lanes || ((cfg->lanes + window) > (size * 4)) ||
+		(cfg->format > TWOS_COMPLEMENT))
+	{
+		return -1;
+	}
+	for (n = 0; n < cfg->lanes; n++)
+	{
+		acc[n] = 0;
+	}
+	result->captures = 0;
+	result->overflows = 0;
+	result->missed = 0;
+	result->stalls = 0;
+	if (adc_stream_start(size, address, nb_buffers) < 0)
+	{
+		return -1;
+	}
+	while ((result->captures < cfg->captures) &&
+		   (result->missed <= cfg->captures))
+	{
+		if (adc_stream_get(&buffer, &overflow) < 0)
+		{
+			/* A stalled DMA or ADC core ends the averaging */
+			if (++polls > (ADC_AVG_TIMEOUT_US / ADC_CAPTURE_POLL_US))
+			{
+				break;
+			}
+			TIMER_DelayUs(ADC_CAPTURE_POLL_US);
+			continue;
+		}
+		polls = 0;
+		offset = cfg->trigger ? adc_avg_trigger(buffer, flip) : 0;
+		if (offset < 0)
+		{
+			result->missed++;
+		}
+		else
+		{
+			adc_avg_accumulate(buffer + (offset * 2), cfg->lanes, flip, acc);
+			result->captures++;
+			result->overflows += overflow;
+		}
+		adc_stream_release();
+	}
+	adc_stream_stop(&stats);
+	result->stalls = stats.stalls;
+	/* The buffers are reused by the caller, let the last capture land */
+	polls = 0;
+	while ((Xil_In32(CF_BASEADDR + CF_REG_ADC_STATUS) & CF_ADC_STATUS_BUSY) &&
+		   (polls++ < (ADC_AVG_TIMEOUT_US / ADC_CAPTURE_POLL_US)))
+	{
+		TIMER_DelayUs(ADC_CAPTURE_POLL_US);
+	}
+
+	return (result->captures == cfg->captures) ? 0 : -1;
+}
+
+/***************************************************************************//**
+ * @brief Configures the AD9467 device to run in the selected test mode
+ * 		  and checks if the read data pattern corresponds to the expected
+ * 		  values for the set test mode.
+ *
+ * @param mode - The test mode. Range 0 ..7
+ *                        0 - test mode off
+ *                        1 - midscale short
+ *                        2 - +FS short
+ *                        3 - -FS short
+ *                        4 - checkerboard output
+ *                        5 - PN 23 sequence
+ *                        6 - PN 9 sequence
+ *                        7 - one/zero word toggle
+ * @param format - Sets the data format:
+ *                 0 - offset binary
+ *                 1 - twos complement
+ *                 2 - gray code
+ *
+ * @return 0 if the test passed or the mode has no known data, -1 if errors
+ *         were found.
+*******************************************************************************/
+int32_t adc_test(u32 mode, u32 format)
+{
+	adc_verify_result result;
+	u32 n;
+	u32 error = 0;
+
+	ad9467_stage_begin();
+	ad9467_output_format(format);
+	ad9467_test_mode(mode);
+	ad9467_stage_commit();
+	adc_capture(ADC_TEST_SAMPLES, DDR_BASEADDR);
+	DisplayTestMode(mode, format);
+	if (((mode == PN_23_SEQUENCE) || (mode == PN_9_SEQUENCE)) &&
+		(format != TWOS_COMPLEMENT))
+	{
+		Xil_Out32((CF_BASEADDR + CF_REG_PN_TYPE),
+				  ((mode == PN_23_SEQUENCE) ? 0x01 : 0x00));
+		delay_ms(10);
+		Xil_Out32((CF_BASEADDR + CF_REG_DATA_MONITOR),
+				   CF_DATA_MONITOR_PN_ERR |
+				   CF_DATA_MONITOR_PN_SYNC |
+				   CF_DATA_MONITOR_PN_OVER_RNG);	// write ones to clear bits
+		delay_ms(100);
+		if ((Xil_In32(CF_BASEADDR + CF_REG_DATA_MONITOR) &
+				     (CF_DATA_MONITOR_PN_ERR |
+				     CF_DATA_MONITOR_PN_SYNC |
+				     CF_DATA_MONITOR_PN_OVER_RNG)) != 0)
+		{
+			LOG_ERROR("  ERROR: PN status(%04x).\n\r",
+					   Xil_In32(CF_BASEADDR + CF_REG_DATA_MONITOR));
+			error = 1;
+		}
+	}
+	if (adc_verify(mode, format, DDR_BASEADDR, ADC_TEST_SAMPLES, &result) < 0)
+	{
+		return error ? -1 : 0;
+	}
+	for (n = 0; n < 2; n++)
+	{
+		if (result.errors[n])
+		{
+			LOG_ERROR("  ERROR: lane(%d), samples(%d/%d), bit errors(%d)\n\r",
+					   n, result.errors[n], result.samples[n],
+					   result.bit_errors[n]);
+			error = 1;
+		}
+	}
+	if(error == 0)
+	{
+		LOG_INFO("          Test passed\r\n");
+	}
+
+	return error ? -1 : 0;
+}
+
+/***************************************************************************//**
+ * @brief Runs the power-on self-test of the data path. The fast level runs
+ *        a single PN23 test, checked by the PN monitor of the core and on
+ *        one capture by adc_verify(). The full level runs adc_test() for all
+ *        the test modes in both output formats and is kept as a diagnostic.
+ *        The test mode and the output format are left as set by the last
+ *        test.
+ *
+ * @param level - ADC_POST_NONE, ADC_POST_FAST or ADC_POST_FULL
+ *
+ * @return 0 if the tests passed, -1 if a test failed.
+*******************************************************************************/
+int32_t adc_post(u32 level)
+{
+	int32_t ret = 0;
+	u32 mode;
+
+	if (level == ADC_POST_NONE)
+	{
+		return 0;
+	}
+	if (level == ADC_POST_FAST)
+	{
+		return adc_test(PN_23_SEQUENCE, OFFSET_BINARY);
+	}
+	for (mode = MIDSCALE; mode <= ONE_ZERO_TOGGLE; mode++)
+	{
+		if (adc_test(mode, OFFSET_BINARY) < 0)
+		{
+			ret = -1;
+		}
+		if (adc_test(mode, TWOS_COMPLEMENT) < 0)
+		{
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Writes a configuration block to the CF registers, in the list
+ *        order and each entry once.
+ *
+ * @param cfg - the registers and their values
+ * @param cnt - number of entries of the block
+ *
+ * @return None.
+*******************************************************************************/
+void cf_write_block(const cf_reg_value *cfg, u32 cnt)
+{
+	volatile u32 *base = (volatile u32 *)CF_BASEADDR;
+	u32 i;
+
+	for (i = 0; i < cnt; i++)
+	{
+		base[cfg[i].reg >> 2] = cfg[i].value;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Initializes the AD9467 FPGA core.
+ *
+ * @param dco_delay - ADC delay.
+ *
+ * @return None.
+*******************************************************************************/
+void adc_setup(u32 dco_delay)
+{
+	static const cf_reg_value core_cfg[] =
+	{
+		{CF_REG_DATA_MODE, CF_DATA_MODE_BITS(0x1)},		// Samples are interleaved rising edge first and then falling edge.
+		{CF_REG_PN_TYPE, CF_PN_TYPE_BIT(0)},			// Select PN9
+		{CF_REG_DATA_SELECT, CF_DATA_SELECT_BIT(0)},	// First byte from DDR appears on rising edge
+		{CF_REG_DELAY_CTRL, 0x00000},					// clear bits
+		{CF_REG_DELAY_CTRL, CF_DELAY_CTRL_SEL(1) |		// delay write
+							CF_DELAY_CTRL_WR_ADDR(0xF) |
+							CF_DELAY_CTRL_WR_DATA(0x1F)}
+	};
+
+	cf_write_block(core_cfg, sizeof(core_cfg) / sizeof(core_cfg[0]));
+	ad9467_stage_begin();					// Collect the register changes
+	ad9467_test_mode(PN_23_SEQUENCE);		// Select PN 23 sequence test mode
+	ad9467_output_format(OFFSET_BINARY);	// Select output format as offset binary
+	ad9467_stage_commit();			  		// Synchronously update registers
+	Xil_Out32((CF_BASEADDR + CF_REG_PN_TYPE), CF_PN_TYPE_BIT(1));
+	ad9467_dco_clock_invert(0);		  		// Activates the non-inverted DCO clock
+	ad9467_transfer();				  		// Synchronously update registers
+	delay_ms(10);
+	if (adc_delay())
+	{
+		ad9467_dco_clock_invert(1); 	// Activates the inverted DCO clock
+		ad9467_transfer();				// Synchronously update registers
+		LOG_INFO("AD9467[REG_OUT_PHASE]: %02x\n\r",
+					ad9467_dco_clock_invert(-1));	 // reads the dco clock invert bit state
+		delay_ms(10);
+		if (adc_delay())
+		{
+			LOG_ERROR("adc_setup: can not set a zero error delay!\n\r");
+			adc_delay_1(0);
+		}
+	}
+}
+
+void DisplayTestMode(u32 mode, u32 format)
+{
+	char *sMode;
+	char *sFormat;
+
+	switch(format)
+	{
+		case OFFSET_BINARY:
+			sFormat = "OFFSET BINARY";
+			break;
+		case TWOS_COMPLEMENT:
+			sFormat = "TWOS_COMPLEMENT";
+			break;
+		case GRAY_CODE:
+			sFormat = "GRAY_CODE";
+			break;
+		default:
+			sFormat = "";
+			break;
+	}
+	switch(mode)
+		{
+			case TEST_DISABLE:
+				sMode = "TEST_DISABLE BINARY";
+				break;
+			case MIDSCALE:
+				sMode = "MIDSCALE";
+				break;
+			case POS_FULLSCALE:
+				sMode = "POS_FULLSCALE";
+				break;
+			case NEG_FULLSCALE:
+				sMode = "NEG_FULLSCALE BINARY";
+				break;
+			case CHECKERBOARD:
+				sMode = "CHECKERBOARD";
+				break;
+			case PN_23_SEQUENCE:
+				sMode = "PN_23_SEQUENCE";
+				break;
+			case PN_9_SEQUENCE:
+				sMode = "PN_9_SEQUENCE";
+				break;
+			case ONE_ZERO_TOGGLE:
+				sMode = "ONE_ZERO_TOGGLE";
+				break;
+			default:
+				sMode = "";
+				break;
+		}
+	LOG_INFO("ADC Test: mode - %s\r\n          format - %s\n\r", sMode, sFormat);
+}
@@ -1,145 +1,393 @@
-/***************************************************************************//**
- *   @file   cf_ad9467.h
- *   @brief  Header file of cf_ad9467 Driver.
-********************************************************************************
- * Copyright 2012(c) Analog Devices, Inc.
- *
- * All rights reserved.
- *
- * Redistribution and use in source and binary forms, with or without
- * modification, are permitted provided that the following conditions are met:
- *  - Redistributions of source code must retain the above copyright
- *    notice, this list of conditions and the following disclaimer.
- *  - Redistributions in binary form must reproduce the above copyright
- *    notice, this list of conditions and the following disclaimer in
- *    the documentation and/or other materials provided with the
- *    distribution.
- *  - Neither the name of Analog Devices, Inc. nor the names of its
- *    contributors may be used to endorse or promote products derived
- *    from this software without specific prior written permission.
- *  - The use of this software may or may not infringe the patent rights
- *    of one or more patent holders.  This license does not release you
- *    from the requirement that you obtain separate licenses from these
- *    patent holders to use this software.
- *  - Use of the software either in source or binary form, must be run
- *    on or directly connected to an Analog Devices Inc. component.
- *
- * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
- * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
- * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
- * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
- * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
- * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
- * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
- * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
- * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
- * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
- *
-********************************************************************************
- *   SVN Revision: $WCREV$
-*******************************************************************************/
-#ifndef __CF_AD9467_H__
-#define __CF_AD9467_H__
-
-/******************************************************************************/
-/***************************** Include Files **********************************/
-/******************************************************************************/
-#include "xbasic_types.h"
-#include "xparameters.h"
-
-/******************************************************************************/
-/******************* Macros and Constants Definitions *************************/
-/******************************************************************************/
-#ifdef _XPARAMETERS_PS_H_
-	#define CF_BASEADDR   XPAR_AXI_ADC_1C_0_BASEADDR
-	#define DDR_BASEADDR  XPAR_DDR_MEM_BASEADDR + 128*1024*1024
-	#define DMA_BASEADDR  XPAR_AXI_DMA_0_BASEADDR
-	#define UART_BASEADDR XPS_UART1_BASEADDR
-	#define SPI_BASEADDR  XPAR_AXI_SPI_0_BASEADDR
-#else
-	#define CF_BASEADDR   XPAR_AXI_ADC_1C_0_BASEADDR
-	#define DDR_BASEADDR  XPAR_DDR3_SDRAM_S_AXI_BASEADDR
-	#define DMA_BASEADDR  XPAR_AXI_DMA_0_BASEADDR
-	#define UART_BASEADDR XPS_UART1_BASEADDR
-	#define SPI_BASEADDR  XPAR_AXI_SPI_0_BASEADDR
-#endif
-
-/* CF register map. */
-#define CF_REG_VERSION			0x00
-#define CF_REG_CAPTURE_CTRL		0x0C
-#define CF_REG_ADC_STATUS		0x10
-#define CF_REG_DATA_MONITOR		0x14
-#define CF_REG_DATA_MODE		0x18
-#define CF_REG_DELAY_CTRL		0x1C
-#define CF_REG_DELAY_STATUS		0x20
-#define CF_REG_PN_TYPE			0x24
-#define CF_REG_DATA_SELECT		0x28
-
-/* CF_REG_CAPTURE_CTRL bit definition. */
-#define CF_CAPTURE_CTRL_CAPTURE_START(x)	(((x) & 0x1) << 16)
-#define CF_CAPTURE_CTRL_CAPTURE_COUNT(x)	((((x) - 1) & 0xFFFF) << 0)
-
-/* CF_REG_ADC_STATUS bit definition. */
-#define CF_ADC_STATUS_UNDERFLOW		(1 << 2) // (Write 1 to clear)
-#define CF_ADC_STATUS_OVERFLOW		(1 << 1) // (Write 1 to clear)
-#define CF_ADC_STATUS_BUSY			(1 << 0) // (Read Only)
-
-/* CF_REG_DATA_MONITOR bit definition. */
-#define CF_DATA_MONITOR_PN_ERR		(1 << 2) // (Write 1 to clear)
-#define CF_DATA_MONITOR_PN_SYNC		(1 << 1) // (Write 1 to clear)
-#define CF_DATA_MONITOR_PN_OVER_RNG	(1 << 0) // (Write 1 to clear)
-
-/* CF_REG_DATA_MODE bit definition. */
-#define CF_DATA_MODE_BITS(x)		(((x) & 0x3) << 0)
-
-/* CF_REG_DELAY_CTRL bit definition. */
-#define CF_DELAY_CTRL_SEL(x)		(((x) & 0x1) << 17)
-#define CF_DELAY_CTRL_RW_ENABLE(x)  (((x) & 0x1) << 16)
-#define CF_DELAY_CTRL_WR_ADDR(x)	(((x) & 0xF) << 8)
-#define CF_DELAY_CTRL_WR_DATA(x)	(((x) & 0x1F) << 0)
-
-/* CF_REG_DELAY_STATUS bit definition. */
-#define CF_DELAY_STATUS_LOCKED		(1 << 8)	// (Read Only)
-#define CF_DELAY_STATUS_RD_DATA		(0x1F << 0) // (Read Only)
-
-/* CF_REG_PN_TYPE bit definition. */
-#define CF_PN_TYPE_BIT(x)			(((x) & 0x1) << 0)
-
-/* CF_REG_DATA_SELECT bit definition. */
-#define CF_DATA_SELECT_BIT(x)		(((x) & 0x1) << 0)
-
-/******************************************************************************/
-/************************** Types Declarations ********************************/
-/******************************************************************************/
-typedef enum _TestModes
-{
-	TEST_DISABLE = 0,
-	MIDSCALE,
-	POS_FULLSCALE,
-	NEG_FULLSCALE,
-	CHECKERBOARD,
-	PN_23_SEQUENCE,
-	PN_9_SEQUENCE,
-	ONE_ZERO_TOGGLE
-
-}typeTestModes;
-
-typedef enum _OutputModes
-{
-	OFFSET_BINARY = 0,
-	TWOS_COMPLEMENT,
-	GRAY_CODE,
-
-}typeOutputModes;
-
-/*******************************************************************************/
-/************************ Functions Declarations *******************************/
-/*******************************************************************************/
-/*! Initializes the ADC FPGA core. FPGA core. */
-void adc_setup(u32 dco_delay);
-/*! Configures the AD9467 device to run in the selected test mode. */
-void adc_test(u32 mode, u32 format);
-/*! Captures a specified number of samples from the ADC. */
-void adc_capture(u32 qwcnt, u32 sa);
-
-#endif /* __CF_AD9467_H__ */
+/***************************************************************************//**
+ *   @file   cf_ad9467.h
+ *   @brief  Header file of cf_ad9467 Driver.
+********************************************************************************
+ * Copyright 2012(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+********************************************************************************
+ *   SVN Revision: $WCREV$
+*******************************************************************************/
+#ifndef __CF_AD9467_H__
+#define __CF_AD9467_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "xbasic_types.h"
+#include "xparameters.h"
+
+/******************************************************************************/
+/******************* Macros and Constants Definitions *************************/
+/******************************************************************************/
+#ifdef _XPARAMETERS_PS_H_
+	#define CF_BASEADDR   XPAR_AXI_ADC_1C_0_BASEADDR
+	#define DDR_BASEADDR  XPAR_DDR_MEM_BASEADDR + 128*1024*1024
+	#define DMA_BASEADDR  XPAR_AXI_DMA_0_BASEADDR
+	#define UART_BASEADDR XPS_UART1_BASEADDR
+	#ifdef SPI_PS7
+		#define SPI_BASEADDR  XPAR_PS7_SPI_0_BASEADDR
+	#else
+		#define SPI_BASEADDR  XPAR_AXI_SPI_0_BASEADDR
+	#endif
+#else
+	#define CF_BASEADDR   XPAR_AXI_ADC_1C_0_BASEADDR
+	#define DDR_BASEADDR  XPAR_DDR3_SDRAM_S_AXI_BASEADDR
+	#define DMA_BASEADDR  XPAR_AXI_DMA_0_BASEADDR
+	#define UART_BASEADDR XPS_UART1_BASEADDR
+	#define SPI_BASEADDR  XPAR_AXI_SPI_0_BASEADDR
+#endif
+
+/* CF register map. */
+#define CF_REG_VERSION			0x00
+#define CF_REG_CAPTURE_CTRL		0x0C
+#define CF_REG_ADC_STATUS		0x10
+#define CF_REG_DATA_MONITOR		0x14
+#define CF_REG_DATA_MODE		0x18
+#define CF_REG_DELAY_CTRL		0x1C
+#define CF_REG_DELAY_STATUS		0x20
+#define CF_REG_PN_TYPE			0x24
+#define CF_REG_DATA_SELECT		0x28
+
+/* CF_REG_CAPTURE_CTRL bit definition. */
+#define CF_CAPTURE_CTRL_CAPTURE_START(x)	(((x) & 0x1) << 16)
+#define CF_CAPTURE_CTRL_CAPTURE_COUNT(x)	((((x) - 1) & 0xFFFF) << 0)
+
+/* CF_REG_ADC_STATUS bit definition. */
+#define CF_ADC_STATUS_UNDERFLOW		(1 << 2) // (Write 1 to clear)
+#define CF_ADC_STATUS_OVERFLOW		(1 << 1) // (Write 1 to clear)
+#define CF_ADC_STATUS_BUSY			(1 << 0) // (Read Only)
+
+/* CF_REG_DATA_MONITOR bit definition. */
+#define CF_DATA_MONITOR_PN_ERR		(1 << 2) // (Write 1 to clear)
+#define CF_DATA_MONITOR_PN_SYNC		(1 << 1) // (Write 1 to clear)
+#define CF_DATA_MONITOR_PN_OVER_RNG	(1 << 0) // (Write 1 to clear)
+
+/* CF_REG_DATA_MODE bit definition. */
+#define CF_DATA_MODE_BITS(x)		(((x) & 0x3) << 0)
+
+/* CF_REG_DELAY_CTRL bit definition. */
+#define CF_DELAY_CTRL_SEL(x)		(((x) & 0x1) << 17)
+#define CF_DELAY_CTRL_RW_ENABLE(x)  (((x) & 0x1) << 16)
+#define CF_DELAY_CTRL_WR_ADDR(x)	(((x) & 0xF) << 8)
+#define CF_DELAY_CTRL_WR_DATA(x)	(((x) & 0x1F) << 0)
+
+/* CF_REG_DELAY_STATUS bit definition. */
+#define CF_DELAY_STATUS_LOCKED		(1 << 8)	// (Read Only)
+#define CF_DELAY_STATUS_RD_DATA		(0x1F << 0) // (Read Only)
+
+/* CF_REG_PN_TYPE bit definition. */
+#define CF_PN_TYPE_BIT(x)			(((x) & 0x1) << 0)
+
+/* CF_REG_DATA_SELECT bit definition. */
+#define CF_DATA_SELECT_BIT(x)		(((x) & 0x1) << 0)
+
+/* AXI DMA S2MM registers used for the capture done interrupt. */
+#define DMA_REG_S2MM_SR			0x034
+#define DMA_S2MM_CR_IOC_IRQ_EN	(1 << 12)
+#define DMA_S2MM_SR_IOC_IRQ		(1 << 12) // (Write 1 to clear)
+
+/* Busy bit poll period when the capture done interrupt is not used. */
+#ifndef ADC_CAPTURE_POLL_US
+#define ADC_CAPTURE_POLL_US		1
+#endif
+
+/* Data cache line size, the capture buffers must be aligned to it. */
+#define ADC_CACHE_LINE			32
+
+/* Set to 1 when the capture DMA writes through the Zynq ACP port. The
+   buffers are then coherent with the caches and need no maintenance. */
+#ifndef ADC_CAPTURE_ACP
+#define ADC_CAPTURE_ACP		0
+#endif
+
+/* Maximum number of buffers of the continuous capture. */
+#ifndef ADC_STREAM_MAX_BUFFERS
+#define ADC_STREAM_MAX_BUFFERS	8
+#endif
+
+/* IDELAY search modes of adc_delay(). */
+#define ADC_DELAY_SEARCH_EDGE	0	// coarse taps, then bisect the edges per lane
+#define ADC_DELAY_SEARCH_FULL	1	// all the taps with the PN monitor
+
+#define ADC_DELAY_LANES			8
+#define ADC_DELAY_TAPS			32
+#define ADC_DELAY_COARSE_STEP	4
+
+/* Settling time after the taps are written, before the data is checked. */
+#ifndef ADC_DELAY_SETTLE_US
+#define ADC_DELAY_SETTLE_US		100
+#endif
+
+/* Capture samples checked in software at each step of the edge search.
+   16384 are 65536 ADC samples, 1 Mbit: a passing tap has a BER below 3e-6
+   with 95 % confidence (3 / number of bits). */
+#ifndef ADC_DELAY_CAPTURE_SAMPLES
+#define ADC_DELAY_CAPTURE_SAMPLES	16384
+#endif
+
+/* The PN monitor dwell of the final check is sized to check
+   ADC_DELAY_CONFIRM_MBITS at ADC_DELAY_RATE_MSPS. 300 Mbit give a BER below
+   1e-8 with 95 % confidence. */
+#ifndef ADC_DELAY_RATE_MSPS
+#define ADC_DELAY_RATE_MSPS		250
+#endif
+#ifndef ADC_DELAY_CONFIRM_MBITS
+#define ADC_DELAY_CONFIRM_MBITS	300
+#endif
+#define ADC_DELAY_CONFIRM_US	((ADC_DELAY_CONFIRM_MBITS * 1000000UL) / \
+								 (ADC_DELAY_RATE_MSPS * 16))
+
+/* AXI DMA S2MM registers and descriptors used for the scatter gather capture. */
+#define DMA_REG_S2MM_CR		0x030
+#define DMA_REG_S2MM_CURDESC	0x038
+#define DMA_REG_S2MM_TAILDESC	0x040
+#define DMA_S2MM_CR_RESET	(1 << 2)
+#define DMA_S2MM_CR_RUN		(1 << 0)
+#define DMA_S2MM_SR_SG_INCLD	(1 << 3) // (Read Only)
+#define DMA_DESC_NEXT		0x00
+#define DMA_DESC_ADDR		0x08
+#define DMA_DESC_CTRL		0x18
+#define DMA_DESC_STATUS		0x1C
+#define DMA_DESC_STATUS_CMPLT	(1 << 31)
+#define DMA_DESC_SIZE		0x40
+
+/* Capture count of the core, longer captures are split in descriptors. */
+#define ADC_CAPTURE_MAX_SAMPLES	65536
+
+/* Maximum number of descriptors of the scatter gather capture. */
+#ifndef ADC_SG_MAX_DESC
+#define ADC_SG_MAX_DESC		64
+#endif
+
+/* Power-on self-test levels of adc_post(). */
+#define ADC_POST_NONE	0	// no test
+#define ADC_POST_FAST	1	// one PN23 check
+#define ADC_POST_FULL	2	// all the test modes in both formats
+#ifndef ADC_POST_LEVEL
+#define ADC_POST_LEVEL	ADC_POST_FAST
+#endif
+
+/* Number of samples captured and checked in software by adc_test(). */
+#ifndef ADC_TEST_SAMPLES
+#define ADC_TEST_SAMPLES	16384
+#endif
+
+/* Resolution and position of the samples in each 16 bit lane. */
+#define ADC_SAMPLE_WIDTH	16
+#define ADC_SAMPLE_SHIFT	0
+#define ADC_SAMPLE_MASK		((1 << ADC_SAMPLE_WIDTH) - 1)
+
+/* The two lanes of a word are successive samples of a single sequence. */
+#define ADC_VERIFY_STREAMS	1
+
+/* Averaged capture: maximum number of captures summed, which keeps the 32 bit
+   accumulators from overflowing, software trigger search window, in samples,
+   and trigger hysteresis below midscale, in LSBs. */
+#define ADC_AVG_MAX_CAPTURES	65535
+#ifndef ADC_AVG_TRIGGER_WINDOW
+#define ADC_AVG_TRIGGER_WINDOW	1024
+#endif
+#ifndef ADC_AVG_HYSTERESIS
+#define ADC_AVG_HYSTERESIS		256
+#endif
+/* Longest wait for a buffer of the averaged capture, in us. Build with
+   ADC_AVG_NEON to accumulate the captures with NEON on Zynq. */
+#ifndef ADC_AVG_TIMEOUT_US
+#define ADC_AVG_TIMEOUT_US		1000000
+#endif
+/* Lanes between two samples of the trigger signal. */
+#define ADC_AVG_LANE_STRIDE		1
+
+/******************************************************************************/
+/************************** Types Declarations ********************************/
+/******************************************************************************/
+/* CF register map, overlaid on CF_BASEADDR. */
+typedef struct _cf_regs
+{
+	volatile u32 version;		// CF_REG_VERSION
+	volatile u32 reserved0[2];
+	volatile u32 capture_ctrl;	// CF_REG_CAPTURE_CTRL
+	volatile u32 adc_status;	// CF_REG_ADC_STATUS
+	volatile u32 data_monitor;	// CF_REG_DATA_MONITOR
+	volatile u32 data_mode;		// CF_REG_DATA_MODE
+	volatile u32 delay_ctrl;	// CF_REG_DELAY_CTRL
+	volatile u32 delay_status;	// CF_REG_DELAY_STATUS
+	volatile u32 pn_type;		// CF_REG_PN_TYPE
+	volatile u32 data_select;	// CF_REG_DATA_SELECT
+}cf_regs;
+
+#define CF_REGS		((cf_regs *)CF_BASEADDR)
+
+/* Register and value of a CF configuration block. */
+typedef struct _cf_reg_value
+{
+	u32 reg;		// CF_REG_* register address
+	u32 value;		// value written to the register
+}cf_reg_value;
+
+typedef struct _adc_sg_segment
+{
+	u32 address;	// start address of the region
+	u32 size;		// number of samples in the region
+}adc_sg_segment;
+
+typedef struct _adc_verify_result
+{
+	u32 samples[2];		// samples checked per lane
+	u32 errors[2];		// samples in error per lane
+	u32 bit_errors[2];	// bit errors per lane
+	u32 diff_mask[2];	// bits in error per lane
+}adc_verify_result;
+
+typedef struct _adc_stream_stats
+{
+	u32 captures;	// buffers captured
+	u32 overflows;	// buffers captured with an overflow
+	u32 stalls;		// times all the buffers were filled
+	u32 sent;		// buffers handed to the streaming sink
+	u32 completions;	// captures completed, one interrupt each
+	u32 coalesce;	// buffers completed at once by the next capture
+	u32 buffer_us;	// capture time of one buffer
+}adc_stream_stats;
+
+typedef struct _adc_avg_config
+{
+	u32 captures;	// number of captures summed, up to ADC_AVG_MAX_CAPTURES
+	u32 lanes;		// samples summed per capture
+	u32 format;		// the output format of the ADC, gray code is not supported
+	u32 trigger;	// 1 to sum each capture from the trigger point
+}adc_avg_config;
+
+typedef struct _adc_avg_result
+{
+	u32 captures;	// captures summed
+	u32 overflows;	// captures summed with an overflow
+	u32 missed;		// captures skipped without a trigger
+	u32 stalls;		// times the ring was full during the accumulation
+}adc_avg_result;
+
+/* Streaming sink of the continuous capture, called with a filled buffer, its
+   size in bytes and 1 if an overflow occurred. The buffer is transmitted in
+   place and returned with adc_stream_tx_done() once it is sent. Returns 0 if
+   the buffer was queued, negative if the transmit path is busy. */
+typedef int32_t (*adc_stream_sink)(u32 address, u32 bytes, u32 overflow);
+
+/* Capture completion callback, called with the start address of the capture
+   and 1 if an overflow occurred. */
+typedef void (*adc_capture_callback)(u32 address, u32 overflow);
+
+typedef enum _TestModes
+{
+	TEST_DISABLE = 0,
+	MIDSCALE,
+	POS_FULLSCALE,
+	NEG_FULLSCALE,
+	CHECKERBOARD,
+	PN_23_SEQUENCE,
+	PN_9_SEQUENCE,
+	ONE_ZERO_TOGGLE
+
+}typeTestModes;
+
+typedef enum _OutputModes
+{
+	OFFSET_BINARY = 0,
+	TWOS_COMPLEMENT,
+	GRAY_CODE,
+
+}typeOutputModes;
+
+/*******************************************************************************/
+/************************ Functions Declarations *******************************/
+/*******************************************************************************/
+/*! Writes a configuration block to the CF registers. */
+void cf_write_block(const cf_reg_value *cfg, u32 cnt);
+/*! Initializes the ADC FPGA core. FPGA core. */
+void adc_setup(u32 dco_delay);
+/*! Sets the IDELAY of each data lane to the center of its eye. */
+u32 adc_delay(void);
+/*! Selects the IDELAY search mode of adc_delay(). */
+int32_t adc_delay_search_mode(int32_t mode);
+/*! Gets the IDELAY taps selected for each data lane. */
+void adc_delay_get_lanes(u32 *delay);
+/*! Moves the IDELAY of each data lane one tap away from a failing neighbour tap. */
+int32_t adc_delay_track(void);
+/*! Checks a captured buffer against the data of a test mode. */
+int32_t adc_verify(u32 mode, u32 format, u32 address, u32 size,
+                   adc_verify_result *result);
+/*! Configures the AD9467 device to run in the selected test mode. */
+int32_t adc_test(u32 mode, u32 format);
+/*! Runs the power-on self-test of the data path. */
+int32_t adc_post(u32 level);
+/*! Captures a specified number of samples from the ADC. */
+void adc_capture(u32 qwcnt, u32 sa);
+/*! Starts a capture without waiting for it to complete. */
+void adc_capture_start(u32 size, u32 address);
+/*! Waits for the started capture to complete. */
+u32 adc_capture_wait(void);
+/*! Enables the capture done interrupt. */
+void adc_capture_irq_enable(adc_capture_callback callback);
+/*! Disables the capture done interrupt. */
+void adc_capture_irq_disable(void);
+/*! Selects whether the capture buffers are coherent with the caches. */
+void adc_capture_set_coherent(u32 enable);
+/*! Capture done interrupt handler. */
+void adc_capture_isr(void *ref);
+/*! Captures a number of samples spread over several regions in one go. */
+int32_t adc_capture_sg(adc_sg_segment *seg, u32 nb_segments, u32 desc_address);
+/*! Starts a continuous capture into a ring of buffers. */
+int32_t adc_stream_start(u32 size, u32 *address, u32 nb_buffers);
+/*! Completion path of the continuous capture. */
+int32_t adc_stream_poll(void);
+/*! Gets the oldest filled buffer of the continuous capture. */
+int32_t adc_stream_get(u32 *address, u32 *overflow);
+/*! Releases the oldest filled buffer of the continuous capture. */
+void adc_stream_release(void);
+/*! Sets the streaming sink of the continuous capture. */
+void adc_stream_set_sink(adc_stream_sink sink);
+/*! Hands the filled buffers of the continuous capture to the streaming sink. */
+int32_t adc_stream_sink_process(void);
+/*! Returns the oldest buffer handed to the streaming sink. */
+void adc_stream_tx_done(void);
+/*! Stops the continuous capture. */
+void adc_stream_stop(adc_stream_stats *stats);
+/*! Gets the counters of the continuous capture. */
+void adc_stream_get_stats(adc_stream_stats *stats);
+/*! Sets the completion coalescing of the continuous capture. */
+void adc_stream_set_coalesce(u32 max_buffers, u32 max_us);
+/*! Sums a number of trigger aligned captures for averaging. */
+int32_t adc_average(adc_avg_config *cfg, u32 size, u32 *address,
+					u32 nb_buffers, int32_t *acc, adc_avg_result *result);
+
+#endif /* __CF_AD9467_H__ */
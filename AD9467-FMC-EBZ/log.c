@@ -0,0 +1,471 @@
+/**************************************************************************//**
+*   @file   log.c
+*   @brief  Buffered UART logging implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdarg.h>
+#include "xparameters.h"
+#include "xil_io.h"
+#include "timer.h"
+#include "log.h"
+#include "ring.h"
+#include "fastmem.h"
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+#ifdef _XPARAMETERS_PS_H_
+	/* Zynq PS UART 1 */
+	#define LOG_UART_BASEADDR		XPS_UART1_BASEADDR
+	#define UART_IER				0x08
+	#define UART_IDR				0x0C
+	#define UART_ISR				0x14
+	#define UART_SR					0x2C
+	#define UART_FIFO				0x30
+	#define UART_IXR_TXEMPTY		(1 << 3)
+	#define UART_SR_TXFULL			(1 << 4)
+	#define LOG_UART_TX_FULL()		(Xil_In32(LOG_UART_BASEADDR + UART_SR) & \
+									 UART_SR_TXFULL)
+	#define LOG_UART_PUT(c)			Xil_Out32(LOG_UART_BASEADDR + UART_FIFO, (c))
+	#define LOG_UART_IRQ_ON()		Xil_Out32(LOG_UART_BASEADDR + UART_IER, \
+											  UART_IXR_TXEMPTY)
+	#define LOG_UART_IRQ_OFF()		Xil_Out32(LOG_UART_BASEADDR + UART_IDR, \
+											  UART_IXR_TXEMPTY)
+	#define LOG_UART_IRQ_ACK()		Xil_Out32(LOG_UART_BASEADDR + UART_ISR, \
+											  UART_IXR_TXEMPTY)
+#elif defined(XPAR_UARTLITE_0_BASEADDR)
+	/* AXI UART Lite, interrupts when the TX FIFO becomes empty */
+	#define LOG_UART_BASEADDR		XPAR_UARTLITE_0_BASEADDR
+	#define UARTLITE_TX_FIFO		0x04
+	#define UARTLITE_STAT			0x08
+	#define UARTLITE_CTRL			0x0C
+	#define UARTLITE_STAT_TX_FULL	(1 << 3)
+	#define UARTLITE_CTRL_INTR_EN	(1 << 4)
+	#define LOG_UART_TX_FULL()		(Xil_In32(LOG_UART_BASEADDR + UARTLITE_STAT) & \
+									 UARTLITE_STAT_TX_FULL)
+	#define LOG_UART_PUT(c)			Xil_Out32(LOG_UART_BASEADDR + UARTLITE_TX_FIFO, (c))
+	#define LOG_UART_IRQ_ON()		Xil_Out32(LOG_UART_BASEADDR + UARTLITE_CTRL, \
+											  UARTLITE_CTRL_INTR_EN)
+	#define LOG_UART_IRQ_OFF()		Xil_Out32(LOG_UART_BASEADDR + UARTLITE_CTRL, 0)
+	#define LOG_UART_IRQ_ACK()
+#else
+	/* No known UART, the bytes go to the standard output and block */
+	extern void outbyte(char c);
+	#define LOG_UART_TX_FULL()		0
+	#define LOG_UART_PUT(c)			outbyte(c)
+	#define LOG_UART_IRQ_ON()
+	#define LOG_UART_IRQ_OFF()
+	#define LOG_UART_IRQ_ACK()
+#endif
+
+/* Message slots of LOG_MAX_MSG bytes, a power of 2 */
+#define LOG_SLOTS				(LOG_BUFFER_SIZE / LOG_MAX_MSG)
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+/* Each message is written into a slot, then published by a descriptor of
+   the message ring. The ring has a single producer, the main context, and a
+   single consumer, the TX interrupt or the polling loop. The slot of a
+   message is reused once the consumer has sent it and popped its
+   descriptor. */
+static FAST_DATA uint8_t log_slot[LOG_SLOTS][LOG_MAX_MSG];
+static FAST_DATA stRingDesc log_desc[LOG_SLOTS];
+static FAST_DATA stRing log_msgs = {0, {0}, 0, {0}, LOG_SLOTS - 1, log_desc};
+
+static FAST_DATA volatile struct
+{
+	uint32_t	sent;		// bytes of the oldest message sent
+	uint32_t	dropped;	// messages which did not fit
+	uint8_t		irq;		// drained from the TX interrupt
+	uint8_t		busy;		// the TX interrupt is running
+	uint8_t		binary;		// events are written as binary records
+} log_ring;
+
+static const char log_hex[] = "0123456789abcdef0123456789ABCDEF";
+
+/***************************************************************************//**
+ * @brief Moves the buffered bytes into the UART FIFO until the FIFO is full
+ *        or the ring is empty. The descriptor of a message is popped once the
+ *        whole message is in the FIFO.
+ *
+ * @return None.
+*******************************************************************************/
+static FAST_CODE void LOG_Fill(void)
+{
+	stRingDesc msg;
+	uint32_t sent = log_ring.sent;
+
+	while (RING_Peek(&log_msgs, &msg) == 0)
+	{
+		while ((sent < msg.length) && !LOG_UART_TX_FULL())
+		{
+			LOG_UART_PUT(((const uint8_t*)msg.address)[sent]);
+			sent++;
+		}
+		if (sent < msg.length)
+		{
+			break;
+		}
+		RING_Pop(&log_msgs, &msg);
+		sent = 0;
+	}
+	log_ring.sent = sent;
+}
+
+/***************************************************************************//**
+ * @brief Gets the slot of the next message.
+ *
+ * @return Returns the slot or 0 if all the slots are in use. The message is
+ *         then counted as dropped.
+*******************************************************************************/
+static FAST_CODE uint8_t* LOG_Reserve(void)
+{
+	if (RING_Count(&log_msgs) > log_msgs.mask)
+	{
+		log_ring.dropped++;
+		return 0;
+	}
+
+	return log_slot[log_msgs.head & log_msgs.mask];
+}
+
+/***************************************************************************//**
+ * @brief Publishes a message written in the slot given by LOG_Reserve() and
+ *        starts sending it.
+ *
+ * @param msg - slot of the message
+ * @param size - size of the message in bytes
+ *
+ * @return None.
+*******************************************************************************/
+static FAST_CODE void LOG_Commit(uint8_t* msg, uint32_t size)
+{
+	stRingDesc desc;
+
+	desc.timestampUs = 0;
+	desc.address     = (uint32_t)msg;
+	desc.length      = size;
+	desc.flags       = 0;
+	desc.user        = 0;
+	RING_Push(&log_msgs, &desc);
+	if (!log_ring.irq)
+	{
+		LOG_Fill();
+	}
+	else if (!log_ring.busy)
+	{
+		log_ring.busy = 1;
+		LOG_Fill();
+		LOG_UART_IRQ_ON();
+	}
+}
+
+/***************************************************************************//**
+ * @brief Initializes the UART output and empties the ring buffer. The ring is
+ *        drained by LOG_Poll() until LOG_IrqEnable() is called.
+ *
+ * @return None.
+*******************************************************************************/
+void LOG_Init(void)
+{
+	LOG_UART_IRQ_OFF();
+	RING_Init(&log_msgs, log_desc, LOG_SLOTS);
+	log_ring.sent = 0;
+	log_ring.dropped = 0;
+	log_ring.irq = 0;
+	log_ring.busy = 0;
+	log_ring.binary = 0;
+}
+
+/***************************************************************************//**
+ * @brief Formats a message into the ring buffer. The conversions of
+ *        xil_printf are supported: %c, %s, %d, %u, %x and %X with an
+ *        optional 0 flag, width and l modifier, and %%. The message is
+ *        dropped if all the message slots are in use.
+ *
+ * @param fmt - format string
+ *
+ * @return None.
+*******************************************************************************/
+void LOG_Printf(const char* fmt, ...)
+{
+	char* msg;
+	char num[12];
+	const char* str;
+	va_list args;
+	uint32_t size = 0;
+	uint32_t value;
+	uint32_t width;
+	uint32_t base;
+	uint32_t len;
+	uint32_t i;
+	char pad;
+	char neg;
+
+	msg = (char*)LOG_Reserve();
+	if (!msg)
+	{
+		return;
+	}
+	va_start(args, fmt);
+	while (*fmt && (size < LOG_MAX_MSG))
+	{
+		if (*fmt != '%')
+		{
+			msg[size++] = *fmt++;
+			continue;
+		}
+		fmt++;
+		pad = ' ';
+		if (*fmt == '0')
+		{
+			pad = '0';
+			fmt++;
+		}
+		width = 0;
+		while ((*fmt >= '0') && (*fmt <= '9'))
+		{
+			width = (width * 10) + (*fmt++ - '0');
+		}
+		if (*fmt == 'l')
+		{
+			fmt++;
+		}
+		len = 0;
+		neg = 0;
+		str = num;
+		switch (*fmt)
+		{
+		case 'c':
+			num[len++] = (char)va_arg(args, int);
+			break;
+		case 's':
+			str = va_arg(args, const char*);
+			while (str[len])
+			{
+				len++;
+			}
+			break;
+		case 'd':
+		case 'u':
+		case 'x':
+		case 'X':
+			value = va_arg(args, uint32_t);
+			base = ((*fmt == 'x') || (*fmt == 'X')) ? 16 : 10;
+			if ((*fmt == 'd') && ((int32_t)value < 0))
+			{
+				neg = 1;
+				value = -value;
+			}
+			do
+			{
+				num[sizeof(num) - 1 - len++] =
+					log_hex[(value % base) + ((*fmt == 'X') ? 16 : 0)];
+				value /= base;
+			}
+			while (value);
+			if (neg)
+			{
+				num[sizeof(num) - 1 - len++] = '-';
+			}
+			str = &num[sizeof(num) - len];
+			break;
+		case '%':
+			num[len++] = '%';
+			break;
+		default:
+			fmt--;
+			break;
+		}
+		if (*fmt)
+		{
+			fmt++;
+		}
+		for (i = len; (i < width) && (size < LOG_MAX_MSG); i++)
+		{
+			msg[size++] = pad;
+		}
+		for (i = 0; (i < len) && (size < LOG_MAX_MSG); i++)
+		{
+			msg[size++] = str[i];
+		}
+	}
+	va_end(args);
+
+	LOG_Commit((uint8_t*)msg, size);
+}
+
+/***************************************************************************//**
+ * @brief Writes an event into the ring buffer. In the binary format the event
+ *        takes a LOG_EVENT_SIZE byte record and is not formatted, which keeps
+ *        the cost of high rate events low; in the text format it is written
+ *        as "#id time arg".
+ *
+ * @param id - event id
+ * @param arg - event argument
+ *
+ * @return None.
+*******************************************************************************/
+void LOG_Event(uint8_t id, uint32_t arg)
+{
+	uint32_t time = (uint32_t)TIMER_GetTimeUs();
+	uint8_t* rec;
+	uint32_t size = 0;
+	uint32_t i;
+
+	if (!log_ring.binary)
+	{
+		LOG_Printf("#%d %u %x\n\r", id, time, arg);
+		return;
+	}
+	rec = LOG_Reserve();
+	if (!rec)
+	{
+		return;
+	}
+	rec[size++] = LOG_EVENT_MARKER;
+	rec[size++] = id;
+	for (i = 0; i < 4; i++)
+	{
+		rec[size++] = (time >> (8 * i)) & 0xFF;
+	}
+	for (i = 0; i < 4; i++)
+	{
+		rec[size++] = (arg >> (8 * i)) & 0xFF;
+	}
+	LOG_Commit(rec, LOG_EVENT_SIZE);
+}
+
+/***************************************************************************//**
+ * @brief Selects the format of the events.
+ *
+ * @param enable - 1 for the binary records, 0 for text.
+ *
+ * @return None.
+*******************************************************************************/
+void LOG_SetBinary(uint8_t enable)
+{
+	log_ring.binary = enable ? 1 : 0;
+}
+
+/***************************************************************************//**
+ * @brief Moves the buffered bytes into the UART FIFO without waiting. To be
+ *        called periodically, for example from a background task, when the
+ *        TX interrupt is not used.
+ *
+ * @return None.
+*******************************************************************************/
+void LOG_Poll(void)
+{
+	if (!log_ring.irq)
+	{
+		LOG_Fill();
+	}
+}
+
+/***************************************************************************//**
+ * @brief Waits until all the buffered bytes are in the UART FIFO. Called
+ *        before output which bypasses the ring, such as xil_printf.
+ *
+ * @return None.
+*******************************************************************************/
+void LOG_Flush(void)
+{
+	while (RING_Count(&log_msgs) != 0)
+	{
+		if (!log_ring.irq)
+		{
+			LOG_Fill();
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @brief Drains the ring buffer from the UART TX interrupt. LOG_Isr() must be
+ *        connected to the UART interrupt by the application first.
+ *
+ * @return None.
+*******************************************************************************/
+void LOG_IrqEnable(void)
+{
+	log_ring.busy = 0;
+	log_ring.irq = 1;
+	if (RING_Count(&log_msgs) != 0)
+	{
+		log_ring.busy = 1;
+		LOG_Fill();
+		LOG_UART_IRQ_ON();
+	}
+}
+
+/***************************************************************************//**
+ * @brief UART TX empty interrupt handler. Refills the UART FIFO and stops
+ *        the interrupt when the ring is empty.
+ *
+ * @param ref - not used
+ *
+ * @return None.
+*******************************************************************************/
+FAST_CODE void LOG_Isr(void* ref)
+{
+	LOG_UART_IRQ_ACK();
+	LOG_Fill();
+	if (RING_Count(&log_msgs) == 0)
+	{
+		LOG_UART_IRQ_OFF();
+		log_ring.busy = 0;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Gets the number of messages dropped because the buffer was full.
+ *
+ * @return Number of dropped messages.
+*******************************************************************************/
+uint32_t LOG_GetDropped(void)
+{
+	return log_ring.dropped;
+}
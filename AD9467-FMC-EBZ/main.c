@@ -48,8 +48,36 @@
 #include "cf_ad9467.h"
 #include "AD9467.h"
 #include "AD9517.h"
+#include "bus_profile.h"
+#include "scheduler.h"
+#include "bench.h"
+#include "log.h"
 
-void xil_printf(const char *ctrl1, ...);
+/***************************************************************************//**
+ * @brief Captures a block of samples. Background task, run on every pass of
+ *        the scheduler.
+ *
+ * @param events - Unused.
+ *
+ * @return None.
+*******************************************************************************/
+static void capture_task(uint32_t events)
+{
+	adc_capture(1024, DDR_BASEADDR);
+}
+
+/***************************************************************************//**
+ * @brief Sends the buffered log messages. Background task, run on every pass
+ *        of the scheduler while the UART TX interrupt is not used.
+ *
+ * @param events - Unused.
+ *
+ * @return None.
+*******************************************************************************/
+static void log_task(uint32_t events)
+{
+	LOG_Poll();
+}
 
 /***************************************************************************//**
  * @brief Main function.
@@ -58,48 +86,57 @@ void xil_printf(const char *ctrl1, ...);
 *******************************************************************************/
 int main(){
 
-	u32 mode;
-
 	Xil_ICacheEnable();
     Xil_DCacheEnable();
+    LOG_Init();
 
     /* AD9467 Setup. */
+    PROFILE_PHASE("AD9467 setup");
     ad9467_setup(XPAR_AXI_SPI_0_BASEADDR, 1);
 
 	/* AD9517 Setup. */
+	PROFILE_PHASE("AD9517 setup");
 	ad9517_setup(XPAR_AXI_SPI_0_BASEADDR, 2);	// Initialize device.
+	PROFILE_PHASE("AD9517 channel 3");
 	ad9517_power_mode(3, 0);					// Set channel 3 for normal operation
 	ad9517_frequency(3, 250000000); 			// Set the channel 3 frequency to 250Mhz
 	ad9517_update();							// Update registers
+	PROFILE_PHASE_END();
 
 	/* Read the device ID for AD9467 and AD9517. */
-	xil_printf("\n\r********************************************************************\r\n");
-	xil_printf("  ADI AD9467-FMC-EBZ Reference Design\n\r");
-	xil_printf("  AD9467 CHIP ID: 0x%02x\n\r", ad9467_read(AD9467_REG_CHIP_ID));
-	xil_printf("  AD9467 CHIP GRADE: 0x%02x\n\r", ad9467_read(AD9467_REG_CHIP_GRADE));
-	xil_printf("  AD9517 CHIP ID: 0x%02x", ad9517_read(AD9517_REG_PART_ID));
-	xil_printf("\n\r********************************************************************\r\n");
+	LOG_INFO("\n\r********************************************************************\r\n");
+	LOG_INFO("  ADI AD9467-FMC-EBZ Reference Design\n\r");
+	LOG_INFO("  AD9467 CHIP ID: 0x%02x\n\r", ad9467_read(AD9467_REG_CHIP_ID));
+	LOG_INFO("  AD9467 CHIP GRADE: 0x%02x\n\r", ad9467_read(AD9467_REG_CHIP_GRADE));
+	LOG_INFO("  AD9517 CHIP ID: 0x%02x", ad9517_read(AD9517_REG_PART_ID));
+	LOG_INFO("\n\r********************************************************************\r\n");
 
 	/* AD9467 test. */
+	PROFILE_PHASE("ADC core setup");
 	adc_setup(0);
-	for (mode = MIDSCALE; mode <= ONE_ZERO_TOGGLE; mode++)		// Data pattern checks
+	PROFILE_PHASE_END();
+	/* Startup time of each stage, compiled out without BUS_PROFILE_EN. */
+	LOG_Flush();
+	PROFILE_PhaseDump();
+	/* Throughput benchmarks, compiled out without BENCH_EN. */
+	BENCH_Run();
+	if (adc_post(ADC_POST_LEVEL) < 0)		// Data pattern checks
 	{
-		adc_test(mode, OFFSET_BINARY);     // Data format is offset binary
-		adc_test(mode, TWOS_COMPLEMENT);   // Data format is twos complement
+		LOG_ERROR("Self-test failed.\n\r");
 	}
+	ad9467_stage_begin();       // Collect the register changes
 	ad9467_output_invert(0);    // Output invert Off
 	ad9467_output_format(0);    // Offset binary
 	ad9467_reset_PN9(0);        // Clear PN9 bit
 	ad9467_reset_PN23(0);       // Clear PN23 bit
 	ad9467_test_mode(0);        // Test mode Off
-	ad9467_transfer();          // Synchronously update registers
+	ad9467_stage_commit();      // Synchronously update registers
 
-	xil_printf("Done\n\r");
+	LOG_INFO("Done\n\r");
 
-	while(1)
-	{
-		adc_capture(1024, DDR_BASEADDR);
-	}
+	SCHED_AddTask("capture", capture_task, 0, 0);
+	SCHED_AddTask("log", log_task, 0, 0);
+	SCHED_Run();
 
 	Xil_DCacheDisable();
 	Xil_ICacheDisable();
@@ -0,0 +1,109 @@
+/**************************************************************************//**
+*   @file   ring.h
+*   @brief  Lock-free single producer, single consumer descriptor ring header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+
+#ifndef __RING_H__
+#define __RING_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+#include "xparameters.h"
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* The head and the tail are on separate cache lines, each written by one
+   side only */
+#define RING_CACHE_LINE		32
+
+/*****************************************************************************/
+/************************ Macros Definitions *********************************/
+/*****************************************************************************/
+/** Orders the descriptor accesses with the index which publishes them. The
+    MicroBlaze executes in order, only the compiler has to be stopped. */
+#ifdef _XPARAMETERS_PS_H_
+#define RING_BARRIER()		__asm__ __volatile__("dmb" : : : "memory")
+#else
+#define RING_BARRIER()		__asm__ __volatile__("" : : : "memory")
+#endif
+
+/*****************************************************************************/
+/************************ Types Declarations *********************************/
+/*****************************************************************************/
+/* Buffer descriptor, in the style of the ADC capture header */
+typedef struct _stRingDesc
+{
+	uint64_t	timestampUs;	/*!< Time of the buffer in us */
+	uint32_t	address;		/*!< Start address of the buffer */
+	uint32_t	length;			/*!< Length of the buffer in bytes */
+	uint32_t	flags;			/*!< Flags defined by the producer */
+	uint32_t	user;			/*!< Value defined by the producer */
+} stRingDesc;
+
+typedef struct _stRing
+{
+	volatile uint32_t	head;		/*!< Descriptors pushed, by the producer */
+	uint32_t			pad0[(RING_CACHE_LINE / 4) - 1];
+	volatile uint32_t	tail;		/*!< Descriptors popped, by the consumer */
+	uint32_t			pad1[(RING_CACHE_LINE / 4) - 1];
+	uint32_t			mask;		/*!< Number of descriptors - 1 */
+	stRingDesc*			pDesc;		/*!< Descriptor storage */
+} stRing;
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+/*! Initializes an empty ring on a power of 2 number of descriptors */
+int32_t RING_Init(stRing* pRing, stRingDesc* pDesc, uint32_t size);
+/*! Adds a descriptor, producer side */
+int32_t RING_Push(stRing* pRing, const stRingDesc* pDesc);
+/*! Removes the oldest descriptor, consumer side */
+int32_t RING_Pop(stRing* pRing, stRingDesc* pDesc);
+/*! Reads the oldest descriptor without removing it, consumer side */
+int32_t RING_Peek(const stRing* pRing, stRingDesc* pDesc);
+/*! Gets the number of descriptors in the ring */
+uint32_t RING_Count(const stRing* pRing);
+
+#endif /* __RING_H__ */
@@ -1,228 +1,537 @@
-/**************************************************************************//**
-*   @file   spi.c
-*   @brief  SPI functions implementations.
-*   @author acozma (andrei.cozma@analog.com)
-*
-*******************************************************************************
-* Copyright 2011(c) Analog Devices, Inc.
-*
-* All rights reserved.
-*
-* Redistribution and use in source and binary forms, with or without modification,
-* are permitted provided that the following conditions are met:
-*  - Redistributions of source code must retain the above copyright
-*    notice, this list of conditions and the following disclaimer.
-*  - Redistributions in binary form must reproduce the above copyright
-*    notice, this list of conditions and the following disclaimer in
-*    the documentation and/or other materials provided with the
-*    distribution.
-*  - Neither the name of Analog Devices, Inc. nor the names of its
-*    contributors may be used to endorse or promote products derived
-*    from this software without specific prior written permission.
-*  - The use of this software may or may not infringe the patent rights
-*    of one or more patent holders.  This license does not release you
-*    from the requirement that you obtain separate licenses from these
-*    patent holders to use this software.
-*  - Use of the software either in source or binary form, must be run
-*    on or directly connected to an Analog Devices Inc. component.
-*
-* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
-* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
-* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
-* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
-* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
-* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
-* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
-* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
-* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
-* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-*
-*******************************************************************************
-*   SVN Revision: $WCREV$
-******************************************************************************/
-
-/*****************************************************************************/
-/***************************** Include Files *********************************/
-/*****************************************************************************/
-#include "spi.h"
-#include "xil_io.h"
-
-/*****************************************************************************/
-/************************ Constants Definitions ******************************/
-/*****************************************************************************/
-#define MAX_TX_SIZE	16 /*!< Maximum number of bytes that can be transmitted in one SPI transfer */
-
-/*****************************************************************************/
-/************************ Variables Definitions ******************************/
-/*****************************************************************************/
-typedef struct _stSpiConfig
-{
-	u32 	axiBaseAddr; /*!< Base address of the SPI Microblaze IP */
-	u32		config;	 	 /*!< Configuration of the SPI Microblaze IP  */
-}stSpiConfig;
-
-static stSpiConfig spiConfig[2] = {{0,0}, {0,0}};
-static char emptyTxBuf[MAX_TX_SIZE];
-
-/**************************************************************************//**
-* @brief Initializes the communication with the Microblaze SPI peripheral.
-*
-* @param axiBaseAddr - Microblaze SPI peripheral AXI base address.
-* @param lsbFirst - Set to 1 if the data is transmitted LSB first.
-* @param cpha - Set to 1 if CPHA mode is used.
-* @param cpol - Set to 1 if CPOL mode is used.
-* @return TRUE
-******************************************************************************/
-u32 SPI_Init(u32 axiBaseAddr, char lsbFirst, char cpha, char cpol)
-{
-    u32 i = 0;
-	u32 cfgValue = 0;
-
-	//set the empty Tx buffer to 0
-	for(i = 0; i < MAX_TX_SIZE; i++)
-	{
-		emptyTxBuf[i] = 0;
-	}
-
-	// Configuration Register Settings
-	cfgValue |= (lsbFirst 	<< LSBFirst)         | // MSB First transfer format
-				(1 			<< MasterTranInh)    | // Master transactions disabled
-				(1 			<< ManualSlaveAssEn) | // Slave select output follows data in slave select register
-				(1 			<< RxFifoReset)      | // Receive FIFO normal operation
-				(0 			<< TxFifoReset)      | // Transmit FIFO normal operation
-				(cpha 		<< CHPA)             | // Data valid on first SCK edge
-				(cpol 		<< CPOL)             | // Active high clock, SCK idles low
-				(1 			<< Master)           | // SPI in Master configuration mode
-				(1 			<< SPE)              | // SPI enabled
-				(0 			<< LOOP);              // Normal operation
-
-    //initialize the SPI configuration
-    for(i = 0; i < sizeof(spiConfig) / sizeof(stSpiConfig); i++)
-    {
-    	if(spiConfig[i].axiBaseAddr == 0)
-    	{
-    		spiConfig[i].axiBaseAddr = axiBaseAddr;
-    		spiConfig[i].config	 	 = cfgValue;
-    		break;
-    	}
-    }
-
-    //set the slave select register to all ones
-    Xil_Out32(axiBaseAddr + SPISSR, 0xFFFFFFFF);
-
-    // Set corresponding value to the Configuration Register
-    Xil_Out32(axiBaseAddr + SPICR, cfgValue);
-
-    return TRUE;
-}
-
-/**************************************************************************//**
-* @brief Transfers data to and from a SPI slave.
-*
-* @param axiBaseAddr - Microblaze SPI peripheral AXI base address.
-* @param txSize - Number of bytes to transmit to the SPI slave.
-* @param txBuffer - Buffer which holds the data to be transmitted to the SPI slave.
-* @param rxSize - Number of bytes to receive from the SPI slave.
-* @param txBuffer - Buffer to store the data read to the SPI slave.
-* @param ssNo - Slave select line on which the slave is connected.
-* @return TRUE.
-******************************************************************************/
-u32 SPI_TransferData(u32 axiBaseAddr, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo)
-{
-    u32 i = 0;
-    u32 cfgValue  = 0;
-    u32 SPIStatus = 0;
-    u32 rxCnt = 0;
-    u32 txCnt = 0;
-    u32 timeout = 0xFFFF;
-
-    // Get the configuration of the SPI core
-    for(i = 0; i < sizeof(spiConfig) / sizeof(stSpiConfig); i++)
-	{
-		if(spiConfig[i].axiBaseAddr == axiBaseAddr)
-		{
-			cfgValue = spiConfig[i].config;
-			break;
-		}
-	}
-
-    // Check if the transmit buffer is empty
-    if(txSize == 0)
-    {
-    	txSize = rxSize;
-    	txBuf = emptyTxBuf;
-    }
-
-    // Write configuration data to master SPI device SPICR
-    Xil_Out32(axiBaseAddr + SPICR, cfgValue);
-
-    // Write to SPISSR to manually assert SSn
-    Xil_Out32(axiBaseAddr + SPISSR, ~(0x00000001 << (ssNo - 1)));
-
-    // Write initial data to master SPIDTR register
-    Xil_Out32(axiBaseAddr + SPIDTR, txBuf[0]);
-
-    // Enable the master transactions
-    cfgValue &= ~(1 << MasterTranInh);
-    Xil_Out32(axiBaseAddr + SPICR, cfgValue);
-
-    // Send and receive the data
-    while(txCnt < txSize)
-    {
-    	// Poll status for completion
-    	do
-    	{
-    		SPIStatus = Xil_In32(axiBaseAddr + SPISR);
-    	}
-    	while(((SPIStatus & 0x01) == 1) && timeout--);
-    	if(timeout == -1)
-    	{
-        	// Disable the master transactions
-    		cfgValue |= (1 << MasterTranInh);
-    		Xil_Out32(axiBaseAddr + SPICR, cfgValue);
-
-    		//reset the SPI core
-			Xil_Out32(axiBaseAddr + SRR, 0x0000000A);
-
-			//set the slave select register to all ones
-			Xil_Out32(axiBaseAddr + SPISSR, 0xFFFFFFFF);
-
-			// Set corresponding value to the Configuration Register
-			Xil_Out32(axiBaseAddr + SPICR, cfgValue);
-
-			return FALSE;
-    	}
-    	timeout = 0xFFFF;
-
-    	// Read received data from SPI Core buffer
-    	if(rxCnt < rxSize)
-    	{
-    		rxBuf[rxCnt] = Xil_In32(axiBaseAddr + SPIDRR);
-    		rxCnt++;
-    	}
-		// Send next data
-    	txCnt++;
-    	if(txCnt < txSize)
-    	{
-        	// Disable the master transactions
-    		cfgValue |= (1 << MasterTranInh);
-    		Xil_Out32(axiBaseAddr + SPICR, cfgValue);
-
-    		// Write data
-    		Xil_Out32(axiBaseAddr + SPIDTR, txBuf[txCnt]);
-
-    		/// Enable the master transactions
-			cfgValue &= ~(1 << MasterTranInh);
-			Xil_Out32(axiBaseAddr + SPICR, cfgValue);
-    	}
-    }
-
-    // Disable the master transactions
-    cfgValue |= (1 << MasterTranInh);
-    Xil_Out32(axiBaseAddr + SPICR, cfgValue);
-
-    // Write all ones to SPISSR
-    Xil_Out32(axiBaseAddr + SPISSR, 0xFFFFFFFF);
-
-    return TRUE;
-}
+/**************************************************************************//**
+*   @file   spi.c
+*   @brief  SPI functions implementations.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2011(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "spi.h"
+#include "xil_io.h"
+#include "fastmem.h"
+
+/* Built only with the AXI SPI core, see spi_ps7.c */
+#ifndef SPI_PS7
+
+extern void delay_ms(u32 ms_count);
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+#define MAX_TX_SIZE	16 /*!< Maximum number of bytes that can be transmitted in one SPI transfer */
+#define FIFO_DEPTH	16 /*!< Depth of the SPI core Tx/Rx FIFOs */
+#ifndef SPI_MAX_CORES
+#define SPI_MAX_CORES 8 /*!< Maximum number of SPI cores that can be initialized */
+#endif
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+struct _stSpiConfig
+{
+	u32 	axiBaseAddr; /*!< Base address of the SPI Microblaze IP */
+	u32		config;	 	 /*!< Configuration of the SPI Microblaze IP  */
+	u32		burst;		 /*!< Set to 1 if the Tx FIFO is preloaded for a transfer */
+	char*	txBuf;		 /*!< Transmit buffer of the current transfer */
+	char*	rxBuf;		 /*!< Receive buffer of the current transfer */
+	u32		txSize;		 /*!< Number of bytes to transmit */
+	u32		rxSize;		 /*!< Number of bytes to receive */
+	u32		txCnt;		 /*!< Number of bytes written to the Tx FIFO */
+	u32		rxCnt;		 /*!< Number of bytes read from the Rx FIFO */
+	volatile u32 busy;	 /*!< Set to 1 while a transfer is in progress */
+	volatile u32 status; /*!< Result of the last transfer */
+	SPI_Callback callback; /*!< Completion callback of the current transfer */
+	void*	callbackParam; /*!< Parameter of the completion callback */
+};
+
+static FAST_DATA stSpiConfig spiConfig[SPI_MAX_CORES];
+static FAST_DATA char emptyTxBuf[MAX_TX_SIZE];
+
+/**************************************************************************//**
+* @brief Initializes the communication with the Microblaze SPI peripheral.
+*
+* @param axiBaseAddr - Microblaze SPI peripheral AXI base address.
+* @param lsbFirst - Set to 1 if the data is transmitted LSB first.
+* @param cpha - Set to 1 if CPHA mode is used.
+* @param cpol - Set to 1 if CPOL mode is used.
+* @return Handle of the SPI core, NULL if all the SPI_MAX_CORES entries are
+*         used. Initializing a core again returns the same handle.
+******************************************************************************/
+SPI_Handle SPI_Init(u32 axiBaseAddr, char lsbFirst, char cpha, char cpol)
+{
+    u32 i = 0;
+	u32 cfgValue = 0;
+	stSpiConfig* pSpi = NULL;
+
+	//set the empty Tx buffer to 0
+	for(i = 0; i < MAX_TX_SIZE; i++)
+	{
+		emptyTxBuf[i] = 0;
+	}
+
+	// Configuration Register Settings
+	cfgValue |= (lsbFirst 	<< LSBFirst)         | // MSB First transfer format
+				(1 			<< MasterTranInh)    | // Master transactions disabled
+				(1 			<< ManualSlaveAssEn) | // Slave select output follows data in slave select register
+				(1 			<< RxFifoReset)      | // Receive FIFO normal operation
+				(0 			<< TxFifoReset)      | // Transmit FIFO normal operation
+				(cpha 		<< CHPA)             | // Data valid on first SCK edge
+				(cpol 		<< CPOL)             | // Active high clock, SCK idles low
+				(1 			<< Master)           | // SPI in Master configuration mode
+				(1 			<< SPE)              | // SPI enabled
+				(0 			<< LOOP);              // Normal operation
+
+    //find the entry of the SPI core or the first free one
+    for(i = 0; i < SPI_MAX_CORES; i++)
+    {
+    	if(spiConfig[i].axiBaseAddr == axiBaseAddr)
+    	{
+    		pSpi = &spiConfig[i];
+    		break;
+    	}
+    	if((pSpi == NULL) && (spiConfig[i].axiBaseAddr == 0))
+    	{
+    		pSpi = &spiConfig[i];
+    	}
+    }
+    if(pSpi == NULL)
+    {
+    	return NULL;
+    }
+
+    //initialize the SPI configuration
+    pSpi->axiBaseAddr = axiBaseAddr;
+    pSpi->config	  = cfgValue;
+    pSpi->burst		  = 1;
+
+    //set the slave select register to all ones
+    Xil_Out32(axiBaseAddr + SPISSR, 0xFFFFFFFF);
+
+    // Set corresponding value to the Configuration Register
+    Xil_Out32(axiBaseAddr + SPICR, cfgValue);
+
+    return pSpi;
+}
+
+/**************************************************************************//**
+* @brief Enables or disables the Tx FIFO burst mode of a SPI core. In burst
+*        mode up to FIFO_DEPTH bytes are preloaded into the Tx FIFO and the
+*        master transaction is released once per chunk, so the bytes are
+*        shifted out back to back with SSn held. With burst mode disabled
+*        the frame is sent one byte at a time.
+*
+* @param pSpi - Handle of the SPI core returned by SPI_Init().
+* @param enable - Set to 1 to enable the burst mode, 0 to disable it.
+* @return TRUE on success, FALSE if the handle is NULL.
+******************************************************************************/
+u32 SPI_SetBurstMode(SPI_Handle pSpi, char enable)
+{
+    if(pSpi == NULL)
+    {
+    	return FALSE;
+    }
+    pSpi->burst = enable ? 1 : 0;
+
+    return TRUE;
+}
+
+/**************************************************************************//**
+* @brief Resets the SPI core after a transfer timeout.
+*
+* @param axiBaseAddr - Microblaze SPI peripheral AXI base address.
+* @param cfgValue - Configuration register value to restore.
+* @return None.
+******************************************************************************/
+static void SPI_Recover(u32 axiBaseAddr, u32 cfgValue)
+{
+	// Disable the master transactions
+	cfgValue |= (1 << MasterTranInh);
+	Xil_Out32(axiBaseAddr + SPICR, cfgValue);
+
+	//reset the SPI core
+	Xil_Out32(axiBaseAddr + SRR, 0x0000000A);
+
+	//set the slave select register to all ones
+	Xil_Out32(axiBaseAddr + SPISSR, 0xFFFFFFFF);
+
+	// Set corresponding value to the Configuration Register
+	Xil_Out32(axiBaseAddr + SPICR, cfgValue);
+}
+
+/**************************************************************************//**
+* @brief Loads the next chunk of the current transfer in the Tx FIFO and
+*        releases the master transaction. In burst mode the chunk is as
+*        large as the FIFO, otherwise a single byte is sent.
+*
+* @param pSpi - Configuration entry of the SPI core.
+* @return None.
+******************************************************************************/
+static FAST_CODE void SPI_LoadChunk(stSpiConfig* pSpi)
+{
+    u32 cfgValue = pSpi->config;
+    u32 chunkEnd = 0;
+
+    chunkEnd = pSpi->txCnt + (pSpi->burst ? FIFO_DEPTH : 1);
+    if(chunkEnd > pSpi->txSize)
+    {
+    	chunkEnd = pSpi->txSize;
+    }
+
+    // Disable the master transactions
+    cfgValue |= (1 << MasterTranInh);
+    Xil_Out32(pSpi->axiBaseAddr + SPICR, cfgValue);
+
+    // Write data
+    while(pSpi->txCnt < chunkEnd)
+    {
+    	Xil_Out32(pSpi->axiBaseAddr + SPIDTR, pSpi->txBuf[pSpi->txCnt]);
+    	pSpi->txCnt++;
+    }
+
+    // Enable the master transactions
+    cfgValue &= ~(1 << MasterTranInh);
+    Xil_Out32(pSpi->axiBaseAddr + SPICR, cfgValue);
+}
+
+/**************************************************************************//**
+* @brief Reads the data of the chunk in flight from the Rx FIFO, one byte is
+*        received for every byte sent.
+*
+* @param pSpi - Configuration entry of the SPI core.
+* @return TRUE if the whole chunk was received, FALSE on timeout.
+******************************************************************************/
+static FAST_CODE u32 SPI_DrainChunk(stSpiConfig* pSpi)
+{
+    u32 timeout = 0xFFFF;
+    u32 rxData = 0;
+
+    while(pSpi->rxCnt < pSpi->txCnt)
+    {
+    	if(Xil_In32(pSpi->axiBaseAddr + SPISR) & (1 << RxEmpty))
+    	{
+    		if(timeout-- == 0)
+    		{
+    			return FALSE;
+    		}
+    		continue;
+    	}
+    	rxData = Xil_In32(pSpi->axiBaseAddr + SPIDRR);
+    	if(pSpi->rxCnt < pSpi->rxSize)
+    	{
+    		pSpi->rxBuf[pSpi->rxCnt] = rxData;
+    	}
+    	pSpi->rxCnt++;
+    	timeout = 0xFFFF;
+    }
+
+    return TRUE;
+}
+
+/**************************************************************************//**
+* @brief Ends the current transfer, releases SSn and signals the completion.
+*
+* @param pSpi - Configuration entry of the SPI core.
+* @param status - TRUE if the transfer completed, FALSE on timeout.
+* @return None.
+******************************************************************************/
+static FAST_CODE void SPI_EndTransfer(stSpiConfig* pSpi, u32 status)
+{
+    // Disable the SPI core interrupts
+    Xil_Out32(pSpi->axiBaseAddr + DGIER, 0);
+    Xil_Out32(pSpi->axiBaseAddr + IPIER, 0);
+
+    if(status == TRUE)
+    {
+    	// Disable the master transactions
+    	Xil_Out32(pSpi->axiBaseAddr + SPICR, pSpi->config);
+
+    	// Write all ones to SPISSR
+    	Xil_Out32(pSpi->axiBaseAddr + SPISSR, 0xFFFFFFFF);
+    }
+    else
+    {
+    	SPI_Recover(pSpi->axiBaseAddr, pSpi->config);
+    }
+
+    pSpi->status = status;
+    pSpi->busy = 0;
+    if(pSpi->callback)
+    {
+    	pSpi->callback(pSpi->callbackParam, status);
+    }
+}
+
+/**************************************************************************//**
+* @brief Drains the chunk in flight and either loads the next one or ends
+*        the transfer.
+*
+* @param pSpi - Configuration entry of the SPI core.
+* @return None.
+******************************************************************************/
+static FAST_CODE void SPI_Advance(stSpiConfig* pSpi)
+{
+    if(SPI_DrainChunk(pSpi) == FALSE)
+    {
+    	SPI_EndTransfer(pSpi, FALSE);
+    }
+    else if(pSpi->txCnt < pSpi->txSize)
+    {
+    	SPI_LoadChunk(pSpi);
+    }
+    else
+    {
+    	SPI_EndTransfer(pSpi, TRUE);
+    }
+}
+
+/**************************************************************************//**
+* @brief Asserts SSn and starts a transfer on a SPI core.
+*
+* @param pSpi - Configuration entry of the SPI core.
+* @param txSize - Number of bytes to transmit to the SPI slave.
+* @param txBuffer - Buffer which holds the data to be transmitted to the SPI slave.
+* @param rxSize - Number of bytes to receive from the SPI slave.
+* @param rxBuffer - Buffer to store the data read from the SPI slave.
+* @param ssNo - Slave select line on which the slave is connected.
+* @param intrEn - Set to 1 to signal the chunk completion by interrupt.
+* @return None.
+******************************************************************************/
+static FAST_CODE void SPI_StartTransfer(stSpiConfig* pSpi, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo, u32 intrEn)
+{
+    // Check if the transmit buffer is empty
+    if(txSize == 0)
+    {
+    	txSize = rxSize;
+    	txBuf = emptyTxBuf;
+    }
+
+    pSpi->txBuf  = txBuf;
+    pSpi->txSize = txSize;
+    pSpi->txCnt  = 0;
+    pSpi->rxBuf  = rxBuf;
+    pSpi->rxSize = rxSize;
+    pSpi->rxCnt  = 0;
+    pSpi->status = FALSE;
+    pSpi->busy   = 1;
+
+    // Write configuration data to master SPI device SPICR, this also flushes the Rx FIFO
+    Xil_Out32(pSpi->axiBaseAddr + SPICR, pSpi->config);
+
+    // Write to SPISSR to manually assert SSn
+    Xil_Out32(pSpi->axiBaseAddr + SPISSR, ~(0x00000001 << (ssNo - 1)));
+
+    if(intrEn)
+    {
+    	// Clear the pending interrupts and enable the DTR empty interrupt
+    	Xil_Out32(pSpi->axiBaseAddr + IPISR, Xil_In32(pSpi->axiBaseAddr + IPISR));
+    	Xil_Out32(pSpi->axiBaseAddr + IPIER, (1 << DTREmpty));
+    	Xil_Out32(pSpi->axiBaseAddr + DGIER, 0x80000000);
+    }
+
+    SPI_LoadChunk(pSpi);
+}
+
+/**************************************************************************//**
+* @brief Runs a single SPI frame without any post-transfer delay.
+*
+* @param pSpi - Configuration entry of the SPI core.
+* @param txSize - Number of bytes to transmit to the SPI slave.
+* @param txBuffer - Buffer which holds the data to be transmitted to the SPI slave.
+* @param rxSize - Number of bytes to receive from the SPI slave.
+* @param rxBuffer - Buffer to store the data read from the SPI slave.
+* @param ssNo - Slave select line on which the slave is connected.
+* @return TRUE if the frame completed, FALSE on timeout.
+******************************************************************************/
+static FAST_CODE u32 SPI_TransferFrame(stSpiConfig* pSpi, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo)
+{
+    PROFILE_START(startTime);
+
+    if((pSpi == NULL) || pSpi->busy)
+    {
+    	return FALSE;
+    }
+
+    // Run the transfer in polled mode
+    pSpi->callback = NULL;
+    SPI_StartTransfer(pSpi, txSize, txBuf, rxSize, rxBuf, ssNo, 0);
+    while(pSpi->busy)
+    {
+    	SPI_Advance(pSpi);
+    }
+    PROFILE_END(startTime, PROFILE_BUS_SPI, ssNo, pSpi->txSize);
+
+    return pSpi->status;
+}
+
+/**************************************************************************//**
+* @brief Starts a transfer to and from a SPI slave and returns immediately.
+*        The transfer is carried on by SPI_IntrHandler(), which must be
+*        connected to the interrupt line of the SPI core. The buffers must
+*        stay valid until the transfer ends.
+*
+* @param pSpi - Handle of the SPI core returned by SPI_Init().
+* @param txSize - Number of bytes to transmit to the SPI slave.
+* @param txBuffer - Buffer which holds the data to be transmitted to the SPI slave.
+* @param rxSize - Number of bytes to receive from the SPI slave.
+* @param rxBuffer - Buffer to store the data read from the SPI slave.
+* @param ssNo - Slave select line on which the slave is connected.
+* @param callback - Function called from the interrupt context when the
+*                   transfer ends, may be NULL.
+* @param callbackParam - Parameter passed to the callback function.
+* @return TRUE if the transfer was started, FALSE if the handle is NULL or
+*         another transfer is in progress.
+******************************************************************************/
+FAST_CODE u32 SPI_TransferDataAsync(SPI_Handle pSpi, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo,
+						  SPI_Callback callback, void* callbackParam)
+{
+    if((pSpi == NULL) || pSpi->busy)
+    {
+    	return FALSE;
+    }
+
+    pSpi->callback		= callback;
+    pSpi->callbackParam = callbackParam;
+    SPI_StartTransfer(pSpi, txSize, txBuf, rxSize, rxBuf, ssNo, 1);
+
+    return TRUE;
+}
+
+/**************************************************************************//**
+* @brief Checks the state of the last transfer started on a SPI core.
+*
+* @param pSpi - Handle of the SPI core returned by SPI_Init().
+* @return 1 while the transfer is in progress, 0 once it ended. The transfer
+*         result is returned by SPI_GetTransferStatus().
+******************************************************************************/
+FAST_CODE u32 SPI_IsTransferBusy(SPI_Handle pSpi)
+{
+    return (pSpi != NULL) ? pSpi->busy : 0;
+}
+
+/**************************************************************************//**
+* @brief Returns the result of the last transfer started on a SPI core.
+*
+* @param pSpi - Handle of the SPI core returned by SPI_Init().
+* @return TRUE if the transfer completed, FALSE on timeout or if the handle is
+*         NULL.
+******************************************************************************/
+FAST_CODE u32 SPI_GetTransferStatus(SPI_Handle pSpi)
+{
+    return (pSpi != NULL) ? pSpi->status : FALSE;
+}
+
+/**************************************************************************//**
+* @brief SPI core interrupt handler. Must be registered with the interrupt
+*        controller with the handle of the core as callback reference.
+*
+* @param callbackRef - Handle of the SPI core returned by SPI_Init().
+* @return None.
+******************************************************************************/
+FAST_CODE void SPI_IntrHandler(void* callbackRef)
+{
+    stSpiConfig* pSpi = (stSpiConfig*)callbackRef;
+    u32 intrStatus = 0;
+
+    if(pSpi == NULL)
+    {
+    	return;
+    }
+
+    // Clear the serviced interrupts
+    intrStatus = Xil_In32(pSpi->axiBaseAddr + IPISR);
+    Xil_Out32(pSpi->axiBaseAddr + IPISR, intrStatus);
+
+    if(pSpi->busy && (intrStatus & (1 << DTREmpty)))
+    {
+    	SPI_Advance(pSpi);
+    }
+}
+
+/**************************************************************************//**
+* @brief Transfers data to and from a SPI slave.
+*
+* @param pSpi - Handle of the SPI core returned by SPI_Init().
+* @param txSize - Number of bytes to transmit to the SPI slave.
+* @param txBuffer - Buffer which holds the data to be transmitted to the SPI slave.
+* @param rxSize - Number of bytes to receive from the SPI slave.
+* @param rxBuffer - Buffer to store the data read from the SPI slave.
+* @param ssNo - Slave select line on which the slave is connected.
+* @return TRUE if the transfer completed, FALSE on timeout.
+******************************************************************************/
+FAST_CODE u32 SPI_TransferData(SPI_Handle pSpi, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo)
+{
+    return SPI_TransferFrame(pSpi, txSize, txBuf, rxSize, rxBuf, ssNo);
+}
+
+/**************************************************************************//**
+* @brief Runs a list of SPI transfers back to back. Each transfer uses its own
+*        slave select line and is followed by its own delay, if any, so the
+*        caller decides where the devices actually need settling time.
+*
+* @param pSpi - Handle of the SPI core returned by SPI_Init().
+* @param transferList - Array of transfer descriptors.
+* @param transferCnt - Number of transfers in the array.
+* @return TRUE if all the transfers completed, FALSE if one of them timed out.
+*         The transfers following the failed one are not started.
+******************************************************************************/
+u32 SPI_TransferList(SPI_Handle pSpi, stSpiTransfer* transferList, u32 transferCnt)
+{
+    u32 i;
+
+    for(i = 0; i < transferCnt; i++)
+    {
+    	if(SPI_TransferFrame(pSpi,
+    						 transferList[i].txSize, transferList[i].txBuf,
+    						 transferList[i].rxSize, transferList[i].rxBuf,
+    						 transferList[i].ssNo) == FALSE)
+    	{
+    		return FALSE;
+    	}
+    	if(transferList[i].delayMs)
+    	{
+    		delay_ms(transferList[i].delayMs);
+    	}
+    }
+
+    return TRUE;
+}
+
+#endif /* SPI_PS7 */
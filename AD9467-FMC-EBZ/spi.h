@@ -1,109 +1,188 @@
-/**************************************************************************//**
-*   @file   spi.h
-*   @brief  SPI header file.
-*   @author acozma (andrei.cozma@analog.com)
-*
-*******************************************************************************
-* Copyright 2011(c) Analog Devices, Inc.
-*
-* All rights reserved.
-*
-* Redistribution and use in source and binary forms, with or without modification,
-* are permitted provided that the following conditions are met:
-*  - Redistributions of source code must retain the above copyright
-*    notice, this list of conditions and the following disclaimer.
-*  - Redistributions in binary form must reproduce the above copyright
-*    notice, this list of conditions and the following disclaimer in
-*    the documentation and/or other materials provided with the
-*    distribution.
-*  - Neither the name of Analog Devices, Inc. nor the names of its
-*    contributors may be used to endorse or promote products derived
-*    from this software without specific prior written permission.
-*  - The use of this software may or may not infringe the patent rights
-*    of one or more patent holders.  This license does not release you
-*    from the requirement that you obtain separate licenses from these
-*    patent holders to use this software.
-*  - Use of the software either in source or binary form, must be run
-*    on or directly connected to an Analog Devices Inc. component.
-*
-* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
-* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
-* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
-* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
-* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
-* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
-* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
-* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
-* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
-* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-*
-*******************************************************************************
-*   SVN Revision: $WCREV$
-******************************************************************************/
-
-#ifndef __SPI__H__
-#define __SPI_H__
-
-/*****************************************************************************/
-/***************************** Include Files *********************************/
-/*****************************************************************************/
-#include "xil_types.h"
-
-/*****************************************************************************/
-/******************* SPI Registers Definitions *******************************/
-/*****************************************************************************/
-// Register address
-#define SRR         0x40
-#define SPICR       0x60
-#define SPISR       0x64
-#define SPIDTR      0x68
-#define SPIDRR      0x6C
-#define SPISSR      0x70
-#define SPI_T_FIFO  0x74
-#define SPI_R_FIFO  0x78
-#define DGIER       0x1C
-#define IPISR       0x20
-#define IPIER       0x28
-
-/*****************************************************************************/
-/******************* SPI Registers Bits **************************************/
-/*****************************************************************************/
-// SPI Control Register (SPICR)
-#define LSBFirst            9
-#define MasterTranInh       8
-#define ManualSlaveAssEn    7
-#define RxFifoReset         6
-#define TxFifoReset         5
-#define CHPA                4
-#define CPOL                3
-#define Master              2
-#define SPE                 1
-#define LOOP                0
-
-// SPI Status Register (SPISR)
-#define SlaveModeSel        5
-#define MODF                4
-#define TxFull              3
-#define TxEmpty             2
-#define RxFull              1
-#define RxEmpty             0
-
-// IP Interrupt Status Register
-#define DDRNotEmpty         8
-#define SlaveModeSel_int    7
-#define TxFifoHalfEmpty     6
-#define DDROverRun          5
-#define DDRFull             4
-#define DTRUnderRun         3
-#define DTREmpty            2
-#define SlaveMODF           1
-#define MODF_int            0
-
-/*****************************************************************************/
-/************************ Functions Declarations *****************************/
-/*****************************************************************************/
-u32	SPI_Init(u32 axiBaseAddr, char lsbFirst, char cpha, char cpol);
-u32 SPI_TransferData(u32 axiBaseAddr, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo);
-
-#endif /*__SPI_H__*/
-
+/**************************************************************************//**
+*   @file   spi.h
+*   @brief  SPI header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2011(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __SPI__H__
+#define __SPI_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "xil_types.h"
+#include "bus_profile.h"
+
+/*****************************************************************************/
+/******************* SPI Registers Definitions *******************************/
+/*****************************************************************************/
+// Register address
+#define SRR         0x40
+#define SPICR       0x60
+#define SPISR       0x64
+#define SPIDTR      0x68
+#define SPIDRR      0x6C
+#define SPISSR      0x70
+#define SPI_T_FIFO  0x74
+#define SPI_R_FIFO  0x78
+#define DGIER       0x1C
+#define IPISR       0x20
+#define IPIER       0x28
+
+/*****************************************************************************/
+/******************* SPI Registers Bits **************************************/
+/*****************************************************************************/
+// SPI Control Register (SPICR)
+#define LSBFirst            9
+#define MasterTranInh       8
+#define ManualSlaveAssEn    7
+#define RxFifoReset         6
+#define TxFifoReset         5
+#define CHPA                4
+#define CPOL                3
+#define Master              2
+#define SPE                 1
+#define LOOP                0
+
+// SPI Status Register (SPISR)
+#define SlaveModeSel        5
+#define MODF                4
+#define TxFull              3
+#define TxEmpty             2
+#define RxFull              1
+#define RxEmpty             0
+
+// IP Interrupt Status Register
+#define DDRNotEmpty         8
+#define SlaveModeSel_int    7
+#define TxFifoHalfEmpty     6
+#define DDROverRun          5
+#define DDRFull             4
+#define DTRUnderRun         3
+#define DTREmpty            2
+#define SlaveMODF           1
+#define MODF_int            0
+
+/*****************************************************************************/
+/******************* PS SPI Registers Definitions ****************************/
+/*****************************************************************************/
+/* The Zynq PS SPI controller is used instead of the AXI SPI core when
+   SPI_PS7 is defined, spi_ps7.c is then built instead of spi.c. */
+#define PS7_SPI_CR			0x00
+#define PS7_SPI_SR			0x04
+#define PS7_SPI_IER			0x08
+#define PS7_SPI_IDR			0x0C
+#define PS7_SPI_IMR			0x10
+#define PS7_SPI_ER			0x14
+#define PS7_SPI_DR			0x18
+#define PS7_SPI_TXD			0x1C
+#define PS7_SPI_RXD			0x20
+#define PS7_SPI_SICR		0x24
+#define PS7_SPI_TX_THRES	0x28
+#define PS7_SPI_RX_THRES	0x2C
+
+// Configuration Register (PS7_SPI_CR)
+#define PS7_SPI_CR_MODE_FAIL_EN		(1 << 17)
+#define PS7_SPI_CR_MAN_START		(1 << 16)
+#define PS7_SPI_CR_MAN_START_EN		(1 << 15)
+#define PS7_SPI_CR_MANUAL_CS		(1 << 14)
+#define PS7_SPI_CR_CS(x)			(((x) & 0xF) << 10)
+#define PS7_SPI_CR_BAUD_DIV(x)		(((x) & 0x7) << 3) // ref clock / 2^(x + 1)
+#define PS7_SPI_CR_CPHA				(1 << 2)
+#define PS7_SPI_CR_CPOL				(1 << 1)
+#define PS7_SPI_CR_MODE_SEL			(1 << 0)
+#define PS7_SPI_CS_NONE				0xF
+
+// Interrupt Status Register, also the status of the FIFOs
+#define PS7_SPI_IXR_TX_UNDERFLOW	(1 << 6) // (Write 1 to clear)
+#define PS7_SPI_IXR_RX_FULL			(1 << 5)
+#define PS7_SPI_IXR_RX_NEMPTY		(1 << 4) // Rx FIFO level >= PS7_SPI_RX_THRES
+#define PS7_SPI_IXR_TX_FULL			(1 << 3)
+#define PS7_SPI_IXR_TX_NFULL		(1 << 2)
+#define PS7_SPI_IXR_MODE_FAIL		(1 << 1) // (Write 1 to clear)
+#define PS7_SPI_IXR_RX_OVERFLOW		(1 << 0) // (Write 1 to clear)
+#define PS7_SPI_IXR_ALL				0x7F
+
+// Enable Register (PS7_SPI_ER)
+#define PS7_SPI_ER_ENABLE			(1 << 0)
+
+/* Reference clock of the PS SPI controllers and maximum SCLK frequency */
+#ifndef PS7_SPI_REF_CLK_HZ
+#define PS7_SPI_REF_CLK_HZ			166666667
+#endif
+#ifndef PS7_SPI_SCLK_HZ
+#define PS7_SPI_SCLK_HZ				10000000
+#endif
+
+/*****************************************************************************/
+/************************ Types Definitions **********************************/
+/*****************************************************************************/
+/*! Transfer completion callback, status is TRUE on success and FALSE on timeout */
+typedef void (*SPI_Callback)(void* param, u32 status);
+
+/*! Opaque handle of an initialized SPI core, returned by SPI_Init() */
+typedef struct _stSpiConfig stSpiConfig;
+typedef stSpiConfig* SPI_Handle;
+
+typedef struct _stSpiTransfer
+{
+	char	txSize;	 /*!< Number of bytes to transmit */
+	char*	txBuf;	 /*!< Transmit buffer, zeros are sent if txSize is 0 */
+	char	rxSize;	 /*!< Number of bytes to receive */
+	char*	rxBuf;	 /*!< Receive buffer */
+	char	ssNo;	 /*!< Slave select line of the target device */
+	u32		delayMs; /*!< Delay inserted after the transfer, 0 for none */
+}stSpiTransfer;
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+SPI_Handle SPI_Init(u32 axiBaseAddr, char lsbFirst, char cpha, char cpol);
+u32 SPI_SetBurstMode(SPI_Handle pSpi, char enable);
+u32 SPI_TransferData(SPI_Handle pSpi, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo);
+u32 SPI_TransferList(SPI_Handle pSpi, stSpiTransfer* transferList, u32 transferCnt);
+u32 SPI_TransferDataAsync(SPI_Handle pSpi, char txSize, char* txBuf, char rxSize, char* rxBuf, char ssNo,
+						  SPI_Callback callback, void* callbackParam);
+u32 SPI_IsTransferBusy(SPI_Handle pSpi);
+u32 SPI_GetTransferStatus(SPI_Handle pSpi);
+void SPI_IntrHandler(void* callbackRef);
+
+#endif /*__SPI_H__*/
+
@@ -0,0 +1,152 @@
+/**************************************************************************//**
+*   @file   regmap.h
+*   @brief  Register map access layer header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __REGMAP_H__
+#define __REGMAP_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Largest number of data bytes of a bulk transfer chunk */
+#ifndef REGMAP_MAX_TRANSFER
+#define REGMAP_MAX_TRANSFER		64
+#endif
+
+/* Define to read back the registers of the reset values table in
+   REGMAP_Reset, the registers which do not match are always written */
+/* #define REGMAP_VERIFY_DEFAULTS */
+
+/*****************************************************************************/
+/************************** Types Declarations *******************************/
+/*****************************************************************************/
+/* Bus access functions. The instruction word holds the read/write flag, the
+   byte count field and the register address and is sent MSB first, followed
+   by size data bytes. In MSB first mode the device decrements the address
+   after each data byte. */
+typedef int32_t (*REGMAP_BusRead)(uint32_t busId, uint32_t instr,
+								  uint8_t* data, uint32_t size);
+typedef int32_t (*REGMAP_BusWrite)(uint32_t busId, uint32_t instr,
+								   const uint8_t* data, uint32_t size);
+
+/* Range of consecutive registers with the same power on reset value */
+typedef struct _stRegmapDefault
+{
+	uint16_t		addr;			/*!< First register of the range */
+	uint16_t		count;			/*!< Number of registers of the range */
+	uint8_t			value;			/*!< Reset value of the registers */
+}stRegmapDefault;
+
+typedef struct _stRegmapConfig
+{
+	uint32_t		addrMask;		/*!< Address bits of the instruction word */
+	uint32_t		readFlag;		/*!< Instruction bits set for a read */
+	uint32_t		writeFlag;		/*!< Instruction bits set for a write */
+	uint32_t		cntShift;		/*!< Position of the W1:W0 byte count field, 0 if none */
+	uint32_t		maxRead;		/*!< Most data bytes of one read transfer */
+	uint32_t		maxWrite;		/*!< Most data bytes of one write transfer */
+	uint32_t		numRegs;		/*!< Number of registers covered by the cache */
+	const uint8_t*	volatileMap;	/*!< Bit per register set for the registers
+										 which are never cached, NULL if none */
+	REGMAP_BusRead	busRead;		/*!< Reads data bytes from the device */
+	REGMAP_BusWrite	busWrite;		/*!< Writes data bytes to the device */
+	const stRegmapDefault* defaults;	/*!< Reset values of the registers set
+										 up by the driver, sorted by address,
+										 NULL if none */
+	uint32_t		numDefaults;	/*!< Number of ranges of defaults */
+}stRegmapConfig;
+
+typedef struct _stRegmap
+{
+	const stRegmapConfig*	pConfig;	/*!< Register map description */
+	uint32_t				busId;		/*!< Passed to the bus access functions */
+	uint8_t*				cache;		/*!< numRegs register values, NULL if the
+											 map is not cached */
+	uint8_t*				cacheValid;	/*!< Bit per register set when the cache
+											 holds the register value */
+	uint8_t*				atReset;	/*!< Bit per register of defaults set while
+											 the register keeps its reset value,
+											 NULL to always write the registers */
+	uint32_t				elided;		/*!< Register writes skipped because the
+											 register held the value */
+}stRegmap;
+
+/*****************************************************************************/
+/************************ Macros Definitions *********************************/
+/*****************************************************************************/
+/** Size of a bit map of n registers */
+#define REGMAP_BITMAP_SIZE(n)	(((n) + 7) / 8)
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+/** Initializes a register map, the cache storage is optional */
+void REGMAP_Init(stRegmap* pMap, const stRegmapConfig* pConfig, uint32_t busId,
+				 uint8_t* cache, uint8_t* cacheValid);
+/** Sets the storage which tracks the registers holding their reset value */
+void REGMAP_InitDefaults(stRegmap* pMap, uint8_t* atReset);
+/** Reads a register of up to 4 bytes, addr is the most significant byte */
+int32_t REGMAP_Read(stRegmap* pMap, uint32_t addr, uint32_t size, uint32_t* value);
+/** Writes a register of up to 4 bytes, addr is the most significant byte */
+int32_t REGMAP_Write(stRegmap* pMap, uint32_t addr, uint32_t size, uint32_t value);
+/** Changes the masked bits of a register, the write is skipped if they are unchanged */
+int32_t REGMAP_UpdateBits(stRegmap* pMap, uint32_t addr, uint32_t size,
+						  uint32_t mask, uint32_t value);
+/** Reads count registers from addr down, data[i] holds register addr - i */
+int32_t REGMAP_RawRead(stRegmap* pMap, uint32_t addr, uint8_t* data, uint32_t count);
+/** Writes count registers from addr down, data[i] goes to register addr - i */
+int32_t REGMAP_RawWrite(stRegmap* pMap, uint32_t addr, const uint8_t* data, uint32_t count);
+/** Reads count registers from addr up, data[i] holds register addr + i */
+int32_t REGMAP_BulkRead(stRegmap* pMap, uint32_t addr, uint8_t* data, uint32_t count);
+/** Writes count registers from addr up, data[i] goes to register addr + i */
+int32_t REGMAP_BulkWrite(stRegmap* pMap, uint32_t addr, const uint8_t* data, uint32_t count);
+/** Drops all the cached register values */
+void REGMAP_CacheInvalidate(stRegmap* pMap);
+/** Updates the register map state after a reset of the device */
+int32_t REGMAP_Reset(stRegmap* pMap);
+
+#endif /* __REGMAP_H__ */
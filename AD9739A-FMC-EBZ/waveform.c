@@ -0,0 +1,538 @@
+/**************************************************************************//**
+*   @file   waveform.c
+*   @brief  DAC waveform synthesizer implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "waveform.h"
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Odd Taylor coefficients of sin(x * pi / 2) on [0, 1], Q30 */
+#define WAVE_SIN_C1		1686629713
+#define WAVE_SIN_C3		-693598668
+#define WAVE_SIN_C5		85569306
+#define WAVE_SIN_C7		-5026995
+#define WAVE_SIN_C9		172272
+#define WAVE_SIN_C11	-3864
+
+#define WAVE_QUARTER	0x40000000u
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+/* Phase increments computed by WAVE_DdsIncr, sampleRate is 0 if unused */
+static struct
+{
+	uint32_t	frequency;
+	uint32_t	sampleRate;
+	uint32_t	incr;
+}WAVE_ddsCache[WAVE_DDS_CACHE];
+static uint32_t WAVE_ddsNext = 0;
+#ifdef __ARM_NEON__
+/* Sample offsets of the lanes of a vector */
+static const uint32_t WAVE_lane[4] = {0, 1, 2, 3};
+#endif
+
+/**************************************************************************//**
+* @brief Computes the sine of a phase. The phase is folded into the first
+*        quadrant and the sine is evaluated as a polynomial, the error is
+*        below 1e-7 of the full scale.
+*
+* @param phase - The phase, 2^32 is a full turn.
+*
+* @return The sine in Q30.
+******************************************************************************/
+static int32_t WAVE_Sin(uint32_t phase)
+{
+	int64_t x = phase & (WAVE_QUARTER - 1);
+	int64_t x2;
+	int64_t y;
+
+	if(phase & WAVE_QUARTER)
+	{
+		x = WAVE_QUARTER - x;
+	}
+	x2 = (x * x) >> 30;
+	y = WAVE_SIN_C11;
+	y = WAVE_SIN_C9 + ((y * x2) >> 30);
+	y = WAVE_SIN_C7 + ((y * x2) >> 30);
+	y = WAVE_SIN_C5 + ((y * x2) >> 30);
+	y = WAVE_SIN_C3 + ((y * x2) >> 30);
+	y = WAVE_SIN_C1 + ((y * x2) >> 30);
+	y = (y * x) >> 30;
+	if(y > WAVE_QUARTER)
+	{
+		y = WAVE_QUARTER;
+	}
+
+	return (int32_t)((phase & (2 * WAVE_QUARTER)) ? -y : y);
+}
+
+/**************************************************************************//**
+* @brief Scales a Q30 value by an amplitude, rounded to the nearest.
+*
+* @param value - The value in Q30.
+* @param amplitude - The amplitude.
+*
+* @return The scaled value.
+******************************************************************************/
+static int32_t WAVE_Scale(int32_t value, int32_t amplitude)
+{
+	return (int32_t)((((int64_t)value * amplitude) + (1 << 29)) >> 30);
+}
+
+/**************************************************************************//**
+* @brief Limits a sample to the 16 bit range.
+*
+* @param value - The sample.
+*
+* @return The limited sample.
+******************************************************************************/
+static int16_t WAVE_Saturate(int32_t value)
+{
+	if(value > 32767)
+	{
+		return 32767;
+	}
+	if(value < -32768)
+	{
+		return -32768;
+	}
+
+	return (int16_t)value;
+}
+
+#ifdef __ARM_NEON__
+/**************************************************************************//**
+* @brief Multiplies four pairs of Q30 values, as (a * b) >> 30 in 64 bits.
+*
+* @param a - The first values.
+* @param b - The second values.
+*
+* @return The products in Q30.
+******************************************************************************/
+static int32x4_t WAVE_Mul4(int32x4_t a, int32x4_t b)
+{
+	return vcombine_s32(vshrn_n_s64(vmull_s32(vget_low_s32(a),
+											  vget_low_s32(b)), 30),
+						vshrn_n_s64(vmull_s32(vget_high_s32(a),
+											  vget_high_s32(b)), 30));
+}
+
+/**************************************************************************//**
+* @brief Computes the sines of four phases, with the same folding and
+*        polynomial as WAVE_Sin so the results are identical.
+*
+* @param phase - The phases, 2^32 is a full turn.
+*
+* @return The sines in Q30.
+******************************************************************************/
+static int32x4_t WAVE_Sin4(uint32x4_t phase)
+{
+	const uint32x4_t quarter = vdupq_n_u32(WAVE_QUARTER);
+	uint32x4_t fold;
+	int32x4_t x;
+	int32x4_t x2;
+	int32x4_t y;
+
+	fold = vandq_u32(phase, vdupq_n_u32(WAVE_QUARTER - 1));
+	fold = vbslq_u32(vtstq_u32(phase, quarter), vsubq_u32(quarter, fold), fold);
+	x = vreinterpretq_s32_u32(fold);
+	x2 = WAVE_Mul4(x, x);
+	y = vdupq_n_s32(WAVE_SIN_C11);
+	y = vaddq_s32(vdupq_n_s32(WAVE_SIN_C9), WAVE_Mul4(y, x2));
+	y = vaddq_s32(vdupq_n_s32(WAVE_SIN_C7), WAVE_Mul4(y, x2));
+	y = vaddq_s32(vdupq_n_s32(WAVE_SIN_C5), WAVE_Mul4(y, x2));
+	y = vaddq_s32(vdupq_n_s32(WAVE_SIN_C3), WAVE_Mul4(y, x2));
+	y = vaddq_s32(vdupq_n_s32(WAVE_SIN_C1), WAVE_Mul4(y, x2));
+	y = vminq_s32(WAVE_Mul4(y, x), vreinterpretq_s32_u32(quarter));
+
+	return vbslq_s32(vtstq_u32(phase, vdupq_n_u32(2 * WAVE_QUARTER)),
+					 vnegq_s32(y), y);
+}
+
+/**************************************************************************//**
+* @brief Scales four Q30 values by an amplitude, rounded to the nearest.
+*
+* @param value - The values in Q30.
+* @param amplitude - The amplitude.
+*
+* @return The scaled values.
+******************************************************************************/
+static int32x4_t WAVE_Scale4(int32x4_t value, int32_t amplitude)
+{
+	return vcombine_s32(vrshrn_n_s64(vmull_n_s32(vget_low_s32(value),
+												 amplitude), 30),
+						vrshrn_n_s64(vmull_n_s32(vget_high_s32(value),
+												 amplitude), 30));
+}
+#endif
+
+/**************************************************************************//**
+* @brief Computes the phase increment of a frequency.
+*
+* @param frequency - The frequency in Hz, below the sample rate.
+* @param sampleRate - The sample rate in Hz.
+*
+* @return The phase increment per sample.
+******************************************************************************/
+uint32_t WAVE_Incr(uint64_t frequency, uint64_t sampleRate)
+{
+	return (uint32_t)((frequency << 32) / sampleRate);
+}
+
+/**************************************************************************//**
+* @brief Computes the phase increment of a number of cycles over a buffer.
+*        The buffer is periodic, so it can be played in a loop without a
+*        phase jump, if the number of samples is a power of 2.
+*
+* @param cycles - Number of cycles in the buffer.
+* @param samples - Number of samples of the buffer.
+*
+* @return The phase increment per sample.
+******************************************************************************/
+uint32_t WAVE_CycleIncr(uint32_t cycles, uint32_t samples)
+{
+	return (uint32_t)(((uint64_t)cycles << 32) / samples);
+}
+
+/**************************************************************************//**
+* @brief Synthesizes the samples of a waveform into a DMA buffer, with plain
+*        stores so the buffer should be cacheable; the caller flushes the
+*        buffer before the DMA reads it. The samples are synthesized by
+*        blocks of WAVE_BLOCK: the phases of a block are computed directly
+*        from the first phase of the block, then each tone is added over the
+*        block. With NEON the sines, the modulation and the packing are done
+*        four samples at a time.
+*
+* @param pConfig - The waveform, its phases are updated.
+* @param pBuffer - The buffer.
+* @param samples - Number of samples, even for WAVE_FORMAT_REAL.
+*
+* @return Number of words written, -1 if the waveform is not valid.
+******************************************************************************/
+int32_t WAVE_Generate(stWaveConfig* pConfig, uint32_t* pBuffer, uint32_t samples)
+{
+	uint32_t phase[WAVE_BLOCK];
+	int32_t i[WAVE_BLOCK];
+	int32_t q[WAVE_BLOCK];
+	uint32_t tri[WAVE_BLOCK];
+	stWaveTone* pTone;
+	uint32_t words = 0;
+	uint32_t count;
+	uint32_t n;
+	uint32_t t;
+#ifdef __ARM_NEON__
+	const uint32x4_t quarter = vdupq_n_u32(WAVE_QUARTER);
+	uint32x4_t p;
+	int32x4_t gain;
+	int16x4x2_t iq;
+#endif
+
+	if((pConfig->nbTones > WAVE_MAX_TONES) ||
+	   ((pConfig->format == WAVE_FORMAT_REAL) && (samples & 1)))
+	{
+		return -1;
+	}
+	for(n = 0; n < WAVE_BLOCK; n++)
+	{
+		tri[n] = (n * (n - 1)) / 2;
+	}
+	while(samples)
+	{
+		count = (samples < WAVE_BLOCK) ? samples : WAVE_BLOCK;
+		for(n = 0; n < WAVE_BLOCK; n++)
+		{
+			i[n] = 0;
+			q[n] = 0;
+		}
+		for(t = 0; t < pConfig->nbTones; t++)
+		{
+			pTone = &pConfig->tone[t];
+			for(n = 0; n < WAVE_BLOCK; n++)
+			{
+				phase[n] = pTone->phase + (n * pTone->incr) +
+						   (tri[n] * (uint32_t)pTone->chirp);
+			}
+			n = 0;
+#ifdef __ARM_NEON__
+			for(; (n + 4) <= WAVE_BLOCK; n += 4)
+			{
+				p = vld1q_u32(&phase[n]);
+				vst1q_s32(&i[n], vaddq_s32(vld1q_s32(&i[n]),
+						  WAVE_Scale4(WAVE_Sin4(vaddq_u32(p, quarter)),
+									  pTone->amplitude)));
+				vst1q_s32(&q[n], vaddq_s32(vld1q_s32(&q[n]),
+						  WAVE_Scale4(WAVE_Sin4(p), pTone->amplitude)));
+			}
+#endif
+			for(; n < WAVE_BLOCK; n++)
+			{
+				i[n] += WAVE_Scale(WAVE_Sin(phase[n] + WAVE_QUARTER),
+								   pTone->amplitude);
+				q[n] += WAVE_Scale(WAVE_Sin(phase[n]), pTone->amplitude);
+			}
+			pTone->phase += (count * pTone->incr) +
+							(((count * (count - 1)) / 2) * (uint32_t)pTone->chirp);
+			pTone->incr += count * (uint32_t)pTone->chirp;
+		}
+		if(pConfig->modDepth)
+		{
+			n = 0;
+#ifdef __ARM_NEON__
+			for(; (n + 4) <= WAVE_BLOCK; n += 4)
+			{
+				p = vmlaq_n_u32(vdupq_n_u32(pConfig->modPhase),
+								vaddq_u32(vld1q_u32(WAVE_lane), vdupq_n_u32(n)),
+								pConfig->modIncr);
+				gain = vaddq_s32(vdupq_n_s32(32768 - (pConfig->modDepth >> 1)),
+								 WAVE_Scale4(WAVE_Sin4(p), pConfig->modDepth >> 1));
+				vst1q_s32(&i[n], vshrq_n_s32(vmulq_s32(vld1q_s32(&i[n]), gain), 15));
+				vst1q_s32(&q[n], vshrq_n_s32(vmulq_s32(vld1q_s32(&q[n]), gain), 15));
+			}
+#endif
+			for(; n < WAVE_BLOCK; n++)
+			{
+				/* Envelope from 1 - depth to 1, Q15 */
+				int32_t env = 32768 - (pConfig->modDepth >> 1) +
+							  WAVE_Scale(WAVE_Sin(pConfig->modPhase +
+												  (n * pConfig->modIncr)),
+										 pConfig->modDepth >> 1);
+				i[n] = (i[n] * env) >> 15;
+				q[n] = (q[n] * env) >> 15;
+			}
+			pConfig->modPhase += count * pConfig->modIncr;
+		}
+		n = 0;
+		if(pConfig->format == WAVE_FORMAT_REAL)
+		{
+#ifdef __ARM_NEON__
+			/* Four samples saturated to 16 bits fill two words */
+			for(; (n + 4) <= count; n += 4)
+			{
+				vst1_s16((int16_t*)&pBuffer[words], vqmovn_s32(vld1q_s32(&q[n])));
+				words += 2;
+			}
+#endif
+			for(; n < count; n += 2)
+			{
+				pBuffer[words++] = (uint16_t)WAVE_Saturate(q[n]) |
+								   ((uint32_t)(uint16_t)WAVE_Saturate(q[n + 1]) << 16);
+			}
+		}
+		else
+		{
+#ifdef __ARM_NEON__
+			/* Interleaved stores put Q in the lower half of each word */
+			for(; (n + 4) <= count; n += 4)
+			{
+				iq.val[0] = vqmovn_s32(vld1q_s32(&q[n]));
+				iq.val[1] = vqmovn_s32(vld1q_s32(&i[n]));
+				vst2_s16((int16_t*)&pBuffer[words], iq);
+				words += 4;
+			}
+#endif
+			for(; n < count; n++)
+			{
+				pBuffer[words++] = (uint16_t)WAVE_Saturate(q[n]) |
+								   ((uint32_t)(uint16_t)WAVE_Saturate(i[n]) << 16);
+			}
+		}
+		samples -= count;
+	}
+
+	return words;
+}
+
+/**************************************************************************//**
+* @brief Computes num * WAVE_DDS_TURN / den with 32 bit operations only. The
+*        16 bits of num * 2^16 / den are found one by one as in a long
+*        division, then num * 0xFFFF / den is one less than this quotient if
+*        the remainder is below num.
+*
+* @param num - The numerator, below den.
+* @param den - The denominator.
+*
+* @return The rounded down ratio, below 2^16.
+******************************************************************************/
+static uint32_t WAVE_DdsRatio(uint32_t num, uint32_t den)
+{
+	uint32_t rem = num;
+	uint32_t quot = 0;
+	uint32_t carry;
+	uint32_t bit;
+
+	for(bit = 0; bit < 16; bit++)
+	{
+		carry = rem >> 31;
+		rem <<= 1;
+		quot <<= 1;
+		if(carry || (rem >= den))
+		{
+			rem -= den;
+			quot |= 1;
+		}
+	}
+	if(rem < num)
+	{
+		quot--;
+	}
+
+	return quot;
+}
+
+/**************************************************************************//**
+* @brief Computes the phase increment word of a pcore DDS tone, 0xFFFF is a
+*        full turn. The increment is odd so the phase accumulator goes
+*        through all its values. The last increments are kept in a small
+*        table, a known frequency and sample rate is not computed again.
+*
+* @param frequency - The frequency, in the unit of the sample rate.
+* @param sampleRate - The sample rate, not 0.
+*
+* @return The phase increment, in the lower 16 bits.
+******************************************************************************/
+uint32_t WAVE_DdsIncr(uint32_t frequency, uint32_t sampleRate)
+{
+	uint32_t incr;
+	uint32_t i;
+
+	if(frequency >= sampleRate)
+	{
+		frequency %= sampleRate;
+	}
+	for(i = 0; i < WAVE_DDS_CACHE; i++)
+	{
+		if((WAVE_ddsCache[i].sampleRate == sampleRate) &&
+		   (WAVE_ddsCache[i].frequency == frequency))
+		{
+			return WAVE_ddsCache[i].incr;
+		}
+	}
+	incr = WAVE_DdsRatio(frequency, sampleRate) | 1;
+
+	WAVE_ddsCache[WAVE_ddsNext].frequency = frequency;
+	WAVE_ddsCache[WAVE_ddsNext].sampleRate = sampleRate;
+	WAVE_ddsCache[WAVE_ddsNext].incr = incr;
+	WAVE_ddsNext = (WAVE_ddsNext + 1) % WAVE_DDS_CACHE;
+
+	return incr;
+}
+
+/**************************************************************************//**
+* @brief Computes the phase offset word of a pcore DDS tone, 0xFFFF is a
+*        full turn.
+*
+* @param phase - The phase in millidegrees, up to WAVE_DDS_MDEG_TURN.
+*
+* @return The phase offset, in the lower 16 bits.
+******************************************************************************/
+uint32_t WAVE_DdsPhase(uint32_t phase)
+{
+	if(phase >= WAVE_DDS_MDEG_TURN)
+	{
+		return WAVE_DDS_TURN;
+	}
+
+	return WAVE_DdsRatio(phase, WAVE_DDS_MDEG_TURN);
+}
+
+/**************************************************************************//**
+* @brief Computes the output control word of a pcore DDS tone: the phase
+*        offset in the upper half and the phase increment in the lower half.
+*
+* @param phase - The phase in millidegrees.
+* @param frequency - The frequency, in the unit of the sample rate.
+* @param sampleRate - The sample rate, not 0.
+*
+* @return The output control word.
+******************************************************************************/
+uint32_t WAVE_DdsWord(uint32_t phase, uint32_t frequency, uint32_t sampleRate)
+{
+	return (WAVE_DdsPhase(phase) << 16) | WAVE_DdsIncr(frequency, sampleRate);
+}
+
+/**************************************************************************//**
+* @brief Computes the output control words of a DDS with two tones on each
+*        of its two channels, in the order of the registers: the tones 1 and
+*        2 of the first channel, then of the second channel. Each channel
+*        has its own phase, so the channels can be set in quadrature.
+*
+* @param pWords - The WAVE_DDS_WORDS output control words.
+* @param freq1 - The frequency of the first tones.
+* @param freq2 - The frequency of the second tones.
+* @param phase1 - The phase of the first channel in millidegrees.
+* @param phase2 - The phase of the second channel in millidegrees.
+* @param sampleRate - The sample rate, in the unit of the frequencies.
+*
+* @return None.
+******************************************************************************/
+void WAVE_DdsDualTone(uint32_t* pWords, uint32_t freq1, uint32_t freq2,
+					  uint32_t phase1, uint32_t phase2, uint32_t sampleRate)
+{
+	uint32_t incr1 = WAVE_DdsIncr(freq1, sampleRate);
+	uint32_t incr2 = WAVE_DdsIncr(freq2, sampleRate);
+
+	pWords[0] = (WAVE_DdsPhase(phase1) << 16) | incr1;
+	pWords[1] = (WAVE_DdsPhase(phase1) << 16) | incr2;
+	pWords[2] = (WAVE_DdsPhase(phase2) << 16) | incr1;
+	pWords[3] = (WAVE_DdsPhase(phase2) << 16) | incr2;
+}
+
+/**************************************************************************//**
+* @brief Computes the scale word of a pcore DDS: each tone has a 4 bit code,
+*        the tone is divided by 2^code, 0 leaves it at full scale.
+*
+* @param shift - The code of all the tones, up to 15.
+*
+* @return The scale word.
+******************************************************************************/
+uint32_t WAVE_DdsScale(uint32_t shift)
+{
+	return (shift & 0xF) * 0x1111;
+}
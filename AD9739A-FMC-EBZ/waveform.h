@@ -0,0 +1,131 @@
+/**************************************************************************//**
+*   @file   waveform.h
+*   @brief  DAC waveform synthesizer header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __WAVEFORM_H__
+#define __WAVEFORM_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Maximum number of tones of a waveform */
+#ifndef WAVE_MAX_TONES
+#define WAVE_MAX_TONES	4
+#endif
+
+/* Number of samples synthesized together, the inner loops run over a block
+   with no dependency between the samples so the compiler can vectorize them */
+#ifndef WAVE_BLOCK
+#define WAVE_BLOCK		8
+#endif
+
+/* Sample formats of the DMA buffer */
+#define WAVE_FORMAT_IQ		0	/* one complex sample per word, I in the upper half */
+#define WAVE_FORMAT_REAL	1	/* two real samples per word, the first in the lower half */
+
+/* Full scale amplitude */
+#define WAVE_FULL_SCALE		32767
+
+/* Full turn of the phase words of the pcore DDS, and of a phase in millidegrees */
+#define WAVE_DDS_TURN		0xFFFF
+#define WAVE_DDS_MDEG_TURN	360000
+
+/* Number of output control words of a DDS with two tones on two channels */
+#define WAVE_DDS_WORDS		4
+
+/* Number of phase increments kept by WAVE_DdsIncr, a tone setup or a sweep
+   loop then reuses them with no division */
+#ifndef WAVE_DDS_CACHE
+#define WAVE_DDS_CACHE		8
+#endif
+
+/*****************************************************************************/
+/************************ Types Definitions **********************************/
+/*****************************************************************************/
+/* A tone or a linear chirp. The phases are in 2^32 units per turn. */
+typedef struct
+{
+	uint32_t	phase;		/* phase of the next sample */
+	uint32_t	incr;		/* phase increment per sample */
+	int32_t		chirp;		/* change of the increment per sample, 0 for a tone */
+	uint16_t	amplitude;	/* up to WAVE_FULL_SCALE */
+}stWaveTone;
+
+/* Waveform: the sum of the tones, optionally amplitude modulated. The phases
+   are updated by WAVE_Generate so the next call continues the waveform. */
+typedef struct
+{
+	uint32_t	format;		/* WAVE_FORMAT_x */
+	uint32_t	nbTones;	/* up to WAVE_MAX_TONES */
+	stWaveTone	tone[WAVE_MAX_TONES];
+	uint32_t	modPhase;	/* phase of the modulating tone */
+	uint32_t	modIncr;	/* phase increment of the modulating tone */
+	uint16_t	modDepth;	/* modulation depth, WAVE_FULL_SCALE for 100 %, 0 for none */
+}stWaveConfig;
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+/** Computes the phase increment of a frequency */
+uint32_t WAVE_Incr(uint64_t frequency, uint64_t sampleRate);
+/** Computes the phase increment of a number of cycles over a buffer */
+uint32_t WAVE_CycleIncr(uint32_t cycles, uint32_t samples);
+/** Synthesizes the samples of a waveform into a DMA buffer */
+int32_t WAVE_Generate(stWaveConfig* pConfig, uint32_t* pBuffer, uint32_t samples);
+/** Computes the phase increment word of a pcore DDS tone */
+uint32_t WAVE_DdsIncr(uint32_t frequency, uint32_t sampleRate);
+/** Computes the phase offset word of a pcore DDS tone */
+uint32_t WAVE_DdsPhase(uint32_t phase);
+/** Computes the output control word of a pcore DDS tone */
+uint32_t WAVE_DdsWord(uint32_t phase, uint32_t frequency, uint32_t sampleRate);
+/** Computes the output control words of two tones on two channels */
+void WAVE_DdsDualTone(uint32_t* pWords, uint32_t freq1, uint32_t freq2,
+					  uint32_t phase1, uint32_t phase2, uint32_t sampleRate);
+/** Computes the scale word of a pcore DDS, the same for all the tones */
+uint32_t WAVE_DdsScale(uint32_t shift);
+
+#endif /* __WAVEFORM_H__ */
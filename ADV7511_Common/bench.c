@@ -1,5 +1,6 @@
 /***************************************************************************//**
- *   @file   main.c
+ *   @file   bench.c
+ *   @brief  Pixel clock and frame buffer benchmarks.
 ********************************************************************************
  * Copyright 2013(c) Analog Devices, Inc.
  *
@@ -41,135 +42,128 @@
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
-#include <stdio.h>
-#include "xil_cache.h"
-#include "xbasic_types.h"
+#include <string.h>
+#include "xil_types.h"
 #include "xil_io.h"
-#include "cf_hdmi.h"
 #include "atv_platform.h"
-#include "transmitter.h"
-#include "xil_exception.h"
+#include "cf_hdmi.h"
+#include "bench.h"
+
+#ifdef BENCH_EN
 
-extern void delay_ms(u32 ms_count);
+extern void xil_printf(const char *ctrl1, ...);
 
 /******************************************************************************/
 /************************** Macros Definitions ********************************/
 /******************************************************************************/
-#define HDMI_CALL_INTERVAL_MS	10			/* Interval between two         */
-											/* iterations of the main loop  */
-#define DBG_MSG                 xil_printf
+/* Number of CLKGEN_CalcParams calls timed for each pixel clock, enough for
+   the millisecond time base to resolve a single call */
+#define BENCH_CALC_ITER		1000
+
+/* DDR fill, after the video frames */
+#define BENCH_FILL_ADDR		(DDR_BASEADDR + 0x4000000)
+#define BENCH_FILL_SIZE		0x800000
 
 /******************************************************************************/
 /************************ Variables Definitions *******************************/
 /******************************************************************************/
-static UCHAR    MajorRev;      /* Major Release Number */
-static UCHAR    MinorRev;      /* Usually used for code-drops */
-static UCHAR    RcRev;         /* Release Candidate Number */
-static BOOL     DriverEnable;
-static BOOL     LastEnable;
+static const u32 benchPixelClocks[] = {25175000, 27000000, 65000000,
+									   74250000, 108000000, 148500000};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
 
 /***************************************************************************//**
- * @brief Enables the driver.
+ * @brief Prints one result as a comma separated record:
+ *        BENCH,group,metric,parameter,value,unit
  *
- * @return Returns ATVERR_OK.
+ * @param group - benchmark group
+ * @param metric - measured quantity
+ * @param param - parameter of the measure
+ * @param value - measured value
+ * @param unit - unit of the value
+ *
+ * @return None.
 *******************************************************************************/
-void APP_EnableDriver (BOOL Enable)
+static void BENCH_Print(const char *group, const char *metric, u32 param,
+						u32 value, const char *unit)
 {
-    DriverEnable = Enable;
+	xil_printf("BENCH,%s,%s,%d,%d,%s\n\r", group, metric, param, value, unit);
 }
 
 /***************************************************************************//**
- * @brief Returns the driver enable status.
+ * @brief Measures the time CLKGEN_CalcParams takes to find the MMCM settings
+ *        of each pixel clock, which is part of every video mode change.
  *
- * @return Returns the driver enable status.
+ * @return None.
 *******************************************************************************/
-static BOOL APP_DriverEnabled (void)
+static void BENCH_CalcParams(void)
 {
-    if ((DriverEnable && HAL_GetMBSwitchState()) != LastEnable)
-    {
-        LastEnable = DriverEnable && HAL_GetMBSwitchState();
-        DBG_MSG ("APP: Driver %s\n\r", LastEnable? "Enabled": "Disabled");
-    }
-    return (LastEnable);
+	unsigned long d;
+	unsigned long m;
+	unsigned long dout;
+	u32 start;
+	u32 ms;
+	u32 i;
+	u32 j;
+
+	for (i = 0; i < sizeof(benchPixelClocks) / sizeof(benchPixelClocks[0]); i++)
+	{
+		start = HAL_GetCurrentMsCount();
+		for (j = 0; j < BENCH_CALC_ITER; j++)
+		{
+			CLKGEN_CalcParams(CF_CLKGEN_REF_RATE, benchPixelClocks[i],
+							  &d, &m, &dout);
+		}
+		ms = HAL_GetCurrentMsCount() - start;
+		/* ms * 1000000 / BENCH_CALC_ITER gives ns per call */
+		BENCH_Print("clkgen", "calc_time", benchPixelClocks[i],
+					ms * (1000000 / BENCH_CALC_ITER), "ns");
+	}
 }
 
 /***************************************************************************//**
- * @brief Displays the application version and the chip revision.
+ * @brief Measures the DDR fill rate with a Xil_Out32 loop and with memset,
+ *        the two ways the frame buffers are written.
  *
  * @return None.
 *******************************************************************************/
-static void APP_PrintRevisions (void)
+static void BENCH_Fill(void)
 {
-	UINT16 TxRev;
+	u32 start;
+	u32 ms;
+	u32 addr;
 
-	ADIAPI_TxGetChipRevision(&TxRev);
-
-	DBG_MSG("\n\r********************************************************************\r\n");
-	DBG_MSG("  ADI HDMI Trasmitter Application Ver R%d.%d.%d\n\r", MajorRev, MinorRev, RcRev);
-	DBG_MSG("  HDMI-TX:  ADV7511 Rev 0x%x\r\n", TxRev);
-	DBG_MSG("  Created:  %s At %s\n\r", __DATE__, __TIME__);
-	DBG_MSG("********************************************************************\r\n\n\r");
+	start = HAL_GetCurrentMsCount();
+	for (addr = 0; addr < BENCH_FILL_SIZE; addr += 4)
+	{
+		Xil_Out32(BENCH_FILL_ADDR + addr, addr);
+	}
+	ms = HAL_GetCurrentMsCount() - start;
+	BENCH_Print("ddr", "out32_rate", BENCH_FILL_SIZE,
+				ms ? (u32)((u64)BENCH_FILL_SIZE * 1000 / ms) : 0, "B/s");
+
+	start = HAL_GetCurrentMsCount();
+	memset((void *)BENCH_FILL_ADDR, 0, BENCH_FILL_SIZE);
+	ms = HAL_GetCurrentMsCount() - start;
+	BENCH_Print("ddr", "memset_rate", BENCH_FILL_SIZE,
+				ms ? (u32)((u64)BENCH_FILL_SIZE * 1000 / ms) : 0, "B/s");
 }
 
 /***************************************************************************//**
- * @brief Main function.
+ * @brief Runs the benchmarks and prints the results over UART, one record per
+ *        line between a header and an end record. The platform timer must be
+ *        running, so this is called after HAL_PlatformInit.
  *
- * @return Returns 0.
+ * @return None.
 *******************************************************************************/
-int main()
+void BENCH_Run(void)
 {
-	UINT32 StartCount;
-
-	MajorRev     = 1;
-	MinorRev     = 1;
-	RcRev        = 1;
-	DriverEnable = TRUE;
-	LastEnable   = FALSE;
-
-	Xil_ICacheEnable();
-	Xil_DCacheEnable();
-
-	HAL_PlatformInit(XPAR_AXI_IIC_0_BASEADDR,	/* Perform any required platform init */
-				 XPAR_AXI_TIMER_0_BASEADDR,		/* including hardware reset to HDMI devices */
-				 XPAR_AXI_TIMER_0_INTERRUPT_MASK,
-				 XPAR_AXI_INTC_0_BASEADDR);
-
-	Xil_ExceptionEnable();
-
-	/* Set the default values for 1080P 60Hz */
-	CLKGEN_SetRate(148500000, 200000000);
-	InitHdmiVideoPcore(1920,
-					   1080,
-					   280,
-					   45,
-					   44,
-					   5,
-					   88,
-					   4);
-	InitHdmiAudioPcore();
-
-	APP_PrintRevisions();       /* Display S/W and H/W revisions */
-
-	ADIAPI_TransmitterInit();   /* Initialize ADI repeater software and h/w */
-
-	ADIAPI_TransmitterSetPowerMode(REP_POWER_UP);
-
-	StartCount = HAL_GetCurrentMsCount();
-
-	while(1)
-	{
-		if (ATV_GetElapsedMs (StartCount, NULL) >= HDMI_CALL_INTERVAL_MS)
-		{
-			StartCount = HAL_GetCurrentMsCount();
-			if (APP_DriverEnabled())
-			{
-				ADIAPI_TransmitterMain();
-			}
-		}
-	}
-
-	Xil_DCacheDisable();
-	Xil_ICacheDisable();
-
-	return(0);
+	xil_printf("BENCH,group,metric,param,value,unit\n\r");
+	BENCH_CalcParams();
+	BENCH_Fill();
+	xil_printf("BENCH,end\n\r");
 }
+
+#endif /* BENCH_EN */
@@ -1,5 +1,6 @@
 /***************************************************************************//**
- *   @file   main.c
+ *   @file   boot_profile.c
+ *   @brief  Boot phase profiler.
 ********************************************************************************
  * Copyright 2013(c) Analog Devices, Inc.
  *
@@ -41,135 +42,113 @@
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
-#include <stdio.h>
-#include "xil_cache.h"
-#include "xbasic_types.h"
-#include "xil_io.h"
-#include "cf_hdmi.h"
+#include "xil_types.h"
 #include "atv_platform.h"
-#include "transmitter.h"
-#include "xil_exception.h"
+#include "boot_profile.h"
 
-extern void delay_ms(u32 ms_count);
+#ifdef BUS_PROFILE_EN
 
-/******************************************************************************/
-/************************** Macros Definitions ********************************/
-/******************************************************************************/
-#define HDMI_CALL_INTERVAL_MS	10			/* Interval between two         */
-											/* iterations of the main loop  */
-#define DBG_MSG                 xil_printf
+extern void xil_printf(const char *ctrl1, ...);
 
 /******************************************************************************/
 /************************ Variables Definitions *******************************/
 /******************************************************************************/
-static UCHAR    MajorRev;      /* Major Release Number */
-static UCHAR    MinorRev;      /* Usually used for code-drops */
-static UCHAR    RcRev;         /* Release Candidate Number */
-static BOOL     DriverEnable;
-static BOOL     LastEnable;
-
-/***************************************************************************//**
- * @brief Enables the driver.
- *
- * @return Returns ATVERR_OK.
-*******************************************************************************/
-void APP_EnableDriver (BOOL Enable)
+typedef struct
 {
-    DriverEnable = Enable;
-}
+	const char	*name;		/* name of the phase */
+	u32			startMs;	/* time at which the phase was opened */
+	u32			timeMs;		/* duration of the phase in ms */
+} PROFILE_PHASE_ENTRY;
 
-/***************************************************************************//**
- * @brief Returns the driver enable status.
- *
- * @return Returns the driver enable status.
-*******************************************************************************/
-static BOOL APP_DriverEnabled (void)
-{
-    if ((DriverEnable && HAL_GetMBSwitchState()) != LastEnable)
-    {
-        LastEnable = DriverEnable && HAL_GetMBSwitchState();
-        DBG_MSG ("APP: Driver %s\n\r", LastEnable? "Enabled": "Disabled");
-    }
-    return (LastEnable);
-}
+static PROFILE_PHASE_ENTRY profilePhases[PROFILE_MAX_PHASES];
+static u32 profilePhaseCnt = 0;
+static u32 profilePhaseOpen = 0;
+static u32 profilePhaseDropped = 0;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
 
 /***************************************************************************//**
- * @brief Displays the application version and the chip revision.
+ * @brief Closes the running boot phase and opens a new one. The phases are
+ *        not nested; a phase left open by an early return is closed by the
+ *        next marker. The time base is the millisecond count of the platform
+ *        timer.
+ *
+ * @param name - name of the new phase, NULL to only close the running one
  *
  * @return None.
 *******************************************************************************/
-static void APP_PrintRevisions (void)
+void PROFILE_PhaseMark(const char *name)
 {
-	UINT16 TxRev;
+	u32 now = HAL_GetCurrentMsCount();
+	PROFILE_PHASE_ENTRY *pPhase;
 
-	ADIAPI_TxGetChipRevision(&TxRev);
-
-	DBG_MSG("\n\r********************************************************************\r\n");
-	DBG_MSG("  ADI HDMI Trasmitter Application Ver R%d.%d.%d\n\r", MajorRev, MinorRev, RcRev);
-	DBG_MSG("  HDMI-TX:  ADV7511 Rev 0x%x\r\n", TxRev);
-	DBG_MSG("  Created:  %s At %s\n\r", __DATE__, __TIME__);
-	DBG_MSG("********************************************************************\r\n\n\r");
+	if (profilePhaseOpen)
+	{
+		pPhase = &profilePhases[profilePhaseCnt - 1];
+		pPhase->timeMs = now - pPhase->startMs;
+		profilePhaseOpen = 0;
+	}
+	if (name == 0)
+	{
+		return;
+	}
+	if (profilePhaseCnt == PROFILE_MAX_PHASES)
+	{
+		profilePhaseDropped++;
+		return;
+	}
+	pPhase = &profilePhases[profilePhaseCnt++];
+	pPhase->name = name;
+	pPhase->startMs = now;
+	pPhase->timeMs = 0;
+	profilePhaseOpen = 1;
 }
 
 /***************************************************************************//**
- * @brief Main function.
+ * @brief Closes the running boot phase and prints the boot phases over UART,
+ *        sorted by duration. The phases are cleared, so a mode change after
+ *        the boot reports its own phases.
  *
- * @return Returns 0.
+ * @return None.
 *******************************************************************************/
-int main()
+void PROFILE_PhaseDump(void)
 {
-	UINT32 StartCount;
-
-	MajorRev     = 1;
-	MinorRev     = 1;
-	RcRev        = 1;
-	DriverEnable = TRUE;
-	LastEnable   = FALSE;
-
-	Xil_ICacheEnable();
-	Xil_DCacheEnable();
-
-	HAL_PlatformInit(XPS_I2C0_BASEADDR,			/* Perform any required platform init */
-					 XPAR_SCUTIMER_DEVICE_ID,	/* including hardware reset to HDMI devices */
-					 XPAR_SCUGIC_SINGLE_DEVICE_ID,
-					 XPAR_SCUTIMER_INTR);
-
-	Xil_ExceptionEnable();
-
-	/* Set the default values for 1080P 60Hz */
-	CLKGEN_SetRate(148500000, 200000000);
-	InitHdmiVideoPcore(1920,
-					   1080,
-					   280,
-					   45,
-					   44,
-					   5,
-					   88,
-					   4);
-	InitHdmiAudioPcore();
-
-	APP_PrintRevisions();       /* Display S/W and H/W revisions */
-
-	ADIAPI_TransmitterInit();   /* Initialize ADI repeater software and h/w */
-
-	ADIAPI_TransmitterSetPowerMode(REP_POWER_UP);
-
-	StartCount = HAL_GetCurrentMsCount();
-
-	while(1)
+	u8  order[PROFILE_MAX_PHASES];
+	u32 totalMs = 0;
+	u32 i;
+	u32 j;
+	u8  idx;
+
+	PROFILE_PhaseMark(0);
+	/* Insertion sort of the phase indexes, longest phase first */
+	for (i = 0; i < profilePhaseCnt; i++)
 	{
-		if (ATV_GetElapsedMs (StartCount, NULL) >= HDMI_CALL_INTERVAL_MS)
+		idx = (u8)i;
+		for (j = i; (j > 0) &&
+			 (profilePhases[order[j - 1]].timeMs < profilePhases[idx].timeMs); j--)
 		{
-			StartCount = HAL_GetCurrentMsCount();
-			if (APP_DriverEnabled())
-			{
-				ADIAPI_TransmitterMain();
-			}
+			order[j] = order[j - 1];
 		}
+		order[j] = idx;
+		totalMs += profilePhases[i].timeMs;
 	}
-
-	Xil_DCacheDisable();
-	Xil_ICacheDisable();
-
-	return(0);
+	xil_printf("\n\rPhase                       Time[ms]   Percent\n\r");
+	for (i = 0; i < profilePhaseCnt; i++)
+	{
+		xil_printf("%-24s %11d %9d\n\r",
+				   profilePhases[order[i]].name,
+				   profilePhases[order[i]].timeMs,
+				   totalMs ? (profilePhases[order[i]].timeMs * 100 / totalMs) : 0);
+	}
+	xil_printf("Total                    %11d\n\r", totalMs);
+	if (profilePhaseDropped)
+	{
+		xil_printf("%d phases not tracked, table full\n\r", profilePhaseDropped);
+	}
+	profilePhaseCnt = 0;
+	profilePhaseDropped = 0;
 }
+
+#endif /* BUS_PROFILE_EN */
@@ -0,0 +1,1445 @@
+/***************************************************************************//**
+ *   @file   cf_hdmi.c
+********************************************************************************
+ * Copyright 2013(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+********************************************************************************
+ *   SVN Revision: $WCREV$
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "xil_io.h"
+#include "xparameters.h"
+#include "cf_hdmi.h"
+#include "boot_profile.h"
+#include "atv_platform.h"
+#include "ring.h"
+#ifndef VIDEO_NO_DEMO_IMAGE
+#include "cf_hdmi_image.h"
+#endif
+#include "xil_cache.h"
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+/*****************************************************************************/
+/******************* Macros and Constants Definitions ************************/
+/*****************************************************************************/
+#define MIN(x, y)				(x < y ? x : y)
+#define MAX(x, y) 				(x > y ? x : y)
+#define DIV_ROUND_UP(x,y)		(((x) + (y) - 1) / (y))
+#define DIV_ROUND_CLOSEST(x, y)	(unsigned long)(((double)x / y) + 0.5)
+#define CLAMP(val, min, max)	(val < min ? min : (val > max ? max :val))
+#define ABS(x)					(x < 0 ? -x : x)
+
+/* Widest line the test patterns are drawn for, and largest number of
+   different lines in a pattern */
+#define VIDEO_PATTERN_MAX_WIDTH	1920
+#define VIDEO_PATTERN_LINES		4
+/* Distance in pixels between the lines of the grid pattern */
+#define VIDEO_GRID_STEP			64
+
+static const unsigned long clkgen_filter_table[] =
+{
+	0x01001990, 0x01001190, 0x01009890, 0x01001890,
+	0x01008890, 0x01009090, 0x01009090, 0x01009090,
+	0x01009090, 0x01000890, 0x01000890, 0x01000890,
+	0x08009090, 0x01001090, 0x01001090, 0x01001090,
+	0x01001090, 0x01001090, 0x01001090, 0x01001090,
+	0x01001090, 0x01001090, 0x01001090, 0x01008090,
+	0x01008090, 0x01008090, 0x01008090, 0x01008090,
+	0x01008090, 0x01008090, 0x01008090, 0x01008090,
+	0x01008090, 0x01008090, 0x01008090, 0x01008090,
+	0x01008090, 0x08001090, 0x08001090, 0x08001090,
+	0x08001090, 0x08001090, 0x08001090, 0x08001090,
+	0x08001090, 0x08001090, 0x08001090
+};
+
+static const unsigned long clkgen_lock_table[] =
+{
+	0x060603e8, 0x060603e8, 0x080803e8, 0x0b0b03e8,
+	0x0e0e03e8, 0x111103e8, 0x131303e8, 0x161603e8,
+	0x191903e8, 0x1c1c03e8, 0x1f1f0384, 0x1f1f0339,
+	0x1f1f02ee, 0x1f1f02bc, 0x1f1f028a, 0x1f1f0271,
+	0x1f1f023f, 0x1f1f0226, 0x1f1f020d, 0x1f1f01f4,
+	0x1f1f01db, 0x1f1f01c2, 0x1f1f01a9, 0x1f1f0190,
+	0x1f1f0190, 0x1f1f0177, 0x1f1f015e, 0x1f1f015e,
+	0x1f1f0145, 0x1f1f0145, 0x1f1f012c, 0x1f1f012c,
+	0x1f1f012c, 0x1f1f0113, 0x1f1f0113, 0x1f1f0113
+};
+
+/* Video modes, with the MMCM settings CLKGEN_CalcParams finds for the
+   CF_CLKGEN_REF_RATE reference clock and the matching filter and lock words */
+static const VIDEO_MODE video_modes[] =
+{
+	/* vic, pixel clock, h/v active, h/v blanking, h/v sync width, h/v sync offset, d, m, dout, filter, lock */
+	{ 1, 25175000, 640, 480, 160, 45, 96, 2, 16, 10, 3, 17, 45, 0x01001090, 0x1f1f023f},	// 640x480p60
+	{ 2, 27000000, 720, 480, 138, 45, 62, 6, 16, 9, 5, 27, 40, 0x01008090, 0x1f1f015e},		// 720x480p60
+	{17, 27000000, 720, 576, 144, 49, 64, 5, 12, 5, 5, 27, 40, 0x01008090, 0x1f1f015e},		// 720x576p50
+	{ 4, 74250000, 1280, 720, 370, 30, 40, 5, 110, 5, 5, 26, 14, 0x01008090, 0x1f1f0177},	// 1280x720p60
+	{19, 74250000, 1280, 720, 700, 30, 40, 5, 440, 5, 5, 26, 14, 0x01008090, 0x1f1f0177},	// 1280x720p50
+	{34, 74250000, 1920, 1080, 280, 45, 44, 5, 88, 4, 5, 26, 14, 0x01008090, 0x1f1f0177},	// 1920x1080p30
+	{33, 74250000, 1920, 1080, 720, 45, 44, 5, 528, 4, 5, 26, 14, 0x01008090, 0x1f1f0177},	// 1920x1080p25
+	{31, 148500000, 1920, 1080, 720, 45, 44, 5, 528, 4, 5, 26, 7, 0x01008090, 0x1f1f0177},	// 1920x1080p50
+	{16, 148500000, 1920, 1080, 280, 45, 44, 5, 88, 4, 5, 26, 7, 0x01008090, 0x1f1f0177},	// 1920x1080p60
+	{ 0, 40000000, 800, 600, 256, 28, 128, 4, 40, 1, 1, 3, 15, 0x01009890, 0x080803e8},		// 800x600@60
+	{ 0, 65000000, 1024, 768, 320, 38, 136, 6, 24, 3, 4, 13, 10, 0x08009090, 0x1f1f02ee},	// 1024x768@60
+	{ 0, 108000000, 1280, 1024, 408, 42, 112, 3, 48, 1, 5, 27, 10, 0x01008090, 0x1f1f015e},	// 1280x1024@60
+	{ 0, 106500000, 1440, 900, 464, 34, 152, 6, 80, 3, 3, 16, 10, 0x01001090, 0x1f1f0271},	// 1440x900@60
+	{ 0, 146250000, 1680, 1050, 560, 39, 176, 6, 104, 3, 7, 41, 8, 0x08001090, 0x1f1f00fa}	// 1680x1050@60
+};
+
+/* Status polls the MMCM needed to lock after the last clock change */
+static u32 clkgen_lock_time = 0;
+/* Frame store the VDMA is parked on */
+static u32 video_park_frame = 0;
+/* Size in bytes of the active part of a frame store */
+static u32 video_frame_size = 0;
+/* Pixel format of the frame stores */
+static VIDEO_FORMAT video_format = VIDEO_FMT_ARGB8888;
+/* Distance in bytes between two lines of a frame store */
+static u32 video_line_stride = 0;
+/* Descriptor of the period the producer fills */
+static u32 audio_head = 0;
+/* Samples written in the period of the head descriptor */
+static u32 audio_fill = 0;
+/* Periods submitted to the DMA, oldest first. AudioSubmit pushes them and
+   AudioReclaim pops them once the DMA completed them. */
+static stRingDesc audio_ring_desc[AUDIO_PERIODS];
+static stRing audio_ring = {0, {0}, 0, {0}, AUDIO_PERIODS - 1, audio_ring_desc};
+/* Times the DMA ran out of submitted periods */
+static u32 audio_underruns = 0;
+/* One period of the click tone */
+static u32 audio_click[AUDIO_LENGTH];
+/* 75% color bars, 0x00RRGGBB */
+static const u32 video_bars[8] =
+{
+	0xc0c0c0, 0xc0c000, 0x00c0c0, 0x00c000,
+	0xc000c0, 0xc00000, 0x0000c0, 0x000000
+};
+/* Different lines of a test pattern: 0x00RRGGBB pixels, then in the frame
+   store format. The 64 bit alignment suits the line copy. */
+static u32 video_pattern_rgb[VIDEO_PATTERN_MAX_WIDTH];
+static unsigned long long video_pattern_line[VIDEO_PATTERN_LINES]
+											[VIDEO_PATTERN_MAX_WIDTH / 2];
+
+/***************************************************************************//**
+ * @brief Fills a DDR buffer with a 32 bit value. The buffer is written with
+ *        plain 64 bit stores, four per loop iteration, so the writes go
+ *        through the data cache and reach DDR in cache line bursts; the
+ *        caller flushes the buffer once it is complete, before a DMA reads it.
+ *        With NEON the loop does two 128 bit stores instead.
+ *
+ * @param address - start address of the buffer, 4 byte aligned
+ * @param value - the value of each word
+ * @param count - number of words
+ *
+ * @return None.
+*******************************************************************************/
+static void DDRFill(u32 address, u32 value, u32 count)
+{
+	u32 *dst = (u32 *)address;
+	unsigned long long *dst64;
+	unsigned long long value64;
+#ifdef __ARM_NEON__
+	uint32x4_t value128;
+#endif
+	u32 n;
+
+	if ((address & 0x4) && count)
+	{
+		*dst++ = value;
+		count--;
+	}
+	dst64 = (unsigned long long *)dst;
+	value64 = ((unsigned long long)value << 32) | value;
+#ifdef __ARM_NEON__
+	value128 = vdupq_n_u32(value);
+	for (n = 0; n < (count / 8); n++)
+	{
+		vst1q_u32((u32 *)dst64, value128);
+		vst1q_u32((u32 *)(dst64 + 2), value128);
+		dst64 += 4;
+	}
+#else
+	for (n = 0; n < (count / 8); n++)
+	{
+		dst64[0] = value64;
+		dst64[1] = value64;
+		dst64[2] = value64;
+		dst64[3] = value64;
+		dst64 += 4;
+	}
+#endif
+	for (n = 0; n < ((count / 2) & 3); n++)
+	{
+		*dst64++ = value64;
+	}
+	if (count & 1)
+	{
+		dst[count - 1] = value;
+	}
+}
+
+/***************************************************************************//**
+ * @brief DDRVideoWr. Draws the demo image in the first frame store when it
+ *        fits the frame, and the color bars otherwise or when the image is
+ *        left out with VIDEO_NO_DEMO_IMAGE.
+*******************************************************************************/
+void DDRVideoWr(void)
+{
+#ifndef VIDEO_NO_DEMO_IMAGE
+	u32 dcnt = 0;
+
+	if ((video_line_stride == (IMG_WIDTH * VideoBytesPerPixel(video_format))) &&
+		(video_frame_size == (video_line_stride * IMG_HEIGHT)))
+	{
+		dcnt = ImageDecode(VIDEO_BASEADDR, IMG_SIZE);
+		if (video_format != VIDEO_FMT_ARGB8888)
+		{
+			dcnt = VideoConvertPixels(VIDEO_BASEADDR, (u32 *)VIDEO_BASEADDR,
+									  dcnt / 4);
+		}
+		Xil_DCacheFlushRange(VIDEO_BASEADDR, dcnt);
+		return;
+	}
+#endif
+	VideoDrawPattern(0, VIDEO_PATTERN_COLOR_BARS, 0);
+}
+
+/***************************************************************************//**
+ * @brief Gets the address of an audio DMA descriptor.
+ *
+ * @param n - the descriptor, 0 to AUDIO_PERIODS - 1
+ *
+ * @return Returns the address of the descriptor.
+*******************************************************************************/
+static u32 AudioDescAddress(u32 n)
+{
+	return AUDIO_BASEADDR + (n * AUDIO_DESC_SIZE);
+}
+
+/***************************************************************************//**
+ * @brief Gets the address of the period buffer of an audio DMA descriptor.
+ *
+ * @param n - the descriptor, 0 to AUDIO_PERIODS - 1
+ *
+ * @return Returns the address of the period buffer.
+*******************************************************************************/
+static u32 AudioBufferAddress(u32 n)
+{
+	return AUDIO_BUF_BASEADDR + (n * AUDIO_PERIOD_LENGTH * 4);
+}
+
+/***************************************************************************//**
+ * @brief Builds the audio DMA descriptor ring. Each descriptor points to its
+ *        own period buffer and to the next descriptor; the addresses are
+ *        written once here and the descriptors are then recycled, only their
+ *        control and status words change while streaming.
+ *
+ * @return None.
+*******************************************************************************/
+void DDRAudioWr(void)
+{
+	u32 *desc;
+	u32 n     = 0;
+	u32 scnt  = 0;
+	u32 sincr = 0;
+
+	DDRFill(AUDIO_BASEADDR, 0x00, (AUDIO_PERIODS * AUDIO_DESC_SIZE) / 4); // init descriptors
+	for (n = 0; n < AUDIO_PERIODS; n++)
+	{
+		desc = (u32 *)AudioDescAddress(n);
+		desc[AXI_DMA_DESC_NXTDESC/4] = AudioDescAddress((n + 1) % AUDIO_PERIODS); // next descriptor
+		desc[AXI_DMA_DESC_BUFFER/4] = AudioBufferAddress(n); // start address
+	}
+	Xil_DCacheFlushRange(AUDIO_BASEADDR, (AUDIO_PERIODS * AUDIO_DESC_SIZE));
+	audio_head = 0;
+	audio_fill = 0;
+	RING_Init(&audio_ring, audio_ring_desc, AUDIO_PERIODS);
+	audio_underruns = 0;
+
+	sincr = (65536*2)/AUDIO_LENGTH;
+	for (n = 0; n < AUDIO_LENGTH; n++)
+	{
+		audio_click[n] = ((scnt << 16) | scnt);
+		scnt = (n > (AUDIO_LENGTH/2)) ? (scnt-sincr) : (scnt+sincr);
+	}
+}
+
+/***************************************************************************//**
+ * @brief Hands the period of the head descriptor to the DMA. The period and
+ *        the control and status words of its descriptor are flushed, the
+ *        period is queued in the audio ring, then the descriptor becomes the
+ *        DMA tail. The caller checks that the ring has a free slot.
+ *
+ * @return None.
+*******************************************************************************/
+static void AudioSubmit(void)
+{
+	stRingDesc period;
+	u32 desc = AudioDescAddress(audio_head);
+
+	Xil_DCacheFlushRange(AudioBufferAddress(audio_head), (audio_fill * 4));
+	Xil_Out32((desc + AXI_DMA_DESC_CONTROL), (0xc000000 | (audio_fill * 4))); // sof, eof & no. of bytes
+	Xil_Out32((desc + AXI_DMA_DESC_STATUS), 0x00); // status
+	Xil_DCacheFlushRange((desc + AXI_DMA_DESC_CONTROL), 8);
+	period.timestampUs = (uint64_t)HAL_GetCurrentMsCount() * 1000;
+	period.address     = desc;
+	period.length      = audio_fill * 4;
+	period.flags       = 0;
+	period.user        = audio_head;
+	RING_Push(&audio_ring, &period);
+	audio_head = (audio_head + 1) % AUDIO_PERIODS;
+	audio_fill = 0;
+	Xil_Out32((ADMA_BASEADDR + AXI_DMA_REG_MM2S_TAILDESC), desc); // tail descr.
+}
+
+/***************************************************************************//**
+ * @brief Returns the periods completed by the DMA to the producer. The
+ *        completed bit of the status word of the descriptor of each period
+ *        in the audio ring is checked, oldest first, and the completed
+ *        periods are removed from the ring; only the status words are
+ *        invalidated in the data cache.
+ *
+ * @return None.
+*******************************************************************************/
+static void AudioReclaim(void)
+{
+	stRingDesc period;
+	u32 done = 0;
+
+	while (RING_Peek(&audio_ring, &period) == 0)
+	{
+		Xil_DCacheInvalidateRange((period.address + AXI_DMA_DESC_STATUS), 4);
+		if ((Xil_In32(period.address + AXI_DMA_DESC_STATUS) & 0x80000000) == 0) // not completed
+		{
+			break;
+		}
+		RING_Pop(&audio_ring, &period);
+		done++;
+	}
+	if (done && (RING_Count(&audio_ring) == 0))
+	{
+		audio_underruns++;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Queues audio samples. The samples are copied into the free periods
+ *        of the ring and each full period is handed to the DMA; the call does
+ *        not wait for free periods.
+ *
+ * @param samples - the samples, one 32 bit word (left and right) per sample
+ * @param count - number of samples
+ *
+ * @return Returns the number of samples queued.
+*******************************************************************************/
+u32 AudioWrite(const u32 *samples, u32 count)
+{
+	u32 *buf;
+	u32 done = 0;
+	u32 n;
+
+	AudioReclaim();
+	while ((done < count) && (RING_Count(&audio_ring) < AUDIO_PERIODS))
+	{
+		buf = (u32 *)AudioBufferAddress(audio_head) + audio_fill;
+		n = AUDIO_PERIOD_LENGTH - audio_fill;
+		if (n > (count - done))
+		{
+			n = count - done;
+		}
+		audio_fill += n;
+		while (n--)
+		{
+			*buf++ = samples[done++];
+		}
+		if (audio_fill == AUDIO_PERIOD_LENGTH)
+		{
+			AudioSubmit();
+		}
+	}
+
+	return done;
+}
+
+/***************************************************************************//**
+ * @brief Hands a partly filled period to the DMA, so the queued samples are
+ *        played without waiting for the period to fill.
+ *
+ * @return None.
+*******************************************************************************/
+void AudioFlush(void)
+{
+	AudioReclaim();
+	if ((audio_fill != 0) && (RING_Count(&audio_ring) < AUDIO_PERIODS))
+	{
+		AudioSubmit();
+	}
+}
+
+/***************************************************************************//**
+ * @brief Gets the number of samples AudioWrite can queue without waiting.
+ *
+ * @return Returns the number of free samples.
+*******************************************************************************/
+u32 AudioGetFree(void)
+{
+	AudioReclaim();
+
+	return ((AUDIO_PERIODS - RING_Count(&audio_ring)) * AUDIO_PERIOD_LENGTH) -
+		   audio_fill;
+}
+
+/***************************************************************************//**
+ * @brief Gets the number of times the DMA ran out of submitted periods.
+ *
+ * @return Returns the number of underruns.
+*******************************************************************************/
+u32 AudioGetUnderruns(void)
+{
+	return audio_underruns;
+}
+
+/***************************************************************************//**
+ * @brief InitHdmiVideoPcore.
+*******************************************************************************/
+void InitHdmiVideoPcore(unsigned short hActive,
+						unsigned short vActive,
+						unsigned short hBlanking,
+						unsigned short vBlanking,
+						unsigned short hWidth,
+						unsigned short vWidth,
+						unsigned short hOffset,
+						unsigned short vOffset)
+{
+	unsigned short hCount	  = 0;
+	unsigned short vCount	  = 0;
+	unsigned short hBackPorch = 0;
+	unsigned short vBackPorch = 0;
+	unsigned short hDeMin	  = 0;
+	unsigned short hDeMax	  = 0;
+	unsigned short vDeMin	  = 0;
+	unsigned short vDeMax	  = 0;
+
+	hCount = hActive + hBlanking;
+	vCount = vActive + vBlanking;
+	hBackPorch = hBlanking - hOffset - hWidth;
+	vBackPorch = vBlanking - vOffset - vWidth;
+	hDeMin = hWidth + hBackPorch;
+	hDeMax = hDeMin + hActive;
+	vDeMin = vWidth + vBackPorch;
+	vDeMax = vDeMin + vActive;
+
+	Xil_Out32((CFV_BASEADDR + AXI_HDMI_REG_HTIMING1), ((hWidth << 16) | hCount));
+	Xil_Out32((CFV_BASEADDR + AXI_HDMI_REG_HTIMING2), ((hDeMin << 16) | hDeMax));
+	Xil_Out32((CFV_BASEADDR + AXI_HDMI_REG_VTIMING1), ((vWidth << 16) | vCount));
+	Xil_Out32((CFV_BASEADDR + AXI_HDMI_REG_VTIMING2), ((vDeMin << 16) | vDeMax));
+	Xil_Out32((CFV_BASEADDR + AXI_HDMI_REG_CTRL), 0x00000000); // disable
+	Xil_Out32((CFV_BASEADDR + AXI_HDMI_REG_CTRL), 0x00000001); // enable
+
+	video_line_stride = hActive*VideoBytesPerPixel(video_format);
+	video_frame_size = video_line_stride*vActive;
+	video_park_frame = 0;
+	DDRVideoWr();
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_PARK_PTR), 0); // park on the first frame store
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_DMA_CTRL), 0x00000001); // enable park mode
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_START_1), VideoFrameAddress(0)); // start address
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_START_2), VideoFrameAddress(1)); // start address
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_START_3), VideoFrameAddress(2)); // start address
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_FRMDLY_STRIDE), video_line_stride); // h offset
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_H_SIZE), video_line_stride); // h size
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_V_SIZE), vActive); // v size
+}
+
+/***************************************************************************//**
+ * @brief Gets the start address of a frame store.
+ *
+ * @param frame - the frame store, 0 to VIDEO_FRAMES - 1
+ *
+ * @return Returns the start address of the frame store.
+*******************************************************************************/
+u32 VideoFrameAddress(u32 frame)
+{
+	return VIDEO_BASEADDR + (frame * VIDEO_FRAME_STRIDE);
+}
+
+/***************************************************************************//**
+ * @brief Gets a frame store to render the next frame in. The frame store is
+ *        neither the one the VDMA is reading nor the one a pending flip parks
+ *        it on, so it can be written while the two others are in use.
+ *
+ * @return Returns the frame store.
+*******************************************************************************/
+u32 VideoGetBackFrame(void)
+{
+	u32 current;
+	u32 frame;
+
+	current = (Xil_In32(VDMA_BASEADDR + AXI_VDMA_REG_PARK_PTR) >> 16) & 0x1f;
+	for (frame = 0; frame < (VIDEO_FRAMES - 1); frame++)
+	{
+		if ((frame != current) && (frame != video_park_frame))
+		{
+			break;
+		}
+	}
+
+	return frame;
+}
+
+/***************************************************************************//**
+ * @brief Shows a rendered frame store. The frame store is flushed from the
+ *        data cache and the VDMA is parked on it; the VDMA only changes frame
+ *        stores at a frame start, so the new frame replaces the old one at
+ *        vsync, without tearing.
+ *
+ * @param frame - the frame store, as returned by VideoGetBackFrame
+ *
+ * @return None.
+*******************************************************************************/
+void VideoFlip(u32 frame)
+{
+	Xil_DCacheFlushRange(VideoFrameAddress(frame), video_frame_size);
+	video_park_frame = frame;
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_PARK_PTR), frame); // park pointer
+}
+
+/***************************************************************************//**
+ * @brief Shows a rendered frame store of which only some lines changed since
+ *        it was last shown. Only these lines are flushed from the data cache,
+ *        otherwise as VideoFlip.
+ *
+ * @param frame - the frame store, as returned by VideoGetBackFrame
+ * @param y - first changed line
+ * @param height - number of changed lines
+ *
+ * @return None.
+*******************************************************************************/
+void VideoFlipLines(u32 frame, u32 y, u32 height)
+{
+	Xil_DCacheFlushRange(VideoFrameAddress(frame) + (y * video_line_stride),
+						 height * video_line_stride);
+	video_park_frame = frame;
+	Xil_Out32((VDMA_BASEADDR + AXI_VDMA_REG_PARK_PTR), frame); // park pointer
+}
+
+/***************************************************************************//**
+ * @brief Waits until the VDMA reads the frame store of the last flip.
+ *
+ * @return Returns 0 once the frame is displayed or -1 on timeout.
+*******************************************************************************/
+int VideoWaitFlip(void)
+{
+	u32 timeout = VIDEO_FLIP_TIMEOUT;
+
+	while (((Xil_In32(VDMA_BASEADDR + AXI_VDMA_REG_PARK_PTR) >> 16) & 0x1f) !=
+		   video_park_frame)
+	{
+		if (--timeout == 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Selects the pixel format of the frame stores. The format is applied
+ *        by the next call of InitHdmiVideoPcore, and the HDMI core has to be
+ *        built for the same format.
+ *
+ * @param format - the pixel format:
+ *                 VIDEO_FMT_ARGB8888 - 32 bit word per pixel, 0x00RRGGBB
+ *                 VIDEO_FMT_RGB888   - 3 bytes per pixel, blue byte first
+ *                 VIDEO_FMT_RGB565   - 16 bit per pixel, RRRRRGGGGGGBBBBB
+ *                 VIDEO_FMT_YCBCR422 - 16 bit per pixel, Y in the low byte,
+ *                                      Cb (even pixels) or Cr (odd pixels)
+ *                                      in the high byte
+ *
+ * @return None.
+*******************************************************************************/
+void VideoSetFormat(VIDEO_FORMAT format)
+{
+	video_format = format;
+}
+
+/***************************************************************************//**
+ * @brief Gets the pixel format of the frame stores.
+ *
+ * @return Returns the pixel format.
+*******************************************************************************/
+VIDEO_FORMAT VideoGetFormat(void)
+{
+	return video_format;
+}
+
+/***************************************************************************//**
+ * @brief Gets the number of bytes a pixel takes in a frame store.
+ *
+ * @param format - the pixel format
+ *
+ * @return Returns the number of bytes per pixel.
+*******************************************************************************/
+u32 VideoBytesPerPixel(VIDEO_FORMAT format)
+{
+	switch (format)
+	{
+		case VIDEO_FMT_RGB888:
+			return 3;
+		case VIDEO_FMT_RGB565:
+		case VIDEO_FMT_YCBCR422:
+			return 2;
+		default:
+			return 4;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Gets the distance between two lines of a frame store.
+ *
+ * @return Returns the line stride in bytes.
+*******************************************************************************/
+u32 VideoGetLineStride(void)
+{
+	return video_line_stride;
+}
+
+/***************************************************************************//**
+ * @brief Gets the size of the active part of a frame store.
+ *
+ * @return Returns the size in bytes.
+*******************************************************************************/
+u32 VideoGetFrameSize(void)
+{
+	return video_frame_size;
+}
+
+/***************************************************************************//**
+ * @brief Converts a 0x00RRGGBB color to BT.601 limited range YCbCr.
+ *
+ * @param rgb - the color
+ *
+ * @return Returns the color as 0x00YYCbCr.
+*******************************************************************************/
+static u32 VideoRgbToYCbCr(u32 rgb)
+{
+	u32 r = (rgb >> 16) & 0xff;
+	u32 g = (rgb >> 8) & 0xff;
+	u32 b = rgb & 0xff;
+	u32 y;
+	u32 cb;
+	u32 cr;
+
+	y  = ((66 * r) + (129 * g) + (25 * b) + 4224) >> 8;
+	cb = ((112 * b) + 32896 - (38 * r) - (74 * g)) >> 8;
+	cr = ((112 * r) + 32896 - (94 * g) - (18 * b)) >> 8;
+
+	return (y << 16) | (cb << 8) | cr;
+}
+
+/***************************************************************************//**
+ * @brief Writes one pixel at a frame store address in the selected format.
+ *
+ * @param dst - address of the pixel
+ * @param x - column of the pixel, selects Cb or Cr in YCbCr 4:2:2
+ * @param rgb - the color, 0x00RRGGBB
+ *
+ * @return None.
+*******************************************************************************/
+static void VideoWritePixel(u8 *dst, u32 x, u32 rgb)
+{
+	u32 ycc;
+
+	switch (video_format)
+	{
+		case VIDEO_FMT_RGB888:
+			dst[0] = rgb & 0xff;
+			dst[1] = (rgb >> 8) & 0xff;
+			dst[2] = (rgb >> 16) & 0xff;
+			break;
+		case VIDEO_FMT_RGB565:
+			*(u16 *)dst = ((rgb >> 8) & 0xf800) |
+						  ((rgb >> 5) & 0x07e0) |
+						  ((rgb >> 3) & 0x001f);
+			break;
+		case VIDEO_FMT_YCBCR422:
+			ycc = VideoRgbToYCbCr(rgb);
+			dst[0] = (ycc >> 16) & 0xff;
+			dst[1] = (x & 1) ? (ycc & 0xff) : ((ycc >> 8) & 0xff);
+			break;
+		default:
+			*(u32 *)dst = rgb;
+			break;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Converts a line of 0x00RRGGBB pixels to the selected format. The
+ *        output may overlap the input as long as it does not start after
+ *        it, so an image can be converted in place. In YCbCr 4:2:2 the two
+ *        pixels of a pair share the average of their chroma.
+ *
+ * @param dst - address of the output
+ * @param src - the input pixels
+ * @param count - number of pixels
+ *
+ * @return Returns the number of bytes written.
+*******************************************************************************/
+u32 VideoConvertPixels(u32 dst, const u32 *src, u32 count)
+{
+	u8  *out = (u8 *)dst;
+	u32 bpp  = VideoBytesPerPixel(video_format);
+	u32 ycc0;
+	u32 ycc1;
+	u32 cb;
+	u32 cr;
+	u32 n;
+
+	if (video_format == VIDEO_FMT_YCBCR422)
+	{
+		for (n = 0; (n + 1) < count; n += 2)
+		{
+			ycc0 = VideoRgbToYCbCr(src[n]);
+			ycc1 = VideoRgbToYCbCr(src[n + 1]);
+			cb = ((((ycc0 >> 8) & 0xff) + ((ycc1 >> 8) & 0xff)) + 1) >> 1;
+			cr = (((ycc0 & 0xff) + (ycc1 & 0xff)) + 1) >> 1;
+			out[0] = (ycc0 >> 16) & 0xff;
+			out[1] = cb;
+			out[2] = (ycc1 >> 16) & 0xff;
+			out[3] = cr;
+			out += 4;
+		}
+		if (n < count)
+		{
+			VideoWritePixel(out, n, src[n]);
+		}
+	}
+	else
+	{
+		for (n = 0; n < count; n++)
+		{
+			VideoWritePixel(out, n, src[n]);
+			out += bpp;
+		}
+	}
+
+	return count * bpp;
+}
+
+/***************************************************************************//**
+ * @brief Draws a pixel in a frame store.
+ *
+ * @param frame - the frame store
+ * @param x - column of the pixel
+ * @param y - line of the pixel
+ * @param rgb - the color, 0x00RRGGBB
+ *
+ * @return None.
+*******************************************************************************/
+void VideoPutPixel(u32 frame, u32 x, u32 y, u32 rgb)
+{
+	u32 address;
+
+	address = VideoFrameAddress(frame) + (y * video_line_stride) +
+			  (x * VideoBytesPerPixel(video_format));
+	VideoWritePixel((u8 *)address, x, rgb);
+}
+
+/***************************************************************************//**
+ * @brief Fills a rectangle of a frame store with a color.
+ *
+ * @param frame - the frame store
+ * @param x - first column of the rectangle
+ * @param y - first line of the rectangle
+ * @param width - number of columns
+ * @param height - number of lines
+ * @param rgb - the color, 0x00RRGGBB
+ *
+ * @return None.
+*******************************************************************************/
+void VideoFillRect(u32 frame, u32 x, u32 y, u32 width, u32 height, u32 rgb)
+{
+	u32 bpp = VideoBytesPerPixel(video_format);
+	u32 address;
+	u32 line;
+	u32 n;
+	u8  *dst;
+
+	address = VideoFrameAddress(frame) + (y * video_line_stride) + (x * bpp);
+	for (line = 0; line < height; line++)
+	{
+		if (video_format == VIDEO_FMT_ARGB8888)
+		{
+			DDRFill(address, rgb, width);
+		}
+		else
+		{
+			dst = (u8 *)address;
+			for (n = 0; n < width; n++)
+			{
+				VideoWritePixel(dst, x + n, rgb);
+				dst += bpp;
+			}
+		}
+		address += video_line_stride;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Copies a line of a frame store with 64 bit stores, four per loop
+ *        iteration, as DDRFill. With NEON each iteration does two 128 bit
+ *        loads and stores.
+ *
+ * @param dst - address of the line
+ * @param src - the line to copy
+ * @param bytes - size of the line
+ *
+ * @return None.
+*******************************************************************************/
+static void VideoCopyLine(u32 dst, const unsigned long long *src, u32 bytes)
+{
+	unsigned long long *dst64 = (unsigned long long *)dst;
+#ifdef __ARM_NEON__
+	uint64x2_t lo;
+	uint64x2_t hi;
+#endif
+	u32 n;
+
+	if ((dst | bytes) & 7)
+	{
+		memcpy((void *)dst, src, bytes);
+		return;
+	}
+#ifdef __ARM_NEON__
+	for (n = 0; n < (bytes / 32); n++)
+	{
+		lo = vld1q_u64((const uint64_t *)src);
+		hi = vld1q_u64((const uint64_t *)(src + 2));
+		vst1q_u64((uint64_t *)dst64, lo);
+		vst1q_u64((uint64_t *)(dst64 + 2), hi);
+		dst64 += 4;
+		src += 4;
+	}
+#else
+	for (n = 0; n < (bytes / 32); n++)
+	{
+		dst64[0] = src[0];
+		dst64[1] = src[1];
+		dst64[2] = src[2];
+		dst64[3] = src[3];
+		dst64 += 4;
+		src += 4;
+	}
+#endif
+	for (n = 0; n < ((bytes / 8) & 3); n++)
+	{
+		*dst64++ = *src++;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Draws a test pattern over a whole frame store, for any video mode
+ *        and pixel format, and flushes it from the data cache. The few
+ *        different lines of the pattern are built and converted once, then
+ *        the frame store is written in one pass of line copies.
+ *
+ * @param frame - the frame store
+ * @param pattern - the pattern:
+ *                  VIDEO_PATTERN_COLOR_BARS - eight 75% color bars
+ *                  VIDEO_PATTERN_GRADIENT   - red, green, blue and gray ramps
+ *                  VIDEO_PATTERN_GRID       - white grid and border on black
+ *                  VIDEO_PATTERN_SOLID      - the rgb color
+ * @param rgb - the color of VIDEO_PATTERN_SOLID, 0x00RRGGBB
+ *
+ * @return Returns 0 in case of success or -1 if the frame is too wide or no
+ *         video mode is set.
+*******************************************************************************/
+int VideoDrawPattern(u32 frame, VIDEO_PATTERN pattern, u32 rgb)
+{
+	u32 bpp = VideoBytesPerPixel(video_format);
+	u32 width;
+	u32 height;
+	u32 lines;
+	u32 kind;
+	u32 address;
+	u32 x;
+	u32 y;
+	u32 v;
+
+	if (video_line_stride == 0)
+	{
+		return -1;
+	}
+	width = video_line_stride / bpp;
+	height = video_frame_size / video_line_stride;
+	if (width > VIDEO_PATTERN_MAX_WIDTH)
+	{
+		return -1;
+	}
+
+	lines = (pattern == VIDEO_PATTERN_GRADIENT) ? 4 :
+			(pattern == VIDEO_PATTERN_GRID) ? 2 : 1;
+	for (kind = 0; kind < lines; kind++)
+	{
+		for (x = 0; x < width; x++)
+		{
+			v = (x * 255) / ((width > 1) ? (width - 1) : 1);
+			switch (pattern)
+			{
+				case VIDEO_PATTERN_COLOR_BARS:
+					video_pattern_rgb[x] = video_bars[(x * 8) / width];
+					break;
+				case VIDEO_PATTERN_GRADIENT:
+					video_pattern_rgb[x] = (kind == 3) ? (v * 0x010101) :
+										   (v << (16 - (kind * 8)));
+					break;
+				case VIDEO_PATTERN_GRID:
+					video_pattern_rgb[x] = ((kind == 0) ||
+											((x % VIDEO_GRID_STEP) == 0) ||
+											(x == (width - 1))) ?
+										   0xffffff : 0x000000;
+					break;
+				default:
+					video_pattern_rgb[x] = rgb;
+					break;
+			}
+		}
+		VideoConvertPixels((u32)video_pattern_line[kind], video_pattern_rgb,
+						   width);
+	}
+
+	address = VideoFrameAddress(frame);
+	for (y = 0; y < height; y++)
+	{
+		switch (pattern)
+		{
+			case VIDEO_PATTERN_GRADIENT:
+				kind = (y * 4) / height;
+				break;
+			case VIDEO_PATTERN_GRID:
+				kind = (((y % VIDEO_GRID_STEP) == 0) || (y == (height - 1))) ?
+					   0 : 1;
+				break;
+			default:
+				kind = 0;
+				break;
+		}
+		VideoCopyLine(address, video_pattern_line[kind], video_line_stride);
+		address += video_line_stride;
+	}
+	Xil_DCacheFlushRange(VideoFrameAddress(frame), video_frame_size);
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Flushes a rectangle of a frame store from the data cache, so that
+ *        the VDMA reads what was drawn in it. Only the cache lines covering
+ *        the columns of the rectangle are flushed on each of its lines; a
+ *        rectangle nearly as wide as the frame is flushed as one range.
+ *
+ * @param frame - the frame store
+ * @param x - first column of the rectangle
+ * @param y - first line of the rectangle
+ * @param width - number of columns
+ * @param height - number of lines
+ *
+ * @return None.
+*******************************************************************************/
+void VideoFlushRect(u32 frame, u32 x, u32 y, u32 width, u32 height)
+{
+	u32 bpp = VideoBytesPerPixel(video_format);
+	u32 address;
+	u32 line;
+
+	address = VideoFrameAddress(frame) + (y * video_line_stride) + (x * bpp);
+	if ((width * bpp * 2) >= video_line_stride)
+	{
+		Xil_DCacheFlushRange(address, ((height - 1) * video_line_stride) +
+							 (width * bpp));
+		return;
+	}
+	for (line = 0; line < height; line++)
+	{
+		Xil_DCacheFlushRange(address, width * bpp);
+		address += video_line_stride;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Writes a rectangle of 0x00RRGGBB pixels in a frame store, in the
+ *        selected format, and flushes only that rectangle from the data
+ *        cache. Small overlays can so be updated in the frame store being
+ *        shown without rewriting or flushing the whole frame.
+ *
+ * @param frame - the frame store
+ * @param x - first column of the rectangle, even in YCbCr 4:2:2
+ * @param y - first line of the rectangle
+ * @param width - number of columns
+ * @param height - number of lines
+ * @param pixels - the pixels, width per line, line after line
+ *
+ * @return None.
+*******************************************************************************/
+void VideoUpdateRect(u32 frame, u32 x, u32 y, u32 width, u32 height,
+					 const u32 *pixels)
+{
+	u32 bpp = VideoBytesPerPixel(video_format);
+	u32 address;
+	u32 line;
+
+	if ((width == 0) || (height == 0))
+	{
+		return;
+	}
+	address = VideoFrameAddress(frame) + (y * video_line_stride) + (x * bpp);
+	for (line = 0; line < height; line++)
+	{
+		if (video_format == VIDEO_FMT_ARGB8888)
+		{
+			memcpy((void *)address, pixels, width * 4);
+		}
+		else
+		{
+			VideoConvertPixels(address, pixels, width);
+		}
+		pixels += width;
+		address += video_line_stride;
+	}
+	VideoFlushRect(frame, x, y, width, height);
+}
+
+/***************************************************************************//**
+ * @brief InitHdmiAudioPcore.
+*******************************************************************************/
+void InitHdmiAudioPcore(void)
+{
+	DDRAudioWr();
+
+	Xil_Out32((ADMA_BASEADDR + AXI_DMA_REG_MM2S_DMACR), 0); // clear dma operations
+	Xil_Out32((ADMA_BASEADDR + AXI_DMA_REG_MM2S_CURDESC), AudioDescAddress(0)); // head descr.
+	Xil_Out32((ADMA_BASEADDR + AXI_DMA_REG_MM2S_DMACR), 0x00000001); // enable dma operations, completions are polled
+
+	Xil_Out32((CFA_BASEADDR + 0x04), 0x040); // sample frequency
+	Xil_Out32((CFA_BASEADDR + 0x00), CFA_CTRL); // clock ratio, data enable & signal enable
+}
+
+/***************************************************************************//**
+ * @brief AudioClick.
+*******************************************************************************/
+void AudioClick(void)
+{
+	/* Generating audio clicks. */
+	AudioWrite(audio_click, AUDIO_LENGTH);
+	AudioFlush();
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_LookupFilter.
+*******************************************************************************/
+static unsigned long CLKGEN_LookupFilter(unsigned long m)
+{
+	if (m < 47)
+	{
+		return clkgen_filter_table[m];
+	}
+	return 0x08008090;
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_LookupLock.
+*******************************************************************************/
+static unsigned long CLKGEN_LookupLock(unsigned long m)
+{
+	if (m < 36)
+	{
+		return clkgen_lock_table[m];
+	}
+	return 0x1f1f00fa;
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_CalcParams.
+*******************************************************************************/
+void CLKGEN_CalcParams(unsigned long fin,
+					   unsigned long fout,
+					   unsigned long *best_d,
+					   unsigned long *best_m,
+					   unsigned long *best_dout)
+{
+	const unsigned long fpfd_min = 10000;
+	const unsigned long fpfd_max = 300000;
+	const unsigned long fvco_min = 600000;
+	const unsigned long	fvco_max = 1200000;
+	unsigned long		d		 = 0;
+	unsigned long		d_min	 = 0;
+	unsigned long		d_max	 = 0;
+	unsigned long		_d_min	 = 0;
+	unsigned long		_d_max	 = 0;
+	unsigned long		m		 = 0;
+	unsigned long		m_min	 = 0;
+	unsigned long		m_max	 = 0;
+	unsigned long		dout	 = 0;
+	unsigned long		fvco	 = 0;
+	long				f		 = 0;
+	long				best_f	 = 0;
+
+	fin /= 1000;
+	fout /= 1000;
+
+	best_f = 0x7fffffff;
+	*best_d = 0;
+	*best_m = 0;
+	*best_dout = 0;
+
+	d_min = MAX(DIV_ROUND_UP(fin, fpfd_max), 1);
+	d_max = MIN(fin / fpfd_min, 80);
+
+	m_min = MAX(DIV_ROUND_UP(fvco_min, fin) * d_min, 1);
+	m_max = MIN(fvco_max * d_max / fin, 64);
+
+	for(m = m_min; m <= m_max; m++)
+	{
+		_d_min = MAX(d_min, DIV_ROUND_UP(fin * m, fvco_max));
+		_d_max = MIN(d_max, fin * m / fvco_min);
+
+		for (d = _d_min; d <= _d_max; d++)
+		{
+			fvco = fin * m / d;
+
+			dout = DIV_ROUND_CLOSEST(fvco, fout);
+			dout = CLAMP(dout, 1, 128);
+			f = fvco / dout;
+			if (ABS(f - fout) < ABS(best_f - fout))
+			{
+				best_f = f;
+				*best_d = d;
+				*best_m = m;
+				*best_dout = dout;
+				if (best_f == fout)
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_CalcClkParams.
+*******************************************************************************/
+void CLKGEN_CalcClkParams(unsigned long divider,
+						  unsigned long *low,
+						  unsigned long *high,
+						  unsigned long *edge,
+						  unsigned long *nocount)
+{
+	if (divider == 1)
+	{
+		*nocount = 1;
+	}
+	else
+	{
+		*nocount = 0;
+	}
+	*high = divider / 2;
+	*edge = divider % 2;
+	*low = divider - *high;
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_Write.
+*******************************************************************************/
+void CLKGEN_Write(unsigned long reg,
+				  unsigned long val)
+{
+	Xil_Out32(XPAR_AXI_CLKGEN_0_BASEADDR + reg, val);
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_Read.
+*******************************************************************************/
+static void CLKGEN_Read(unsigned long reg,
+						unsigned long *val)
+{
+	*val = Xil_In32(XPAR_AXI_CLKGEN_0_BASEADDR + reg);
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_WriteParams.
+*******************************************************************************/
+static void CLKGEN_WriteParams(unsigned long d,
+							   unsigned long m,
+							   unsigned long dout,
+							   unsigned long filter,
+							   unsigned long lock)
+{
+	unsigned long nocount = 0;
+	unsigned long high	  = 0;
+	unsigned long edge	  = 0;
+	unsigned long low	  = 0;
+
+	CLKGEN_Write(AXI_CLKGEN_REG_UPDATE_ENABLE, 0);
+
+	CLKGEN_CalcClkParams(dout, &low, &high, &edge, &nocount);
+	CLKGEN_Write(AXI_CLKGEN_REG_CLK_OUT1, (high << 6) | low);
+	CLKGEN_Write(AXI_CLKGEN_REG_CLK_OUT2, (edge << 7) | (nocount << 6));
+
+	CLKGEN_CalcClkParams(d, &low, &high, &edge, &nocount);
+	CLKGEN_Write(AXI_CLKGEN_REG_CLK_DIV, (edge << 13) | (nocount << 12) | (high << 6) | low);
+
+	CLKGEN_CalcClkParams(m, &low, &high, &edge, &nocount);
+	CLKGEN_Write(AXI_CLKGEN_REG_CLK_FB1, (high << 6) | low);
+	CLKGEN_Write(AXI_CLKGEN_REG_CLK_FB2, (edge << 7) | (nocount << 6));
+
+	CLKGEN_Write(AXI_CLKGEN_REG_LOCK1, lock & 0x3ff);
+	CLKGEN_Write(AXI_CLKGEN_REG_LOCK2, (((lock >> 16) & 0x1f) << 10) | 0x1);
+	CLKGEN_Write(AXI_CLKGEN_REG_LOCK3, (((lock >> 24) & 0x1f) << 10) | 0x3e9);
+	CLKGEN_Write(AXI_CLKGEN_REG_FILTER1, filter >> 16);
+	CLKGEN_Write(AXI_CLKGEN_REG_FILTER2, filter);
+	CLKGEN_Write(AXI_CLKGEN_REG_UPDATE_ENABLE, 1);
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_SetRate.
+*******************************************************************************/
+int CLKGEN_SetRate(unsigned long rate,
+				   unsigned long parent_rate)
+{
+	unsigned long d		  = 0;
+	unsigned long m		  = 0;
+	unsigned long dout	  = 0;
+	unsigned long filter  = 0;
+	unsigned long lock	  = 0;
+
+	if (parent_rate == 0 || rate == 0)
+	{
+		return 0;
+	}
+
+	CLKGEN_CalcParams(parent_rate, rate, &d, &m, &dout);
+
+	if (d == 0 || dout == 0 || m == 0)
+	{
+		return 0;
+	}
+
+	filter = CLKGEN_LookupFilter(m - 1);
+	lock = CLKGEN_LookupLock(m - 1);
+
+	CLKGEN_WriteParams(d, m, dout, filter, lock);
+
+	if (CLKGEN_WaitLock() < 0)
+	{
+		return -1;
+	}
+
+	/* Read the dividers back to make sure the core took them. */
+	if (CLKGEN_GetRate(parent_rate) !=
+		(unsigned long)((unsigned long long)(parent_rate / d) * m / dout))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Waits for the pixel clock MMCM to lock after a reconfiguration.
+ *
+ * @return Returns the number of status polls until lock or -1 on timeout.
+*******************************************************************************/
+int CLKGEN_WaitLock(void)
+{
+	unsigned long reg;
+	u32 polls = 0;
+
+	do
+	{
+		CLKGEN_Read(AXI_CLKGEN_REG_STATUS, &reg);
+		if (reg & AXI_CLKGEN_STATUS_LOCKED)
+		{
+			clkgen_lock_time = polls;
+			return polls;
+		}
+	} while (++polls < CLKGEN_LOCK_TIMEOUT);
+
+	clkgen_lock_time = polls;
+
+	return -1;
+}
+
+/***************************************************************************//**
+ * @brief Returns the settle time of the last pixel clock change.
+ *
+ * @return Status polls the MMCM needed to lock.
+*******************************************************************************/
+unsigned long CLKGEN_GetLockTime(void)
+{
+	return clkgen_lock_time;
+}
+
+/***************************************************************************//**
+ * @brief CLKGEN_GetRate.
+*******************************************************************************/
+unsigned long CLKGEN_GetRate(unsigned long parent_rate)
+{
+	unsigned long d, m, dout;
+	unsigned long reg;
+	unsigned long long tmp;
+
+	CLKGEN_Read(AXI_CLKGEN_REG_CLK_OUT1, &reg);
+	dout = (reg & 0x3f) + ((reg >> 6) & 0x3f);
+	CLKGEN_Read(AXI_CLKGEN_REG_CLK_DIV, &reg);
+	d = (reg & 0x3f) + ((reg >> 6) & 0x3f);
+	CLKGEN_Read(AXI_CLKGEN_REG_CLK_FB1, &reg);
+	m = (reg & 0x3f) + ((reg >> 6) & 0x3f);
+
+	if (d == 0 || dout == 0)
+		return 0;
+
+	tmp = (unsigned long long)(parent_rate / d) * m;
+	tmp = tmp / dout;
+
+	if (tmp > 0xffffffff)
+	{
+		return 0xffffffff;
+	}
+
+	return (unsigned long)tmp;
+}
+
+/***************************************************************************//**
+ * @brief Finds a video mode by its CEA-861 video identification code.
+ *
+ * @param vic - the video identification code
+ *
+ * @return Returns the video mode or NULL if the table has no such mode.
+*******************************************************************************/
+const VIDEO_MODE *VideoFindMode(unsigned char vic)
+{
+	unsigned long n;
+
+	for (n = 0; n < (sizeof(video_modes) / sizeof(video_modes[0])); n++)
+	{
+		if ((vic != 0) && (video_modes[n].vic == vic))
+		{
+			return &video_modes[n];
+		}
+	}
+
+	return NULL;
+}
+
+/***************************************************************************//**
+ * @brief Finds the video mode of a timing, e.g. an EDID detailed timing. The
+ *        pixel clock has to match within 0.5%.
+ *
+ * @param hActive - active pixels per line
+ * @param vActive - active lines per frame
+ * @param hBlanking - blanking pixels per line
+ * @param vBlanking - blanking lines per frame
+ * @param pixelClk - pixel clock in Hz
+ *
+ * @return Returns the video mode or NULL if the table has no such mode.
+*******************************************************************************/
+const VIDEO_MODE *VideoMatchMode(unsigned short hActive,
+								 unsigned short vActive,
+								 unsigned short hBlanking,
+								 unsigned short vBlanking,
+								 unsigned long pixelClk)
+{
+	const VIDEO_MODE *mode;
+	unsigned long	 n;
+
+	for (n = 0; n < (sizeof(video_modes) / sizeof(video_modes[0])); n++)
+	{
+		mode = &video_modes[n];
+		if ((mode->hActive == hActive) && (mode->vActive == vActive) &&
+			(mode->hBlanking == hBlanking) && (mode->vBlanking == vBlanking) &&
+			(ABS((long)(mode->pixelClk - pixelClk)) <= (long)(mode->pixelClk / 200)))
+		{
+			return mode;
+		}
+	}
+
+	return NULL;
+}
+
+/***************************************************************************//**
+ * @brief Sets a video mode. The pixel clock is programmed with the settings of
+ *        the mode table, without a search, then the HDMI core and the VDMA are
+ *        configured for the mode timing.
+ *
+ * @param mode - the video mode
+ *
+ * @return Returns 0 in case of success or -1 if mode is NULL.
+*******************************************************************************/
+int VideoSetMode(const VIDEO_MODE *mode)
+{
+	if (mode == NULL)
+	{
+		return -1;
+	}
+
+	PROFILE_PHASE("Pixel clock");
+	CLKGEN_WriteParams(mode->clkD,
+					   mode->clkM,
+					   mode->clkDout,
+					   mode->clkFilter,
+					   mode->clkLock);
+	if (CLKGEN_WaitLock() < 0)
+	{
+		return -1;
+	}
+	PROFILE_PHASE("HDMI video core");
+	InitHdmiVideoPcore(mode->hActive,
+					   mode->vActive,
+					   mode->hBlanking,
+					   mode->vBlanking,
+					   mode->hWidth,
+					   mode->vWidth,
+					   mode->hOffset,
+					   mode->vOffset);
+	PROFILE_PHASE_END();
+
+	return 0;
+}
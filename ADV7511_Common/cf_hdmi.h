@@ -45,23 +45,28 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include "xparameters.h"
+#include "xil_types.h"
+#include "hdmi_board.h"
 
 /******************************************************************************/
 /************************** Macros Definitions ********************************/
 /******************************************************************************/
 #define CF_CLKGEN_BASEADDR  XPAR_AXI_CLKGEN_0_BASEADDR
-#define CFV_BASEADDR        XPAR_AXI_HDMI_TX_36B_0_BASEADDR
 #define CFA_BASEADDR        XPAR_AXI_SPDIF_TX_0_BASEADDR
-#define DDR_BASEADDR        XPAR_DDR3_SDRAM_S_AXI_BASEADDR
 #define UART_BASEADDR       XPS_UART1_BASEADDR
 #define VDMA_BASEADDR       XPAR_AXI_VDMA_0_BASEADDR
-#define ADMA_BASEADDR       XPAR_AXI_DMA_0_BASEADDR
-#define IIC_BASEADDR        XPAR_AXI_IIC_0_BASEADDR
 #define VIDEO_BASEADDR		DDR_BASEADDR + 0x2000000
+#define VIDEO_FRAMES		3			// frame stores, one shown, one queued, one rendered
+#define VIDEO_FRAME_STRIDE	0x800000	// distance between the frame stores
+#define VIDEO_FLIP_TIMEOUT	10000000	// polls of the VDMA park pointer
 #define AUDIO_BASEADDR		DDR_BASEADDR + 0x1000000
 #define A_SAMPLE_FREQ       48000
 #define A_FREQ              1400
 #define AUDIO_LENGTH		(A_SAMPLE_FREQ/A_FREQ)
+#define AUDIO_PERIODS		8			// descriptors in the audio ring
+#define AUDIO_PERIOD_LENGTH	256			// samples per period
+#define AUDIO_DESC_SIZE		0x40
+#define AUDIO_BUF_BASEADDR	(AUDIO_BASEADDR + (AUDIO_PERIODS * AUDIO_DESC_SIZE))
 
 #define AXI_HDMI_REG_CTRL			0x04
 #define AXI_HDMI_REG_HTIMING1		0x08
@@ -72,6 +77,7 @@
 #define AXI_HDMI_REG_COLOR_PATTERN	0x1c
 
 #define AXI_VDMA_REG_DMA_CTRL		0x00
+#define AXI_VDMA_REG_PARK_PTR		0x28
 #define AXI_VDMA_REG_V_SIZE			0x50
 #define AXI_VDMA_REG_H_SIZE			0x54
 #define AXI_VDMA_REG_FRMDLY_STRIDE	0x58
@@ -79,6 +85,18 @@
 #define AXI_VDMA_REG_START_2		0x60
 #define AXI_VDMA_REG_START_3		0x64
 
+#define AXI_DMA_REG_MM2S_DMACR		0x00
+#define AXI_DMA_REG_MM2S_DMASR		0x04
+#define AXI_DMA_REG_MM2S_CURDESC	0x08
+#define AXI_DMA_REG_MM2S_TAILDESC	0x10
+
+#define AXI_DMA_DESC_NXTDESC		0x00
+#define AXI_DMA_DESC_BUFFER			0x08
+#define AXI_DMA_DESC_CONTROL		0x18
+#define AXI_DMA_DESC_STATUS			0x1c
+
+#define CF_CLKGEN_REF_RATE			200000000	// reference clock of the pixel clock MMCM
+
 #define AXI_CLKGEN_REG_UPDATE_ENABLE	0x04
 #define AXI_CLKGEN_REG_CLK_OUT1			0x08
 #define AXI_CLKGEN_REG_CLK_OUT2			0x0c
@@ -90,6 +108,48 @@
 #define AXI_CLKGEN_REG_LOCK3			0x24
 #define AXI_CLKGEN_REG_FILTER1			0x28
 #define AXI_CLKGEN_REG_FILTER2			0x2c
+#define AXI_CLKGEN_REG_STATUS			0x7c
+
+#define AXI_CLKGEN_STATUS_LOCKED		(1 << 0)
+#define CLKGEN_LOCK_TIMEOUT				1000000	// status polls before giving up on the MMCM
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+typedef enum
+{
+	VIDEO_FMT_ARGB8888,
+	VIDEO_FMT_RGB888,
+	VIDEO_FMT_RGB565,
+	VIDEO_FMT_YCBCR422
+} VIDEO_FORMAT;
+
+typedef enum
+{
+	VIDEO_PATTERN_COLOR_BARS,
+	VIDEO_PATTERN_GRADIENT,
+	VIDEO_PATTERN_GRID,
+	VIDEO_PATTERN_SOLID
+} VIDEO_PATTERN;
+
+typedef struct
+{
+	unsigned char	vic;		// CEA-861 video identification code, 0 for VESA modes
+	unsigned long	pixelClk;	// pixel clock in Hz
+	unsigned short	hActive;
+	unsigned short	vActive;
+	unsigned short	hBlanking;
+	unsigned short	vBlanking;
+	unsigned short	hWidth;
+	unsigned short	vWidth;
+	unsigned short	hOffset;
+	unsigned short	vOffset;
+	unsigned char	clkD;		// MMCM input divider
+	unsigned char	clkM;		// MMCM feedback multiplier
+	unsigned char	clkDout;	// MMCM output divider
+	unsigned long	clkFilter;	// MMCM filter word
+	unsigned long	clkLock;	// MMCM lock word
+} VIDEO_MODE;
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
@@ -104,8 +164,43 @@ void InitHdmiVideoPcore(unsigned short hActive,
 						unsigned short vOffset);
 void InitHdmiAudioPcore(void);
 void AudioClick(void);
+u32 AudioWrite(const u32 *samples, u32 count);
+void AudioFlush(void);
+u32 AudioGetFree(void);
+u32 AudioGetUnderruns(void);
+u32 VideoFrameAddress(u32 frame);
+u32 VideoGetBackFrame(void);
+void VideoFlip(u32 frame);
+void VideoFlipLines(u32 frame, u32 y, u32 height);
+int VideoWaitFlip(void);
+void VideoSetFormat(VIDEO_FORMAT format);
+VIDEO_FORMAT VideoGetFormat(void);
+u32 VideoBytesPerPixel(VIDEO_FORMAT format);
+u32 VideoGetLineStride(void);
+u32 VideoGetFrameSize(void);
+u32 VideoConvertPixels(u32 dst, const u32 *src, u32 count);
+void VideoPutPixel(u32 frame, u32 x, u32 y, u32 rgb);
+void VideoFillRect(u32 frame, u32 x, u32 y, u32 width, u32 height, u32 rgb);
+int VideoDrawPattern(u32 frame, VIDEO_PATTERN pattern, u32 rgb);
+void VideoFlushRect(u32 frame, u32 x, u32 y, u32 width, u32 height);
+void VideoUpdateRect(u32 frame, u32 x, u32 y, u32 width, u32 height,
+					 const u32 *pixels);
+void CLKGEN_CalcParams(unsigned long fin,
+					   unsigned long fout,
+					   unsigned long *best_d,
+					   unsigned long *best_m,
+					   unsigned long *best_dout);
 int CLKGEN_SetRate(unsigned long rate,
 				   unsigned long parent_rate);
 unsigned long CLKGEN_GetRate(unsigned long parent_rate);
+int CLKGEN_WaitLock(void);
+unsigned long CLKGEN_GetLockTime(void);
+const VIDEO_MODE *VideoFindMode(unsigned char vic);
+const VIDEO_MODE *VideoMatchMode(unsigned short hActive,
+								 unsigned short vActive,
+								 unsigned short hBlanking,
+								 unsigned short vBlanking,
+								 unsigned long pixelClk);
+int VideoSetMode(const VIDEO_MODE *mode);
 
 #endif /* CF_HDMI_H_ */
@@ -0,0 +1,132 @@
+/**************************************************************************//**
+*   @file   log.h
+*   @brief  Buffered UART logging header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+
+#ifndef __LOG_H__
+#define __LOG_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Message levels */
+#define LOG_LEVEL_NONE		0
+#define LOG_LEVEL_ERROR		1
+#define LOG_LEVEL_WARN		2
+#define LOG_LEVEL_INFO		3
+#define LOG_LEVEL_DEBUG		4
+
+/* Messages above LOG_LEVEL are compiled out */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL			LOG_LEVEL_INFO
+#endif
+
+/* Size of the message storage in bytes, a power of 2. It is split in
+   LOG_BUFFER_SIZE / LOG_MAX_MSG message slots. */
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE		4096
+#endif
+
+/* Longest text message, longer messages are truncated */
+#define LOG_MAX_MSG			128
+
+/* First byte of a binary event record. The text messages are ASCII, so the
+   records can be told apart from the text in the UART stream. A record is
+   LOG_EVENT_MARKER, the event id, then the time in us and the argument,
+   least significant byte first. */
+#define LOG_EVENT_MARKER	0xFF
+#define LOG_EVENT_SIZE		10
+
+/*****************************************************************************/
+/************************ Macros Definitions *********************************/
+/*****************************************************************************/
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...)		LOG_Printf(__VA_ARGS__)
+#else
+#define LOG_ERROR(...)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...)		LOG_Printf(__VA_ARGS__)
+#else
+#define LOG_WARN(...)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...)		LOG_Printf(__VA_ARGS__)
+#else
+#define LOG_INFO(...)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)		LOG_Printf(__VA_ARGS__)
+#define LOG_EVENT(id, arg)	LOG_Event(id, arg)
+#else
+#define LOG_DEBUG(...)
+#define LOG_EVENT(id, arg)
+#endif
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+/*! Initializes the UART output and empties the ring buffer */
+void LOG_Init(void);
+/*! Formats a message into the ring buffer */
+void LOG_Printf(const char* fmt, ...);
+/*! Writes an event into the ring buffer, as text or as a binary record */
+void LOG_Event(uint8_t id, uint32_t arg);
+/*! Selects the binary (1) or text (0) format of the events */
+void LOG_SetBinary(uint8_t enable);
+/*! Moves the buffered bytes into the UART FIFO without waiting */
+void LOG_Poll(void);
+/*! Waits until all the buffered bytes are sent */
+void LOG_Flush(void);
+/*! Drains the ring buffer from the UART TX interrupt */
+void LOG_IrqEnable(void);
+/*! UART TX empty interrupt handler */
+void LOG_Isr(void* ref);
+/*! Gets the number of messages dropped because the buffer was full */
+uint32_t LOG_GetDropped(void);
+
+#endif /* __LOG_H__ */
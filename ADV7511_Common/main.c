@@ -48,6 +48,16 @@
 #include "cf_hdmi.h"
 #include "atv_platform.h"
 #include "transmitter.h"
+#include "boot_profile.h"
+#include "scheduler.h"
+#include "bench.h"
+#include "spectrum.h"
+#include "log.h"
+#ifdef HDMI_BOARD_ZYNQ
+#include "xscugic_hw.h"
+#else
+#include "xintc_l.h"
+#endif
 #include "xil_exception.h"
 
 extern void delay_ms(u32 ms_count);
@@ -55,10 +65,17 @@ extern void delay_ms(u32 ms_count);
 /******************************************************************************/
 /************************** Macros Definitions ********************************/
 /******************************************************************************/
-#define HDMI_CALL_INTERVAL_MS	10			/* Interval between two         */
-											/* iterations of the main loop  */
 #define DBG_MSG                 xil_printf
 
+/* Scheduler events and polling period of the transmitter service */
+#define APP_EVENT_TX_IRQ        0
+#define APP_TX_POLL_US          10000
+
+/* Spectrum demo, built only if SPECTRUM_EN is defined: frame period and
+   number of bins of the synthetic spectrum */
+#define APP_SPECTRUM_PERIOD_US  33333
+#define APP_SPECTRUM_BINS       1024
+
 /******************************************************************************/
 /************************ Variables Definitions *******************************/
 /******************************************************************************/
@@ -67,6 +84,13 @@ static UCHAR    MinorRev;      /* Usually used for code-drops */
 static UCHAR    RcRev;         /* Release Candidate Number */
 static BOOL     DriverEnable;
 static BOOL     LastEnable;
+#ifdef SPECTRUM_EN
+/* Spectrum area of the 1080p frame, levels from 0 dB down to -120 dB */
+static const SPECTRUM_CONFIG AppSpectrum = {160, 140, 1600, 400, 400, 0, 12000};
+static s32      SpectrumBins[APP_SPECTRUM_BINS];
+static u32      SpectrumNoise = 1;
+static u32      SpectrumTone = 0;
+#endif
 
 /***************************************************************************//**
  * @brief Enables the driver.
@@ -111,6 +135,128 @@ static void APP_PrintRevisions (void)
 	DBG_MSG("********************************************************************\r\n\n\r");
 }
 
+#ifdef HDMI_TX_INT_ID
+#ifdef HDMI_BOARD_ZYNQ
+/***************************************************************************//**
+ * @brief Masks or unmasks the ADV7511 interrupt line.
+ *
+ * @return None.
+*******************************************************************************/
+static void APP_TxIrqEnable(BOOL Enable)
+{
+	if (Enable)
+	{
+		XScuGic_EnableIntr(XPAR_SCUGIC_0_DIST_BASEADDR, HDMI_TX_INT_ID);
+	}
+	else
+	{
+		XScuGic_DisableIntr(XPAR_SCUGIC_0_DIST_BASEADDR, HDMI_TX_INT_ID);
+	}
+}
+#else
+/***************************************************************************//**
+ * @brief Masks or unmasks the ADV7511 interrupt line. The other lines of the
+ *        interrupt controller are left as they are.
+ *
+ * @return None.
+*******************************************************************************/
+static void APP_TxIrqEnable(BOOL Enable)
+{
+	u32 ier;
+
+	ier = Xil_In32(XPAR_AXI_INTC_0_BASEADDR + XIN_IER_OFFSET);
+	if (Enable)
+	{
+		ier |= (1 << HDMI_TX_INT_ID);
+	}
+	else
+	{
+		ier &= ~(1 << HDMI_TX_INT_ID);
+	}
+	Xil_Out32((XPAR_AXI_INTC_0_BASEADDR + XIN_IER_OFFSET), ier);
+}
+#endif
+
+/***************************************************************************//**
+ * @brief ADV7511 interrupt handler. The line stays masked until the
+ *        transmitter service has cleared the interrupt over I2C.
+ *
+ * @return None.
+*******************************************************************************/
+static void APP_TxIrqHandler(void *Ref)
+{
+	APP_TxIrqEnable(FALSE);
+	ADIAPI_TransmitterIrqHandler(Ref);
+	SCHED_PostEvent(APP_EVENT_TX_IRQ);
+}
+#endif
+
+/***************************************************************************//**
+ * @brief Services the transmitter. The task is woken up by the transmitter
+ *        interrupt and runs every APP_TX_POLL_US for the housekeeping.
+ *
+ * @param Events - the scheduler events which woke up the task
+ *
+ * @return None.
+*******************************************************************************/
+static void APP_TxTask(uint32_t Events)
+{
+	if (ADIAPI_TransmitterEventPending() && APP_DriverEnabled())
+	{
+		ADIAPI_TransmitterMain();
+#ifdef HDMI_TX_INT_ID
+		APP_TxIrqEnable(TRUE);
+#endif
+	}
+}
+
+/***************************************************************************//**
+ * @brief Sends the buffered log messages. Background task, run on every pass
+ *        of the scheduler while the UART TX interrupt is not used.
+ *
+ * @param Events - Unused.
+ *
+ * @return None.
+*******************************************************************************/
+static void APP_LogTask(uint32_t Events)
+{
+	LOG_Poll();
+}
+
+#ifdef SPECTRUM_EN
+/***************************************************************************//**
+ * @brief Renders a synthetic spectrum, a tone sweeping over a noise floor, as
+ *        the HDMI boards have no converter to analyze. A board with an ADC
+ *        pushes the spectra of its analysis engine instead.
+ *
+ * @param Events - the scheduler events which woke up the task
+ *
+ * @return None.
+*******************************************************************************/
+static void APP_SpectrumTask(uint32_t Events)
+{
+	u32 n;
+	s32 d;
+
+	for (n = 0; n < APP_SPECTRUM_BINS; n++)
+	{
+		/* Galois LFSR, -90 dB to -100 dB of noise */
+		SpectrumNoise = (SpectrumNoise >> 1) ^
+						((0 - (SpectrumNoise & 1)) & 0xd0000001);
+		SpectrumBins[n] = -9000 - (s32)(SpectrumNoise % 1000);
+		d = (s32)n - (s32)SpectrumTone;
+		d = (d < 0) ? -d : d;
+		if (d < 8)
+		{
+			SpectrumBins[n] = -1000 - (d * d * 100);
+		}
+	}
+	SpectrumTone = (SpectrumTone + 1) % APP_SPECTRUM_BINS;
+	SpectrumPush(SpectrumBins, APP_SPECTRUM_BINS);
+	SpectrumRender();
+}
+#endif
+
 /***************************************************************************//**
  * @brief Main function.
  *
@@ -118,8 +264,6 @@ static void APP_PrintRevisions (void)
 *******************************************************************************/
 int main()
 {
-	UINT32 StartCount;
-
 	MajorRev     = 1;
 	MinorRev     = 1;
 	RcRev        = 1;
@@ -128,45 +272,74 @@ int main()
 
 	Xil_ICacheEnable();
 	Xil_DCacheEnable();
+	LOG_Init();
 
-	HAL_PlatformInit(XPAR_AXI_IIC_0_BASEADDR,	/* Perform any required platform init */
+#ifdef HDMI_BOARD_ZYNQ
+	PROFILE_PHASE("Platform init");
+	HAL_PlatformInit(HAL_IIC_BASEADDR,			/* Perform any required platform init */
 					 XPAR_SCUTIMER_DEVICE_ID,	/* including hardware reset to HDMI devices */
 					 XPAR_SCUGIC_SINGLE_DEVICE_ID,
 					 XPAR_SCUTIMER_INTR);
+#else
+	PROFILE_PHASE("Platform init");
+	HAL_PlatformInit(HAL_IIC_BASEADDR,			/* Perform any required platform init */
+					 XPAR_AXI_TIMER_0_BASEADDR,	/* including hardware reset to HDMI devices */
+					 XPAR_AXI_TIMER_0_INTERRUPT_MASK,
+					 XPAR_AXI_INTC_0_BASEADDR);
+#endif
 
 	Xil_ExceptionEnable();
 
+	/* Throughput benchmarks, compiled out without BENCH_EN. */
+	BENCH_Run();
+
 	/* Set the default values for 1080P 60Hz */
-	CLKGEN_SetRate(148500000, 200000000);
-	InitHdmiVideoPcore(1920,
-					   1080,
-					   280,
-					   45,
-					   44,
-					   5,
-					   88,
-					   4);
+	VideoSetMode(VideoFindMode(16));
+	PROFILE_PHASE("HDMI audio core");
 	InitHdmiAudioPcore();
+	PROFILE_PHASE_END();
 
 	APP_PrintRevisions();       /* Display S/W and H/W revisions */
 
+	PROFILE_PHASE("Transmitter init");
 	ADIAPI_TransmitterInit();   /* Initialize ADI repeater software and h/w */
 
+	PROFILE_PHASE("Transmitter power up");
 	ADIAPI_TransmitterSetPowerMode(REP_POWER_UP);
+	PROFILE_PHASE_END();
+
+#ifdef HDMI_TX_INT_ID
+#ifdef HDMI_BOARD_ZYNQ
+	XScuGic_RegisterHandler(XPAR_SCUGIC_0_CPU_BASEADDR,
+							HDMI_TX_INT_ID,
+							APP_TxIrqHandler,
+							NULL);
+#else
+	XIntc_RegisterHandler(XPAR_AXI_INTC_0_BASEADDR,
+						  HDMI_TX_INT_ID,
+						  APP_TxIrqHandler,
+						  NULL);
+#endif
+	APP_TxIrqEnable(TRUE);
+	ADIAPI_TransmitterEnableIrq(TRUE);
+#endif
 
-	StartCount = HAL_GetCurrentMsCount();
+	/* Startup time of each stage, compiled out without BUS_PROFILE_EN. */
+	LOG_Flush();
+	PROFILE_PhaseDump();
 
-	while(1)
+	/* The transmitter is serviced on its events only, the rest of the
+	   time is left to the other tasks. */
+	SCHED_AddTask("hdmi tx", APP_TxTask, APP_TX_POLL_US,
+				  SCHED_EVENT(APP_EVENT_TX_IRQ));
+	SCHED_AddTask("log", APP_LogTask, 0, 0);
+#ifdef SPECTRUM_EN
+	if (SpectrumInit(&AppSpectrum) == 0)
 	{
-		if (ATV_GetElapsedMs (StartCount, NULL) >= HDMI_CALL_INTERVAL_MS)
-		{
-			StartCount = HAL_GetCurrentMsCount();
-			if (APP_DriverEnabled())
-			{
-				ADIAPI_TransmitterMain();
-			}
-		}
+		SCHED_AddTask("spectrum", APP_SpectrumTask, APP_SPECTRUM_PERIOD_US, 0);
 	}
+#endif
+	SCHED_Run();
 
 	Xil_DCacheDisable();
 	Xil_ICacheDisable();
@@ -0,0 +1,155 @@
+/**************************************************************************//**
+*   @file   ring.c
+*   @brief  Lock-free single producer, single consumer descriptor ring implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "ring.h"
+
+/**************************************************************************//**
+* @brief Initializes an empty ring. The producer and the consumer may run in
+*        different contexts, for example an interrupt handler and the main
+*        loop, or on different CPUs, without disabling the interrupts; each
+*        side must have a single caller.
+*
+* @param pRing - Ring to initialize.
+* @param pDesc - Storage of the descriptors.
+* @param size - Number of descriptors of the storage, a power of 2.
+*
+* @return Returns 0 in case of success or -1 if size is not a power of 2.
+******************************************************************************/
+int32_t RING_Init(stRing* pRing, stRingDesc* pDesc, uint32_t size)
+{
+	if((size == 0) || (size & (size - 1)))
+		return -1;
+
+	pRing->head = 0;
+	pRing->tail = 0;
+	pRing->mask = size - 1;
+	pRing->pDesc = pDesc;
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Adds a descriptor. The descriptor is written before the head which
+*        publishes it.
+*
+* @param pRing - Ring.
+* @param pDesc - Descriptor to add.
+*
+* @return Returns 0 in case of success or -1 if the ring is full.
+******************************************************************************/
+int32_t RING_Push(stRing* pRing, const stRingDesc* pDesc)
+{
+	uint32_t head = pRing->head;
+
+	if((head - pRing->tail) > pRing->mask)
+		return -1;
+
+	pRing->pDesc[head & pRing->mask] = *pDesc;
+	RING_BARRIER();
+	pRing->head = head + 1;
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Removes the oldest descriptor. The descriptor is read before the tail
+*        which releases its slot.
+*
+* @param pRing - Ring.
+* @param pDesc - Removed descriptor.
+*
+* @return Returns 0 in case of success or -1 if the ring is empty.
+******************************************************************************/
+int32_t RING_Pop(stRing* pRing, stRingDesc* pDesc)
+{
+	uint32_t tail = pRing->tail;
+
+	if(tail == pRing->head)
+		return -1;
+
+	RING_BARRIER();
+	*pDesc = pRing->pDesc[tail & pRing->mask];
+	RING_BARRIER();
+	pRing->tail = tail + 1;
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Reads the oldest descriptor without removing it, for a consumer which
+*        releases the slot only once it is done with the buffer.
+*
+* @param pRing - Ring.
+* @param pDesc - Oldest descriptor.
+*
+* @return Returns 0 in case of success or -1 if the ring is empty.
+******************************************************************************/
+int32_t RING_Peek(const stRing* pRing, stRingDesc* pDesc)
+{
+	uint32_t tail = pRing->tail;
+
+	if(tail == pRing->head)
+		return -1;
+
+	RING_BARRIER();
+	*pDesc = pRing->pDesc[tail & pRing->mask];
+
+	return 0;
+}
+
+/**************************************************************************//**
+* @brief Gets the number of descriptors in the ring. The value may be out of
+*        date as soon as it is read if the other side is running.
+*
+* @param pRing - Ring.
+*
+* @return Number of descriptors.
+******************************************************************************/
+uint32_t RING_Count(const stRing* pRing)
+{
+	return pRing->head - pRing->tail;
+}
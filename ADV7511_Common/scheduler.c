@@ -0,0 +1,314 @@
+/**************************************************************************//**
+*   @file   scheduler.c
+*   @brief  Run-to-completion task scheduler implementation.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include "xparameters.h"
+#include "atv_platform.h"
+#include "scheduler.h"
+
+extern void xil_printf(const char *ctrl1, ...);
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Time base of the scheduler in us, from the millisecond count of the
+   platform timer */
+#define SCHED_GetTimeUs()	((uint64_t)HAL_GetCurrentMsCount() * 1000)
+#define SCHED_DelayUs(us)	HAL_DelayMs((us) / 1000)
+
+/* Length of a pass when the time base reads 0, the passes are then paced
+   with a delay and counted as the elapsed time */
+#ifndef SCHED_NO_TIMER_PASS_US
+#define SCHED_NO_TIMER_PASS_US	1000
+#endif
+
+/* Build with SCHED_IDLE_WFI to sleep until the next interrupt when a pass
+   runs no task. Only usable on the Cortex-A9 and with a periodic interrupt
+   running, otherwise the periodic tasks are not woken up. */
+#if defined(SCHED_IDLE_WFI) && defined(_XPARAMETERS_PS_H_)
+#define SCHED_IDLE()		__asm__ __volatile__("wfi")
+#else
+#define SCHED_IDLE()
+#endif
+
+/*****************************************************************************/
+/************************ Variables Definitions ******************************/
+/*****************************************************************************/
+typedef struct _stSchedTask
+{
+	const char*		name;		/*!< Name of the task */
+	SCHED_TaskFunc	func;		/*!< Task function */
+	uint32_t		periodUs;	/*!< Period in us, 0 if not periodic */
+	uint32_t		eventMask;	/*!< Events which wake up the task */
+	uint64_t		nextUs;		/*!< Time of the next periodic run */
+	uint32_t		runs;		/*!< Number of runs */
+	uint64_t		cpuUs;		/*!< Accumulated run time in us */
+	uint32_t		maxUs;		/*!< Longest run in us */
+}stSchedTask;
+
+static stSchedTask schedTasks[SCHED_MAX_TASKS];
+static uint32_t schedTaskCnt = 0;
+static uint32_t schedStop = 0;
+static uint64_t schedIdleUs = 0;
+static uint64_t schedStartUs = 0;
+/* Time base used while the timer reads 0 */
+static uint64_t schedSoftUs = 0;
+/* Each event has a counter incremented by the poster and a copy of it kept
+   by the scheduler, so posting from an interrupt needs no locking. */
+static volatile uint32_t schedPosted[SCHED_MAX_EVENTS];
+static uint32_t schedTaken[SCHED_MAX_EVENTS];
+
+/**************************************************************************//**
+* @brief Reads the time base of the scheduler. Without a hardware timer the
+*        time is the number of passes times SCHED_NO_TIMER_PASS_US.
+*
+* @return Time in us.
+******************************************************************************/
+static uint64_t SCHED_Now(void)
+{
+	uint64_t now;
+
+	now = SCHED_GetTimeUs();
+
+	return now ? now : schedSoftUs;
+}
+
+/**************************************************************************//**
+* @brief Registers a task. A task with a period runs every periodUs, a task
+*        with an event mask runs when one of its events is posted, and a
+*        task without either runs on every pass of the scheduler. A task may
+*        have both a period and events. The tasks run to completion in the
+*        order in which they were registered, they must not block.
+*
+* @param name - Name of the task, used by SCHED_Dump.
+* @param func - Task function.
+* @param periodUs - Period in us, 0 if the task is not periodic.
+* @param eventMask - Events which wake up the task, built with SCHED_EVENT.
+*
+* @return Returns the task number or -1 if the task table is full.
+******************************************************************************/
+int32_t SCHED_AddTask(const char* name, SCHED_TaskFunc func,
+					  uint32_t periodUs, uint32_t eventMask)
+{
+	stSchedTask* pTask;
+
+	if((schedTaskCnt == SCHED_MAX_TASKS) || (func == 0))
+	{
+		return -1;
+	}
+	pTask = &schedTasks[schedTaskCnt];
+	pTask->name      = name;
+	pTask->func      = func;
+	pTask->periodUs  = periodUs;
+	pTask->eventMask = eventMask;
+	pTask->nextUs    = SCHED_Now() + periodUs;
+	pTask->runs      = 0;
+	pTask->cpuUs     = 0;
+	pTask->maxUs     = 0;
+
+	return schedTaskCnt++;
+}
+
+/**************************************************************************//**
+* @brief Posts an event. The tasks waiting on it run on the next pass of the
+*        scheduler; an event posted several times before that is seen once.
+*
+* @param event - Event number, lower than SCHED_MAX_EVENTS.
+*
+* @return None.
+******************************************************************************/
+void SCHED_PostEvent(uint32_t event)
+{
+	if(event < SCHED_MAX_EVENTS)
+	{
+		schedPosted[event]++;
+	}
+}
+
+/**************************************************************************//**
+* @brief Collects the events posted since the previous call.
+*
+* @return Mask of the posted events.
+******************************************************************************/
+static uint32_t SCHED_TakeEvents(void)
+{
+	uint32_t events = 0;
+	uint32_t posted;
+	uint32_t i;
+
+	for(i = 0; i < SCHED_MAX_EVENTS; i++)
+	{
+		posted = schedPosted[i];
+		if(posted != schedTaken[i])
+		{
+			schedTaken[i] = posted;
+			events |= SCHED_EVENT(i);
+		}
+	}
+
+	return events;
+}
+
+/**************************************************************************//**
+* @brief Runs once every task which is due: the periodic tasks whose period
+*        elapsed, the tasks with a posted event and the background tasks.
+*        The time base has a 1 ms resolution, the run times of short
+*        tasks are accumulated as 0. While the time base reads 0 each pass
+*        is paced with a SCHED_NO_TIMER_PASS_US delay.
+*
+* @return Number of tasks which were run.
+******************************************************************************/
+uint32_t SCHED_RunOnce(void)
+{
+	stSchedTask* pTask;
+	uint32_t events;
+	uint32_t woken;
+	uint32_t due;
+	uint32_t ran = 0;
+	uint64_t now;
+	uint64_t end;
+	uint32_t i;
+
+	events = SCHED_TakeEvents();
+	now = SCHED_Now();
+	if(!schedStartUs)
+	{
+		schedStartUs = now;
+	}
+	for(i = 0; i < schedTaskCnt; i++)
+	{
+		pTask = &schedTasks[i];
+		woken = events & pTask->eventMask;
+		due = pTask->periodUs && (now >= pTask->nextUs);
+		if(!woken && !due && (pTask->eventMask || pTask->periodUs))
+		{
+			continue;
+		}
+		/* A run woken by an event keeps the periodic schedule */
+		if(due)
+		{
+			/* Late runs are not caught up */
+			pTask->nextUs += pTask->periodUs;
+			if(pTask->nextUs <= now)
+			{
+				pTask->nextUs = now + pTask->periodUs;
+			}
+		}
+		pTask->func(woken);
+		end = SCHED_Now();
+		pTask->runs++;
+		pTask->cpuUs += end - now;
+		if((uint32_t)(end - now) > pTask->maxUs)
+		{
+			pTask->maxUs = (uint32_t)(end - now);
+		}
+		now = end;
+		ran++;
+	}
+	if(!ran)
+	{
+		SCHED_IDLE();
+		schedIdleUs += SCHED_Now() - now;
+	}
+	if(SCHED_GetTimeUs() == 0)
+	{
+		SCHED_DelayUs(SCHED_NO_TIMER_PASS_US);
+		schedSoftUs += SCHED_NO_TIMER_PASS_US;
+	}
+
+	return ran;
+}
+
+/**************************************************************************//**
+* @brief Runs the tasks until SCHED_Stop is called by one of them.
+*
+* @return None.
+******************************************************************************/
+void SCHED_Run(void)
+{
+	schedStop = 0;
+	while(!schedStop)
+	{
+		SCHED_RunOnce();
+	}
+}
+
+/**************************************************************************//**
+* @brief Makes SCHED_Run return once the running pass is done.
+*
+* @return None.
+******************************************************************************/
+void SCHED_Stop(void)
+{
+	schedStop = 1;
+}
+
+/**************************************************************************//**
+* @brief Prints the number of runs and the CPU time of each task over UART.
+*        The time not spent in tasks is reported as idle.
+*
+* @return None.
+******************************************************************************/
+void SCHED_Dump(void)
+{
+	uint64_t totalUs = SCHED_Now() - schedStartUs;
+	uint64_t busyUs = 0;
+	uint32_t i;
+
+	xil_printf("\n\rTask                  Runs     Time[us]    Max[us]  Percent\n\r");
+	for(i = 0; i < schedTaskCnt; i++)
+	{
+		xil_printf("%-16s %9d %12d %10d %8d\n\r",
+				   schedTasks[i].name,
+				   schedTasks[i].runs,
+				   (uint32_t)schedTasks[i].cpuUs,
+				   schedTasks[i].maxUs,
+				   totalUs ? (uint32_t)(schedTasks[i].cpuUs * 100 / totalUs) : 0);
+		busyUs += schedTasks[i].cpuUs;
+	}
+	xil_printf("Idle                       %12d\n\r", (uint32_t)schedIdleUs);
+	xil_printf("Overhead                   %12d\n\r",
+			   (uint32_t)(totalUs - busyUs - schedIdleUs));
+}
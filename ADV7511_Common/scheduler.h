@@ -0,0 +1,88 @@
+/**************************************************************************//**
+*   @file   scheduler.h
+*   @brief  Run-to-completion task scheduler header file.
+*   @author acozma (andrei.cozma@analog.com)
+*
+*******************************************************************************
+* Copyright 2013(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*******************************************************************************
+*   SVN Revision: $WCREV$
+******************************************************************************/
+
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+/*****************************************************************************/
+/***************************** Include Files *********************************/
+/*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************/
+/************************ Constants Definitions ******************************/
+/*****************************************************************************/
+/* Number of tasks and events that can be registered */
+#define SCHED_MAX_TASKS		8
+#define SCHED_MAX_EVENTS	8
+
+/*****************************************************************************/
+/************************ Macros Definitions *********************************/
+/*****************************************************************************/
+/** Event mask of an event number, to be passed to SCHED_AddTask */
+#define SCHED_EVENT(n)		(1 << (n))
+
+/*****************************************************************************/
+/************************ Types Definitions **********************************/
+/*****************************************************************************/
+/** Task function, called with the mask of the events which woke it up */
+typedef void (*SCHED_TaskFunc)(uint32_t events);
+
+/*****************************************************************************/
+/************************ Functions Declarations *****************************/
+/*****************************************************************************/
+/*! Registers a periodic, event driven or background task */
+int32_t SCHED_AddTask(const char* name, SCHED_TaskFunc func,
+					  uint32_t periodUs, uint32_t eventMask);
+/*! Posts an event, can be called from an interrupt handler */
+void SCHED_PostEvent(uint32_t event);
+/*! Runs once every task which is due */
+uint32_t SCHED_RunOnce(void);
+/*! Runs the tasks until SCHED_Stop is called */
+void SCHED_Run(void);
+/*! Makes SCHED_Run return after the running pass */
+void SCHED_Stop(void);
+/*! Prints the CPU time used by each task over UART */
+void SCHED_Dump(void);
+
+#endif /* __SCHEDULER_H__ */
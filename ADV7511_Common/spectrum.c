@@ -0,0 +1,496 @@
+/***************************************************************************//**
+ *   @file   spectrum.c
+ *   @brief  Spectrum and waterfall renderer of the HDMI frame stores.
+********************************************************************************
+ * Copyright 2013(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+********************************************************************************
+ *   SVN Revision: $WCREV$
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <string.h>
+#include "xil_types.h"
+#include "xil_cache.h"
+#include "cf_hdmi.h"
+#include "spectrum.h"
+
+#ifdef SPECTRUM_EN
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+/******************************************************************************/
+/************************** Macros Definitions ********************************/
+/******************************************************************************/
+/* Alignment of the waterfall lines in the history */
+#define SPECTRUM_ROW_ALIGN			64
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+/* What a frame store shows, so that only the changes are drawn in it */
+typedef struct
+{
+	u32	seq;							// spectrum_seq when it was rendered
+	u32	drawn;							// the trace is drawn
+	u16	top[SPECTRUM_MAX_WIDTH];		// first line of the trace in a column
+	u16	bottom[SPECTRUM_MAX_WIDTH];		// last line of the trace in a column
+} SPECTRUM_STORE;
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+static SPECTRUM_CONFIG spectrum_config;
+/* Color of each level step, from the bottom to the top of the range */
+static u32 spectrum_cmap[256];
+/* Gradient of the color map: index and color of each stop */
+static const u32 spectrum_cmap_stops[][2] =
+{
+	{  0, 0x000000}, { 64, 0x0000ff}, {128, 0x00ffff},
+	{176, 0xffff00}, {224, 0xff0000}, {255, 0xffffff}
+};
+/* Fixed point scales, 16 fractional bits, of the levels to the trace lines
+   and to the color map */
+static s32 spectrum_y_scale;
+static s32 spectrum_index_scale;
+/* Levels of the columns, then their trace line and color map index */
+static s32 spectrum_level[SPECTRUM_MAX_WIDTH];
+static u16 spectrum_trace[SPECTRUM_MAX_WIDTH];
+static u32 spectrum_line[SPECTRUM_MAX_WIDTH];
+/* 1 for the lines of the trace which hold a grid line */
+static u8 spectrum_grid[SPECTRUM_MAX_LINES];
+/* Waterfall history: distance between its lines, newest line and number of
+   lines */
+static u32 spectrum_row_bytes;
+static u32 spectrum_head;
+static u32 spectrum_rows;
+/* Number of spectra pushed */
+static u32 spectrum_seq;
+static SPECTRUM_STORE spectrum_store[VIDEO_FRAMES];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/***************************************************************************//**
+ * @brief Builds the color map by interpolating between the gradient stops.
+ *
+ * @return None.
+*******************************************************************************/
+static void SpectrumBuildColorMap(void)
+{
+	u32 stop;
+	u32 n;
+	u32 span;
+	u32 pos;
+	u32 c0;
+	u32 c1;
+	u32 rgb;
+	u32 shift;
+	u32 a;
+	u32 b;
+
+	for (stop = 0; (stop + 1) < (sizeof(spectrum_cmap_stops) /
+								 sizeof(spectrum_cmap_stops[0])); stop++)
+	{
+		c0 = spectrum_cmap_stops[stop][1];
+		c1 = spectrum_cmap_stops[stop + 1][1];
+		span = spectrum_cmap_stops[stop + 1][0] - spectrum_cmap_stops[stop][0];
+		for (n = spectrum_cmap_stops[stop][0];
+			 n <= spectrum_cmap_stops[stop + 1][0]; n++)
+		{
+			pos = n - spectrum_cmap_stops[stop][0];
+			rgb = 0;
+			for (shift = 0; shift < 24; shift += 8)
+			{
+				a = (c0 >> shift) & 0xff;
+				b = (c1 >> shift) & 0xff;
+				rgb |= (((a * (span - pos)) + (b * pos) + (span / 2)) / span) <<
+					   shift;
+			}
+			spectrum_cmap[n] = rgb;
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @brief Converts a level to a line of the trace, clamped to the trace.
+ *
+ * @param level - the level
+ *
+ * @return Returns the line, 0 at the top of the trace.
+*******************************************************************************/
+static u32 SpectrumLevelToLine(s32 level)
+{
+	s32 d = spectrum_config.refLevel - level;
+
+	if (d < 0)
+	{
+		d = 0;
+	}
+	if (d > spectrum_config.range)
+	{
+		d = spectrum_config.range;
+	}
+
+	return (d * spectrum_y_scale) >> 16;
+}
+
+/***************************************************************************//**
+ * @brief Converts the levels of the columns to their trace lines and their
+ *        waterfall colors. The lines and the color map indexes are computed
+ *        four columns at a time with NEON; the color map itself is looked up
+ *        one column at a time, 256 entries being out of reach of the NEON
+ *        table instructions.
+ *
+ * @return None.
+*******************************************************************************/
+static void SpectrumMapLevels(void)
+{
+	s32 top = spectrum_config.refLevel;
+	s32 range = spectrum_config.range;
+	u32 width = spectrum_config.width;
+	u16 index[SPECTRUM_MAX_WIDTH];
+	u32 col = 0;
+	s32 d;
+#ifdef __ARM_NEON__
+	const int32x4_t vtop = vdupq_n_s32(top);
+	const int32x4_t vzero = vdupq_n_s32(0);
+	const int32x4_t vrange = vdupq_n_s32(range);
+	const int32x4_t vyscale = vdupq_n_s32(spectrum_y_scale);
+	const int32x4_t viscale = vdupq_n_s32(spectrum_index_scale);
+	int32x4_t vd;
+
+	for (; (col + 4) <= width; col += 4)
+	{
+		/* Distance to the top of the range, clamped to the range */
+		vd = vsubq_s32(vtop, vld1q_s32(spectrum_level + col));
+		vd = vminq_s32(vmaxq_s32(vd, vzero), vrange);
+		vst1_u16(spectrum_trace + col,
+				 vmovn_u32(vreinterpretq_u32_s32(
+					 vshrq_n_s32(vmulq_s32(vd, vyscale), 16))));
+		vst1_u16(index + col,
+				 vmovn_u32(vreinterpretq_u32_s32(
+					 vshrq_n_s32(vmulq_s32(vsubq_s32(vrange, vd), viscale),
+								 16))));
+	}
+#endif
+	for (; col < width; col++)
+	{
+		d = top - spectrum_level[col];
+		d = (d < 0) ? 0 : ((d > range) ? range : d);
+		spectrum_trace[col] = (d * spectrum_y_scale) >> 16;
+		index[col] = ((range - d) * spectrum_index_scale) >> 16;
+	}
+	for (col = 0; col < width; col++)
+	{
+		spectrum_line[col] = spectrum_cmap[index[col]];
+	}
+}
+
+/***************************************************************************//**
+ * @brief Gets the address of a line of the waterfall history.
+ *
+ * @param row - the line of the history
+ *
+ * @return Returns the address of the line.
+*******************************************************************************/
+static u32 SpectrumHistoryRow(u32 row)
+{
+	return SPECTRUM_HISTORY_BASEADDR + (row * spectrum_row_bytes);
+}
+
+/***************************************************************************//**
+ * @brief Copies a line of pixels, 64 bytes per iteration with NEON.
+ *
+ * @param dst - address of the destination
+ * @param src - address of the source
+ * @param bytes - number of bytes
+ *
+ * @return None.
+*******************************************************************************/
+static void SpectrumCopyRow(u32 dst, u32 src, u32 bytes)
+{
+#ifdef __ARM_NEON__
+	u8 *d = (u8 *)dst;
+	const u8 *s = (const u8 *)src;
+	uint8x16_t v0;
+	uint8x16_t v1;
+	uint8x16_t v2;
+	uint8x16_t v3;
+
+	for (; bytes >= 64; bytes -= 64)
+	{
+		v0 = vld1q_u8(s);
+		v1 = vld1q_u8(s + 16);
+		v2 = vld1q_u8(s + 32);
+		v3 = vld1q_u8(s + 48);
+		vst1q_u8(d, v0);
+		vst1q_u8(d + 16, v1);
+		vst1q_u8(d + 32, v2);
+		vst1q_u8(d + 48, v3);
+		s += 64;
+		d += 64;
+	}
+	memcpy(d, s, bytes);
+#else
+	memcpy((void *)dst, (const void *)src, bytes);
+#endif
+}
+
+/***************************************************************************//**
+ * @brief Draws the background and the grid of the trace and the empty
+ *        waterfall in a frame store.
+ *
+ * @param frame - the frame store
+ *
+ * @return None.
+*******************************************************************************/
+static void SpectrumDrawBackground(u32 frame)
+{
+	SPECTRUM_CONFIG *cfg = &spectrum_config;
+	u32 line;
+
+	VideoFillRect(frame, cfg->x, cfg->y, cfg->width,
+				  cfg->traceHeight + cfg->waterfallHeight,
+				  SPECTRUM_COLOR_BACKGROUND);
+	for (line = 0; line < cfg->traceHeight; line++)
+	{
+		if (spectrum_grid[line])
+		{
+			VideoFillRect(frame, cfg->x, cfg->y + line, cfg->width, 1,
+						  SPECTRUM_COLOR_GRID);
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @brief Sets up the spectrum area and draws its background in every frame
+ *        store. The rest of the frame stores is copied from the first frame
+ *        store, which holds the picture shown at startup. Must be called
+ *        after the video mode is set.
+ *
+ * @param config - position and size of the spectrum area and level range
+ *
+ * @return Returns 0 in case of success or -1 if the area does not fit.
+*******************************************************************************/
+int SpectrumInit(const SPECTRUM_CONFIG *config)
+{
+	u32 bpp = VideoBytesPerPixel(VideoGetFormat());
+	u32 stride = VideoGetLineStride();
+	s32 level;
+	u32 frame;
+
+	if ((stride == 0) || (config->width == 0) || (config->range <= 0) ||
+		(config->x & 1) || (config->width & 1) ||
+		(config->width > SPECTRUM_MAX_WIDTH) ||
+		(config->traceHeight < 2) ||
+		(config->traceHeight > SPECTRUM_MAX_LINES) ||
+		(config->waterfallHeight > SPECTRUM_MAX_LINES) ||
+		(((config->x + config->width) * bpp) > stride) ||
+		(((config->y + config->traceHeight + config->waterfallHeight) *
+		  stride) > VideoGetFrameSize()))
+	{
+		return -1;
+	}
+	spectrum_config = *config;
+	spectrum_y_scale = ((config->traceHeight - 1) << 16) / config->range;
+	spectrum_index_scale = (255 << 16) / config->range;
+	SpectrumBuildColorMap();
+
+	memset(spectrum_grid, 0, sizeof(spectrum_grid));
+	for (level = config->refLevel;
+		 level >= (config->refLevel - config->range);
+		 level -= SPECTRUM_GRID_STEP)
+	{
+		spectrum_grid[SpectrumLevelToLine(level)] = 1;
+	}
+
+	spectrum_row_bytes = ((config->width * bpp) + SPECTRUM_ROW_ALIGN - 1) &
+						 ~(SPECTRUM_ROW_ALIGN - 1);
+	spectrum_head = 0;
+	spectrum_rows = 0;
+	spectrum_seq = 0;
+	for (frame = 0; frame < VIDEO_FRAMES; frame++)
+	{
+		if (frame)
+		{
+			SpectrumCopyRow(VideoFrameAddress(frame), VideoFrameAddress(0),
+							VideoGetFrameSize());
+		}
+		SpectrumDrawBackground(frame);
+		Xil_DCacheFlushRange(VideoFrameAddress(frame), VideoGetFrameSize());
+		spectrum_store[frame].seq = 0;
+		spectrum_store[frame].drawn = 0;
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Adds a spectrum. The bins are spread over the columns of the area,
+ *        each column showing the highest level of its bins, and the spectrum
+ *        becomes the newest line of the waterfall. Nothing is drawn until
+ *        SpectrumRender.
+ *
+ * @param levels - levels of the bins, in 0.01 dB
+ * @param count - number of bins
+ *
+ * @return None.
+*******************************************************************************/
+void SpectrumPush(const s32 *levels, u32 count)
+{
+	u32 width = spectrum_config.width;
+	u32 first;
+	u32 last;
+	u32 col;
+	u32 bin;
+	s32 max;
+
+	if ((count == 0) || (width == 0))
+	{
+		return;
+	}
+	for (col = 0; col < width; col++)
+	{
+		first = (col * count) / width;
+		last = ((col + 1) * count) / width;
+		max = levels[first];
+		for (bin = first + 1; bin < last; bin++)
+		{
+			if (levels[bin] > max)
+			{
+				max = levels[bin];
+			}
+		}
+		spectrum_level[col] = max;
+	}
+	SpectrumMapLevels();
+
+	if (spectrum_config.waterfallHeight)
+	{
+		spectrum_head = (spectrum_head + 1) % spectrum_config.waterfallHeight;
+		VideoConvertPixels(SpectrumHistoryRow(spectrum_head), spectrum_line,
+						   width);
+		if (spectrum_rows < spectrum_config.waterfallHeight)
+		{
+			spectrum_rows++;
+		}
+	}
+	spectrum_seq++;
+}
+
+/***************************************************************************//**
+ * @brief Renders the newest spectrum in the back frame store and shows it.
+ *        In the trace only the columns of the former trace of the frame store
+ *        are erased before the new trace is drawn; the waterfall is scrolled
+ *        by copying its lines from the history. Only the lines of the area
+ *        are flushed from the data cache. Call it at the display rate, every
+ *        frame store then lags at most two spectra behind.
+ *
+ * @return Returns 1 if a frame was shown or 0 if there was nothing new.
+*******************************************************************************/
+int SpectrumRender(void)
+{
+	SPECTRUM_CONFIG *cfg = &spectrum_config;
+	SPECTRUM_STORE *store;
+	u32 bpp = VideoBytesPerPixel(VideoGetFormat());
+	u32 stride = VideoGetLineStride();
+	u32 frame;
+	u32 col;
+	u32 line;
+	u32 top;
+	u32 bottom;
+	u32 prev;
+	u32 dst;
+
+	if (spectrum_seq == 0)
+	{
+		return 0;
+	}
+	frame = VideoGetBackFrame();
+	store = &spectrum_store[frame];
+	if (store->seq == spectrum_seq)
+	{
+		return 0;
+	}
+
+	/* Trace, each column joined to the previous one */
+	for (col = 0; col < cfg->width; col++)
+	{
+		if (store->drawn)
+		{
+			for (line = store->top[col]; line <= store->bottom[col]; line++)
+			{
+				VideoPutPixel(frame, cfg->x + col, cfg->y + line,
+							  spectrum_grid[line] ? SPECTRUM_COLOR_GRID :
+													SPECTRUM_COLOR_BACKGROUND);
+			}
+		}
+		prev = spectrum_trace[col ? (col - 1) : 0];
+		top = (prev < spectrum_trace[col]) ? prev : spectrum_trace[col];
+		bottom = (prev > spectrum_trace[col]) ? prev : spectrum_trace[col];
+		for (line = top; line <= bottom; line++)
+		{
+			VideoPutPixel(frame, cfg->x + col, cfg->y + line,
+						  SPECTRUM_COLOR_TRACE);
+		}
+		store->top[col] = top;
+		store->bottom[col] = bottom;
+	}
+	store->drawn = 1;
+
+	/* Waterfall, newest line on top */
+	dst = VideoFrameAddress(frame) +
+		  ((cfg->y + cfg->traceHeight) * stride) + (cfg->x * bpp);
+	for (line = 0; line < spectrum_rows; line++)
+	{
+		SpectrumCopyRow(dst, SpectrumHistoryRow((spectrum_head +
+												 cfg->waterfallHeight - line) %
+												cfg->waterfallHeight),
+						cfg->width * bpp);
+		dst += stride;
+	}
+
+	VideoFlipLines(frame, cfg->y, cfg->traceHeight + cfg->waterfallHeight);
+	store->seq = spectrum_seq;
+
+	return 1;
+}
+
+#endif
@@ -1,5 +1,6 @@
 /***************************************************************************//**
- *   @file   transmitter_defs.h
+ *   @file   spectrum.h
+ *   @brief  Spectrum and waterfall renderer header file.
 ********************************************************************************
  * Copyright 2013(c) Analog Devices, Inc.
  *
@@ -38,85 +39,61 @@
  *   SVN Revision: $WCREV$
 *******************************************************************************/
 
-#ifndef _TRANSMITTER_DEFS_H_
-#define _TRANSMITTER_DEFS_H_
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
 
 /******************************************************************************/
 /***************************** Include Files **********************************/
 /******************************************************************************/
-#include "atv_types.h"
-#include "tx_lib.h"
+#include "xil_types.h"
+#include "cf_hdmi.h"
 
 /******************************************************************************/
-/******************* Macros and Constants Definitions *************************/
+/************************** Macros Definitions ********************************/
 /******************************************************************************/
-#define MUTE_DISABLE			0x0
-#define MUTE_ENABLE				0x1
+/* The renderer is built only if SPECTRUM_EN is defined. The levels are in
+   0.01 dB, the unit of the ADC analysis engine. */
 
-/******************************************************************************/
-/************************** Types Declarations ********************************/
-/******************************************************************************/
-typedef enum
-{
-    MODE_XMT,           /* Transmitter mode */
-    MODE_NONE,          /* None */
-    MODE_INVALID        /* Invalid value, for internal use only */
-}TRANSMITTER_OPER_MODE;
-
-typedef enum
-{
-    REP_POWER_DOWN,
-    REP_POWER_UP
-} TRANSMITTER_POWER_MODE;
-
-typedef enum
-{
-    AUD_IN_I2S0,
-    AUD_IN_I2S1,
-    AUD_IN_I2S2,
-    AUD_IN_I2S3,
-    AUD_IN_I2S,
-    AUD_IN_SPDIF,
-    AUD_IN_DSD0,
-    AUD_IN_DSD1,
-    AUD_IN_DSD2,
-    AUD_IN_DSD3,
-    AUD_IN_DSD4,
-    AUD_IN_DSD5,
-    AUD_IN_DSD6,
-    AUD_IN_DSD7,
-    AUD_IN_DSD,
-    AUD_IN_DST,
-    AUD_IN_ALL
-} TRANSMITTER_AUD_INTERFACE;
+/* Largest width of the spectrum and height of the trace or the waterfall */
+#ifndef SPECTRUM_MAX_WIDTH
+#define SPECTRUM_MAX_WIDTH			1920
+#endif
+#ifndef SPECTRUM_MAX_LINES
+#define SPECTRUM_MAX_LINES			540
+#endif
 
-typedef enum
-{
-    OUT_MODE_HDMI,
-    OUT_MODE_DVI
-}TRANSMITTER_OUTPUT_MODE;
+/* Waterfall lines, in the frame store format, after the video frames */
+#ifndef SPECTRUM_HISTORY_BASEADDR
+#define SPECTRUM_HISTORY_BASEADDR	(VIDEO_BASEADDR + (VIDEO_FRAMES * VIDEO_FRAME_STRIDE))
+#endif
 
-typedef struct
-{
-    BOOL						Changed;
-    TRANSMITTER_OPER_MODE		Mode;
-    TRANSMITTER_POWER_MODE		PowerMode;
-    TRANSMITTER_OUTPUT_MODE		ReqOutputMode;
-    UCHAR						InPixelBitsPerColor;
-    TX_IN_FORMAT				InPixelFormat;
-    UCHAR						InPixelStyle;
-    TX_CHAN_ALIGN				InPixelAlignment;
-    TX_OUT_ENCODING				OutPixelEncFormat;
-    TX_CS_MODE					InColorSpace;
-    TX_CS_MODE					OutColorSpace;
-    TRANSMITTER_AUD_INTERFACE	AudInterface;
-    UINT16						DebugControl;
-} TRANSMITTER_OPER_PARAMS;
+/* Colors, 0x00RRGGBB, and level step of the horizontal grid lines */
+#define SPECTRUM_COLOR_BACKGROUND	0x000000
+#define SPECTRUM_COLOR_GRID			0x303030
+#define SPECTRUM_COLOR_TRACE		0x40ff40
+#define SPECTRUM_GRID_STEP			1000		// 10 dB
 
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
 typedef struct
 {
-    BOOL    Hpd;
-    BOOL    Msen;
-}TX_STATUS_PKT;
+	u32	x;					// first column, even
+	u32	y;					// first line of the trace
+	u32	width;				// columns, even
+	u32	traceHeight;		// lines of the trace
+	u32	waterfallHeight;	// lines of the waterfall, below the trace
+	s32	refLevel;			// level at the top of the trace
+	s32	range;				// levels shown below refLevel
+} SPECTRUM_CONFIG;
 
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+#ifdef SPECTRUM_EN
+int SpectrumInit(const SPECTRUM_CONFIG *config);
+void SpectrumPush(const s32 *levels, u32 count);
+int SpectrumRender(void);
 #endif
+
+#endif /* SPECTRUM_H_ */
@@ -0,0 +1,975 @@
+/***************************************************************************//**
+ *   @file   transmitter.c
+********************************************************************************
+ * Copyright 2013(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+********************************************************************************
+ *   SVN Revision: $WCREV$
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "atv_types.h"
+#include "atv_platform.h"
+#include "atv_common.h"
+#include "transmitter.h"
+#include "tx_lib.h"
+#include "edid.h"
+#include "cf_hdmi.h"
+#include "boot_profile.h"
+#include "xil_io.h"
+
+/*****************************************************************************/
+/******************* Macros and Constants Definitions ************************/
+/*****************************************************************************/
+#define TRANSMITTER_MODE_SWITCH_DELAY	500
+                            /* This value defines the delay from the time   */
+                            /* a mode change is detected to the time it is  */
+                            /* reported to the application. It is used to   */
+                            /* make sure the new mode is stable before it   */
+                            /* is processed                                 */
+
+#define TRANSMITTER_HOUSEKEEPING_DELAY	100
+                            /* This value defines the delay (in ms) between */
+                            /* any two consecutive calls to the repeater    */
+                            /* housekeeping function. This function provide */
+                            /* periodic check on hardware status to make    */
+                            /* sure everything is in order. Smaller delay   */
+                            /* result in better response but generate much  */
+                            /* more i2c access. Recommended 100-200 ms      */
+
+#define TRANSMITTER_EDID_CACHE_SIZE	4
+                            /* Number of sinks whose preferred mode is      */
+                            /* remembered, so that a reconnect applies it   */
+                            /* without decoding and parsing the EDID again  */
+
+typedef struct
+{
+    UCHAR               Id[8];      /* Manufacturer, product code & serial  */
+    UCHAR               Checksum;   /* Checksum of the first EDID block     */
+    const VIDEO_MODE    *Mode;      /* Preferred mode, NULL if unused       */
+} TRANSMITTER_EDID_CACHE;
+
+/*****************************************************************************/
+/**************************** Local Variables ********************************/
+/*****************************************************************************/
+static UINT32					HouseKeepingDelay;
+static TRANSMITTER_OPER_MODE	LastDetMode;
+static UINT32					ModeChngCount;
+TRANSMITTER_OPER_PARAMS			TransmitterParm;
+UCHAR							MuteState;
+static volatile BOOL			IrqPending;
+static BOOL						IrqConnected;
+static TRANSMITTER_EDID_CACHE	EdidCache[TRANSMITTER_EDID_CACHE_SIZE];
+static UCHAR					EdidCacheNext;
+static BOOL						EdidCacheHit;
+
+/* N/CTS of the pixel clocks of the video mode table, HDMI 1.4 section 7.2.
+   CTS is programmed (manual mode) where the pixel clock is an exact multiple
+   of the audio clock; otherwise the transmitter measures it. 25.175 MHz uses
+   the N values of 25.2/1.001 MHz, which it is close to but not equal to. */
+static const TRANSMITTER_ACR_SET AcrTable[] =
+{
+	{  25175000, {
+		TRANSMITTER_ACR( 4576,  28125, FALSE, TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 7007,  31250, FALSE, TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6864,  28125, FALSE, TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(14014,  31250, FALSE, TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(13728,  28125, FALSE, TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(28028,  31250, FALSE, TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(27456,  28125, FALSE, TRANSMITTER_FS_192KHZ)
+	} },
+	{  27000000, {
+		TRANSMITTER_ACR( 4096,  27000, TRUE,  TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 6272,  30000, TRUE,  TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6144,  27000, TRUE,  TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(12544,  30000, TRUE,  TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(12288,  27000, TRUE,  TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(25088,  30000, TRUE,  TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(24576,  27000, TRUE,  TRANSMITTER_FS_192KHZ)
+	} },
+	{  74250000, {
+		TRANSMITTER_ACR( 4096,  74250, TRUE,  TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 6272,  82500, TRUE,  TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6144,  74250, TRUE,  TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(12544,  82500, TRUE,  TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(12288,  74250, TRUE,  TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(25088,  82500, TRUE,  TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(24576,  74250, TRUE,  TRANSMITTER_FS_192KHZ)
+	} },
+	{ 148500000, {
+		TRANSMITTER_ACR( 4096, 148500, TRUE,  TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 6272, 165000, TRUE,  TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6144, 148500, TRUE,  TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(12544, 165000, TRUE,  TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(12288, 148500, TRUE,  TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(25088, 165000, TRUE,  TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(24576, 148500, TRUE,  TRANSMITTER_FS_192KHZ)
+	} },
+	{  40000000, {
+		TRANSMITTER_ACR( 4096,  40000, TRUE,  TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 6272,  44444, FALSE, TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6144,  40000, TRUE,  TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(12544,  44444, FALSE, TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(12288,  40000, TRUE,  TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(25088,  44444, FALSE, TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(24576,  40000, TRUE,  TRANSMITTER_FS_192KHZ)
+	} },
+	{  65000000, {
+		TRANSMITTER_ACR( 4096,  65000, TRUE,  TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 6272,  72222, FALSE, TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6144,  65000, TRUE,  TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(12544,  72222, FALSE, TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(12288,  65000, TRUE,  TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(25088,  72222, FALSE, TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(24576,  65000, TRUE,  TRANSMITTER_FS_192KHZ)
+	} },
+	{ 108000000, {
+		TRANSMITTER_ACR( 4096, 108000, TRUE,  TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 6272, 120000, TRUE,  TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6144, 108000, TRUE,  TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(12544, 120000, TRUE,  TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(12288, 108000, TRUE,  TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(25088, 120000, TRUE,  TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(24576, 108000, TRUE,  TRANSMITTER_FS_192KHZ)
+	} },
+	{ 106500000, {
+		TRANSMITTER_ACR( 4096, 106500, TRUE,  TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 6272, 118333, FALSE, TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6144, 106500, TRUE,  TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(12544, 118333, FALSE, TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(12288, 106500, TRUE,  TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(25088, 118333, FALSE, TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(24576, 106500, TRUE,  TRANSMITTER_FS_192KHZ)
+	} },
+	{ 146250000, {
+		TRANSMITTER_ACR( 4096, 146250, TRUE,  TRANSMITTER_FS_32KHZ),
+		TRANSMITTER_ACR( 6272, 162500, TRUE,  TRANSMITTER_FS_44KHZ),
+		TRANSMITTER_ACR( 6144, 146250, TRUE,  TRANSMITTER_FS_48KHZ),
+		TRANSMITTER_ACR(12544, 162500, TRUE,  TRANSMITTER_FS_88KHZ),
+		TRANSMITTER_ACR(12288, 146250, TRUE,  TRANSMITTER_FS_96KHZ),
+		TRANSMITTER_ACR(25088, 162500, TRUE,  TRANSMITTER_FS_176KHZ),
+		TRANSMITTER_ACR(24576, 146250, TRUE,  TRANSMITTER_FS_192KHZ)
+	} }
+};
+
+/* CSC coefficients for each supported colorimetry pair */
+static const TRANSMITTER_CSC_SET CscTable[] =
+{
+	/* RGB 0-255 to RGB 16-235 */
+	{
+		TX_CS_RGB_FULL_RANGE, TX_CS_RGB,
+		TRANSMITTER_CSC(0x036F, 0x0000, 0x0000, 0x0040,
+						0x0000, 0x036F, 0x0000, 0x0040,
+						0x0000, 0x0000, 0x036F, 0x0040)
+	},
+	/* RGB 0-255 to YCbCr BT.601 */
+	{
+		TX_CS_RGB, TX_CS_YCC_601,
+		TRANSMITTER_CSC(0x01C2, 0x1E87, 0x1FB7, 0x0200,
+						0x0107, 0x0204, 0x0064, 0x0040,
+						0x1F68, 0x1ED6, 0x01C2, 0x0200)
+	},
+	/* RGB 0-255 to YCbCr BT.709 */
+	{
+		TX_CS_RGB, TX_CS_YCC_709,
+		TRANSMITTER_CSC(0x01C2, 0x1E67, 0x1FD7, 0x0200,
+						0x00BB, 0x0275, 0x003F, 0x0040,
+						0x1F99, 0x1EA5, 0x01C2, 0x0200)
+	},
+	/* YCbCr BT.601 to RGB 0-255 */
+	{
+		TX_CS_YCC_601, TX_CS_RGB,
+		TRANSMITTER_CSC(0x0662, 0x04A8, 0x0000, 0x1C84,
+						0x1CC0, 0x04A8, 0x1E6F, 0x021E,
+						0x0000, 0x04A8, 0x0812, 0x1BAD)
+	},
+	/* YCbCr BT.709 to RGB 0-255 */
+	{
+		TX_CS_YCC_709, TX_CS_RGB,
+		TRANSMITTER_CSC(0x072C, 0x04A8, 0x0000, 0x1C20,
+						0x1DDE, 0x04A8, 0x1F26, 0x0134,
+						0x0000, 0x04A8, 0x0873, 0x1B7C)
+	},
+	/* YCbCr BT.601 to YCbCr BT.709 */
+	{
+		TX_CS_YCC_601, TX_CS_YCC_709,
+		TRANSMITTER_CSC(0x041A, 0x0000, 0x004D, 0x1FCD,
+						0x1F2B, 0x0400, 0x1F8A, 0x00A6,
+						0x0075, 0x0000, 0x0413, 0x1FBC)
+	},
+	/* YCbCr BT.709 to YCbCr BT.601 */
+	{
+		TX_CS_YCC_709, TX_CS_YCC_601,
+		TRANSMITTER_CSC(0x03EF, 0x0000, 0x1FB6, 0x002E,
+						0x00C4, 0x0400, 0x0066, 0x1F6B,
+						0x1F8F, 0x0000, 0x03F6, 0x003E)
+	}
+};
+
+/* CSC disabled, the input is forwarded unchanged */
+static const TRANSMITTER_REG CscBypass[] =
+{
+	{0x18, 0x80, 0x00}
+};
+
+/***************************************************************************//**
+ * @brief Initializes the transmitter.
+ *
+ * @return Returns ATVERR_OK.
+*******************************************************************************/
+ATV_ERR ADIAPI_TransmitterInit(void)
+{
+    LastDetMode							= MODE_INVALID;
+    TransmitterParm.Changed				= TRUE;
+    TransmitterParm.Mode				= MODE_NONE;
+    TransmitterParm.ReqOutputMode		= OUT_MODE_HDMI;
+    TransmitterParm.InPixelBitsPerColor = HDMI_IN_BITS_PER_COLOR;
+    TransmitterParm.InPixelFormat 		= HDMI_IN_FORMAT;
+    TransmitterParm.InPixelStyle 		= 2;
+    TransmitterParm.InPixelAlignment 	= ALIGN_RIGHT;
+    TransmitterParm.OutPixelEncFormat 	= HDMI_OUT_ENC_FORMAT;
+    TransmitterParm.InColorSpace 		= TX_CS_RGB;
+    TransmitterParm.InColorSpace 		= TX_CS_RGB;
+    TransmitterParm.AudInterface		= TX_SPDIF;
+    TransmitterParm.AudSampFreq			= TX_FS_48KHZ;
+    TransmitterParm.PixelClk			= 0;
+    TransmitterParm.DebugControl		= 1;
+    MuteState							= MUTE_ENABLE;
+
+    TRANSMITTER_SoftwareInit();
+    TRANSMITTER_HardwareInit();
+
+    return ATVERR_OK;
+}
+
+/***************************************************************************//**
+ * @brief Initializes the software parameters.
+ *
+ * @return None.
+*******************************************************************************/
+void TRANSMITTER_SoftwareInit(void)
+{
+    memset (&(TransmitterTxVars), 0, sizeof(TRANSMITTER_TX_VARS));
+
+    TxStatus.Hpd        = FALSE;
+    TxStatus.Msen       = FALSE;
+}
+
+/***************************************************************************//**
+ * @brief Initializes the hardware of the transmitter.
+ *
+ * @return None.
+*******************************************************************************/
+void TRANSMITTER_HardwareInit(void)
+{
+	/* Enable TX HPD line. */
+    HAL_EnableTxHPD(TRUE);
+
+    /* Initialize HDMI TX chip. */
+    ADIAPI_TxInit(TRUE);
+
+    /* Enable TMDS clock and data lines. */
+    ADIAPI_TxEnableTmds (TRUE, TRUE);
+
+    /* Set system mute. */
+    ADIAPI_TxSetAvmute(TX_AVMUTE_OFF);
+    ADIAPI_TransmitterSetMuteState();
+
+    /* Set output mode. */
+    ADIAPI_TxSetOutputMode(TransmitterParm.ReqOutputMode);
+
+	/* Set input pixel data format. */
+	ADIAPI_TxSetInputPixelFormat(TransmitterParm.InPixelBitsPerColor,
+								 TransmitterParm.InPixelFormat,
+								 TransmitterParm.InPixelStyle,
+								 TransmitterParm.InPixelAlignment,
+								 FALSE,
+								 FALSE);
+
+    /* Set output pixel format. */
+    ADIAPI_TxSetOutputPixelFormat(TransmitterParm.OutPixelEncFormat,
+    							  TRUE);
+
+    /* Set colour space conversion */
+    TRANSMITTER_SetCsc(TransmitterParm.InColorSpace,
+    				   TransmitterParm.OutColorSpace);
+
+    /* Enable audio interface. */
+    ADIAPI_TxSetAudioInterface(TransmitterParm.AudInterface,
+    						   AUD_SAMP_PKT,
+    						   1);
+
+    /* Set interrupt masks. */
+    ADIAPI_TxSetEnabledEvents (TX_EVENT_ALL_EVENTS, FALSE);
+    ADIAPI_TxSetEnabledEvents ((TX_EVENT)(TX_EVENT_HPD_CHG |
+    									  TX_EVENT_MSEN_CHG |
+    									  TX_EVENT_EDID_READY),
+    						   TRUE);
+
+    /* Enable AVI InfoFrame. */
+	ADIAPI_TxEnablePackets(PKT_AV_INFO_FRAME,
+						   TRUE);
+}
+
+/***************************************************************************//**
+ * @brief Sets the format of the pixel data the HDMI core drives into the
+ *        transmitter. Used when the frame store format changes what the core
+ *        outputs, e.g. a YCbCr 4:2:2 frame store forwarded without color
+ *        space conversion.
+ *
+ * @param BitsPerColor - bits per color component.
+ * @param Format - input pixel format (ID).
+ * @param Style - input pixel style.
+ * @param ColorSpace - color space of the input pixel data.
+ *
+ * @return Returns ATVERR_OK.
+*******************************************************************************/
+ATV_ERR ADIAPI_TransmitterSetInputFormat(UCHAR BitsPerColor,
+										 TX_IN_FORMAT Format,
+										 UCHAR Style,
+										 TX_CS_MODE ColorSpace)
+{
+	TransmitterParm.InPixelBitsPerColor	= BitsPerColor;
+	TransmitterParm.InPixelFormat		= Format;
+	TransmitterParm.InPixelStyle		= Style;
+	TransmitterParm.InColorSpace		= ColorSpace;
+
+	ADIAPI_TxSetInputPixelFormat(TransmitterParm.InPixelBitsPerColor,
+								 TransmitterParm.InPixelFormat,
+								 TransmitterParm.InPixelStyle,
+								 TransmitterParm.InPixelAlignment,
+								 FALSE,
+								 FALSE);
+	TRANSMITTER_SetCsc(TransmitterParm.InColorSpace,
+					   TransmitterParm.OutColorSpace);
+
+	return ATVERR_OK;
+}
+
+/***************************************************************************//**
+ * @brief Sets the transmitter power mode.
+ *
+ * @param Mode - transmitter power mode.
+ *
+ * @return Returns ATVERR_OK.
+*******************************************************************************/
+ATV_ERR ADIAPI_TransmitterSetPowerMode(TRANSMITTER_POWER_MODE pwrmode)
+{
+    TransmitterParm.PowerMode = pwrmode;
+
+    return ATVERR_OK;
+}
+
+/***************************************************************************//**
+ * @brief Gets the operating mode based on HDMI HPD and MSEN state.
+ *
+ * @param Mode - operating mode.
+ *
+ * @return Returns ATVERR_OK.
+*******************************************************************************/
+ATV_ERR ADIAPI_TransmitterGetDetectedMode(TRANSMITTER_OPER_MODE *Mode)
+{
+    BOOL Hpd;
+    BOOL Msen;
+
+    ADIAPI_TxGetHpdMsenState(&Hpd, &Msen);
+    if(Hpd && Msen)
+    {
+        *Mode = MODE_XMT;
+    }
+    else
+    {
+        *Mode = MODE_NONE;
+    }
+
+    return ATVERR_OK;
+}
+
+/***************************************************************************//**
+ * @brief Gets the current system operating mode.
+ *
+ * @param Mode - operating mode.
+ *
+ * @return Returns ATVERR_OK.
+*******************************************************************************/
+ATV_ERR ADIAPI_TransmitterGetOperatingMode(TRANSMITTER_OPER_MODE *Mode)
+{
+    *Mode = TransmitterParm.Mode;
+
+    return ATVERR_OK;
+}
+
+/***************************************************************************//**
+ * @brief Sets the system operating mode.
+ *
+ * @param Mode - operating mode.
+ *
+ * @return Returns ATVERR_OK.
+*******************************************************************************/
+ATV_ERR ADIAPI_TransmitterSetOperatingMode(TRANSMITTER_OPER_MODE Mode)
+{
+    if (TransmitterParm.Mode != Mode)
+    {
+        TransmitterParm.Mode = Mode;
+        TransmitterParm.Changed = TRUE;
+        LOG_INFO("APP: Changed system mode to ");
+        if (TransmitterParm.Mode == MODE_XMT)
+        {
+            LOG_INFO("Transmitter\n\r");
+        }
+        else
+        {
+            LOG_INFO("Disconnected\n\r");
+        }
+    }
+
+    return ATVERR_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief Sets the mute mode using the operating mode information.
+ *
+ * @param Mode - operating mode.
+ *
+ * @return None.
+*******************************************************************************/
+void ADIAPI_TransmitterSetMuteMode(TRANSMITTER_OPER_MODE Mode)
+{
+	if(Mode == MODE_XMT)
+	{
+		MuteState = MUTE_DISABLE;
+	}
+	else
+	{
+		MuteState = MUTE_ENABLE;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Checks current AVR operating mode and notify application if mode
+ * 		  changed. Entering the transmitter mode restores the audio clock
+ * 		  and the color space conversion from the precomputed tables.
+ *
+ * @return None.
+*******************************************************************************/
+void TRANSMITTER_MonitorAvrMode(void)
+{
+    TRANSMITTER_OPER_MODE Mode;
+
+    ADIAPI_TransmitterGetDetectedMode(&Mode);
+    if(Mode != LastDetMode)
+    {
+        LastDetMode = Mode;
+        ModeChngCount = ATV_GetMsCountNZ();
+    }
+    if((Mode != TransmitterParm.Mode) && ModeChngCount)
+    {
+        if(ATV_GetElapsedMs(ModeChngCount, 0) > TRANSMITTER_MODE_SWITCH_DELAY)
+        {
+           	ADIAPI_TransmitterSetOperatingMode(Mode);
+           	ADIAPI_TransmitterSetMuteMode(Mode);
+           	if (Mode == MODE_XMT)
+           	{
+           		TRANSMITTER_SetAudioClock(TransmitterParm.PixelClk,
+           								  TransmitterParm.AudSampFreq);
+           		TRANSMITTER_SetCsc(TransmitterParm.InColorSpace,
+           						   TransmitterParm.OutColorSpace);
+           	}
+            ModeChngCount = 0;
+        }
+    }
+}
+
+/***************************************************************************//**
+ * @brief Signals an interrupt of the transmitter. The interrupt is serviced by
+ *        the next call of ADIAPI_TransmitterMain, outside of the interrupt
+ *        context, since clearing it takes I2C transfers.
+ *
+ * @param Ref - unused.
+ *
+ * @return None.
+*******************************************************************************/
+void ADIAPI_TransmitterIrqHandler(void *Ref)
+{
+    IrqPending = TRUE;
+}
+
+/***************************************************************************//**
+ * @brief Tells the service whether the transmitter interrupt line is
+ *        connected. Without it, the interrupt state is polled at the
+ *        housekeeping interval.
+ *
+ * @param Enable - TRUE if ADIAPI_TransmitterIrqHandler is connected.
+ *
+ * @return None.
+*******************************************************************************/
+void ADIAPI_TransmitterEnableIrq(BOOL Enable)
+{
+    IrqConnected = Enable;
+}
+
+/***************************************************************************//**
+ * @brief Checks whether the transmitter has an event to service: a pending
+ *        interrupt, a parameter change or an elapsed housekeeping interval.
+ *
+ * @return Returns TRUE if ADIAPI_TransmitterMain should be called.
+*******************************************************************************/
+BOOL ADIAPI_TransmitterEventPending(void)
+{
+    if (IrqPending)
+    {
+        return TRUE;
+    }
+
+    return (TransmitterParm.PowerMode == REP_POWER_UP) && (TransmitterParm.Changed ||
+           (ATV_GetElapsedMs(HouseKeepingDelay, 0) >= TRANSMITTER_HOUSEKEEPING_DELAY));
+}
+
+/***************************************************************************//**
+ * @brief Main function of the transmitter service.
+ * 		  This function should be called when ADIAPI_TransmitterEventPending
+ * 		  returns TRUE.
+ *
+ * @return None.
+*******************************************************************************/
+ATV_ERR ADIAPI_TransmitterMain(void)
+{
+    UCHAR Events;
+
+    Events = 0;
+    if ( (TransmitterParm.PowerMode == REP_POWER_UP) && (TransmitterParm.Changed ||
+        (ATV_GetElapsedMs(HouseKeepingDelay, 0) >= TRANSMITTER_HOUSEKEEPING_DELAY)))
+    {
+        TransmitterParm.Changed = FALSE;
+        Events |= ADI_TASK_EVENT_TIMER;
+        HouseKeepingDelay = HAL_GetCurrentMsCount();
+    }
+    Events &= ADI_TASK_EVENT_TIMER;
+    if (IrqPending || (!IrqConnected && (Events & ADI_TASK_EVENT_TIMER)))
+    {
+        IrqPending = FALSE;
+        if (ADIAPI_TxIntPending() == ATVERR_TRUE)
+        {
+            ADIAPI_TxIsr();
+        }
+    }
+    TRANSMITTER_MonitorAvrMode();
+    if ((Events & ADI_TASK_EVENT_TIMER) && (TransmitterParm.PowerMode == REP_POWER_UP))
+    {
+    	TRANSMITTER_Housekeeping();
+    }
+    if((CurrMuteState == MUTE_DISABLE) && (TransmitterParm.PowerMode == REP_POWER_UP))
+    {
+    	AudioClick();
+    }
+
+    return ATVERR_OK;
+}
+
+/***************************************************************************//**
+ * @brief Performs TX housekeeping tasks.
+ *		  This function should be called periodically (at least every 100 ms)
+ *
+ * @return None.
+*******************************************************************************/
+void TRANSMITTER_Housekeeping(void)
+{
+	/* Handle mute state. */
+	ADIAPI_TransmitterSetMuteState();
+}
+
+/***************************************************************************//**
+ * @brief This is the TX audio/video mute handling function.
+ *
+ * @return Returns ATVERR_OK.
+*******************************************************************************/
+ATV_ERR ADIAPI_TransmitterSetMuteState(void)
+{
+    if (MuteState != CurrMuteState)
+    {
+    	CurrMuteState = MuteState;
+        if(CurrMuteState)
+        {
+        	TRANSMITTER_DBG_MSG("Mute audio and video.\n\r");
+        	ADIAPI_TxMuteAudio(TRUE);
+        	ADIAPI_TxMuteVideo(TRUE);
+        }
+        else
+        {
+        	TRANSMITTER_DBG_MSG("Un-mute audio and video.\n\r");
+        	ADIAPI_TxMuteAudio(FALSE);
+        	ADIAPI_TxMuteVideo(FALSE);
+        }
+    }
+
+	return ATVERR_OK;
+}
+
+/***************************************************************************//**
+ * @brief Performs the notification operations.
+ *
+ * @return Returns 0.
+*******************************************************************************/
+UINT16 TRANSMITTER_Notification (TX_EVENT Ev, UINT16 Count, UCHAR *BufPtr)
+{
+    switch (Ev)
+    {
+    	/* HPD changed */
+        case TX_EVENT_HPD_CHG:
+            TxStatus.Hpd = *((BOOL *)BufPtr);
+            TRANSMITTER_DBG_MSG("HPD changed to %s\n\r", TxStatus.Hpd? "HI": "LOW");
+            if (TxStatus.Hpd)
+            {
+            	TRANSMITTER_HardwareInit();
+            }
+            else
+            {
+            	TRANSMITTER_SoftwareInit();
+            }
+            break;
+        /* MSEN changed */
+        case TX_EVENT_MSEN_CHG:
+            TxStatus.Msen = *((BOOL *)BufPtr);
+            TRANSMITTER_DBG_MSG("MSEN changed to %s\n\r", TxStatus.Msen? "HI": "LOW");
+            break;
+        /* EDID ready */
+        case TX_EVENT_EDID_READY:
+        	TRANSMITTER_DBG_MSG("A new EDID segment was read.\n\r");
+        	TRANSMITTER_NewEdidSegment(Count, BufPtr);
+            break;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/***************************************************************************//**
+ * @brief Writes a batch of registers of a transmitter register map. Each run
+ *        of consecutive register addresses, up to TRANSMITTER_BURST_MAX, is
+ *        sent as one auto-incrementing HAL_I2CWriteBlock burst instead of one
+ *        transaction per register. A run with partial masks is first read
+ *        with one HAL_I2CReadBlock burst and its fields merged, so that whole
+ *        registers are written back; write-one-to-clear registers (e.g. the
+ *        interrupt registers) must then be given with a full mask. Suits the
+ *        CSC coefficient, InfoFrame and audio register blocks.
+ *
+ * @param Dev - I2C address of the register map, e.g. TRANSMITTER_MAIN_MAP.
+ * @param Regs - the registers, in the order they are written.
+ * @param Count - number of registers.
+ *
+ * @return Returns ATVERR_OK or ATVERR_INV_PARM if Regs is NULL.
+*******************************************************************************/
+ATV_ERR TRANSMITTER_WriteRegs(UCHAR Dev, const TRANSMITTER_REG *Regs,
+							  UINT16 Count)
+{
+	UCHAR	Data[TRANSMITTER_BURST_MAX];
+	UINT16	Start;
+	UINT16	Len;
+	UINT16	n;
+	BOOL	Partial;
+
+	if ((Regs == NULL) && Count)
+	{
+		return ATVERR_INV_PARM;
+	}
+	for (Start = 0; Start < Count; Start += Len)
+	{
+		/* Run of consecutive registers */
+		Partial = FALSE;
+		for (Len = 0; ((Start + Len) < Count) && (Len < TRANSMITTER_BURST_MAX);
+			 Len++)
+		{
+			if (Len && (Regs[Start + Len].Reg !=
+						(UCHAR)(Regs[Start + Len - 1].Reg + 1)))
+			{
+				break;
+			}
+			if (Regs[Start + Len].Mask != 0xFF)
+			{
+				Partial = TRUE;
+			}
+		}
+		if (Partial)
+		{
+			HAL_I2CReadBlock(Dev, Regs[Start].Reg, Data, Len);
+		}
+		for (n = 0; n < Len; n++)
+		{
+			Data[n] = Partial ? ((Data[n] & ~Regs[Start + n].Mask) |
+								 (Regs[Start + n].Value & Regs[Start + n].Mask)) :
+					  Regs[Start + n].Value;
+		}
+		if (Len == 1)
+		{
+			HAL_I2CWriteByte(Dev, Regs[Start].Reg, Data[0]);
+		}
+		else
+		{
+			HAL_I2CWriteBlock(Dev, Regs[Start].Reg, Data, Len);
+		}
+	}
+
+	return ATVERR_OK;
+}
+
+/***************************************************************************//**
+ * @brief Sets the audio clock regeneration N/CTS values and the sampling
+ *        frequency of a pixel clock and audio rate with one batched write of
+ *        a precomputed register set.
+ *
+ * @param PixelClk - pixel clock in Hz, one of the video mode table.
+ * @param SampFreq - audio sample rate, TX_FS_32KHZ to TX_FS_192KHZ.
+ *
+ * @return Returns ATVERR_OK or ATVERR_INV_PARM if the pixel clock or the
+ *         sample rate are not in the table.
+*******************************************************************************/
+ATV_ERR TRANSMITTER_SetAudioClock(unsigned long PixelClk, TX_AUD_FS SampFreq)
+{
+	UCHAR i;
+
+	if ((UINT32)SampFreq >= TRANSMITTER_ACR_RATES)
+	{
+		return ATVERR_INV_PARM;
+	}
+	for (i = 0; i < (sizeof(AcrTable) / sizeof(AcrTable[0])); i++)
+	{
+		if (AcrTable[i].PixelClk == PixelClk)
+		{
+			return TRANSMITTER_WriteRegs(TRANSMITTER_MAIN_MAP,
+										 AcrTable[i].Acr[SampFreq],
+										 TRANSMITTER_ACR_REGS);
+		}
+	}
+
+	return ATVERR_INV_PARM;
+}
+
+/***************************************************************************//**
+ * @brief Sets the color space conversion with one batched write of a
+ *        precomputed coefficient set. Pairs without a set are left to
+ *        ADIAPI_TxSetCSC.
+ *
+ * @param InColorSpace - color space of the input pixel data.
+ * @param OutColorSpace - color space sent to the sink.
+ *
+ * @return Returns ATVERR_OK.
+*******************************************************************************/
+ATV_ERR TRANSMITTER_SetCsc(TX_CS_MODE InColorSpace, TX_CS_MODE OutColorSpace)
+{
+	UCHAR i;
+
+	if (InColorSpace == OutColorSpace)
+	{
+		return TRANSMITTER_WriteRegs(TRANSMITTER_MAIN_MAP, CscBypass,
+									 sizeof(CscBypass) / sizeof(CscBypass[0]));
+	}
+	for (i = 0; i < (sizeof(CscTable) / sizeof(CscTable[0])); i++)
+	{
+		if ((CscTable[i].In == InColorSpace) &&
+			(CscTable[i].Out == OutColorSpace))
+		{
+			return TRANSMITTER_WriteRegs(TRANSMITTER_MAIN_MAP,
+										 CscTable[i].Regs,
+										 TRANSMITTER_CSC_REGS);
+		}
+	}
+
+	return ADIAPI_TxSetCSC(InColorSpace, OutColorSpace);
+}
+
+/***************************************************************************//**
+ * @brief Looks up a sink in the EDID cache.
+ *
+ * @param Edid - first block of the sink EDID.
+ *
+ * @return Returns the cache entry of the sink or NULL if it is not cached.
+*******************************************************************************/
+static TRANSMITTER_EDID_CACHE *TRANSMITTER_FindEdid(EDID_STRUCT *Edid)
+{
+    UCHAR i;
+
+    for (i = 0; i < TRANSMITTER_EDID_CACHE_SIZE; i++)
+    {
+        if ((EdidCache[i].Mode != NULL) &&
+            (EdidCache[i].Checksum == Edid->Checksum) &&
+            (memcmp(EdidCache[i].Id, Edid->ManID, sizeof(EdidCache[i].Id)) == 0))
+        {
+            return &EdidCache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/***************************************************************************//**
+ * @brief Remembers the preferred mode of a sink, replacing the oldest entry
+ *        when the cache is full.
+ *
+ * @param Edid - first block of the sink EDID.
+ * @param Mode - preferred mode of the sink.
+ *
+ * @return None.
+*******************************************************************************/
+static void TRANSMITTER_CacheEdid(EDID_STRUCT *Edid, const VIDEO_MODE *Mode)
+{
+    TRANSMITTER_EDID_CACHE *Entry;
+
+    Entry = &EdidCache[EdidCacheNext];
+    EdidCacheNext = (EdidCacheNext + 1) % TRANSMITTER_EDID_CACHE_SIZE;
+    memcpy(Entry->Id, Edid->ManID, sizeof(Entry->Id));
+    Entry->Checksum = Edid->Checksum;
+    Entry->Mode = Mode;
+}
+
+/***************************************************************************//**
+ * @brief Parse the new EDID segment and set the resolution and the pixel clock
+ * 		  according to EDID data. A sink found in the EDID cache gets its
+ * 		  cached mode right away and its EDID is not parsed again.
+ *
+ * @param SegmentNum - Segment number.
+ * @param SegPtr - Segment pointer.
+ *
+ * @return None.
+*******************************************************************************/
+void TRANSMITTER_NewEdidSegment(UINT16 SegmentNum, UCHAR *SegPtr)
+{
+	UCHAR  		EdidData[256];
+	UINT16 		SpaOffset;
+	EDID_STRUCT *Edid;
+	STD_TIMING *TDesc;
+	const VIDEO_MODE *Mode;
+	TRANSMITTER_EDID_CACHE *Entry;
+
+	unsigned short hActive = 0;
+	unsigned short vActive = 0;
+	unsigned short hBlanking = 0;
+	unsigned short vBlanking = 0;
+	unsigned short hWidth = 0;
+	unsigned short vWidth = 0;
+	unsigned short hOffset = 0;
+	unsigned short vOffset = 0;
+	unsigned long pixelClk = 0;
+
+    if (SegPtr)
+    {
+        memcpy (EdidData, SegPtr, 256);
+    }
+    else
+    {
+        memset (EdidData, 0, 256);
+    }
+    if (SegPtr && (SegmentNum == 0))
+    {
+    	Entry = TRANSMITTER_FindEdid((EDID_STRUCT *)EdidData);
+    	EdidCacheHit = (Entry != NULL);
+    	if (EdidCacheHit)
+    	{
+    		TRANSMITTER_DBG_MSG("Known sink, using the cached mode.\n\r");
+    		if (VideoSetMode(Entry->Mode) < 0)
+    		{
+    			TRANSMITTER_DBG_MSG("Pixel clock failed to lock.\n\r");
+    		}
+    		TransmitterParm.PixelClk = Entry->Mode->pixelClk;
+    		TRANSMITTER_SetAudioClock(TransmitterParm.PixelClk,
+    								  TransmitterParm.AudSampFreq);
+    		return;
+    	}
+    }
+    if (SegPtr && (SegmentNum < 2) && !EdidCacheHit)
+    {
+    	Edid = (EDID_STRUCT *)EdidData;
+    	TDesc = (STD_TIMING *)(Edid->DetailedTiming);
+
+    	hActive = ((TDesc->HActBlnk44 & 0xf0) << 4) | TDesc->HActive;
+    	vActive = ((TDesc->VActBlnk44 & 0xf0) << 4) | TDesc->VActive;
+    	hBlanking = ((TDesc->HActBlnk44 & 0x0f) << 8) | TDesc->HBlanking;
+    	vBlanking = ((TDesc->VActBlnk44 & 0x0f) << 8) | TDesc->VBlanking;
+    	hWidth = ((TDesc->HVOffsPulse & 0x30) << 4) | TDesc->HSyncWidth;
+    	vWidth = ((TDesc->HVOffsPulse & 0x03) << 4) | (TDesc->VOffsPulse & 0x0f);
+    	hOffset = ((TDesc->HVOffsPulse & 0xC0) << 2) | TDesc->HSyncOffs;
+    	vOffset = ((TDesc->HVOffsPulse & 0x0C) << 2) | ((TDesc->VOffsPulse & 0xf0) >> 4);
+
+    	pixelClk = (TDesc->PixelClk[1] << 8) | TDesc->PixelClk[0];
+    	pixelClk = pixelClk * 10000;
+
+    	/* Known modes use the precomputed clock settings. */
+    	Mode = VideoMatchMode(hActive, vActive, hBlanking, vBlanking, pixelClk);
+    	if (Mode != NULL)
+    	{
+    		if (VideoSetMode(Mode) < 0)
+    		{
+    			TRANSMITTER_DBG_MSG("Pixel clock failed to lock.\n\r");
+    		}
+    		if (SegmentNum == 0)
+    		{
+    			TRANSMITTER_CacheEdid(Edid, Mode);
+    		}
+    	}
+    	else
+    	{
+    		PROFILE_PHASE("Pixel clock search");
+    		if (CLKGEN_SetRate(pixelClk, CF_CLKGEN_REF_RATE) < 0)
+    		{
+    			TRANSMITTER_DBG_MSG("Pixel clock failed to lock.\n\r");
+    		}
+    		PROFILE_PHASE("HDMI video core");
+    		InitHdmiVideoPcore(hActive,
+    						   vActive,
+    						   hBlanking,
+    						   vBlanking,
+    						   hWidth,
+    						   vWidth,
+    						   hOffset,
+    						   vOffset);
+    	}
+    	TRANSMITTER_DBG_MSG("Pixel clock settled after %lu status polls.\n\r",
+    						CLKGEN_GetLockTime());
+    	TransmitterParm.PixelClk = (Mode != NULL) ? Mode->pixelClk : pixelClk;
+    	if (TRANSMITTER_SetAudioClock(TransmitterParm.PixelClk,
+    								  TransmitterParm.AudSampFreq) != ATVERR_OK)
+    	{
+    		TRANSMITTER_DBG_MSG("No N/CTS set for this pixel clock.\n\r");
+    	}
+    	PROFILE_PhaseDump();
+
+    	ADIAPI_MwEdidEnableDebugMsg(TRUE);
+    	ADIAPI_MwEdidParse(EdidData, &SpaOffset, SegmentNum);
+    }
+}
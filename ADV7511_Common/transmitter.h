@@ -45,13 +45,15 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include "transmitter_defs.h"
+#include "log.h"
 
 /******************************************************************************/
 /******************* Macros and Variables Definitions *************************/
 /******************************************************************************/
 #define ADI_TASK_EVENT_TIMER	0x1
 #define DBG_MSG                 xil_printf
-#define TRANSMITTER_DBG_MSG		if(TransmitterParm.DebugControl)DBG_MSG
+/* The state machine messages go through the buffered log */
+#define TRANSMITTER_DBG_MSG		if(TransmitterParm.DebugControl)LOG_INFO
 
 typedef struct
 {
@@ -120,6 +122,12 @@ void TRANSMITTER_SoftwareInit(void);
 /*! Initializes the hardware of the transmitter. */
 void TRANSMITTER_HardwareInit(void);
 
+/*! Sets the format of the transmitter input pixel data. */
+ATV_ERR ADIAPI_TransmitterSetInputFormat(UCHAR BitsPerColor,
+										 TX_IN_FORMAT Format,
+										 UCHAR Style,
+										 TX_CS_MODE ColorSpace);
+
 /*! Sets the transmitter power mode. */
 ATV_ERR ADIAPI_TransmitterSetPowerMode(TRANSMITTER_POWER_MODE pwrmode);
 
@@ -138,7 +146,16 @@ void ADIAPI_TransmitterSetMuteMode(TRANSMITTER_OPER_MODE Mode);
 /*! Checks current AVR operating mode and notify application if mode changed. */
 void TRANSMITTER_MonitorAvrMode(void);
 
-/*! @brief Main function for polling mode operation. */
+/*! Signals an interrupt of the transmitter. */
+void ADIAPI_TransmitterIrqHandler(void *Ref);
+
+/*! Tells the service whether the transmitter interrupt line is connected. */
+void ADIAPI_TransmitterEnableIrq(BOOL Enable);
+
+/*! Checks whether the transmitter has an event to service. */
+BOOL ADIAPI_TransmitterEventPending(void);
+
+/*! @brief Main function of the transmitter service. */
 ATV_ERR ADIAPI_TransmitterMain(void);
 
 /*! Performs TX housekeeping tasks. */
@@ -153,4 +170,14 @@ UINT16 TRANSMITTER_Notification (TX_EVENT Ev, UINT16 Count, UCHAR *BufPtr);
 /*! @brief Parse the new EDID segment. */
 void TRANSMITTER_NewEdidSegment(UINT16 SegmentNum, UCHAR *SegPtr);
 
+/*! Writes a batch of registers with I2C bursts. */
+ATV_ERR TRANSMITTER_WriteRegs(UCHAR Dev, const TRANSMITTER_REG *Regs,
+							  UINT16 Count);
+
+/*! Sets the audio N/CTS values of a pixel clock from the precomputed table. */
+ATV_ERR TRANSMITTER_SetAudioClock(unsigned long PixelClk, TX_AUD_FS SampFreq);
+
+/*! Sets the color space conversion from the precomputed coefficient sets. */
+ATV_ERR TRANSMITTER_SetCsc(TX_CS_MODE InColorSpace, TX_CS_MODE OutColorSpace);
+
 #endif
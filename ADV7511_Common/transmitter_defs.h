@@ -0,0 +1,211 @@
+/***************************************************************************//**
+ *   @file   transmitter_defs.h
+********************************************************************************
+ * Copyright 2013(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+********************************************************************************
+ *   SVN Revision: $WCREV$
+*******************************************************************************/
+
+#ifndef _TRANSMITTER_DEFS_H_
+#define _TRANSMITTER_DEFS_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "atv_types.h"
+#include "tx_lib.h"
+
+/******************************************************************************/
+/******************* Macros and Constants Definitions *************************/
+/******************************************************************************/
+#define MUTE_DISABLE			0x0
+#define MUTE_ENABLE				0x1
+
+/* Default I2C addresses of the ADV7511 register maps */
+#define TRANSMITTER_MAIN_MAP	0x72
+#define TRANSMITTER_PACKET_MAP	0x70
+
+/* Largest number of registers written in one I2C burst */
+#define TRANSMITTER_BURST_MAX	32
+
+/* Audio sample rates of the N/CTS table, TX_FS_32KHZ to TX_FS_192KHZ */
+#define TRANSMITTER_ACR_RATES	7
+/* Registers of one N/CTS set: N, CTS, CTS select and sampling frequency */
+#define TRANSMITTER_ACR_REGS	11
+/* Registers of one CSC set: update mode, coefficients, update mode */
+#define TRANSMITTER_CSC_REGS	26
+
+/* Sampling frequency codes of register 0x15[7:4] (IEC 60958-3) */
+#define TRANSMITTER_FS_32KHZ	0x3
+#define TRANSMITTER_FS_44KHZ	0x0
+#define TRANSMITTER_FS_48KHZ	0x2
+#define TRANSMITTER_FS_88KHZ	0x8
+#define TRANSMITTER_FS_96KHZ	0xA
+#define TRANSMITTER_FS_176KHZ	0xC
+#define TRANSMITTER_FS_192KHZ	0xE
+
+/* N (0x01-0x03), CTS (0x07-0x09), CTS select (0x0A[7]) and sampling
+   frequency (0x15[7:4]) of a pixel clock and audio rate. The measured CTS
+   registers 0x04-0x06 are left alone; they only keep the run consecutive. */
+#define TRANSMITTER_ACR(N, CTS, Manual, Fs)	{				\
+	{0x01, 0x0F, (UCHAR)(((N) >> 16) & 0x0F)},				\
+	{0x02, 0xFF, (UCHAR)(((N) >> 8) & 0xFF)},				\
+	{0x03, 0xFF, (UCHAR)((N) & 0xFF)},						\
+	{0x04, 0x00, 0x00},										\
+	{0x05, 0x00, 0x00},										\
+	{0x06, 0x00, 0x00},										\
+	{0x07, 0x0F, (UCHAR)(((CTS) >> 16) & 0x0F)},			\
+	{0x08, 0xFF, (UCHAR)(((CTS) >> 8) & 0xFF)},				\
+	{0x09, 0xFF, (UCHAR)((CTS) & 0xFF)},					\
+	{0x0A, 0x80, (Manual) ? 0x80 : 0x00},					\
+	{0x15, 0xF0, (UCHAR)((Fs) << 4)}						\
+}
+
+/* One 13-bit two's complement CSC coefficient, at its upper register */
+#define TRANSMITTER_CSC_COEF(Reg, Coef)						\
+	{(Reg), 0x1F, (UCHAR)(((Coef) >> 8) & 0x1F)},			\
+	{(Reg) + 1, 0xFF, (UCHAR)((Coef) & 0xFF)}
+
+/* CSC coefficients in the +/-4.0 scaling mode (0x18[6:5] = 2): A1-A3 are
+   multiplied by 1024, the A4 offset by 4. The update mode bit (0x1A[5])
+   holds the previous set in use until all coefficients are written. A1 is
+   written with the enable and the scaling mode bits. */
+#define TRANSMITTER_CSC(A1, A2, A3, A4, B1, B2, B3, B4, C1, C2, C3, C4) {	\
+	{0x1A, 0x20, 0x20},										\
+	{0x18, 0xFF, (UCHAR)(0xC0 | (((A1) >> 8) & 0x1F))},		\
+	{0x19, 0xFF, (UCHAR)((A1) & 0xFF)},						\
+	TRANSMITTER_CSC_COEF(0x1A, A2),							\
+	TRANSMITTER_CSC_COEF(0x1C, A3),							\
+	TRANSMITTER_CSC_COEF(0x1E, A4),							\
+	TRANSMITTER_CSC_COEF(0x20, B1),							\
+	TRANSMITTER_CSC_COEF(0x22, B2),							\
+	TRANSMITTER_CSC_COEF(0x24, B3),							\
+	TRANSMITTER_CSC_COEF(0x26, B4),							\
+	TRANSMITTER_CSC_COEF(0x28, C1),							\
+	TRANSMITTER_CSC_COEF(0x2A, C2),							\
+	TRANSMITTER_CSC_COEF(0x2C, C3),							\
+	TRANSMITTER_CSC_COEF(0x2E, C4),							\
+	{0x1A, 0x20, 0x00}										\
+}
+
+/******************************************************************************/
+/************************** Types Declarations ********************************/
+/******************************************************************************/
+typedef enum
+{
+    MODE_XMT,           /* Transmitter mode */
+    MODE_NONE,          /* None */
+    MODE_INVALID        /* Invalid value, for internal use only */
+}TRANSMITTER_OPER_MODE;
+
+typedef enum
+{
+    REP_POWER_DOWN,
+    REP_POWER_UP
+} TRANSMITTER_POWER_MODE;
+
+typedef enum
+{
+    AUD_IN_I2S0,
+    AUD_IN_I2S1,
+    AUD_IN_I2S2,
+    AUD_IN_I2S3,
+    AUD_IN_I2S,
+    AUD_IN_SPDIF,
+    AUD_IN_DSD0,
+    AUD_IN_DSD1,
+    AUD_IN_DSD2,
+    AUD_IN_DSD3,
+    AUD_IN_DSD4,
+    AUD_IN_DSD5,
+    AUD_IN_DSD6,
+    AUD_IN_DSD7,
+    AUD_IN_DSD,
+    AUD_IN_DST,
+    AUD_IN_ALL
+} TRANSMITTER_AUD_INTERFACE;
+
+typedef enum
+{
+    OUT_MODE_HDMI,
+    OUT_MODE_DVI
+}TRANSMITTER_OUTPUT_MODE;
+
+typedef struct
+{
+    BOOL						Changed;
+    TRANSMITTER_OPER_MODE		Mode;
+    TRANSMITTER_POWER_MODE		PowerMode;
+    TRANSMITTER_OUTPUT_MODE		ReqOutputMode;
+    UCHAR						InPixelBitsPerColor;
+    TX_IN_FORMAT				InPixelFormat;
+    UCHAR						InPixelStyle;
+    TX_CHAN_ALIGN				InPixelAlignment;
+    TX_OUT_ENCODING				OutPixelEncFormat;
+    TX_CS_MODE					InColorSpace;
+    TX_CS_MODE					OutColorSpace;
+    unsigned long				PixelClk;
+    TX_AUD_FS					AudSampFreq;
+    TRANSMITTER_AUD_INTERFACE	AudInterface;
+    UINT16						DebugControl;
+} TRANSMITTER_OPER_PARAMS;
+
+typedef struct
+{
+    BOOL    Hpd;
+    BOOL    Msen;
+}TX_STATUS_PKT;
+
+typedef struct
+{
+    UCHAR   Reg;        /* Register address */
+    UCHAR   Mask;       /* Bits of the register written, 0xFF for all */
+    UCHAR   Value;      /* Value of the bits, in place */
+}TRANSMITTER_REG;
+
+typedef struct
+{
+    unsigned long   PixelClk;   /* Pixel clock in Hz */
+    TRANSMITTER_REG Acr[TRANSMITTER_ACR_RATES][TRANSMITTER_ACR_REGS];
+}TRANSMITTER_ACR_SET;
+
+typedef struct
+{
+    TX_CS_MODE      In;         /* Color space of the input pixel data */
+    TX_CS_MODE      Out;        /* Color space sent to the sink */
+    TRANSMITTER_REG Regs[TRANSMITTER_CSC_REGS];
+}TRANSMITTER_CSC_SET;
+
+#endif
@@ -0,0 +1,235 @@
+/***************************************************************************//**
+ *   @file   cf_hdmi_image.c
+********************************************************************************
+ * Copyright 2013(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+********************************************************************************
+ *   SVN Revision: $WCREV$
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "cf_hdmi_image.h"
+#include "cf_hdmi_image_data.h"
+
+/******************************************************************************/
+/************************** Macros Definitions ********************************/
+/******************************************************************************/
+#define LZ4_MAGIC			0x184D2204
+#define LZ4_FLG_VERSION		0x40
+#define LZ4_FLG_BLOCK_CSUM	(1 << 4)
+#define LZ4_FLG_SIZE		(1 << 3)
+#define LZ4_FLG_DICT_ID		(1 << 0)
+#define LZ4_BLOCK_RAW		(1 << 31)
+#define LZ4_MIN_MATCH		4
+
+/***************************************************************************//**
+ * @brief Reads a little endian 32 bit value.
+ *
+ * @param src - pointer to the value
+ *
+ * @return Returns the value.
+*******************************************************************************/
+static u32 LZ4Read32(const u8 *src)
+{
+	return src[0] | (src[1] << 8) | (src[2] << 16) | ((u32)src[3] << 24);
+}
+
+/***************************************************************************//**
+ * @brief Reads the extension bytes of an LZ4 literal or match length.
+ *
+ * @param src - pointer to the read pointer, advanced past the bytes
+ * @param end - end of the block
+ * @param len - the length from the token
+ *
+ * @return Returns the full length.
+*******************************************************************************/
+static u32 LZ4ReadLength(const u8 **src, const u8 *end, u32 len)
+{
+	u8 b;
+
+	if (len == 15)
+	{
+		do
+		{
+			b = (*src < end) ? *(*src)++ : 0;
+			len += b;
+		} while (b == 255);
+	}
+
+	return len;
+}
+
+/***************************************************************************//**
+ * @brief Decodes an LZ4 block. The matches are copied from the output, so the
+ *        output of the previous blocks is the history of the linked blocks.
+ *        Word aligned matches at least one word back, which is the case of
+ *        the pixel runs, are copied a word at a time.
+ *
+ * @param base - start of the output buffer
+ * @param dst - where the block is written
+ * @param limit - end of the output buffer
+ * @param src - the block
+ * @param size - size of the block
+ *
+ * @return Returns the end of the block output or 0 if the block is not valid.
+*******************************************************************************/
+static u8 *LZ4DecodeBlock(u8 *base, u8 *dst, u8 *limit,
+						  const u8 *src, u32 size)
+{
+	const u8 *end = src + size;
+	const u8 *ref;
+	u32 token;
+	u32 offset;
+	u32 len;
+
+	while (src < end)
+	{
+		token = *src++;
+		len = LZ4ReadLength(&src, end, token >> 4);
+		if ((len > (u32)(end - src)) || (len > (u32)(limit - dst)))
+		{
+			return 0;
+		}
+		while (len--)
+		{
+			*dst++ = *src++;
+		}
+		/* The last sequence only has literals */
+		if (src >= end)
+		{
+			break;
+		}
+
+		offset = src[0] | (src[1] << 8);
+		src += 2;
+		if ((offset == 0) || (offset > (u32)(dst - base)))
+		{
+			return 0;
+		}
+		ref = dst - offset;
+		len = LZ4ReadLength(&src, end, token & 15) + LZ4_MIN_MATCH;
+		if (len > (u32)(limit - dst))
+		{
+			return 0;
+		}
+		if ((offset >= 4) && ((((u32)dst | (u32)ref) & 3) == 0))
+		{
+			for (; len >= 4; len -= 4)
+			{
+				*(u32 *)dst = *(const u32 *)ref;
+				dst += 4;
+				ref += 4;
+			}
+		}
+		while (len--)
+		{
+			*dst++ = *ref++;
+		}
+	}
+
+	return dst;
+}
+
+/***************************************************************************//**
+ * @brief Decodes the demo image into a frame buffer. The image is stored as
+ *        an LZ4 frame of 32 bit pixels and is decoded straight into the frame
+ *        buffer, through the data cache; the caller flushes the frame buffer
+ *        before the VDMA reads it.
+ *
+ * @param address - start address of the frame buffer, 4 byte aligned
+ * @param size - size of the frame buffer in bytes
+ *
+ * @return Returns the number of bytes written or 0 if the image is not valid.
+*******************************************************************************/
+u32 ImageDecode(u32 address, u32 size)
+{
+	const u8 *src = IMG_LZ4;
+	const u8 *end = IMG_LZ4 + IMG_LZ4_LENGTH;
+	u8 *base = (u8 *)address;
+	u8 *dst = base;
+	u8 *limit = base + size;
+	u32 block;
+	u32 flg;
+	u32 len;
+
+	if ((IMG_LZ4_LENGTH < 7) || (LZ4Read32(src) != LZ4_MAGIC))
+	{
+		return 0;
+	}
+	flg = src[4];
+	if ((flg & 0xc0) != LZ4_FLG_VERSION)
+	{
+		return 0;
+	}
+	src += 7 + ((flg & LZ4_FLG_SIZE) ? 8 : 0) + ((flg & LZ4_FLG_DICT_ID) ? 4 : 0);
+
+	while ((end - src) >= 4)
+	{
+		block = LZ4Read32(src);
+		src += 4;
+		if (block == 0)
+		{
+			break;
+		}
+		len = block & ~LZ4_BLOCK_RAW;
+		if (len > (u32)(end - src))
+		{
+			return 0;
+		}
+		if (block & LZ4_BLOCK_RAW)
+		{
+			if (len > (u32)(limit - dst))
+			{
+				return 0;
+			}
+			for (block = 0; block < len; block++)
+			{
+				*dst++ = src[block];
+			}
+		}
+		else
+		{
+			dst = LZ4DecodeBlock(base, dst, limit, src, len);
+			if (!dst)
+			{
+				return 0;
+			}
+		}
+		src += len + ((flg & LZ4_FLG_BLOCK_CSUM) ? 4 : 0);
+	}
+
+	return dst - base;
+}
@@ -45,10 +45,77 @@
 #include "xil_io.h"
 #include "xparameters.h"
 #include "cf_hdmi.h"
-#include "cf_hdmi_demo.h"
+#include "cf_hdmi_image.h"
+#include "xil_cache.h"
 
 void xil_printf(const char *ctrl1, ...);
 
+/* Frame store the VDMA is parked on */
+static u32 video_park_frame = 0;
+/* Size in bytes of the active part of a frame store */
+static u32 video_frame_size = 0;
+/* Pixel format of the frame stores */
+static VIDEO_FORMAT video_format = VIDEO_FMT_ARGB8888;
+/* Distance in bytes between two lines of a frame store */
+static u32 video_line_stride = 0;
+/* Descriptor of the period the producer fills */
+static u32 audio_head = 0;
+/* Oldest descriptor owned by the DMA */
+static u32 audio_tail = 0;
+/* Samples written in the period of the head descriptor */
+static u32 audio_fill = 0;
+/* Periods submitted to the DMA and periods completed by it */
+static u32 audio_submitted = 0;
+static u32 audio_completed = 0;
+/* Times the DMA ran out of submitted periods */
+static u32 audio_underruns = 0;
+/* One period of the click tone */
+static u32 audio_click[AUDIO_LENGTH];
+
+/***************************************************************************//**
+ * @brief Fills a DDR buffer with a 32 bit value. The buffer is written with
+ *        plain 64 bit stores, four per loop iteration, so the writes go
+ *        through the data cache and reach DDR in cache line bursts; the
+ *        caller flushes the buffer once it is complete, before a DMA reads it.
+ *
+ * @param address - start address of the buffer, 4 byte aligned
+ * @param value - the value of each word
+ * @param count - number of words
+ *
+ * @return None.
+*******************************************************************************/
+static void DDRFill(u32 address, u32 value, u32 count)
+{
+	u32 *dst = (u32 *)address;
+	unsigned long long *dst64;
+	unsigned long long value64;
+	u32 n;
+
+	if ((address & 0x4) && count)
+	{
+		*dst++ = value;
+		count--;
+	}
+	dst64 = (unsigned long long *)dst;
+	value64 = ((unsigned long long)value << 32) | value;
+	for (n = 0; n < (count / 8); n++)
+	{
+		dst64[0] = value64;
+		dst64[1] = value64;
+		dst64[2] = value64;
+		dst64[3] = value64;
+		dst64 += 4;
+	}
+	for (n = 0; n < ((count / 2) & 3); n++)
+	{
+		*dst64++ = value64;
+	}
+	if (count & 1)
+	{
+		dst[count - 1] = value;
+	}
+}
+
 /***************************************************************************//**
  * @brief DDR write.
  *
@@ -56,55 +123,210 @@ void xil_printf(const char *ctrl1, ...);
 *******************************************************************************/
 void DDRVideoWr(void)
 {
-	u32 n;
-	u32 d;
 	u32 dcnt;
 
-	dcnt = 0;
-	xil_printf("DDR write: started (length %d)\n\r", IMG_LENGTH);
-	for (n = 0; n < IMG_LENGTH; n++)
+	xil_printf("DDR write: started (length %d)\n\r", IMG_SIZE);
+	dcnt = ImageDecode(VIDEO_BASEADDR, IMG_SIZE);
+	if (video_format != VIDEO_FMT_ARGB8888)
 	{
-		for (d = 0; d < ((IMG_DATA[n]>>24) & 0xff); d++)
-		{
-			Xil_Out32((VIDEO_BASEADDR+(dcnt*4)), (IMG_DATA[n] & 0xffffff));
-			dcnt = dcnt + 1;
-		}
+		dcnt = VideoConvertPixels(VIDEO_BASEADDR, (u32 *)VIDEO_BASEADDR,
+								  dcnt / 4);
 	}
+	Xil_DCacheFlushRange(VIDEO_BASEADDR, dcnt);
 	xil_printf("DDR write: completed (total %d)\n\r", dcnt);
 }
 
 /***************************************************************************//**
- * @brief DDR write.
+ * @brief Gets the address of an audio DMA descriptor.
+ *
+ * @param n - the descriptor, 0 to AUDIO_PERIODS - 1
+ *
+ * @return Returns the address of the descriptor.
+*******************************************************************************/
+static u32 AudioDescAddress(u32 n)
+{
+	return AUDIO_BASEADDR + (n * AUDIO_DESC_SIZE);
+}
+
+/***************************************************************************//**
+ * @brief Gets the address of the period buffer of an audio DMA descriptor.
+ *
+ * @param n - the descriptor, 0 to AUDIO_PERIODS - 1
+ *
+ * @return Returns the address of the period buffer.
+*******************************************************************************/
+static u32 AudioBufferAddress(u32 n)
+{
+	return AUDIO_BUF_BASEADDR + (n * AUDIO_PERIOD_LENGTH * 4);
+}
+
+/***************************************************************************//**
+ * @brief Builds the audio DMA descriptor ring. Each descriptor points to its
+ *        own period buffer and to the next descriptor; the addresses are
+ *        written once here and the descriptors are then recycled, only their
+ *        control and status words change while streaming.
  *
  * @return None.
 *******************************************************************************/
 void DDRAudioWr(void)
 {
-	u32 n;
-	u32 scnt;
-	u32 sincr;
+	u32 *desc;
+	u32 n     = 0;
+	u32 scnt  = 0;
+	u32 sincr = 0;
+
+	DDRFill(AUDIO_BASEADDR, 0x00, (AUDIO_PERIODS * AUDIO_DESC_SIZE) / 4); // init descriptors
+	for (n = 0; n < AUDIO_PERIODS; n++)
+	{
+		desc = (u32 *)AudioDescAddress(n);
+		desc[AXI_DMA_DESC_NXTDESC/4] = AudioDescAddress((n + 1) % AUDIO_PERIODS); // next descriptor
+		desc[AXI_DMA_DESC_BUFFER/4] = AudioBufferAddress(n); // start address
+	}
+	Xil_DCacheFlushRange(AUDIO_BASEADDR, (AUDIO_PERIODS * AUDIO_DESC_SIZE));
+	audio_head = 0;
+	audio_tail = 0;
+	audio_fill = 0;
+	audio_submitted = 0;
+	audio_completed = 0;
+	audio_underruns = 0;
 
-	xil_printf("DDR audio write: started\n\r");
-	scnt = 0;
 	sincr = (65536*2)/AUDIO_LENGTH;
-	for (n = 0; n < 32; n++)
-	{
-		Xil_Out32((AUDIO_BASEADDR+(n*4)), 0x00); // init descriptors
-	}
-	Xil_Out32((AUDIO_BASEADDR+0x00), (AUDIO_BASEADDR + 0x40)); // next descriptor
-	Xil_Out32((AUDIO_BASEADDR+0x08), (AUDIO_BASEADDR + 0x80)); // start address
-	Xil_Out32((AUDIO_BASEADDR+0x40), (AUDIO_BASEADDR + 0x00)); // next descriptor
-	Xil_Out32((AUDIO_BASEADDR+0x48), (AUDIO_BASEADDR + 0x80)); // start address
-	Xil_Out32((AUDIO_BASEADDR+0x18), (0x8000000 | (AUDIO_LENGTH*8))); // no. of bytes
-	Xil_Out32((AUDIO_BASEADDR+0x58), (0x4000000 | (AUDIO_LENGTH*8))); // no. of bytes
-	Xil_Out32((AUDIO_BASEADDR+0x1c), 0x00); // status
-	Xil_Out32((AUDIO_BASEADDR+0x5c), 0x00); // status
 	for (n = 0; n < AUDIO_LENGTH; n++)
 	{
-		Xil_Out32((AUDIO_BASEADDR+0x80+(n*4)), ((scnt << 16) | scnt));
+		audio_click[n] = ((scnt << 16) | scnt);
 		scnt = (n > (AUDIO_LENGTH/2)) ? (scnt-sincr) : (scnt+sincr);
 	}
-	xil_printf("DDR audio write: completed (total %d)\n\r", AUDIO_LENGTH);
+}
+
+/***************************************************************************//**
+ * @brief Hands the period of the head descriptor to the DMA. The period and
+ *        the control and status words of its descriptor are flushed, then
+ *        the descriptor becomes the DMA tail.
+ *
+ * @return None.
+*******************************************************************************/
+static void AudioSubmit(void)
+{
+	u32 desc = AudioDescAddress(audio_head);
+
+	Xil_DCacheFlushRange(AudioBufferAddress(audio_head), (audio_fill * 4));
+	Xil_Out32((desc + AXI_DMA_DESC_CONTROL), (0xc000000 | (audio_fill * 4))); // sof, eof & no. of bytes
+	Xil_Out32((desc + AXI_DMA_DESC_STATUS), 0x00); // status
+	Xil_DCacheFlushRange((desc + AXI_DMA_DESC_CONTROL), 8);
+	audio_head = (audio_head + 1) % AUDIO_PERIODS;
+	audio_fill = 0;
+	audio_submitted++;
+	Xil_Out32((ADMA_BASEADDR + AXI_DMA_REG_MM2S_TAILDESC), desc); // tail descr.
+}
+
+/***************************************************************************//**
+ * @brief Returns the descriptors completed by the DMA to the producer. The
+ *        completed bit of the status word of each descriptor owned by the
+ *        DMA is checked, oldest first; only the status words are invalidated
+ *        in the data cache.
+ *
+ * @return None.
+*******************************************************************************/
+static void AudioReclaim(void)
+{
+	u32 desc;
+	u32 done = 0;
+
+	while (audio_completed != audio_submitted)
+	{
+		desc = AudioDescAddress(audio_tail);
+		Xil_DCacheInvalidateRange((desc + AXI_DMA_DESC_STATUS), 4);
+		if ((Xil_In32(desc + AXI_DMA_DESC_STATUS) & 0x80000000) == 0) // not completed
+		{
+			break;
+		}
+		audio_tail = (audio_tail + 1) % AUDIO_PERIODS;
+		audio_completed++;
+		done++;
+	}
+	if (done && (audio_completed == audio_submitted))
+	{
+		audio_underruns++;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Queues audio samples. The samples are copied into the free periods
+ *        of the ring and each full period is handed to the DMA; the call does
+ *        not wait for free periods.
+ *
+ * @param samples - the samples, one 32 bit word (left and right) per sample
+ * @param count - number of samples
+ *
+ * @return Returns the number of samples queued.
+*******************************************************************************/
+u32 AudioWrite(const u32 *samples, u32 count)
+{
+	u32 *buf;
+	u32 done = 0;
+	u32 n;
+
+	AudioReclaim();
+	while ((done < count) &&
+		   ((audio_submitted - audio_completed) < AUDIO_PERIODS))
+	{
+		buf = (u32 *)AudioBufferAddress(audio_head) + audio_fill;
+		n = AUDIO_PERIOD_LENGTH - audio_fill;
+		if (n > (count - done))
+		{
+			n = count - done;
+		}
+		audio_fill += n;
+		while (n--)
+		{
+			*buf++ = samples[done++];
+		}
+		if (audio_fill == AUDIO_PERIOD_LENGTH)
+		{
+			AudioSubmit();
+		}
+	}
+
+	return done;
+}
+
+/***************************************************************************//**
+ * @brief Hands a partly filled period to the DMA, so the queued samples are
+ *        played without waiting for the period to fill.
+ *
+ * @return None.
+*******************************************************************************/
+void AudioFlush(void)
+{
+	AudioReclaim();
+	if ((audio_fill != 0) &&
+		((audio_submitted - audio_completed) < AUDIO_PERIODS))
+	{
+		AudioSubmit();
+	}
+}
+
+/***************************************************************************//**
+ * @brief Gets the number of samples AudioWrite can queue without waiting.
+ *
+ * @return Returns the number of free samples.
+*******************************************************************************/
+u32 AudioGetFree(void)
+{
+	AudioReclaim();
+
+	return ((AUDIO_PERIODS - (audio_submitted - audio_completed)) *
+			AUDIO_PERIOD_LENGTH) - audio_fill;
+}
+
+/***************************************************************************//**
+ * @brief Gets the number of times the DMA ran out of submitted periods.
+ *
+ * @return Returns the number of underruns.
+*******************************************************************************/
+u32 AudioGetUnderruns(void)
+{
+	return audio_underruns;
 }
 
 /***************************************************************************//**
@@ -116,12 +338,16 @@ void InitHdmiVideoPcore(void)
 {
 	DDRVideoWr();
 
-	Xil_Out32((VDMA_BASEADDR + 0x000), 0x3); // enable circular mode
-	Xil_Out32((VDMA_BASEADDR + 0x05c), VIDEO_BASEADDR); // start address
-	Xil_Out32((VDMA_BASEADDR + 0x060), VIDEO_BASEADDR); // start address
-	Xil_Out32((VDMA_BASEADDR + 0x064), VIDEO_BASEADDR); // start address
-	Xil_Out32((VDMA_BASEADDR + 0x058), (H_STRIDE*4)); // h offset (2048 * 4) bytes
-	Xil_Out32((VDMA_BASEADDR + 0x054), (H_ACTIVE*4)); // h size (1920 * 4) bytes
+	video_line_stride = H_STRIDE*VideoBytesPerPixel(video_format);
+	video_frame_size = video_line_stride*V_ACTIVE;
+	video_park_frame = 0;
+	Xil_Out32((VDMA_BASEADDR + 0x028), 0); // park on the first frame store
+	Xil_Out32((VDMA_BASEADDR + 0x000), 0x1); // enable park mode
+	Xil_Out32((VDMA_BASEADDR + 0x05c), VideoFrameAddress(0)); // start address
+	Xil_Out32((VDMA_BASEADDR + 0x060), VideoFrameAddress(1)); // start address
+	Xil_Out32((VDMA_BASEADDR + 0x064), VideoFrameAddress(2)); // start address
+	Xil_Out32((VDMA_BASEADDR + 0x058), video_line_stride); // h offset (2048 * bytes per pixel)
+	Xil_Out32((VDMA_BASEADDR + 0x054), (H_ACTIVE*VideoBytesPerPixel(video_format))); // h size (1920 * bytes per pixel)
 	Xil_Out32((VDMA_BASEADDR + 0x050), V_ACTIVE); // v size (1080)
 
 	Xil_Out32((CFV_BASEADDR + 0x08), ((H_ACTIVE << 16) | H_TOTAL)); // v2h, h-de parameters
@@ -129,6 +355,302 @@ void InitHdmiVideoPcore(void)
 	Xil_Out32((CFV_BASEADDR + 0x04), 0x1); // v2h, enable, csc-bypass & tpg
 }
 
+/***************************************************************************//**
+ * @brief Gets the start address of a frame store.
+ *
+ * @param frame - the frame store, 0 to VIDEO_FRAMES - 1
+ *
+ * @return Returns the start address of the frame store.
+*******************************************************************************/
+u32 VideoFrameAddress(u32 frame)
+{
+	return VIDEO_BASEADDR + (frame * VIDEO_FRAME_STRIDE);
+}
+
+/***************************************************************************//**
+ * @brief Gets a frame store to render the next frame in. The frame store is
+ *        neither the one the VDMA is reading nor the one a pending flip parks
+ *        it on, so it can be written while the two others are in use.
+ *
+ * @return Returns the frame store.
+*******************************************************************************/
+u32 VideoGetBackFrame(void)
+{
+	u32 current;
+	u32 frame;
+
+	current = (Xil_In32(VDMA_BASEADDR + 0x028) >> 16) & 0x1f;
+	for (frame = 0; frame < (VIDEO_FRAMES - 1); frame++)
+	{
+		if ((frame != current) && (frame != video_park_frame))
+		{
+			break;
+		}
+	}
+
+	return frame;
+}
+
+/***************************************************************************//**
+ * @brief Shows a rendered frame store. The frame store is flushed from the
+ *        data cache and the VDMA is parked on it; the VDMA only changes frame
+ *        stores at a frame start, so the new frame replaces the old one at
+ *        vsync, without tearing.
+ *
+ * @param frame - the frame store, as returned by VideoGetBackFrame
+ *
+ * @return None.
+*******************************************************************************/
+void VideoFlip(u32 frame)
+{
+	Xil_DCacheFlushRange(VideoFrameAddress(frame), video_frame_size);
+	video_park_frame = frame;
+	Xil_Out32((VDMA_BASEADDR + 0x028), frame); // park pointer
+}
+
+/***************************************************************************//**
+ * @brief Waits until the VDMA reads the frame store of the last flip.
+ *
+ * @return Returns 0 once the frame is displayed or -1 on timeout.
+*******************************************************************************/
+int VideoWaitFlip(void)
+{
+	u32 timeout = VIDEO_FLIP_TIMEOUT;
+
+	while (((Xil_In32(VDMA_BASEADDR + 0x028) >> 16) & 0x1f) !=
+		   video_park_frame)
+	{
+		if (--timeout == 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Selects the pixel format of the frame stores. The format is applied
+ *        by the next call of InitHdmiVideoPcore, and the HDMI core has to be
+ *        built for the same format.
+ *
+ * @param format - the pixel format:
+ *                 VIDEO_FMT_ARGB8888 - 32 bit word per pixel, 0x00RRGGBB
+ *                 VIDEO_FMT_RGB888   - 3 bytes per pixel, blue byte first
+ *                 VIDEO_FMT_RGB565   - 16 bit per pixel, RRRRRGGGGGGBBBBB
+ *                 VIDEO_FMT_YCBCR422 - 16 bit per pixel, Y in the low byte,
+ *                                      Cb (even pixels) or Cr (odd pixels)
+ *                                      in the high byte
+ *
+ * @return None.
+*******************************************************************************/
+void VideoSetFormat(VIDEO_FORMAT format)
+{
+	video_format = format;
+}
+
+/***************************************************************************//**
+ * @brief Gets the pixel format of the frame stores.
+ *
+ * @return Returns the pixel format.
+*******************************************************************************/
+VIDEO_FORMAT VideoGetFormat(void)
+{
+	return video_format;
+}
+
+/***************************************************************************//**
+ * @brief Gets the number of bytes a pixel takes in a frame store.
+ *
+ * @param format - the pixel format
+ *
+ * @return Returns the number of bytes per pixel.
+*******************************************************************************/
+u32 VideoBytesPerPixel(VIDEO_FORMAT format)
+{
+	switch (format)
+	{
+		case VIDEO_FMT_RGB888:
+			return 3;
+		case VIDEO_FMT_RGB565:
+		case VIDEO_FMT_YCBCR422:
+			return 2;
+		default:
+			return 4;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Converts a 0x00RRGGBB color to BT.601 limited range YCbCr.
+ *
+ * @param rgb - the color
+ *
+ * @return Returns the color as 0x00YYCbCr.
+*******************************************************************************/
+static u32 VideoRgbToYCbCr(u32 rgb)
+{
+	u32 r = (rgb >> 16) & 0xff;
+	u32 g = (rgb >> 8) & 0xff;
+	u32 b = rgb & 0xff;
+	u32 y;
+	u32 cb;
+	u32 cr;
+
+	y  = ((66 * r) + (129 * g) + (25 * b) + 4224) >> 8;
+	cb = ((112 * b) + 32896 - (38 * r) - (74 * g)) >> 8;
+	cr = ((112 * r) + 32896 - (94 * g) - (18 * b)) >> 8;
+
+	return (y << 16) | (cb << 8) | cr;
+}
+
+/***************************************************************************//**
+ * @brief Writes one pixel at a frame store address in the selected format.
+ *
+ * @param dst - address of the pixel
+ * @param x - column of the pixel, selects Cb or Cr in YCbCr 4:2:2
+ * @param rgb - the color, 0x00RRGGBB
+ *
+ * @return None.
+*******************************************************************************/
+static void VideoWritePixel(u8 *dst, u32 x, u32 rgb)
+{
+	u32 ycc;
+
+	switch (video_format)
+	{
+		case VIDEO_FMT_RGB888:
+			dst[0] = rgb & 0xff;
+			dst[1] = (rgb >> 8) & 0xff;
+			dst[2] = (rgb >> 16) & 0xff;
+			break;
+		case VIDEO_FMT_RGB565:
+			*(u16 *)dst = ((rgb >> 8) & 0xf800) |
+						  ((rgb >> 5) & 0x07e0) |
+						  ((rgb >> 3) & 0x001f);
+			break;
+		case VIDEO_FMT_YCBCR422:
+			ycc = VideoRgbToYCbCr(rgb);
+			dst[0] = (ycc >> 16) & 0xff;
+			dst[1] = (x & 1) ? (ycc & 0xff) : ((ycc >> 8) & 0xff);
+			break;
+		default:
+			*(u32 *)dst = rgb;
+			break;
+	}
+}
+
+/***************************************************************************//**
+ * @brief Converts a line of 0x00RRGGBB pixels to the selected format. The
+ *        output may overlap the input as long as it does not start after
+ *        it, so an image can be converted in place. In YCbCr 4:2:2 the two
+ *        pixels of a pair share the average of their chroma.
+ *
+ * @param dst - address of the output
+ * @param src - the input pixels
+ * @param count - number of pixels
+ *
+ * @return Returns the number of bytes written.
+*******************************************************************************/
+u32 VideoConvertPixels(u32 dst, const u32 *src, u32 count)
+{
+	u8  *out = (u8 *)dst;
+	u32 bpp  = VideoBytesPerPixel(video_format);
+	u32 ycc0;
+	u32 ycc1;
+	u32 cb;
+	u32 cr;
+	u32 n;
+
+	if (video_format == VIDEO_FMT_YCBCR422)
+	{
+		for (n = 0; (n + 1) < count; n += 2)
+		{
+			ycc0 = VideoRgbToYCbCr(src[n]);
+			ycc1 = VideoRgbToYCbCr(src[n + 1]);
+			cb = ((((ycc0 >> 8) & 0xff) + ((ycc1 >> 8) & 0xff)) + 1) >> 1;
+			cr = (((ycc0 & 0xff) + (ycc1 & 0xff)) + 1) >> 1;
+			out[0] = (ycc0 >> 16) & 0xff;
+			out[1] = cb;
+			out[2] = (ycc1 >> 16) & 0xff;
+			out[3] = cr;
+			out += 4;
+		}
+		if (n < count)
+		{
+			VideoWritePixel(out, n, src[n]);
+		}
+	}
+	else
+	{
+		for (n = 0; n < count; n++)
+		{
+			VideoWritePixel(out, n, src[n]);
+			out += bpp;
+		}
+	}
+
+	return count * bpp;
+}
+
+/***************************************************************************//**
+ * @brief Draws a pixel in a frame store.
+ *
+ * @param frame - the frame store
+ * @param x - column of the pixel
+ * @param y - line of the pixel
+ * @param rgb - the color, 0x00RRGGBB
+ *
+ * @return None.
+*******************************************************************************/
+void VideoPutPixel(u32 frame, u32 x, u32 y, u32 rgb)
+{
+	u32 address;
+
+	address = VideoFrameAddress(frame) + (y * video_line_stride) +
+			  (x * VideoBytesPerPixel(video_format));
+	VideoWritePixel((u8 *)address, x, rgb);
+}
+
+/***************************************************************************//**
+ * @brief Fills a rectangle of a frame store with a color.
+ *
+ * @param frame - the frame store
+ * @param x - first column of the rectangle
+ * @param y - first line of the rectangle
+ * @param width - number of columns
+ * @param height - number of lines
+ * @param rgb - the color, 0x00RRGGBB
+ *
+ * @return None.
+*******************************************************************************/
+void VideoFillRect(u32 frame, u32 x, u32 y, u32 width, u32 height, u32 rgb)
+{
+	u32 bpp = VideoBytesPerPixel(video_format);
+	u32 address;
+	u32 line;
+	u32 n;
+	u8  *dst;
+
+	address = VideoFrameAddress(frame) + (y * video_line_stride) + (x * bpp);
+	for (line = 0; line < height; line++)
+	{
+		if (video_format == VIDEO_FMT_ARGB8888)
+		{
+			DDRFill(address, rgb, width);
+		}
+		else
+		{
+			dst = (u8 *)address;
+			for (n = 0; n < width; n++)
+			{
+				VideoWritePixel(dst, x + n, rgb);
+				dst += bpp;
+			}
+		}
+		address += video_line_stride;
+	}
+}
+
 /***************************************************************************//**
  * @brief Initialize the HDMI Audio Pcore.
  *
@@ -138,6 +660,10 @@ void InitHdmiAudioPcore(void)
 {
 	DDRAudioWr();
 
+	Xil_Out32((ADMA_BASEADDR + AXI_DMA_REG_MM2S_DMACR), 0); // clear dma operations
+	Xil_Out32((ADMA_BASEADDR + AXI_DMA_REG_MM2S_CURDESC), AudioDescAddress(0)); // head descr.
+	Xil_Out32((ADMA_BASEADDR + AXI_DMA_REG_MM2S_DMACR), 0x00000001); // enable dma operations, completions are polled
+
 	Xil_Out32((CFA_BASEADDR + 0x04), 0x040); // sample frequency
 	Xil_Out32((CFA_BASEADDR + 0x00), 0xc03); // clock ratio, data enable & signal enable
 }
@@ -149,11 +675,7 @@ void InitHdmiAudioPcore(void)
 *******************************************************************************/
 void AudioClick(void)
 {
-    /* Generating audio clicks. */
-    Xil_Out32((AUDIO_BASEADDR+0x1c), 0x00); // status
-    Xil_Out32((AUDIO_BASEADDR+0x5c), 0x00); // status
-    Xil_Out32((ADMA_BASEADDR + 0x00), 0); // clear dma operations
-    Xil_Out32((ADMA_BASEADDR + 0x08), AUDIO_BASEADDR); // head descr.
-	Xil_Out32((ADMA_BASEADDR + 0x00), 1); // enable dma operations
-    Xil_Out32((ADMA_BASEADDR + 0x10), (AUDIO_BASEADDR+0x40)); // tail descr.
+	/* Generating audio clicks. */
+	AudioWrite(audio_click, AUDIO_LENGTH);
+	AudioFlush();
 }
@@ -45,6 +45,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include "xparameters.h"
+#include "xil_types.h"
 
 /******************************************************************************/
 /************************** Macros Definitions ********************************/
@@ -69,7 +70,35 @@
 #define VIDEO_LENGTH  (H_ACTIVE*V_ACTIVE)
 #define AUDIO_LENGTH  (A_SAMPLE_FREQ/A_FREQ)
 #define VIDEO_BASEADDR  DDR_BASEADDR + 0x2000000
+#define VIDEO_FRAMES        3           // frame stores, one shown, one queued, one rendered
+#define VIDEO_FRAME_STRIDE  0x800000    // distance between the frame stores
+#define VIDEO_FLIP_TIMEOUT  10000000    // polls of the VDMA park pointer
 #define AUDIO_BASEADDR  DDR_BASEADDR + 0x1000000
+#define AUDIO_PERIODS       8           // descriptors in the audio ring
+#define AUDIO_PERIOD_LENGTH 256         // samples per period
+#define AUDIO_DESC_SIZE     0x40
+#define AUDIO_BUF_BASEADDR  (AUDIO_BASEADDR + (AUDIO_PERIODS * AUDIO_DESC_SIZE))
+
+#define AXI_DMA_REG_MM2S_DMACR      0x00
+#define AXI_DMA_REG_MM2S_DMASR      0x04
+#define AXI_DMA_REG_MM2S_CURDESC    0x08
+#define AXI_DMA_REG_MM2S_TAILDESC   0x10
+
+#define AXI_DMA_DESC_NXTDESC        0x00
+#define AXI_DMA_DESC_BUFFER         0x08
+#define AXI_DMA_DESC_CONTROL        0x18
+#define AXI_DMA_DESC_STATUS         0x1c
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+typedef enum
+{
+	VIDEO_FMT_ARGB8888,
+	VIDEO_FMT_RGB888,
+	VIDEO_FMT_RGB565,
+	VIDEO_FMT_YCBCR422
+} VIDEO_FORMAT;
 
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
@@ -77,5 +106,19 @@
 void InitHdmiVideoPcore(void);
 void InitHdmiAudioPcore(void);
 void AudioClick(void);
+u32 AudioWrite(const u32 *samples, u32 count);
+void AudioFlush(void);
+u32 AudioGetFree(void);
+u32 AudioGetUnderruns(void);
+u32 VideoFrameAddress(u32 frame);
+u32 VideoGetBackFrame(void);
+void VideoFlip(u32 frame);
+int VideoWaitFlip(void);
+void VideoSetFormat(VIDEO_FORMAT format);
+VIDEO_FORMAT VideoGetFormat(void);
+u32 VideoBytesPerPixel(VIDEO_FORMAT format);
+u32 VideoConvertPixels(u32 dst, const u32 *src, u32 count);
+void VideoPutPixel(u32 frame, u32 x, u32 y, u32 rgb);
+void VideoFillRect(u32 frame, u32 x, u32 y, u32 width, u32 height, u32 rgb);
 
 #endif /* CF_HDMI_H_ */
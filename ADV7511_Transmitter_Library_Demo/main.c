@@ -48,6 +48,7 @@
 #include "cf_hdmi.h"
 #include "atv_platform.h"
 #include "transmitter.h"
+#include "xintc_l.h"
 
 void xil_printf(const char *ctrl1, ...);
 extern void delay_ms(u32 ms_count);
@@ -55,8 +56,10 @@ extern void delay_ms(u32 ms_count);
 /******************************************************************************/
 /************************** Macros Definitions ********************************/
 /******************************************************************************/
-#define HDMI_CALL_INTERVAL_MS	10  /* Interval between two         */
-                                    /* iterations of the main loop  */
+/* Define HDMI_TX_INT_ID as the interrupt ID of the ADV7511 INT line in designs
+   that route it to the interrupt controller; otherwise the transmitter interrupt
+   state is polled at the housekeeping interval. */
+/* #define HDMI_TX_INT_ID */
 #define DBG_MSG                 xil_printf
 
 /******************************************************************************/
@@ -112,6 +115,42 @@ static void APP_PrintRevisions (void)
 	DBG_MSG("********************************************************************\r\n\n\r");
 }
 
+#ifdef HDMI_TX_INT_ID
+/***************************************************************************//**
+ * @brief Masks or unmasks the ADV7511 interrupt line. The other lines of the
+ *        interrupt controller are left as they are.
+ *
+ * @return None.
+*******************************************************************************/
+static void APP_TxIrqEnable(BOOL Enable)
+{
+	u32 ier;
+
+	ier = Xil_In32(XPAR_AXI_INTC_0_BASEADDR + XIN_IER_OFFSET);
+	if (Enable)
+	{
+		ier |= (1 << HDMI_TX_INT_ID);
+	}
+	else
+	{
+		ier &= ~(1 << HDMI_TX_INT_ID);
+	}
+	Xil_Out32((XPAR_AXI_INTC_0_BASEADDR + XIN_IER_OFFSET), ier);
+}
+
+/***************************************************************************//**
+ * @brief ADV7511 interrupt handler. The line stays masked until the
+ *        transmitter service has cleared the interrupt over I2C.
+ *
+ * @return None.
+*******************************************************************************/
+static void APP_TxIrqHandler(void *Ref)
+{
+	APP_TxIrqEnable(FALSE);
+	ADIAPI_TransmitterIrqHandler(Ref);
+}
+#endif
+
 /***************************************************************************//**
  * @brief Main function.
  *
@@ -119,7 +158,6 @@ static void APP_PrintRevisions (void)
 *******************************************************************************/
 int main()
 {
-	UINT32 StartCount;
 	UINT32 data = 0;
 
 	MajorRev     = 1;
@@ -150,20 +188,28 @@ int main()
 
 	ADIAPI_TransmitterSetPowerMode(REP_POWER_UP);
 
-	StartCount = HAL_GetCurrentMsCount();
+#ifdef HDMI_TX_INT_ID
+	XIntc_RegisterHandler(XPAR_AXI_INTC_0_BASEADDR,
+						  HDMI_TX_INT_ID,
+						  APP_TxIrqHandler,
+						  NULL);
+	APP_TxIrqEnable(TRUE);
+	ADIAPI_TransmitterEnableIrq(TRUE);
+#endif
 
 	InitHdmiVideoPcore();
 	InitHdmiAudioPcore();
 
 	while(1)
 	{
-		if (ATV_GetElapsedMs (StartCount, NULL) >= HDMI_CALL_INTERVAL_MS)
+		/* The transmitter is serviced on its events only, the rest of the
+		   time is left to the application. */
+		if (ADIAPI_TransmitterEventPending() && APP_DriverEnabled())
 		{
-			StartCount = HAL_GetCurrentMsCount();
-			if (APP_DriverEnabled())
-			{
-				ADIAPI_TransmitterMain();
-			}
+			ADIAPI_TransmitterMain();
+#ifdef HDMI_TX_INT_ID
+			APP_TxIrqEnable(TRUE);
+#endif
 		}
 	}
 
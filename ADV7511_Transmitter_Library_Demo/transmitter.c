@@ -79,6 +79,8 @@ static TRANSMITTER_OPER_MODE	LastDetMode;
 static UINT32					ModeChngCount;
 TRANSMITTER_OPER_PARAMS			TransmitterParm;
 UCHAR							MuteState;
+static volatile BOOL			IrqPending;
+static BOOL						IrqConnected;
 
 /***************************************************************************//**
  * @brief Initializes the transmitter.
@@ -280,8 +282,54 @@ void TRANSMITTER_MonitorAvrMode(void)
 }
 
 /***************************************************************************//**
- * @brief Main function for polling mode operation.
- * 		  This function should be called periodically (at least every 100 ms).
+ * @brief Signals an interrupt of the transmitter. The interrupt is serviced by
+ *        the next call of ADIAPI_TransmitterMain, outside of the interrupt
+ *        context, since clearing it takes I2C transfers.
+ *
+ * @param Ref - unused.
+ *
+ * @return None.
+*******************************************************************************/
+void ADIAPI_TransmitterIrqHandler(void *Ref)
+{
+    IrqPending = TRUE;
+}
+
+/***************************************************************************//**
+ * @brief Tells the service whether the transmitter interrupt line is
+ *        connected. Without it, the interrupt state is polled at the
+ *        housekeeping interval.
+ *
+ * @param Enable - TRUE if ADIAPI_TransmitterIrqHandler is connected.
+ *
+ * @return None.
+*******************************************************************************/
+void ADIAPI_TransmitterEnableIrq(BOOL Enable)
+{
+    IrqConnected = Enable;
+}
+
+/***************************************************************************//**
+ * @brief Checks whether the transmitter has an event to service: a pending
+ *        interrupt, a parameter change or an elapsed housekeeping interval.
+ *
+ * @return Returns TRUE if ADIAPI_TransmitterMain should be called.
+*******************************************************************************/
+BOOL ADIAPI_TransmitterEventPending(void)
+{
+    if (IrqPending)
+    {
+        return TRUE;
+    }
+
+    return (TransmitterParm.PowerMode == REP_POWER_UP) && (TransmitterParm.Changed ||
+           (ATV_GetElapsedMs(HouseKeepingDelay, 0) >= TRANSMITTER_HOUSEKEEPING_DELAY));
+}
+
+/***************************************************************************//**
+ * @brief Main function of the transmitter service.
+ * 		  This function should be called when ADIAPI_TransmitterEventPending
+ * 		  returns TRUE.
  *
  * @return None.
 *******************************************************************************/
@@ -289,7 +337,6 @@ ATV_ERR ADIAPI_TransmitterMain(void)
 {
     UCHAR Events;
 
-    TRANSMITTER_MonitorAvrMode();
     Events = 0;
     if ( (TransmitterParm.PowerMode == REP_POWER_UP) && (TransmitterParm.Changed ||
         (ATV_GetElapsedMs(HouseKeepingDelay, 0) >= TRANSMITTER_HOUSEKEEPING_DELAY)))
@@ -299,10 +346,15 @@ ATV_ERR ADIAPI_TransmitterMain(void)
         HouseKeepingDelay = HAL_GetCurrentMsCount();
     }
     Events &= ADI_TASK_EVENT_TIMER;
-    if (ADIAPI_TxIntPending() == ATVERR_TRUE)
+    if (IrqPending || (!IrqConnected && (Events & ADI_TASK_EVENT_TIMER)))
     {
-        ADIAPI_TxIsr();
+        IrqPending = FALSE;
+        if (ADIAPI_TxIntPending() == ATVERR_TRUE)
+        {
+            ADIAPI_TxIsr();
+        }
     }
+    TRANSMITTER_MonitorAvrMode();
     if ((Events & ADI_TASK_EVENT_TIMER) && (TransmitterParm.PowerMode == REP_POWER_UP))
     {
     	TRANSMITTER_Housekeeping();
@@ -96,7 +96,16 @@ void ADIAPI_TransmitterSetMuteMode(TRANSMITTER_OPER_MODE Mode);
 /*! Checks current AVR operating mode and notify application if mode changed. */
 void TRANSMITTER_MonitorAvrMode(void);
 
-/*! @brief Main function for polling mode operation. */
+/*! Signals an interrupt of the transmitter. */
+void ADIAPI_TransmitterIrqHandler(void *Ref);
+
+/*! Tells the service whether the transmitter interrupt line is connected. */
+void ADIAPI_TransmitterEnableIrq(BOOL Enable);
+
+/*! Checks whether the transmitter has an event to service. */
+BOOL ADIAPI_TransmitterEventPending(void);
+
+/*! @brief Main function of the transmitter service. */
 ATV_ERR ADIAPI_TransmitterMain(void);
 
 /*! Performs TX housekeeping tasks. */
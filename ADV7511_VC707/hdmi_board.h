@@ -0,0 +1,69 @@
+/***************************************************************************//**
+ *   @file   hdmi_board.h
+ *   @brief  Board descriptor of the ADV7511 VC707 project.
+********************************************************************************
+ * Copyright 2013(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+********************************************************************************
+ *   SVN Revision: $WCREV$
+*******************************************************************************/
+
+#ifndef HDMI_BOARD_H_
+#define HDMI_BOARD_H_
+
+/******************************************************************************/
+/************************** Macros Definitions ********************************/
+/******************************************************************************/
+/* MicroBlaze, AXI interrupt controller & AXI timer; HDMI_BOARD_ZYNQ not defined */
+
+#define CFV_BASEADDR        XPAR_AXI_HDMI_TX_36B_0_BASEADDR
+#define DDR_BASEADDR        XPAR_DDR3_SDRAM_S_AXI_BASEADDR
+#define ADMA_BASEADDR       XPAR_AXI_DMA_0_BASEADDR
+#define IIC_BASEADDR        XPAR_AXI_IIC_0_BASEADDR
+/* I2C controller of the ADV7511, passed to HAL_PlatformInit */
+#define HAL_IIC_BASEADDR    IIC_BASEADDR
+
+#define CFA_CTRL			0xc03		// audio clock ratio, data enable & signal enable
+
+/* Transmitter input and output pixel formats */
+#define HDMI_IN_BITS_PER_COLOR	12
+#define HDMI_IN_FORMAT			SDR_444_SEP_SYNC
+#define HDMI_OUT_ENC_FORMAT		OUT_ENC_RGB_444
+
+/* Define HDMI_TX_INT_ID as the interrupt ID of the ADV7511 INT line in designs
+   that route it to the interrupt controller; otherwise the transmitter interrupt
+   state is polled at the housekeeping interval. */
+/* #define HDMI_TX_INT_ID */
+
+#endif /* HDMI_BOARD_H_ */